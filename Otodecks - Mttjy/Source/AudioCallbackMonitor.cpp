@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+
+    AudioCallbackMonitor.cpp
+    Created: 19 Oct 2026 9:20:41am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "AudioCallbackMonitor.h"
+
+AudioCallbackMonitor::AudioCallbackMonitor()
+{
+    reset();
+}
+
+void AudioCallbackMonitor::prepare(int samplesPerBlockExpected, double sampleRate)
+{
+    currentSampleRate = sampleRate;
+    expectedBlockSize = samplesPerBlockExpected;
+    previousStartTicks = 0;
+}
+
+void AudioCallbackMonitor::beginCallback(int numSamples) noexcept
+{
+    callbackStartTicks = Time::getHighResolutionTicks();
+    callbackNumSamples = numSamples;
+    deckTicksThisCallback = 0;
+}
+
+void AudioCallbackMonitor::endCallback() noexcept
+{
+    const int64 endTicks = Time::getHighResolutionTicks();
+    const int64 durationTicks = endTicks - callbackStartTicks;
+    const double sampleRate = currentSampleRate.load(std::memory_order_relaxed);
+    const double budgetSecs = callbackNumSamples / sampleRate;
+    const double durationSecs = Time::highResolutionTicksToSeconds(durationTicks);
+    const uint32 durationMicros = (uint32)jmax(0.0, durationSecs * 1.0e6);
+
+    // a device that hands us blocks late has dropped out, even if we were fast
+    if (previousStartTicks != 0)
+    {
+        const double interval = Time::highResolutionTicksToSeconds(callbackStartTicks - previousStartTicks);
+        if (interval > budgetSecs * 1.5)
+            lateCallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+    previousStartTicks = callbackStartTicks;
+
+    if (durationSecs > budgetSecs)
+        overruns.fetch_add(1, std::memory_order_relaxed);
+
+    auto& record = history[(size_t)(historyWritePos.load(std::memory_order_relaxed) % historySize)];
+    record.startTicks = callbackStartTicks;
+    record.durationMicros = durationMicros;
+    record.numSamples = (uint32)callbackNumSamples;
+    historyWritePos.fetch_add(1, std::memory_order_release);
+
+    const int bin = jmin((int)(durationMicros / histogramBinMicros), numHistogramBins - 1);
+    histogram[(size_t)bin].fetch_add(1, std::memory_order_relaxed);
+    numCallbacks.fetch_add(1, std::memory_order_relaxed);
+
+    if (durationMicros > maxDurationMicros.load(std::memory_order_relaxed))
+        maxDurationMicros.store(durationMicros, std::memory_order_relaxed);
+
+    const float load = (float)(durationSecs / budgetSecs);
+    const float previous = smoothedLoad.load(std::memory_order_relaxed);
+    smoothedLoad.store(previous + 0.05f * (load - previous), std::memory_order_relaxed);
+
+    // whatever the decks did not account for was spent summing them
+    mixerTicks.fetch_add(jmax((int64)0, durationTicks - deckTicksThisCallback), std::memory_order_relaxed);
+}
+
+void AudioCallbackMonitor::addDeckStageTime(int deckIndex, Stage stage, int64 ticks) noexcept
+{
+    if (!isPositiveAndBelow(deckIndex, maxDecks))
+        return;
+
+    auto& target = (stage == Stage::reader) ? readerTicks[(size_t)deckIndex] : resamplerTicks[(size_t)deckIndex];
+    target.fetch_add(ticks, std::memory_order_relaxed);
+    deckTicksThisCallback += ticks;
+}
+
+int64 AudioCallbackMonitor::getDeckStageTicks(int deckIndex, Stage stage) const
+{
+    if (!isPositiveAndBelow(deckIndex, maxDecks))
+        return 0;
+
+    return (stage == Stage::reader ? readerTicks[(size_t)deckIndex] : resamplerTicks[(size_t)deckIndex]).load(std::memory_order_relaxed);
+}
+
+void AudioCallbackMonitor::reset()
+{
+    for (auto& bin : histogram)
+        bin.store(0);
+    for (auto& t : readerTicks)
+        t.store(0);
+    for (auto& t : resamplerTicks)
+        t.store(0);
+
+    history.fill(CallbackRecord());
+    historyWritePos = 0;
+    numCallbacks = 0;
+    maxDurationMicros = 0;
+    overruns = 0;
+    lateCallbacks = 0;
+    smoothedLoad = 0.0f;
+    mixerTicks = 0;
+}
+
+double AudioCallbackMonitor::ticksToMs(int64 ticks)
+{
+    return Time::highResolutionTicksToSeconds(ticks) * 1000.0;
+}
+
+double AudioCallbackMonitor::percentileMs(double fraction) const
+{
+    const int64 total = numCallbacks.load(std::memory_order_relaxed);
+    if (total == 0)
+        return 0.0;
+
+    const int64 target = jmax((int64)1, (int64)std::ceil(fraction * (double)total));
+    int64 cumulative = 0;
+    for (int i = 0; i < numHistogramBins; ++i)
+    {
+        cumulative += histogram[(size_t)i].load(std::memory_order_relaxed);
+        if (cumulative >= target)
+            return (i + 0.5) * histogramBinMicros / 1000.0;
+    }
+    return numHistogramBins * histogramBinMicros / 1000.0;
+}
+
+AudioCallbackMonitor::Summary AudioCallbackMonitor::getSummary() const
+{
+    Summary s;
+    s.sampleRate = currentSampleRate.load();
+    s.budgetMs = s.sampleRate > 0 ? expectedBlockSize.load() * 1000.0 / s.sampleRate : 0.0;
+    s.loadPercent = smoothedLoad.load() * 100.0;
+    s.p50Ms = percentileMs(0.50);
+    s.p99Ms = percentileMs(0.99);
+    s.maxMs = maxDurationMicros.load() / 1000.0;
+    s.numCallbacks = numCallbacks.load();
+    s.overruns = overruns.load();
+    s.lateCallbacks = lateCallbacks.load();
+
+    setStageAverages(s, StageTotals(), getStageTotals());
+    return s;
+}
+
+AudioCallbackMonitor::StageTotals AudioCallbackMonitor::getStageTotals() const
+{
+    // not one snapshot: a callback may land between the loads, which a window
+    // of a few hundred callbacks doesn't notice
+    StageTotals t;
+    t.numCallbacks = numCallbacks.load();
+    for (int d = 0; d < maxDecks; ++d)
+    {
+        t.readerTicks[d] = readerTicks[(size_t)d].load();
+        t.resamplerTicks[d] = resamplerTicks[(size_t)d].load();
+    }
+    t.mixerTicks = mixerTicks.load();
+    return t;
+}
+
+void AudioCallbackMonitor::setStageAverages(Summary& summary, const StageTotals& older, const StageTotals& newer)
+{
+    const int64 callbacks = newer.numCallbacks - older.numCallbacks;
+    const double perCallback = callbacks > 0 ? 1.0 / (double)callbacks : 0.0;
+
+    for (int d = 0; d < maxDecks; ++d)
+    {
+        summary.deckReaderMs[d] = jmax(0.0, ticksToMs(newer.readerTicks[d] - older.readerTicks[d]) * perCallback);
+        summary.deckResamplerMs[d] = jmax(0.0, ticksToMs(newer.resamplerTicks[d] - older.resamplerTicks[d]) * perCallback);
+    }
+    summary.mixerMs = jmax(0.0, ticksToMs(newer.mixerTicks - older.mixerTicks) * perCallback);
+}
+
+bool AudioCallbackMonitor::dumpToFile(const File& file) const
+{
+    // the history is read while the audio thread may still be writing it, so
+    // the newest couple of records can be torn; fine for post-mortem use
+    FileOutputStream out(file);
+    if (!out.openedOk())
+        return false;
+    out.setPosition(0);
+    out.truncate();
+
+    const Summary s = getSummary();
+    out << "# Otodecks audio callback dump " << Time::getCurrentTime().toISO8601(true) << "\n";
+    out << "# sample rate " << s.sampleRate << ", expected budget " << s.budgetMs << " ms\n";
+    out << "# callbacks " << (int64)s.numCallbacks << ", overruns " << s.overruns
+        << ", late callbacks " << s.lateCallbacks << "\n";
+    out << "# p50 " << s.p50Ms << " ms, p99 " << s.p99Ms << " ms, max " << s.maxMs << " ms\n";
+    for (int d = 0; d < maxDecks; ++d)
+    {
+        if (s.deckReaderMs[d] > 0 || s.deckResamplerMs[d] > 0)
+            out << "# deck " << (d + 1) << " reader " << s.deckReaderMs[d]
+                << " ms, resampler " << s.deckResamplerMs[d] << " ms\n";
+    }
+    out << "# mixer " << s.mixerMs << " ms (stage times are averages per callback since the last reset)\n";
+
+    out << "start_seconds,duration_us,num_samples\n";
+    const int64 end = historyWritePos.load(std::memory_order_acquire);
+    const int64 begin = jmax((int64)0, end - historySize);
+    for (int64 i = begin; i < end; ++i)
+    {
+        const auto& record = history[(size_t)(i % historySize)];
+        out << String(Time::highResolutionTicksToSeconds(record.startTicks), 6) << ","
+            << (int)record.durationMicros << "," << (int)record.numSamples << "\n";
+    }
+    out.flush();
+    return out.getStatus().wasOk();
+}
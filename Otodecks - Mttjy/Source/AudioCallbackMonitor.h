@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+    AudioCallbackMonitor.h
+    Created: 19 Oct 2026 9:20:41am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/*
+    Always-on timing of the audio callback.
+
+    The audio thread only does relaxed atomic stores and a handful of
+    getHighResolutionTicks() calls per block, so the cost stays well below 1%
+    of the callback budget. Everything else (percentiles, averages, file dumps)
+    is computed on the reading side.
+*/
+class AudioCallbackMonitor
+{
+public:
+    static constexpr int maxDecks = 8;
+    static constexpr int historySize = 4096;
+    static constexpr int histogramBinMicros = 10;
+    static constexpr int numHistogramBins = 5000; // 0 - 50 ms
+
+    enum class Stage
+    {
+        reader,
+        resampler
+    };
+
+    struct CallbackRecord
+    {
+        int64 startTicks = 0;
+        uint32 durationMicros = 0;
+        uint32 numSamples = 0;
+    };
+
+    struct Summary
+    {
+        double sampleRate = 0;
+        double budgetMs = 0;
+        double loadPercent = 0;
+        double p50Ms = 0;
+        double p99Ms = 0;
+        double maxMs = 0;
+        int64 numCallbacks = 0;
+        int overruns = 0;
+        int lateCallbacks = 0;
+        double deckReaderMs[maxDecks] = {};
+        double deckResamplerMs[maxDecks] = {};
+        double mixerMs = 0;
+    };
+
+    /** running totals behind the per-stage figures; two of them make a recent average */
+    struct StageTotals
+    {
+        int64 numCallbacks = 0;
+        int64 readerTicks[maxDecks] = {};
+        int64 resamplerTicks[maxDecks] = {};
+        int64 mixerTicks = 0;
+    };
+
+    AudioCallbackMonitor();
+
+    /** call from prepareToPlay, before the first monitored callback */
+    void prepare(int samplesPerBlockExpected, double sampleRate);
+
+    /** audio thread: bracket one device callback */
+    void beginCallback(int numSamples) noexcept;
+    void endCallback() noexcept;
+
+    /** audio thread: time spent by one deck stage during the current callback */
+    void addDeckStageTime(int deckIndex, Stage stage, int64 ticks) noexcept;
+
+    /** any thread: high-resolution ticks a deck stage has used since the last reset,
+        cheap enough to poll for the recent share of a stage */
+    int64 getDeckStageTicks(int deckIndex, Stage stage) const;
+
+    /** clear the histogram, counters and history */
+    void reset();
+
+    /** the per-stage figures are averages per callback since the last reset */
+    Summary getSummary() const;
+
+    StageTotals getStageTotals() const;
+    /** overwrites summary's per-stage figures with their average per callback
+        between two totals, e.g. over the last second; zero if there was a reset */
+    static void setStageAverages(Summary& summary, const StageTotals& older, const StageTotals& newer);
+
+    /** write the summary and the raw callback history as CSV */
+    bool dumpToFile(const File& file) const;
+
+    class ScopedCallback
+    {
+    public:
+        ScopedCallback(AudioCallbackMonitor& m, int numSamples) noexcept : monitor(m) { monitor.beginCallback(numSamples); }
+        ~ScopedCallback() noexcept { monitor.endCallback(); }
+
+    private:
+        AudioCallbackMonitor& monitor;
+        JUCE_DECLARE_NON_COPYABLE(ScopedCallback)
+    };
+
+private:
+    double percentileMs(double fraction) const;
+    static double ticksToMs(int64 ticks);
+
+    std::atomic<double> currentSampleRate{ 44100.0 };
+    std::atomic<int> expectedBlockSize{ 512 };
+
+    // audio-thread-only scratch for the callback in flight
+    int64 callbackStartTicks = 0;
+    int64 previousStartTicks = 0;
+    int callbackNumSamples = 0;
+    int64 deckTicksThisCallback = 0;
+
+    std::array<CallbackRecord, historySize> history;
+    std::atomic<int64> historyWritePos{ 0 };
+
+    std::array<std::atomic<uint32>, numHistogramBins> histogram;
+    std::atomic<int64> numCallbacks{ 0 };
+    std::atomic<uint32> maxDurationMicros{ 0 };
+    std::atomic<int> overruns{ 0 };
+    std::atomic<int> lateCallbacks{ 0 };
+    std::atomic<float> smoothedLoad{ 0.0f };
+
+    std::array<std::atomic<int64>, maxDecks> readerTicks;
+    std::array<std::atomic<int64>, maxDecks> resamplerTicks;
+    std::atomic<int64> mixerTicks{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioCallbackMonitor)
+};
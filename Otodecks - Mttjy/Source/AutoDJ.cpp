@@ -0,0 +1,308 @@
+/*
+  ==============================================================================
+
+    AutoDJ.cpp
+    Created: 20 Oct 2026 12:14:52am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "AutoDJ.h"
+
+AutoDJ::AutoDJ(MixEngine& _engine)
+    : engine(_engine)
+{
+    prefetchThread.addTimeSliceClient(this);
+    prefetchThread.startThread();
+}
+
+AutoDJ::~AutoDJ()
+{
+    stopTimer();
+    prefetchThread.removeTimeSliceClient(this);
+    prefetchThread.stopThread(2000);
+}
+
+DJAudioPlayer* AutoDJ::getDeck(int index) const
+{
+    return engine.getNumDecks() >= 2 ? engine.getDeck(index) : nullptr;
+}
+
+//==============================================================================
+void AutoDJ::start(const Array<File>& newQueue)
+{
+    stop();
+
+    DJAudioPlayer* first = getDeck(0);
+    DJAudioPlayer* second = getDeck(1);
+    if (first == nullptr || second == nullptr)
+        return;
+
+    queue = newQueue;
+    queueIndex = -1;
+    currentDeck = second->isPlaying() && !first->isPlaying() ? 1 : 0;
+    currentStarted = false;
+    nextLoaded = false;
+    transitionStart = transitionEnd = -1;
+
+    DJAudioPlayer* current = getDeck(currentDeck);
+    if (!current->isPlaying())
+    {
+        if (queue.isEmpty())
+            return;
+
+        current->loadURL(URL{ queue[0] });
+        current->fadeInAt(-1, 0.0);
+        current->startAt(engine.getQuantizedSample());
+        queueIndex = 0;
+    }
+
+    running = true;
+    if (queueIndex + 1 < queue.size())
+        prefetch(queue[queueIndex + 1]);
+    startTimer(timerIntervalMs);
+}
+
+void AutoDJ::stop()
+{
+    stopTimer();
+    running = false;
+    queue.clear();
+    transitionStart = transitionEnd = -1;
+
+    {
+        const ScopedLock sl(prefetchLock);
+        prefetchStream.reset();
+    }
+
+    // a short ramp, so a deck that is already at full doesn't click
+    for (int d = 0; d < 2; ++d)
+        if (DJAudioPlayer* deck = getDeck(d))
+            deck->fadeInAt(-1, 0.05);
+}
+
+bool AutoDJ::isRunning() const
+{
+    return running;
+}
+
+void AutoDJ::setCrossfadeSecs(double secs)
+{
+    crossfadeSecs = jlimit(0.0, 60.0, secs);
+}
+
+double AutoDJ::getCrossfadeSecs() const
+{
+    return crossfadeSecs;
+}
+
+void AutoDJ::setBeatAligned(bool shouldAlign)
+{
+    beatAligned = shouldAlign;
+}
+
+bool AutoDJ::isBeatAligned() const
+{
+    return beatAligned;
+}
+
+String AutoDJ::getStatusText() const
+{
+    if (!running)
+        return "Auto-DJ off";
+
+    String text = queueIndex >= 0 ? String(queueIndex + 1) + "/" + String(queue.size()) : String("0/") + String(queue.size());
+
+    if (transitionEnd >= 0)
+        return text + (engine.getSamplePosition() >= transitionStart ? "  crossfading" : "  crossfade scheduled");
+    if (queueIndex + 1 >= queue.size())
+        return text + "  last track";
+
+    text << (nextLoaded ? "  next ready" : "  loading next");
+    const double secs = getSecondsToTransition();
+    if (secs >= 0)
+        text << ", crossfade in " << String::formatted("%d:%02d", (int)secs / 60, (int)secs % 60);
+    return text;
+}
+
+//==============================================================================
+void AutoDJ::timerCallback()
+{
+    DJAudioPlayer* current = getDeck(currentDeck);
+    if (current == nullptr)
+    {
+        stop();
+        return;
+    }
+
+    if (transitionEnd >= 0)
+    {
+        if (engine.getSamplePosition() < transitionEnd)
+            return;
+
+        // the crossfade is over: the incoming deck is the current one from here
+        currentDeck = 1 - currentDeck;
+        ++queueIndex;
+        currentStarted = true;
+        nextLoaded = false;
+        transitionStart = transitionEnd = -1;
+        if (queueIndex + 1 < queue.size())
+            prefetch(queue[queueIndex + 1]);
+        return;
+    }
+
+    if (current->isPlaying())
+        currentStarted = true;
+
+    if (queueIndex + 1 >= queue.size())
+    {
+        // the last track plays out on its own
+        if (currentStarted && !current->isPlaying())
+            stop();
+        return;
+    }
+
+    const double secondsToTransition = getSecondsToTransition();
+    if (!nextLoaded)
+    {
+        if (prefetchDone.load() || (secondsToTransition >= 0 && secondsToTransition < loadDeadlineSecs))
+            loadNext();
+        return;
+    }
+
+    if (secondsToTransition >= 0 && secondsToTransition < scheduleLeadSecs)
+        scheduleTransition();
+}
+
+double AutoDJ::getSecondsToTransition() const
+{
+    DJAudioPlayer* current = getDeck(currentDeck);
+    if (current == nullptr || current->isLooping())
+        return -1.0;    // a looping deck holds the queue until the loop is let go
+
+    const DJAudioPlayer::PlayheadSnapshot snapshot = current->getPlayheadSnapshot();
+    if (!snapshot.playing || snapshot.rate <= 0 || snapshot.lengthSecs <= 0)
+        return -1.0;
+
+    const double remaining = (snapshot.lengthSecs - snapshot.positionAt(Time::getMillisecondCounterHiRes())) / snapshot.rate;
+    return jmax(0.0, remaining - crossfadeSecs);
+}
+
+void AutoDJ::loadNext()
+{
+    DJAudioPlayer* next = getDeck(1 - currentDeck);
+    const URL url{ queue[queueIndex + 1] };
+
+    // silent until its crossfade, whatever level the last one left it at
+    next->fadeOutAt(-1, 0.0);
+    next->loadURL(url);
+
+    if (next->getLoadedURL() != url)
+    {
+        // unreadable: skip it and warm up the one after
+        queue.remove(queueIndex + 1);
+        if (queueIndex + 1 < queue.size())
+            prefetch(queue[queueIndex + 1]);
+        return;
+    }
+    nextLoaded = true;
+}
+
+void AutoDJ::scheduleTransition()
+{
+    DJAudioPlayer* current = getDeck(currentDeck);
+    DJAudioPlayer* next = getDeck(1 - currentDeck);
+    const DJAudioPlayer::PlayheadSnapshot snapshot = current->getPlayheadSnapshot();
+    const double sampleRate = engine.getSampleRate();
+    if (sampleRate <= 0 || snapshot.rate <= 0)
+        return;
+
+    // the sample the outgoing track ends on, counted from the block the snapshot was taken after
+    const int64 trackEnd = snapshot.clockSample
+                         + (int64)std::llround((snapshot.lengthSecs - snapshot.positionSecs) / snapshot.rate * sampleRate);
+
+    int64 start = trackEnd - (int64)std::llround(crossfadeSecs * sampleRate);
+    if (beatAligned)
+        start = engine.getGridLineBefore(start);
+    start = jmax(start, engine.getEarliestCommandSample());
+
+    const int64 length = jmax((int64)1, trackEnd - start);
+    const double lengthSecs = (double)length / sampleRate;
+
+    next->setPositionAt(0, start);
+    next->startAt(start);
+    next->fadeInAt(start, lengthSecs);
+    current->fadeOutAt(start, lengthSecs);
+    current->stopAt(start + length);
+
+    transitionStart = start;
+    transitionEnd = start + length;
+}
+
+//==============================================================================
+void AutoDJ::prefetch(const File& file)
+{
+    const ScopedLock sl(prefetchLock);
+
+    prefetchStream = std::make_unique<FileInputStream>(file);
+    if (prefetchStream->failedToOpen())
+        prefetchStream.reset();
+
+    // nothing to read means nothing to wait for; the load will report the problem
+    prefetchDone = prefetchStream == nullptr;
+    playingDeck = currentDeck;
+    lastWallTicks = 0;
+    readerShareBaseline = -1.0;
+    prefetchThread.notify();
+}
+
+int AutoDJ::useTimeSlice()
+{
+    const ScopedLock sl(prefetchLock);
+    if (prefetchStream == nullptr)
+        return 250;
+
+    if (isPlayingDeckBusy())
+        return 100;
+
+    const int numRead = prefetchStream->read(prefetchBuffer.get(), prefetchChunkBytes);
+    if (numRead <= 0 || prefetchStream->isExhausted())
+    {
+        prefetchStream.reset();
+        prefetchDone = true;
+        return 250;
+    }
+
+    // spread the chunks out to stay inside the bandwidth budget
+    return 1000 * prefetchChunkBytes / prefetchBytesPerSecond;
+}
+
+bool AutoDJ::isPlayingDeckBusy()
+{
+    const int64 readerTicks = engine.getMonitor().getDeckStageTicks(playingDeck.load(), AudioCallbackMonitor::Stage::reader);
+    const int64 wallTicks = Time::getHighResolutionTicks();
+    const int64 used = readerTicks - lastReaderTicks;
+    const int64 elapsed = wallTicks - lastWallTicks;
+    const bool firstLook = lastWallTicks == 0;
+    lastReaderTicks = readerTicks;
+    lastWallTicks = wallTicks;
+
+    // nothing to compare with yet, or the monitor was reset in between
+    if (firstLook || used < 0 || elapsed <= 0)
+        return false;
+
+    const double share = (double)used / (double)elapsed;
+    if (readerShareBaseline < 0)
+    {
+        readerShareBaseline = share;
+        return false;
+    }
+
+    // the reader mostly decodes from the cache; well above its usual share is time spent waiting
+    if (share > readerShareBaseline * 2.0 + 0.002)
+        return true;
+
+    readerShareBaseline += (share - readerShareBaseline) * 0.05;
+    return false;
+}
@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    AutoDJ.h
+    Created: 20 Oct 2026 12:14:52am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MixEngine.h"
+#include <atomic>
+
+//==============================================================================
+/*
+    Plays through a queue of tracks on its own, alternating between the
+    engine's first two decks with a crossfade between each pair.
+
+    While one deck plays, the next track is read from disk on a background
+    thread so it is in the OS cache before it is needed. That read is held
+    to a fixed bandwidth and stands back whenever the playing deck's reader
+    takes longer than usual, since that may mean it is waiting for the same
+    disk. Once the file is warm it is loaded into the idle deck, whose
+    scratch buffer then decodes its opening seconds, so the first blocks it
+    plays never touch the disk.
+
+    A few seconds before the crossfade is due, its start is worked out on
+    the engine's sample clock from the playing deck's last playhead
+    snapshot (optionally moved back to a beat or bar line of the grid). The
+    incoming deck's start and fade-in and the outgoing deck's fade-out and
+    stop are all scheduled for that sample, so the timing of the message
+    thread never shows in the mix. The fade ends where the outgoing track
+    does. Speed changes made after that point don't move it.
+*/
+class AutoDJ : private Timer,
+               private TimeSliceClient
+{
+public:
+    AutoDJ(MixEngine& engine);
+    ~AutoDJ() override;
+
+    /** play through queue. A deck that is already playing carries on and
+        queue[0] follows it; otherwise queue[0] starts on the first deck. */
+    void start(const Array<File>& queue);
+    /** leave both decks as they are, with their mix levels back at full;
+        a crossfade that is already scheduled still runs */
+    void stop();
+    bool isRunning() const;
+
+    void setCrossfadeSecs(double secs);
+    double getCrossfadeSecs() const;
+    /** start crossfades on a line of the engine's grid, at its quantize setting */
+    void setBeatAligned(bool shouldAlign);
+    bool isBeatAligned() const;
+
+    /** one line for the panel, e.g. "2/14  crossfade in 1:05" */
+    String getStatusText() const;
+
+private:
+    void timerCallback() override;
+    int useTimeSlice() override;
+
+    DJAudioPlayer* getDeck(int index) const;
+    /** output seconds until the playing track should start fading, or -1 if it isn't moving */
+    double getSecondsToTransition() const;
+    void loadNext();
+    void scheduleTransition();
+    void prefetch(const File& file);
+    /** prefetch thread: true if the playing deck's reader has been slower than usual lately */
+    bool isPlayingDeckBusy();
+
+    static constexpr int timerIntervalMs = 50;
+    static constexpr double scheduleLeadSecs = 2.0;   // how far ahead the crossfade is scheduled
+    static constexpr double loadDeadlineSecs = 20.0;  // load the next track by then, warm or not
+    static constexpr int prefetchChunkBytes = 1 << 16;
+    static constexpr int prefetchBytesPerSecond = 4 << 20;
+
+    MixEngine& engine;
+
+    // message thread
+    Array<File> queue;
+    int queueIndex = -1;            // the track on the current deck; -1 for one that was already playing
+    int currentDeck = 0;
+    bool running = false;
+    bool currentStarted = false;    // the current deck has been seen playing
+    bool nextLoaded = false;
+    int64 transitionStart = -1;
+    int64 transitionEnd = -1;
+    double crossfadeSecs = 8.0;
+    bool beatAligned = false;
+
+    // shared with the prefetch thread
+    TimeSliceThread prefetchThread{ "Auto-DJ prefetch" };
+    CriticalSection prefetchLock;
+    std::unique_ptr<FileInputStream> prefetchStream;
+    HeapBlock<char> prefetchBuffer{ (size_t)prefetchChunkBytes };
+    std::atomic<bool> prefetchDone{ false };
+    std::atomic<int> playingDeck{ 0 };
+
+    // prefetch thread, under prefetchLock
+    int64 lastReaderTicks = 0;
+    int64 lastWallTicks = 0;
+    double readerShareBaseline = -1.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AutoDJ)
+};
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    AutoDjPanel.cpp
+    Created: 20 Oct 2026 12:52:19am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "AutoDjPanel.h"
+
+//==============================================================================
+AutoDjPanel::AutoDjPanel(AutoDJ& _autoDJ)
+    : autoDJ(_autoDJ)
+{
+    addAndMakeVisible(autoButton);
+    autoButton.onClick = [this]
+    {
+        if (autoButton.getToggleState() && getQueue)
+            autoDJ.start(getQueue());
+        else
+            autoDJ.stop();
+        timerCallback();
+    };
+
+    addAndMakeVisible(fadeSlider);
+    fadeSlider.setSliderStyle(Slider::IncDecButtons);
+    fadeSlider.setTextBoxStyle(Slider::TextBoxLeft, false, 44, 20);
+    fadeSlider.setRange(0.0, 30.0, 1.0);
+    fadeSlider.setTextValueSuffix(" s");
+    fadeSlider.setTooltip("Crossfade length");
+    fadeSlider.setValue(autoDJ.getCrossfadeSecs(), dontSendNotification);
+    fadeSlider.onValueChange = [this] { autoDJ.setCrossfadeSecs(fadeSlider.getValue()); };
+
+    addAndMakeVisible(beatButton);
+    beatButton.setTooltip("Start crossfades on the tempo grid");
+    beatButton.setToggleState(autoDJ.isBeatAligned(), dontSendNotification);
+    beatButton.onClick = [this] { autoDJ.setBeatAligned(beatButton.getToggleState()); };
+
+    addAndMakeVisible(statusLabel);
+    statusLabel.setFont(12.0f);
+
+    startTimer(250);
+    timerCallback();
+}
+
+AutoDjPanel::~AutoDjPanel()
+{
+    stopTimer();
+}
+
+void AutoDjPanel::paint (Graphics& g)
+{
+    g.fillAll(Colour::fromRGB(15, 15, 15));
+}
+
+void AutoDjPanel::resized()
+{
+    autoButton.setBounds(0, 0, 56, getHeight());
+    fadeSlider.setBounds(56, 0, 90, getHeight());
+    beatButton.setBounds(148, 0, 56, getHeight());
+    statusLabel.setBounds(206, 0, getWidth() - 206, getHeight());
+}
+
+void AutoDjPanel::timerCallback()
+{
+    // the queue can run out on its own
+    if (autoButton.getToggleState() != autoDJ.isRunning())
+        autoButton.setToggleState(autoDJ.isRunning(), dontSendNotification);
+
+    statusLabel.setText(autoDJ.getStatusText(), dontSendNotification);
+}
@@ -0,0 +1,44 @@
+/*
+  ==============================================================================
+
+    AutoDjPanel.h
+    Created: 20 Oct 2026 12:52:19am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AutoDJ.h"
+
+//==============================================================================
+/*
+    Auto-DJ on/off, crossfade length, beat alignment and what it is doing.
+*/
+class AutoDjPanel  : public Component,
+                     public Timer
+{
+public:
+    AutoDjPanel(AutoDJ& autoDJ);
+    ~AutoDjPanel() override;
+
+    void paint (Graphics&) override;
+    void resized() override;
+
+    void timerCallback() override;
+
+    /** the tracks to play when switched on */
+    std::function<Array<File>()> getQueue;
+
+private:
+    AutoDJ& autoDJ;
+
+    ToggleButton autoButton{ "Auto" };
+    Slider fadeSlider;
+    ToggleButton beatButton{ "Grid" };
+    Label statusLabel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutoDjPanel)
+};
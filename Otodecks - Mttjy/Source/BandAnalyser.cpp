@@ -0,0 +1,385 @@
+/*
+  ==============================================================================
+
+    BandAnalyser.cpp
+    Created: 20 Oct 2026 1:20:36am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "BandAnalyser.h"
+
+namespace
+{
+    constexpr double lowCrossoverHz = 200.0;
+    constexpr double highCrossoverHz = 2500.0;
+    constexpr int columnsPerChunk = 64;
+
+    constexpr int storeMagic = 0x4f544257;     // "OTBW"
+    constexpr int storeVersion = 1;
+
+    /** sqrt of the mean square: four running sums the compiler can keep in one vector register */
+    float rootMeanSquare(const float* data, int numSamples) noexcept
+    {
+        float sums[4] = {};
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+            for (int k = 0; k < 4; ++k)
+                sums[k] += data[i + k] * data[i + k];
+
+        float total = sums[0] + sums[1] + sums[2] + sums[3];
+        for (; i < numSamples; ++i)
+            total += data[i] * data[i];
+
+        return std::sqrt(total / (float)jmax(1, numSamples));
+    }
+
+    /** 0-1 of the loudest column, as a byte */
+    void scaleToBytes(const std::vector<float>& levels, std::vector<uint8>& bytes)
+    {
+        const float loudest = levels.empty() ? 0.0f : *std::max_element(levels.begin(), levels.end());
+        const float scale = loudest > 0.0f ? 255.0f / loudest : 0.0f;
+
+        bytes.resize(levels.size());
+        for (size_t i = 0; i < levels.size(); ++i)
+            bytes[i] = (uint8)jlimit(0, 255, roundToInt(levels[i] * scale));
+    }
+}
+
+//==============================================================================
+class BandAnalyser::AnalysisJob : public ThreadPoolJob
+{
+public:
+    AnalysisJob(BandAnalyser& _owner, const URL& _url, StreamingDownload::Ptr _download)
+        : ThreadPoolJob("Bands " + _url.getFileName()), owner(_owner), url(_url), download(_download)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        const String key = url.toString(false);
+        std::shared_ptr<BandWaveform> result = owner.loadStored(url);
+        if (result != nullptr)
+        {
+            owner.finished(key, result);
+            return jobHasFinished;
+        }
+
+        // a blocking stream over the download waits for each part to arrive
+        String error;
+        std::unique_ptr<AudioFormatReader> reader = download != nullptr
+            ? download->createReader(owner.readers.getFormatManager(), false, error)
+            : owner.readers.acquire(url);
+        if (reader != nullptr)
+        {
+            owner.startFeeding(key, *reader);
+            result = analyse(*reader, [this] { return shouldExit(); },
+                             [this, &key](const AudioBuffer<float>& block, int64 position, int numSamples)
+                             {
+                                 owner.feed(key, block, position, numSamples);
+                             });
+            owner.readers.release(url, std::move(reader));
+            if (result != nullptr)
+                owner.store(url, *result);
+        }
+
+        owner.finished(key, result);
+        return jobHasFinished;
+    }
+
+private:
+    BandAnalyser& owner;
+    URL url;
+    StreamingDownload::Ptr download;
+};
+
+//==============================================================================
+BandAnalyser::BandAnalyser(ReaderPool& _readers)
+    : readers(_readers)
+{
+}
+
+BandAnalyser::~BandAnalyser()
+{
+    pool.removeAllJobs(true, 5000);
+}
+
+bool BandAnalyser::request(const URL& url, AudioThumbnail* thumbnail, StreamingDownload::Ptr download)
+{
+    if (download == nullptr && StreamingDownload::canStream(url))
+        return false;
+
+    const String key = url.toString(false);
+    {
+        const ScopedLock sl(lock);
+        if (results.count(key) > 0)
+        {
+            recentKeys.removeString(key);
+            recentKeys.add(key);
+            return false;
+        }
+
+        // a thumbnail can only join before the first block has gone out
+        const bool willFeed = thumbnail != nullptr && !startedKeys.contains(key);
+        if (willFeed)
+            thumbnails.insert({ key, thumbnail });
+
+        if (pendingKeys.contains(key))
+            return willFeed;
+        pendingKeys.add(key);
+    }
+
+    pool.addJob(new AnalysisJob(*this, url, download), true);
+    return thumbnail != nullptr;
+}
+
+void BandAnalyser::removeThumbnail(AudioThumbnail* thumbnail)
+{
+    const ScopedLock sl(lock);
+    for (auto it = thumbnails.begin(); it != thumbnails.end();)
+        it = it->second == thumbnail ? thumbnails.erase(it) : std::next(it);
+}
+
+void BandAnalyser::startFeeding(const String& key, const AudioFormatReader& reader)
+{
+    const ScopedLock sl(lock);
+    startedKeys.add(key);
+    const auto range = thumbnails.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it)
+        it->second->reset((int)reader.numChannels, reader.sampleRate, reader.lengthInSamples);
+}
+
+void BandAnalyser::feed(const String& key, const AudioBuffer<float>& block, int64 position, int numSamples)
+{
+    // under the lock, so removeThumbnail() can't return while a block is going in
+    const ScopedLock sl(lock);
+    const auto range = thumbnails.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it)
+        it->second->addBlock(position, block, 0, numSamples);
+}
+
+std::shared_ptr<const BandWaveform> BandAnalyser::getResult(const URL& url) const
+{
+    const ScopedLock sl(lock);
+    const auto found = results.find(url.toString(false));
+    return found != results.end() ? found->second : nullptr;
+}
+
+void BandAnalyser::finished(const String& key, std::shared_ptr<const BandWaveform> result)
+{
+    {
+        const ScopedLock sl(lock);
+        pendingKeys.removeString(key);
+        startedKeys.removeString(key);
+        thumbnails.erase(key);
+        if (result == nullptr)
+            return;
+
+        results[key] = result;
+        recentKeys.removeString(key);
+        recentKeys.add(key);
+        while (recentKeys.size() > maxResults)
+        {
+            results.erase(recentKeys[0]);
+            recentKeys.remove(0);
+        }
+    }
+    sendChangeMessage();
+}
+
+void BandAnalyser::setStoreDirectory(const File& directory)
+{
+    storeDirectory = directory;
+}
+
+File BandAnalyser::getStoreFile(const URL& url) const
+{
+    return storeDirectory.getChildFile(String::toHexString(url.toString(false).hashCode64()) + ".bands");
+}
+
+std::shared_ptr<BandWaveform> BandAnalyser::loadStored(const URL& url) const
+{
+    if (storeDirectory == File() || !url.isLocalFile())
+        return nullptr;
+
+    FileInputStream in(getStoreFile(url));
+    if (!in.openedOk() || in.readInt() != storeMagic || in.readInt() != storeVersion)
+        return nullptr;
+
+    // another URL with the same hash, or the track has changed since
+    const File track = url.getLocalFile();
+    if (in.readString() != url.toString(false)
+        || in.readInt64() != track.getLastModificationTime().toMilliseconds()
+        || in.readInt64() != track.getSize())
+        return nullptr;
+
+    auto result = std::make_shared<BandWaveform>();
+    result->sampleRate = in.readDouble();
+    result->lengthInSamples = in.readInt64();
+    const int spc = BandWaveform::samplesPerColumn;
+    const int numColumns = in.readInt();
+    if (result->lengthInSamples < 0 || numColumns != (int)((result->lengthInSamples + spc - 1) / spc))
+        return nullptr;
+
+    for (auto* levels : { &result->peak, &result->low, &result->mid, &result->high })
+    {
+        levels->resize((size_t)numColumns);
+        if (in.read(levels->data(), numColumns) != numColumns)
+            return nullptr;
+    }
+    return result;
+}
+
+void BandAnalyser::store(const URL& url, const BandWaveform& waveform) const
+{
+    if (storeDirectory == File() || !url.isLocalFile() || !storeDirectory.createDirectory().wasOk())
+        return;
+
+    const File track = url.getLocalFile();
+    TemporaryFile temp(getStoreFile(url));
+    {
+        FileOutputStream out(temp.getFile());
+        if (!out.openedOk())
+            return;
+
+        out.writeInt(storeMagic);
+        out.writeInt(storeVersion);
+        out.writeString(url.toString(false));
+        out.writeInt64(track.getLastModificationTime().toMilliseconds());
+        out.writeInt64(track.getSize());
+        out.writeDouble(waveform.sampleRate);
+        out.writeInt64(waveform.lengthInSamples);
+        out.writeInt(waveform.getNumColumns());
+        for (const auto* levels : { &waveform.peak, &waveform.low, &waveform.mid, &waveform.high })
+            out.write(levels->data(), levels->size());
+    }
+    temp.overwriteTargetFileWithTemporary();
+
+    Array<File> stored = storeDirectory.findChildFiles(File::findFiles, false, "*.bands");
+    if (stored.size() <= maxStoredResults)
+        return;
+
+    std::sort(stored.begin(), stored.end(), [](const File& a, const File& b)
+    {
+        return a.getLastModificationTime() < b.getLastModificationTime();
+    });
+    for (int i = 0; i < stored.size() - maxStoredResults; ++i)
+        stored.getReference(i).deleteFile();
+}
+
+//==============================================================================
+std::shared_ptr<BandWaveform> BandAnalyser::analyse(AudioFormatReader& reader, std::function<bool()> shouldStop,
+                                                   ChunkCallback onChunk)
+{
+    auto result = std::make_shared<BandWaveform>();
+    result->sampleRate = reader.sampleRate;
+    result->lengthInSamples = reader.lengthInSamples;
+
+    const int spc = BandWaveform::samplesPerColumn;
+    const int numColumns = (int)((reader.lengthInSamples + spc - 1) / spc);
+    std::vector<float> peaks((size_t)numColumns), lows((size_t)numColumns), mids((size_t)numColumns), highs((size_t)numColumns);
+
+    // two cascaded Butterworth sections make a 4th-order Linkwitz-Riley slope
+    IIRFilter lowFilters[2], highFilters[2];
+    for (auto& f : lowFilters)
+        f.setCoefficients(IIRCoefficients::makeLowPass(reader.sampleRate, lowCrossoverHz));
+    for (auto& f : highFilters)
+        f.setCoefficients(IIRCoefficients::makeHighPass(reader.sampleRate, highCrossoverHz));
+
+    const int chunkSize = spc * columnsPerChunk;
+    AudioBuffer<float> buffer(2, chunkSize);
+    HeapBlock<float> lowBand((size_t)chunkSize), highBand((size_t)chunkSize);
+
+    int column = 0;
+    for (int64 position = 0; position < reader.lengthInSamples; position += chunkSize)
+    {
+        if (shouldStop && shouldStop())
+            return nullptr;
+
+        const int numSamples = (int)jmin((int64)chunkSize, reader.lengthInSamples - position);
+        reader.read(&buffer, 0, numSamples, position, true, true);
+        if (onChunk)
+            onChunk(buffer, position, numSamples);
+
+        float* signal = buffer.getWritePointer(0);
+        if (reader.numChannels > 1)
+        {
+            FloatVectorOperations::add(signal, buffer.getReadPointer(1), numSamples);
+            FloatVectorOperations::multiply(signal, 0.5f, numSamples);
+        }
+
+        FloatVectorOperations::copy(lowBand, signal, numSamples);
+        FloatVectorOperations::copy(highBand, signal, numSamples);
+        for (auto& f : lowFilters)
+            f.processSamples(lowBand, numSamples);
+        for (auto& f : highFilters)
+            f.processSamples(highBand, numSamples);
+
+        const int firstColumn = column;
+        for (int start = 0; start < numSamples && column < numColumns; start += spc, ++column)
+        {
+            const auto range = FloatVectorOperations::findMinAndMax(signal + start, jmin(spc, numSamples - start));
+            peaks[(size_t)column] = jmax(-range.getStart(), range.getEnd());
+        }
+
+        // whatever is neither low nor high is mid
+        FloatVectorOperations::subtract(signal, lowBand, numSamples);
+        FloatVectorOperations::subtract(signal, highBand, numSamples);
+
+        column = firstColumn;
+        for (int start = 0; start < numSamples && column < numColumns; start += spc, ++column)
+        {
+            const int n = jmin(spc, numSamples - start);
+            lows[(size_t)column] = rootMeanSquare(lowBand + start, n);
+            mids[(size_t)column] = rootMeanSquare(signal + start, n);
+            highs[(size_t)column] = rootMeanSquare(highBand + start, n);
+        }
+    }
+
+    // peaks keep their real level, like the thumbnail; each band is scaled to its
+    // own loudest column, since a kick carries far more energy than a hi-hat
+    result->peak.resize((size_t)numColumns);
+    for (size_t i = 0; i < peaks.size(); ++i)
+        result->peak[i] = (uint8)jlimit(0, 255, roundToInt(peaks[i] * 255.0f));
+    scaleToBytes(lows, result->low);
+    scaleToBytes(mids, result->mid);
+    scaleToBytes(highs, result->high);
+    return result;
+}
+
+Image BandAnalyser::render(const BandWaveform& waveform, int width, int height)
+{
+    Image image(Image::ARGB, jmax(1, width), jmax(1, height), true);
+    const int numColumns = waveform.getNumColumns();
+    if (numColumns == 0)
+        return image;
+
+    Graphics g(image);
+    const float centre = image.getHeight() * 0.5f;
+
+    for (int x = 0; x < image.getWidth(); ++x)
+    {
+        // every column that falls under this pixel; the loudest of each wins
+        const int first = (int)((int64)x * numColumns / image.getWidth());
+        const int last = jmax(first + 1, (int)((int64)(x + 1) * numColumns / image.getWidth()));
+
+        int peak = 0, low = 0, mid = 0, high = 0;
+        for (int c = first; c < jmin(last, numColumns); ++c)
+        {
+            peak = jmax(peak, (int)waveform.peak[(size_t)c]);
+            low = jmax(low, (int)waveform.low[(size_t)c]);
+            mid = jmax(mid, (int)waveform.mid[(size_t)c]);
+            high = jmax(high, (int)waveform.high[(size_t)c]);
+        }
+
+        // the strongest band sets the hue; a floor keeps quiet passages visible
+        const int strongest = jmax(1, low, mid, high);
+        auto channel = [strongest](int level) { return (uint8)(40 + 215 * level / strongest); };
+        g.setColour(Colour(channel(low), channel(mid), channel(high)));
+
+        const float half = jmax(0.5f, peak / 255.0f * centre);
+        g.drawVerticalLine(x, centre - half, centre + half);
+    }
+    return image;
+}
@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    BandAnalyser.h
+    Created: 20 Oct 2026 1:20:36am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <map>
+#include <memory>
+#include <vector>
+#include "ReaderPool.h"
+#include "StreamingDownload.h"
+
+//==============================================================================
+/*
+    A track's waveform split into low, mid and high bands: one column per
+    1000 source samples, the same resolution as the decks' AudioThumbnails.
+    Each column keeps its peak level and the RMS level of each band, all
+    scaled to 0-255.
+*/
+struct BandWaveform
+{
+    static constexpr int samplesPerColumn = 1000;
+
+    double sampleRate = 0;
+    int64 lengthInSamples = 0;
+    std::vector<uint8> peak;
+    std::vector<uint8> low;
+    std::vector<uint8> mid;
+    std::vector<uint8> high;
+
+    int getNumColumns() const { return (int)peak.size(); }
+};
+
+//==============================================================================
+/*
+    Works out BandWaveforms on a small pool of background threads shared by
+    every deck, and keeps the most recent ones so a track loaded again is
+    shown at once. A change message is sent whenever one finishes.
+
+    With a store directory set, every result for a local file is also
+    written there, one small file per track named by a hash of its URL and
+    holding the track's modification time and size. A request looks there
+    before decoding anything, so a relaunch doesn't analyse the library
+    again; a track changed since is analysed afresh and its file replaced.
+    The least recently written files go once there are more than
+    maxStoredResults.
+
+    This is the one full decode of a loaded track. A deck's AudioThumbnail
+    can be handed to request() and is built from the same decoded blocks,
+    instead of reading the file again through its own source. A streamed
+    track is decoded from the deck's StreamingDownload as it arrives, and
+    never fetched a second time.
+
+    The track is mixed to mono and split by 4th-order Linkwitz-Riley style
+    crossovers at 200 Hz and 2.5 kHz: two cascaded biquads for the low band,
+    two for the high band, and the mid band is whatever is left. Mixing,
+    splitting off the mid band and the peak search use FloatVectorOperations,
+    and the per-column sums of squares are written so the compiler keeps
+    them in vector registers. Decoding the file costs more than all of that.
+
+    render() turns a result into an image once per size, so painting a deck
+    is a single image blit.
+*/
+class BandAnalyser : public ChangeBroadcaster
+{
+public:
+    BandAnalyser(ReaderPool& readers);
+    ~BandAnalyser() override;
+
+    /** start analysing url in the background, unless it is done or already queued.
+        thumbnail, if given, is reset and fed every decoded block; returns false if it
+        won't be, because the analysis is already done or past its start. An http(s)
+        url is read from download, and without one it isn't analysed at all. */
+    bool request(const URL& url, AudioThumbnail* thumbnail = nullptr, StreamingDownload::Ptr download = nullptr);
+
+    /** message thread: stop feeding thumbnail; no block reaches it after this returns */
+    void removeThumbnail(AudioThumbnail* thumbnail);
+
+    /** the finished analysis, or nullptr while it is running or if the file can't be read */
+    std::shared_ptr<const BandWaveform> getResult(const URL& url) const;
+
+    /** message thread, before the first request: keep results on disk in directory */
+    void setStoreDirectory(const File& directory);
+
+    /** called with each block as it is decoded, before it is mixed down */
+    using ChunkCallback = std::function<void(const AudioBuffer<float>& block, int64 position, int numSamples)>;
+
+    /** analyse a whole track in the caller's thread; nullptr if shouldStop() said so */
+    static std::shared_ptr<BandWaveform> analyse(AudioFormatReader& reader, std::function<bool()> shouldStop = nullptr,
+                                                 ChunkCallback onChunk = nullptr);
+
+    /** the waveform drawn across width x height: height from the peaks, colour
+        from the bands (red for low, green for mid, blue for high) */
+    static Image render(const BandWaveform& waveform, int width, int height);
+
+private:
+    class AnalysisJob;
+
+    void finished(const String& key, std::shared_ptr<const BandWaveform> result);
+    void startFeeding(const String& key, const AudioFormatReader& reader);
+    void feed(const String& key, const AudioBuffer<float>& block, int64 position, int numSamples);
+
+    /** pool threads: the stored result for url, if it is still the track's */
+    std::shared_ptr<BandWaveform> loadStored(const URL& url) const;
+    void store(const URL& url, const BandWaveform& waveform) const;
+    File getStoreFile(const URL& url) const;
+
+    static constexpr int maxResults = 32;
+    static constexpr int maxStoredResults = 1000;
+
+    ReaderPool& readers;
+    File storeDirectory;
+    ThreadPool pool{ 2 };
+
+    mutable CriticalSection lock;
+    std::map<String, std::shared_ptr<const BandWaveform>> results;
+    StringArray recentKeys;         // least recently requested first
+    StringArray pendingKeys;
+    StringArray startedKeys;
+    std::multimap<String, AudioThumbnail*> thumbnails;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BandAnalyser)
+};
@@ -10,6 +10,18 @@ Author:  matthew
 
 #include "DJAudioPlayer.h"
 
+namespace
+{
+    /** fastest the platter may be thrown, in source samples per output sample */
+    constexpr double maxBufferVelocity = 8.0;
+    /** slower than this either way, the deck holds still: the resampler can't run at 0 */
+    constexpr double minSpeed = 0.001;
+    /** how long the fader takes to reach a new gain, so it doesn't click */
+    constexpr double faderRampSecs = 0.01;
+    /** the last block before a stop fades out over this many samples, at most */
+    constexpr int stopFadeSamples = 256;
+}
+
 DJAudioPlayer::DJAudioPlayer(AudioFormatManager& _formatManager) 
 : formatManager(_formatManager)
 {
@@ -23,36 +35,323 @@ DJAudioPlayer::~DJAudioPlayer()
 
 void DJAudioPlayer::prepareToPlay (int samplesPerBlockExpected, double sampleRate) 
 {
-    transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    resampleSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    outputSampleRate = sampleRate;
+    sampleClock = 0;
+    // the clock restarts, so a fade or fader move in flight can only be finished off
+    if (fading)
+    {
+        fading = false;
+        mixLevel = fadeTo;
+    }
+    faderFrom = faderTo = (float)currentGain.load();
+    faderRampStart = 0;
+    faderRampLength = jmax((int64)1, (int64)std::llround(faderRampSecs * sampleRate));
+    numLevelChanges = 0;
+    levelCurveSize = jmax(1, samplesPerBlockExpected);
+    levelCurve.allocate((size_t)levelCurveSize, true);
+    {
+        const SpinLock::ScopedLockType swapLock(sourceSwapLock);
+        if (readerSource != nullptr)
+            readerSource->prepareToPlay(samplesPerBlockExpected, sampleRate);
+        moveSource(getSourcePlayhead());
+    }
+    fx.prepare(sampleRate, samplesPerBlockExpected);
+    limiter.prepare(sampleRate, samplesPerBlockExpected);
+    prepared = true;
 }
 
 void DJAudioPlayer::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
 {
-    resampleSource.getNextAudioBlock(bufferToFill);
+    renderPreFader(bufferToFill);
+    applyFader(bufferToFill);
+}
+
+void DJAudioPlayer::renderPreFader(const AudioSourceChannelInfo& bufferToFill)
+{
+    const int64 blockStart = sampleClock.load(std::memory_order_relaxed);
+    const int numSamples = bufferToFill.numSamples;
+
+    const SpinLock::ScopedTryLockType swapLock(sourceSwapLock);
+    if (!swapLock.isLocked())
+    {
+        // a track is being loaded into this deck right now
+        bufferToFill.clearActiveBufferRegion();
+        sampleClock.store(blockStart + numSamples, std::memory_order_relaxed);
+        return;
+    }
+
+    if (sourceChanged)
+    {
+        resampler.reset();
+        stopFadeDue = false;
+        sourceChanged = false;
+    }
+
+    // the load is stamped here, where its track is first heard
+    if (pendingLoadLogId >= 0)
+    {
+        if (eventLog != nullptr)
+            eventLog->logFromAudioThread(deckIndex, EngineEventLog::EventType::load, pendingLoadLogId);
+        pendingLoadLogId = -1;
+    }
 
+    collectCommands(blockStart);
+
+    // render up to each scheduled command, apply it, and carry on from there
+    int done = 0;
+    for (;;)
+    {
+        while (numScheduled > 0 && scheduled[0].sample <= blockStart + done)
+        {
+            applyCommand(scheduled[0], done);
+            std::move(scheduled.begin() + 1, scheduled.begin() + numScheduled, scheduled.begin());
+            --numScheduled;
+        }
+
+        const int64 nextCommand = numScheduled > 0 ? scheduled[0].sample : std::numeric_limits<int64>::max();
+        const int length = (int)jmin((int64)(numSamples - done), nextCommand - (blockStart + done));
+        renderSegment(AudioSourceChannelInfo(bufferToFill.buffer, bufferToFill.startSample + done, length));
+
+        done += length;
+        if (done >= numSamples)
+            break;
+    }
+
+    fx.process(*bufferToFill.buffer, bufferToFill.startSample, numSamples);
+
+    // out of the path the limiter costs nothing and delays nothing; back in,
+    // its delay starts empty rather than replaying what it last held
+    const bool runLimiter = limiterInPath || limiter.isEnabled();
+    if (runLimiter && !limiterWasInPath)
+        limiter.reset();
+    if (runLimiter)
+        limiter.process(*bufferToFill.buffer, bufferToFill.startSample, numSamples);
+    limiterWasInPath = runLimiter;
+
+    // a track that ran off its end is rewound here, in the block it ended in,
+    // rather than whenever the display next looks
+    if (!bufferMode && !looping.load(std::memory_order_relaxed) && readerSource != nullptr
+        && getSourcePlayhead() >= (double)readerSource->getTotalLength())
+    {
+        playing = false;
+        stopFadeDue = false;
+        moveSource(0);
+    }
+
+    sampleClock.store(blockStart + numSamples, std::memory_order_relaxed);
+    publishSnapshot();
+}
+
+void DJAudioPlayer::renderSegment(const AudioSourceChannelInfo& bufferToFill)
+{
+    if (bufferMode)
+    {
+        const int64 start = Time::getHighResolutionTicks();
+        renderFromBuffer(bufferToFill);
+        if (monitor != nullptr)
+            monitor->addDeckStageTime(deckIndex, AudioCallbackMonitor::Stage::resampler, Time::getHighResolutionTicks() - start);
+        return;
+    }
+
+    // where a scratch or reverse play would start from; nothing is decoded
+    // for the scratch buffer until one does
+    scratchBuffer.setPlayhead(getSourcePlayhead(), currentSpeed.load());
+
+    // stopped, the source stays where it is; the block a stop lands in still
+    // plays, and fades out over its first stopFadeSamples
+    const bool fadeOut = !playing.load(std::memory_order_relaxed) && stopFadeDue;
+    if (readerSource == nullptr || (!playing.load(std::memory_order_relaxed) && !fadeOut))
+    {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    readerTicksThisBlock = 0;
+    const int64 start = Time::getHighResolutionTicks();
+    resampler.render(*readerSource, *bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples,
+                     currentSpeed.load(std::memory_order_relaxed) * sourceSampleRate / outputSampleRate);
+    const int64 total = Time::getHighResolutionTicks() - start;
+
+    if (fadeOut)
+    {
+        const int fadeLength = jmin(stopFadeSamples, bufferToFill.numSamples);
+        bufferToFill.buffer->applyGainRamp(bufferToFill.startSample, fadeLength, 1.0f, 0.0f);
+        if (bufferToFill.numSamples > fadeLength)
+            bufferToFill.buffer->clear(bufferToFill.startSample + fadeLength, bufferToFill.numSamples - fadeLength);
+        stopFadeDue = false;
+    }
+
+    if (monitor == nullptr)
+        return;
+
+    monitor->addDeckStageTime(deckIndex, AudioCallbackMonitor::Stage::reader, readerTicksThisBlock);
+    monitor->addDeckStageTime(deckIndex, AudioCallbackMonitor::Stage::resampler, total - readerTicksThisBlock);
+}
+
+void DJAudioPlayer::applyFader(const AudioSourceChannelInfo& bufferToFill)
+{
+    const int numSamples = bufferToFill.numSamples;
+    // renderPreFader has already moved the clock past this block
+    const int64 blockStart = sampleClock.load(std::memory_order_relaxed) - numSamples;
+
+    // up to each gain or fade change, then from it
+    int done = 0;
+    for (int i = 0; i <= numLevelChanges; ++i)
+    {
+        const int end = i < numLevelChanges
+            ? (int)jlimit((int64)done, (int64)numSamples, levelChanges[(size_t)i].sample - blockStart)
+            : numSamples;
+        applyLevels(*bufferToFill.buffer, bufferToFill.startSample + done, blockStart + done, end - done);
+        done = end;
+
+        if (i < numLevelChanges)
+            startLevelChange(levelChanges[(size_t)i]);
+    }
+    numLevelChanges = 0;
+}
+
+float DJAudioPlayer::getFaderGainAt(int64 sample) const noexcept
+{
+    if (sample >= faderRampStart + faderRampLength)
+        return faderTo;
+    if (sample <= faderRampStart)
+        return faderFrom;
+
+    const double t = (double)(sample - faderRampStart) / (double)faderRampLength;
+    return faderFrom + (faderTo - faderFrom) * (float)t;
+}
+
+float DJAudioPlayer::getMixLevelAt(int64 sample) const noexcept
+{
+    if (!fading)
+        return mixLevel;
+    if (sample < fadeStart)
+        return levelBeforeFade;
+    if (sample >= fadeStart + fadeLength)
+        return fadeTo;
+
+    // equal power: sin on the way up, cos on the way down, so two decks
+    // crossing over keep the loudness of the mix roughly constant
+    const double t = (double)(sample - fadeStart) / (double)fadeLength;
+    const double shape = fadeTo > fadeFrom ? std::sin(t * MathConstants<double>::halfPi)
+                                           : 1.0 - std::cos(t * MathConstants<double>::halfPi);
+    return fadeFrom + (fadeTo - fadeFrom) * (float)shape;
+}
+
+void DJAudioPlayer::startLevelChange(const Command& command)
+{
+    if (command.type == CommandType::gain)
+    {
+        faderFrom = getFaderGainAt(command.sample);
+        faderTo = (float)command.value;
+        faderRampStart = command.sample;
+        return;
+    }
+
+    const bool in = command.type == CommandType::fadeIn;
+    levelBeforeFade = getMixLevelAt(command.sample);
+    fadeFrom = levelBeforeFade;
+    fadeTo = in ? 1.0f : 0.0f;
+    fadeStart = command.sample;
+    fadeLength = jmax((int64)1, (int64)std::llround(command.value * outputSampleRate));
+    fading = true;
+}
+
+void DJAudioPlayer::applyLevels(AudioBuffer<float>& buffer, int startSample, int64 firstSample, int numSamples)
+{
+    const int numChannels = buffer.getNumChannels();
+    const int64 endSample = firstSample + numSamples;
+    const bool faderMoving = firstSample < faderRampStart + faderRampLength && endSample > faderRampStart;
+    const bool fadeMoving = fading && firstSample < fadeStart + fadeLength && endSample > fadeStart;
+
+    // every sample gets the same product whichever way it is worked out
+    if (!faderMoving && !fadeMoving)
+    {
+        buffer.applyGain(startSample, numSamples, getFaderGainAt(firstSample) * getMixLevelAt(firstSample));
+    }
+    else
+    {
+        for (int done = 0; done < numSamples; done += levelCurveSize)
+        {
+            const int length = jmin(levelCurveSize, numSamples - done);
+            for (int i = 0; i < length; ++i)
+            {
+                const int64 sample = firstSample + done + i;
+                levelCurve[i] = getFaderGainAt(sample) * getMixLevelAt(sample);
+            }
+            for (int ch = 0; ch < numChannels; ++ch)
+                FloatVectorOperations::multiply(buffer.getWritePointer(ch, startSample + done), levelCurve, length);
+        }
+    }
+
+    if (fading && endSample >= fadeStart + fadeLength)
+    {
+        fading = false;
+        mixLevel = fadeTo;
+    }
 }
 
 void DJAudioPlayer::releaseResources()
 {
-    transportSource.releaseResources();
-    resampleSource.releaseResources();
+    prepared = false;
+    const SpinLock::ScopedLockType swapLock(sourceSwapLock);
+    if (readerSource != nullptr)
+        readerSource->releaseResources();
 }
 
 void DJAudioPlayer::loadURL(URL audioURL)
 {
-    auto* reader = formatManager.createReaderFor(audioURL.createInputStream(false));
+    // http(s) tracks play from a download that carries on in the background;
+    // this only waits for the file's headers
+    StreamingDownload::Ptr download;
+    String streamError;
+    std::unique_ptr<AudioFormatReader> reader;
+    if (StreamingDownload::canStream(audioURL))
+    {
+        download = new StreamingDownload(audioURL, streamingOptions);
+        reader = download->createReader(formatManager, true, streamError);
+    }
+    else
+    {
+        reader = openReader(audioURL);
+    }
+
     if (reader != nullptr) // good file!
     {
-        std::unique_ptr<AudioFormatReaderSource> newSource(new AudioFormatReaderSource(reader, true));
-        transportSource.setSource(newSource.get(), 0, nullptr, reader->sampleRate);
-        readerSource.reset(newSource.release());
+        const double newSampleRate = reader->sampleRate;
+        std::unique_ptr<TimedReaderSource> newSource(new TimedReaderSource(std::move(reader), readerTicksThisBlock, looping,
+                                                                           download.get(), &buffering));
+        const int loadLogId = eventLog != nullptr ? eventLog->addUrl(audioURL.toString(false)) : -1;
+        std::unique_ptr<TimedReaderSource> oldSource;
+        {
+            // a new track is loaded stopped, at its start
+            const SpinLock::ScopedLockType swapLock(sourceSwapLock);
+            oldSource = std::move(readerSource);
+            readerSource = std::move(newSource);
+            sourceSampleRate = newSampleRate;
+            sourceChanged = true;
+            playing = false;
+            positionSecs = 0;
+            lengthSecs = (double)readerSource->getTotalLength() / newSampleRate;
+            pendingLoadLogId = loadLogId;
+        }
+
+        // the last track's readers go back first, so reloading it reuses them
+        if (oldSource != nullptr)
+            recycleReader(loadedURL, oldSource->takeReader());
+
+        // a second reader, so the scratch buffer can decode on its own thread
+        std::unique_ptr<AudioFormatReader> scratchReader = download != nullptr
+            ? download->createReader(formatManager, false, streamError) : openReader(audioURL);
+        recycleReader(loadedURL, scratchBuffer.setReader(scratchReader.release()));
+        loadedURL = audioURL;
+        streamingDownload = download;
         DBG("Loaded file: " << audioURL.toString(true));
     }
     else
     {
         std::cout << "Bad file URL" << std::endl;
-        DBG("Error loading file: " << audioURL.toString(true));
+        DBG("Error loading file: " << audioURL.toString(true) << " " << streamError);
     }
 }
 
@@ -64,25 +363,30 @@ void DJAudioPlayer::setGain(double gain)
         std::cout << "DJAudioPlayer::setGain gain should be between 0 and 1" << std::endl;
     }
     else {
-        transportSource.setGain(gain);
+        pushCommand(CommandType::gain, gain);
     }
    
 }
 
 void DJAudioPlayer::setSpeed(double ratio)
 {
-  if (ratio < 0 || ratio > 100.0)
+  if (ratio < -100.0 || ratio > 100.0)
     {
-        std::cout << "DJAudioPlayer::setSpeed ratio should be between 0 and 100" << std::endl;
+        std::cout << "DJAudioPlayer::setSpeed ratio should be between -100 and 100" << std::endl;
     }
     else {
-        resampleSource.setResamplingRatio(ratio);
+        pushCommand(CommandType::speed, ratio);
     }
 }
 
 void DJAudioPlayer::setPosition(double posInSecs)
 {
-    transportSource.setPosition(posInSecs);
+    setPositionAt(posInSecs, -1);
+}
+
+void DJAudioPlayer::setPositionAt(double posInSecs, int64 sample)
+{
+    pushCommand(CommandType::position, posInSecs, sample);
 }
 
 void DJAudioPlayer::setPositionRelative(double pos)
@@ -92,36 +396,591 @@ void DJAudioPlayer::setPositionRelative(double pos)
         std::cout << "DJAudioPlayer::setPositionRelative pos should be between 0 and 1" << std::endl;
     }
     else {
-        double posInSecs = transportSource.getLengthInSeconds() * pos;
+        double posInSecs = lengthSecs.load() * pos;
         setPosition(posInSecs);
     }
 }
 
 void DJAudioPlayer::start()
 {
-    transportSource.start();
+    startAt(-1);
 }
 void DJAudioPlayer::stop()
 {
-    transportSource.stop();
+    stopAt(-1);
+}
+
+void DJAudioPlayer::startAt(int64 sample)
+{
+    pushCommand(CommandType::start, 0, sample);
+}
+
+void DJAudioPlayer::stopAt(int64 sample)
+{
+    pushCommand(CommandType::stop, 0, sample);
+}
+
+void DJAudioPlayer::fadeInAt(int64 sample, double lengthSecs)
+{
+    pushCommand(CommandType::fadeIn, jmax(0.0, lengthSecs), sample);
+}
+
+void DJAudioPlayer::fadeOutAt(int64 sample, double lengthSecs)
+{
+    pushCommand(CommandType::fadeOut, jmax(0.0, lengthSecs), sample);
+}
+
+void DJAudioPlayer::setLooping(bool shouldLoop)
+{
+    setLoopingAt(shouldLoop, -1);
+}
+
+void DJAudioPlayer::setLoopingAt(bool shouldLoop, int64 sample)
+{
+    pushCommand(CommandType::looping, shouldLoop ? 1.0 : 0.0, sample);
+}
+
+int64 DJAudioPlayer::getSampleClock() const
+{
+    return sampleClock.load();
+}
+
+bool DJAudioPlayer::isLooping() const
+{
+    return looping.load();
+}
+
+void DJAudioPlayer::beginScratch()
+{
+    pushCommand(CommandType::scratch, 1.0);
+}
+
+void DJAudioPlayer::jog(double deltaSecs)
+{
+    pushCommand(CommandType::jog, deltaSecs);
+}
+
+void DJAudioPlayer::endScratch()
+{
+    pushCommand(CommandType::scratch, 0.0);
+}
+
+bool DJAudioPlayer::isScratching() const
+{
+    return scratchActive.load();
+}
+
+void DJAudioPlayer::setRealtime(bool isRealtime)
+{
+    scratchBuffer.setBlockingFill(!isRealtime);
+}
+
+DeckFx& DJAudioPlayer::getFx()
+{
+    return fx;
+}
+
+Limiter& DJAudioPlayer::getLimiter()
+{
+    return limiter;
+}
+
+void DJAudioPlayer::setLimiterInPath(bool inPath) noexcept
+{
+    limiterInPath = inPath;
+}
+
+int DJAudioPlayer::getNumDroppedCommands() const
+{
+    return droppedCommands.load();
+}
+
+double DJAudioPlayer::getGain() const
+{
+    return currentGain.load();
+}
+
+double DJAudioPlayer::getSpeed() const
+{
+    return currentSpeed.load();
+}
+
+bool DJAudioPlayer::isPlaying() const
+{
+    return playing.load();
+}
+
+double DJAudioPlayer::PlayheadSnapshot::positionAt(double whenMs) const
+{
+    // never run far past the last block: the device may have stopped calling us
+    const double elapsedSecs = jlimit(-1.0, 0.25, (whenMs - timeMs) / 1000.0);
+    const double position = positionSecs + rate * elapsedSecs;
+    return lengthSecs > 0 ? jlimit(0.0, lengthSecs, position) : position;
+}
+
+DJAudioPlayer::PlayheadSnapshot DJAudioPlayer::getPlayheadSnapshot() const
+{
+    PlayheadSnapshot snapshot;
+    for (;;)
+    {
+        const uint32 before = snapshotSequence.load(std::memory_order_acquire);
+        if ((before & 1) == 0)
+        {
+            snapshot.positionSecs = snapshotPosition.load(std::memory_order_relaxed);
+            snapshot.lengthSecs = snapshotLength.load(std::memory_order_relaxed);
+            snapshot.rate = snapshotRate.load(std::memory_order_relaxed);
+            snapshot.timeMs = snapshotTime.load(std::memory_order_relaxed);
+            snapshot.clockSample = snapshotClock.load(std::memory_order_relaxed);
+            snapshot.playing = snapshotPlaying.load(std::memory_order_relaxed);
+            snapshot.scratching = snapshotScratching.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (snapshotSequence.load(std::memory_order_relaxed) == before)
+                return snapshot;
+        }
+        Thread::yield();
+    }
+}
+
+void DJAudioPlayer::publishSnapshot()
+{
+    double position = 0, rate = 0;
+    if (bufferMode)
+    {
+        // the platter's own velocity, which scratching changes every block
+        position = bufferPosition / scratchBuffer.getSourceSampleRate();
+        rate = bufferVelocity * outputSampleRate / scratchBuffer.getSourceSampleRate();
+    }
+    else
+    {
+        position = getSourcePlayhead() / sourceSampleRate;
+        rate = playing.load(std::memory_order_relaxed) ? currentSpeed.load(std::memory_order_relaxed) : 0.0;
+    }
+    positionSecs.store(position, std::memory_order_relaxed);
+
+    const uint32 sequence = snapshotSequence.load(std::memory_order_relaxed);
+    snapshotSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    snapshotPosition.store(position, std::memory_order_relaxed);
+    snapshotLength.store(lengthSecs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    snapshotRate.store(rate, std::memory_order_relaxed);
+    snapshotTime.store(Time::getMillisecondCounterHiRes(), std::memory_order_relaxed);
+    snapshotClock.store(sampleClock.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    snapshotPlaying.store(playing.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    snapshotScratching.store(scratching, std::memory_order_relaxed);
+
+    snapshotSequence.store(sequence + 2, std::memory_order_release);
+}
+
+URL DJAudioPlayer::getLoadedURL() const
+{
+    return loadedURL;
 }
 
 bool DJAudioPlayer::isLoaded()
 {
-    return transportSource.isPlaying();
+    return playing.load();
 }
 
 double DJAudioPlayer::getPositionRelative()
 {
-    return transportSource.getCurrentPosition() / transportSource.getLengthInSeconds();
+    return getCurrentPosition() / lengthSecs.load();
 }
 
 double DJAudioPlayer::getCurrentPosition()
 {
-    return transportSource.getCurrentPosition();
+    return inBufferMode ? bufferPositionSecs.load() : positionSecs.load();
 }
 
 double DJAudioPlayer::getTotalLength()
 {
-    return transportSource.getLengthInSeconds();
+    return lengthSecs.load();
+}
+
+void DJAudioPlayer::setMonitor(AudioCallbackMonitor* _monitor, int _deckIndex)
+{
+    monitor = _monitor;
+    deckIndex = _deckIndex;
+}
+
+void DJAudioPlayer::setEventLog(EngineEventLog* log)
+{
+    eventLog = log;
+    fx.setEventLog(log, deckIndex);
+}
+
+void DJAudioPlayer::setReaderPool(ReaderPool* pool)
+{
+    readerPool = pool;
+}
+
+void DJAudioPlayer::setStreamingOptions(const StreamingDownload::Options& options)
+{
+    streamingOptions = options;
+}
+
+bool DJAudioPlayer::isBuffering() const
+{
+    return buffering.load();
+}
+
+StreamingDownload::Ptr DJAudioPlayer::getStreamingDownload() const
+{
+    return streamingDownload;
+}
+
+std::unique_ptr<AudioFormatReader> DJAudioPlayer::openReader(const URL& url)
+{
+    if (readerPool != nullptr)
+        return readerPool->acquire(url);
+    if (url.isLocalFile())
+        return ReaderPool::openInMemory(formatManager, url.getLocalFile());
+    return std::unique_ptr<AudioFormatReader>(formatManager.createReaderFor(url.createInputStream(false)));
+}
+
+void DJAudioPlayer::recycleReader(const URL& url, std::unique_ptr<AudioFormatReader> reader)
+{
+    if (readerPool != nullptr)
+        readerPool->release(url, std::move(reader));
+}
+
+void DJAudioPlayer::pushCommand(CommandType type, double value, int64 sample)
+{
+    // several threads may send commands, but only the audio thread reads them
+    const SpinLock::ScopedLockType sl(commandWriteLock);
+
+    const auto scope = commandFifo.write(1);
+    if (scope.blockSize1 + scope.blockSize2 == 0)
+    {
+        // with no audio device running nobody drains the queue, and nothing
+        // else touches the deck's state, so it is applied here. Otherwise the
+        // audio thread owns that state: a command it has no room for is lost
+        if (!prepared.load())
+        {
+            applyCommand({ type, value, sample }, 0);
+            publishSnapshot();
+        }
+        else
+            droppedCommands.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const int index = scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2;
+    commandQueue[(size_t)index] = { type, value, sample };
+}
+
+void DJAudioPlayer::collectCommands(int64 blockStart)
+{
+    const auto scope = commandFifo.read(commandFifo.getNumReady());
+    scope.forEach([this, blockStart](int index)
+    {
+        const Command& command = commandQueue[(size_t)index];
+
+        // late is better than lost when the schedule is full
+        if (command.sample <= blockStart || numScheduled == maxScheduled)
+        {
+            applyCommand(command, 0);
+            return;
+        }
+
+        // after any command for the same sample, so they run in the order they were sent
+        int i = numScheduled;
+        while (i > 0 && scheduled[(size_t)i - 1].sample > command.sample)
+        {
+            scheduled[(size_t)i] = scheduled[(size_t)i - 1];
+            --i;
+        }
+        scheduled[(size_t)i] = command;
+        ++numScheduled;
+    });
+}
+
+void DJAudioPlayer::applyCommand(const Command& command, int sampleOffset)
+{
+    EngineEventLog::EventType logType = EngineEventLog::EventType::play;
+
+    switch (command.type)
+    {
+        case CommandType::start:
+            // the resampler kept its place when it stopped, so the track is heard from this sample
+            playing = true;
+            stopFadeDue = false;
+            logType = EngineEventLog::EventType::play;
+            break;
+        case CommandType::stop:
+            stopFadeDue = stopFadeDue || playing.load(std::memory_order_relaxed);
+            playing = false;
+            logType = EngineEventLog::EventType::stop;
+            break;
+        case CommandType::gain:
+            // applied in applyFader, after the cue bus has taken its copy
+            currentGain = command.value;
+            addLevelChange(command, sampleOffset);
+            logType = EngineEventLog::EventType::gain;
+            break;
+        case CommandType::speed:
+            // the resampler only goes forwards, and never at 0; reverse play and
+            // a deck held still come from the scratch buffer
+            if (command.value < minSpeed)
+                enterBufferMode();
+            currentSpeed = command.value;
+            logType = EngineEventLog::EventType::speed;
+            break;
+        case CommandType::position:
+            moveSource(command.value * sourceSampleRate);
+            if (bufferMode)
+            {
+                bufferPosition = command.value * scratchBuffer.getSourceSampleRate();
+                scratchTarget = bufferPosition;
+            }
+            logType = EngineEventLog::EventType::position;
+            break;
+        case CommandType::looping:
+            looping = command.value > 0.5;
+            logType = EngineEventLog::EventType::loop;
+            break;
+        case CommandType::scratch:
+            if (command.value > 0.5)
+            {
+                enterBufferMode();
+                scratchTarget = bufferPosition;
+            }
+            scratching = command.value > 0.5;
+            scratchActive = scratching;
+            logType = EngineEventLog::EventType::scratch;
+            break;
+        case CommandType::jog:
+            if (scratching)
+                scratchTarget = jlimit(0.0, (double)scratchBuffer.getLengthInSamples(),
+                                       scratchTarget + command.value * scratchBuffer.getSourceSampleRate());
+            logType = EngineEventLog::EventType::jog;
+            break;
+        case CommandType::fadeIn:
+        case CommandType::fadeOut:
+            addLevelChange(command, sampleOffset);
+            logType = command.type == CommandType::fadeIn ? EngineEventLog::EventType::fadeIn
+                                                          : EngineEventLog::EventType::fadeOut;
+            break;
+    }
+
+    if (eventLog != nullptr)
+        eventLog->logFromAudioThread(deckIndex, logType, command.value, sampleOffset);
+}
+
+void DJAudioPlayer::addLevelChange(const Command& command, int sampleOffset)
+{
+    // the block has not been faded yet, so its clock still reads the block start
+    const Command change{ command.type, command.value, sampleClock.load(std::memory_order_relaxed) + sampleOffset };
+    if (numLevelChanges < maxLevelChanges)
+        levelChanges[(size_t)numLevelChanges++] = change;
+    else
+        levelChanges[(size_t)maxLevelChanges - 1] = change;
+}
+
+//==============================================================================
+void DJAudioPlayer::enterBufferMode()
+{
+    if (bufferMode)
+        return;
+
+    const double sourceRate = scratchBuffer.getSourceSampleRate();
+    bufferPosition = getSourcePlayhead() / sourceSampleRate * sourceRate;
+    bufferVelocity = playing.load() ? currentSpeed.load() * sourceRate / outputSampleRate : 0.0;
+    bufferGeneration = scratchBuffer.getGeneration();
+    bufferPositionSecs = bufferPosition / sourceRate;
+    bufferMode = true;
+    inBufferMode = true;
+    scratchBuffer.setArmed(true);
+}
+
+void DJAudioPlayer::leaveBufferMode()
+{
+    // pick the transport up exactly where the platter was let go
+    moveSource(bufferPosition / scratchBuffer.getSourceSampleRate() * sourceSampleRate);
+    bufferMode = false;
+    inBufferMode = false;
+    scratchBuffer.setArmed(false);
+}
+
+void DJAudioPlayer::renderFromBuffer(const AudioSourceChannelInfo& bufferToFill)
+{
+    if (scratchBuffer.getGeneration() != bufferGeneration)
+    {
+        // a new track was loaded under the hand
+        bufferGeneration = scratchBuffer.getGeneration();
+        bufferPosition = scratchTarget = bufferVelocity = 0.0;
+    }
+
+    const double sourceRate = scratchBuffer.getSourceSampleRate();
+    const double length = (double)scratchBuffer.getLengthInSamples();
+    const int numSamples = bufferToFill.numSamples;
+
+    double targetVelocity = 0.0;
+    if (scratching)
+    {
+        // close the gap to the hand over two blocks: direct enough to feel
+        // attached, smooth enough not to click on every mouse event
+        targetVelocity = (scratchTarget - bufferPosition) / (2.0 * jmax(1, numSamples));
+    }
+    else if (playing.load() && std::abs(currentSpeed.load()) >= minSpeed)
+    {
+        targetVelocity = currentSpeed.load() * sourceRate / outputSampleRate;
+    }
+    targetVelocity = jlimit(-maxBufferVelocity, maxBufferVelocity, targetVelocity);
+
+    // off the platter and not moving, the deck is silent rather than holding
+    // one sample as DC; it fades over the block it slows to a stop in, and
+    // back in over the block it starts moving again in
+    const bool stopping = !scratching && targetVelocity == 0.0;
+    const bool starting = !scratching && bufferVelocity == 0.0;
+    if (stopping && starting)
+    {
+        bufferToFill.clearActiveBufferRegion();
+    }
+    else
+    {
+        scratchBuffer.render(*bufferToFill.buffer, bufferToFill.startSample, numSamples,
+                             bufferPosition, bufferVelocity, targetVelocity);
+        if (stopping || starting)
+            bufferToFill.buffer->applyGainRamp(bufferToFill.startSample, numSamples, stopping ? 1.0f : 0.0f, stopping ? 0.0f : 1.0f);
+    }
+
+    if (bufferPosition < 0.0 || bufferPosition >= length)
+    {
+        if (looping && !scratching && length > 0)
+        {
+            bufferPosition += bufferPosition < 0.0 ? length : -length;
+        }
+        else
+        {
+            bufferPosition = jlimit(0.0, jmax(0.0, length - 1.0), bufferPosition);
+            targetVelocity = 0.0;
+        }
+    }
+    bufferVelocity = targetVelocity;
+
+    scratchBuffer.setPlayhead(bufferPosition, bufferVelocity);
+    bufferPositionSecs = bufferPosition / sourceRate;
+
+    if (!scratching && currentSpeed.load() >= minSpeed)
+        leaveBufferMode();
+}
+
+double DJAudioPlayer::getSourcePlayhead() const
+{
+    if (readerSource == nullptr)
+        return 0.0;
+
+    // what was read ahead may have wrapped round the end of a looping track
+    const double length = (double)readerSource->getTotalLength();
+    const double playhead = (double)readerSource->getNextReadPosition() - resampler.getReadAhead();
+    if (playhead < 0.0)
+        return looping.load(std::memory_order_relaxed) && length > 0.0 ? playhead + length : 0.0;
+    return playhead;
+}
+
+void DJAudioPlayer::moveSource(double sample)
+{
+    if (readerSource == nullptr)
+        return;
+
+    // what the resampler read ahead came from the old place
+    readerSource->setNextReadPosition((int64)std::llround(jmax(0.0, sample)));
+    resampler.reset();
+}
+
+//==============================================================================
+DJAudioPlayer::TimedReaderSource::TimedReaderSource(std::unique_ptr<AudioFormatReader> _reader, int64& ticksToAddTo,
+                                                    const std::atomic<bool>& loopFlag, StreamingDownload* _download,
+                                                    std::atomic<bool>* bufferingFlag)
+: reader(std::move(_reader)), source(std::make_unique<AudioFormatReaderSource>(reader.get(), false)),
+  ticks(ticksToAddTo), shouldLoop(loopFlag), download(_download), buffering(bufferingFlag)
+{
+    source->setLooping(shouldLoop);
+
+    // a streamed track starts with its pre-roll
+    if (buffering != nullptr)
+        buffering->store(download != nullptr);
+}
+
+std::unique_ptr<AudioFormatReader> DJAudioPlayer::TimedReaderSource::takeReader()
+{
+    source.reset();
+    return std::move(reader);
+}
+
+void DJAudioPlayer::TimedReaderSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    source->prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void DJAudioPlayer::TimedReaderSource::releaseResources()
+{
+    source->releaseResources();
+}
+
+void DJAudioPlayer::TimedReaderSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    if (source->isLooping() != shouldLoop.load())
+        source->setLooping(shouldLoop.load());
+
+    const int64 start = Time::getHighResolutionTicks();
+    if (download != nullptr && !isStreamReady(bufferToFill.numSamples))
+        bufferToFill.clearActiveBufferRegion();
+    else
+        source->getNextAudioBlock(bufferToFill);
+    ticks += Time::getHighResolutionTicks() - start;
+}
+
+void DJAudioPlayer::TimedReaderSource::setNextReadPosition(int64 newPosition)
+{
+    source->setNextReadPosition(newPosition);
+    if (download != nullptr)
+        download->prefetch(getByteFor(newPosition));
+}
+
+int64 DJAudioPlayer::TimedReaderSource::getNextReadPosition() const
+{
+    return source->getNextReadPosition();
+}
+
+int64 DJAudioPlayer::TimedReaderSource::getTotalLength() const
+{
+    return source->getTotalLength();
+}
+
+bool DJAudioPlayer::TimedReaderSource::isLooping() const
+{
+    return shouldLoop.load();
+}
+
+void DJAudioPlayer::TimedReaderSource::setLooping(bool)
+{
+    // driven by the player's flag, see getNextAudioBlock
+}
+
+bool DJAudioPlayer::TimedReaderSource::isStreamReady(int numSamples)
+{
+    // the whole pre-roll once it has stalled, and only the next block while it keeps up
+    const bool wasBuffering = buffering != nullptr && buffering->load(std::memory_order_relaxed);
+    const double samplesAhead = wasBuffering ? download->getOptions().prerollSeconds * reader->sampleRate : (double)numSamples;
+
+    // a chunk extra covers the file's header and the estimate's rounding
+    const int64 position = source->getNextReadPosition();
+    const int64 from = getByteFor(position);
+    const int64 to = getByteFor(position + (int64)samplesAhead) + download->getOptions().chunkBytes;
+    const bool ready = download->isAvailable(from, to - from);
+    if (!ready)
+        download->prefetch(from);
+
+    if (buffering != nullptr)
+        buffering->store(!ready, std::memory_order_relaxed);
+    return ready;
+}
+
+int64 DJAudioPlayer::TimedReaderSource::getByteFor(int64 sample) const
+{
+    const int64 length = jmax((int64)1, reader->lengthInSamples);
+    return (int64)((double)jlimit((int64)0, length, sample) / (double)length * (double)download->getTotalLength());
 }
@@ -11,6 +11,16 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "AudioCallbackMonitor.h"
+#include "DeckResampler.h"
+#include "EngineEventLog.h"
+#include "ScratchBuffer.h"
+#include "DeckFx.h"
+#include "Limiter.h"
+#include "ReaderPool.h"
+#include "StreamingDownload.h"
+#include <array>
+#include <atomic>
 
 class DJAudioPlayer : public AudioSource {
   public:
@@ -19,11 +29,20 @@ class DJAudioPlayer : public AudioSource {
     ~DJAudioPlayer();
 
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+    /** renderPreFader() followed by applyFader() */
     void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill) override;
     void releaseResources() override;
 
+    /** audio thread: the deck's output before its volume is applied, for the cue bus */
+    void renderPreFader(const AudioSourceChannelInfo& bufferToFill);
+    /** audio thread: apply the deck's volume and mix level. Both are worked out per
+        sample from the deck clock, so the result doesn't depend on how the
+        output was split into blocks */
+    void applyFader(const AudioSourceChannelInfo& bufferToFill);
+
     void loadURL(URL audioURL);
     void setGain(double gain);
+    /** negative ratios play the track backwards; below 0.001 either way the deck holds still, silent */
     void setSpeed(double ratio);
     void setPosition(double posInSecs);
     void setPositionRelative(double pos);
@@ -32,6 +51,81 @@ class DJAudioPlayer : public AudioSource {
     void start();
     void stop();
 
+    /** loop the whole track instead of stopping at the end */
+    void setLooping(bool shouldLoop);
+    bool isLooping() const;
+
+    /** the same transport changes, landing on an exact sample of the deck's
+        clock (e.g. from MixEngine::getQuantizedSample()). The audio thread
+        splits its block there. -1, or a sample already rendered, means at
+        the start of the next block like the calls above. */
+    void startAt(int64 sample);
+    void stopAt(int64 sample);
+    void setPositionAt(double posInSecs, int64 sample);
+    void setLoopingAt(bool shouldLoop, int64 sample);
+
+    /** crossfades: ramp the deck's mix level, which comes after the fader and
+        the cue bus, from where it is up to full or down to silence over
+        lengthSecs of output on an equal-power curve, starting on an exact
+        sample of the deck's clock (-1 for the next block). A length of 0 jumps. */
+    void fadeInAt(int64 sample, double lengthSecs);
+    void fadeOutAt(int64 sample, double lengthSecs);
+
+    /** samples rendered since prepareToPlay: the clock scheduled commands run on.
+        It matches the MixEngine's sample position for decks added to one. */
+    int64 getSampleClock() const;
+
+    /** hand on the platter: from now on the playhead follows jog() instead of the transport */
+    void beginScratch();
+    /** move the platter by this many seconds of audio (negative pulls it back) */
+    void jog(double deltaSecs);
+    /** hand off the platter: play on at the deck's speed, or stay put if stopped */
+    void endScratch();
+    bool isScratching() const;
+
+    /** offline rendering: decode for scratching and reverse play in the
+        rendering thread instead of a background one, so renders are repeatable */
+    void setRealtime(bool isRealtime);
+
+    /** the deck's effects, run on its output after the resampler and before the fader */
+    DeckFx& getFx();
+    /** the deck's limiter, after the effects and before the fader; off until switched on */
+    Limiter& getLimiter();
+    /** audio thread, from the engine before each block: run the limiter even
+        while it is off, so this deck is delayed as much as one that has its on.
+        A deck on its own runs its limiter only while it is on. */
+    void setLimiterInPath(bool inPath) noexcept;
+
+    /** commands that arrived while the audio thread's queue was full, and were
+        dropped rather than applied from the sending thread */
+    int getNumDroppedCommands() const;
+
+    /** the values most recently applied by the audio thread */
+    double getGain() const;
+    double getSpeed() const;
+    bool isPlaying() const;
+
+    /** where the audio thread left the playhead at the end of its last block */
+    struct PlayheadSnapshot
+    {
+        double positionSecs = 0;
+        double lengthSecs = 0;
+        double rate = 0;          // track seconds per second of output, 0 while stopped
+        double timeMs = 0;        // Time::getMillisecondCounterHiRes() when it was published
+        int64 clockSample = 0;    // the deck clock sample positionSecs was reached at
+        bool playing = false;
+        bool scratching = false;
+
+        /** the position extrapolated to another time on the same clock */
+        double positionAt(double whenMs) const;
+    };
+
+    /** lock-free and wait-free for the audio thread; safe from any thread */
+    PlayheadSnapshot getPlayheadSnapshot() const;
+
+    /** the URL of the last track loaded successfully */
+    URL getLoadedURL() const;
+
     /** get the relative position of the playhead */
     double getPositionRelative();
     double getCurrentPosition();
@@ -39,11 +133,215 @@ class DJAudioPlayer : public AudioSource {
 
     bool isLoaded();
 
+    /** report reader and resampler timings to the monitor under deckIndex */
+    void setMonitor(AudioCallbackMonitor* monitor, int deckIndex);
+
+    /** log every applied command and every load under the monitor's deck index */
+    void setEventLog(EngineEventLog* log);
+
+    /** take readers from the pool, and hand the previous track's back on the next load */
+    void setReaderPool(ReaderPool* pool);
+
+    /** http(s) tracks are streamed (see StreamingDownload): these options
+        apply to the next one loaded */
+    void setStreamingOptions(const StreamingDownload::Options& options);
+    /** true while a streamed track is held silent until its pre-roll is in */
+    bool isBuffering() const;
+    /** the loaded track's download, or nullptr if it isn't streamed */
+    StreamingDownload::Ptr getStreamingDownload() const;
+
 private:
+    /** transport and parameter changes are queued here by the setters and
+        applied by the audio thread at the start of its next block, or at
+        the sample they were scheduled for */
+    enum class CommandType
+    {
+        start,
+        stop,
+        gain,
+        speed,
+        position,
+        looping,
+        scratch,
+        jog,
+        fadeIn,
+        fadeOut
+    };
+
+    struct Command
+    {
+        CommandType type;
+        double value;
+        int64 sample;       // deck clock sample to apply it at, -1 for the next block
+    };
+
+    void pushCommand(CommandType type, double value, int64 sample = -1);
+    /** audio thread: apply what is due now and keep later commands in scheduled */
+    void collectCommands(int64 blockStart);
+    void applyCommand(const Command& command, int sampleOffset);
+    /** audio thread: a gain or fade command for applyFader, sampleOffset into the block */
+    void addLevelChange(const Command& command, int sampleOffset);
+    void renderSegment(const AudioSourceChannelInfo& bufferToFill);
+
+    /** audio thread: scratching and reverse play render from the scratch buffer */
+    void enterBufferMode();
+    void leaveBufferMode();
+    void renderFromBuffer(const AudioSourceChannelInfo& bufferToFill);
+    void publishSnapshot();
+
+    /** audio thread: the source sample being played, the resampler's read-ahead taken off */
+    double getSourcePlayhead() const;
+    /** audio thread: play on from a source sample */
+    void moveSource(double sample);
+
+    std::unique_ptr<AudioFormatReader> openReader(const URL& url);
+    void recycleReader(const URL& url, std::unique_ptr<AudioFormatReader> reader);
+
+    /** audio thread: the fader gain and mix level at a deck clock sample */
+    float getFaderGainAt(int64 sample) const noexcept;
+    float getMixLevelAt(int64 sample) const noexcept;
+    /** audio thread: a gain or fade command, from the sample it was applied at */
+    void startLevelChange(const Command& command);
+    /** audio thread: both levels over numSamples from firstSample on the deck clock */
+    void applyLevels(AudioBuffer<float>& buffer, int startSample, int64 firstSample, int numSamples);
+
+    /** forwards to the reader source, timing every read for the monitor and
+        following the player's loop flag on the audio thread.
+        A streamed track's source plays silence without moving until the
+        download has prerollSeconds past the playhead, and from then on
+        until the download falls behind the next block. */
+    class TimedReaderSource : public PositionableAudioSource
+    {
+    public:
+        TimedReaderSource(std::unique_ptr<AudioFormatReader> reader, int64& ticksToAddTo,
+                          const std::atomic<bool>& loopFlag, StreamingDownload* download = nullptr,
+                          std::atomic<bool>* bufferingFlag = nullptr);
+
+        /** the reader, for reuse; the source can't play after this */
+        std::unique_ptr<AudioFormatReader> takeReader();
+
+        void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+        void releaseResources() override;
+        void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+        void setNextReadPosition(int64 newPosition) override;
+        int64 getNextReadPosition() const override;
+        int64 getTotalLength() const override;
+        bool isLooping() const override;
+        void setLooping(bool shouldLoop) override;
+
+    private:
+        /** audio thread: whether the download has what the next numSamples need */
+        bool isStreamReady(int numSamples);
+        /** roughly where a sample is in the file: right for PCM and constant bit rates */
+        int64 getByteFor(int64 sample) const;
+
+        std::unique_ptr<AudioFormatReader> reader;
+        std::unique_ptr<AudioFormatReaderSource> source;
+        int64& ticks;
+        const std::atomic<bool>& shouldLoop;
+        StreamingDownload::Ptr download;
+        std::atomic<bool>* buffering;
+    };
+
     AudioFormatManager& formatManager;
-    std::unique_ptr<AudioFormatReaderSource> readerSource;
-    AudioTransportSource transportSource; 
-    ResamplingAudioSource resampleSource{&transportSource, false, 2};
+    ReaderPool* readerPool = nullptr;
+    std::unique_ptr<TimedReaderSource> readerSource;
+    double sourceSampleRate = 44100.0;     // readerSource's, swapped with it
+    // the transport: a flag the audio thread reads, so nothing on its path
+    // takes a lock or posts a message to start or stop
+    DeckResampler resampler;
+    std::atomic<bool> playing{ false };
+    std::atomic<double> positionSecs{ 0 };
+    std::atomic<double> lengthSecs{ 0 };
+
+    ScratchBuffer scratchBuffer;
+    DeckFx fx;
+    Limiter limiter;
+    double outputSampleRate = 44100.0;
+
+    // audio thread only
+    bool limiterInPath = false;     // as the engine last said
+    bool limiterWasInPath = false;
+    bool stopFadeDue = false;       // stopped, with the last block still to fade out
+    bool bufferMode = false;
+    bool scratching = false;
+    double bufferPosition = 0;     // source samples
+    double bufferVelocity = 0;     // source samples per output sample
+    double scratchTarget = 0;      // where the hand has put the platter, in source samples
+    uint32 bufferGeneration = 0;
+
+    std::atomic<bool> inBufferMode{ false };
+    std::atomic<bool> scratchActive{ false };
+    std::atomic<double> bufferPositionSecs{ 0 };
+
+    URL loadedURL;
+    StreamingDownload::Options streamingOptions;
+    StreamingDownload::Ptr streamingDownload;
+    std::atomic<bool> buffering{ false };
+    std::atomic<bool> looping{ false };
+    std::atomic<double> currentGain{ 1.0 };
+
+    // audio thread only: the fader moves to a new gain over faderRampLength samples
+    float faderFrom = 1.0f;
+    float faderTo = 1.0f;
+    int64 faderRampStart = 0;
+    int64 faderRampLength = 1;
+    HeapBlock<float> levelCurve;    // per-sample levels while either is moving
+    int levelCurveSize = 0;
+
+    // audio thread only: the fade in progress, see fadeInAt()
+    bool fading = false;
+    float mixLevel = 1.0f;          // outside a fade
+    float levelBeforeFade = 1.0f;
+    float fadeFrom = 1.0f;
+    float fadeTo = 1.0f;
+    int64 fadeStart = 0;
+    int64 fadeLength = 0;
+    std::atomic<double> currentSpeed{ 1.0 };
+
+    static constexpr int commandQueueSize = 256;
+    AbstractFifo commandFifo{ commandQueueSize };
+    std::array<Command, commandQueueSize> commandQueue;
+    SpinLock commandWriteLock;
+    std::atomic<int> droppedCommands{ 0 };
+    // between prepareToPlay and releaseResources, when an audio thread drains the queue
+    std::atomic<bool> prepared{ false };
+
+    // audio thread only: commands waiting for their sample, in time order
+    static constexpr int maxScheduled = 64;
+    std::array<Command, maxScheduled> scheduled;
+    int numScheduled = 0;
+
+    // audio thread only: gain and fade commands applied in this block, stamped
+    // with their deck clock sample, for applyFader to take up in order
+    static constexpr int maxLevelChanges = commandQueueSize + maxScheduled;
+    std::array<Command, maxLevelChanges> levelChanges;
+    int numLevelChanges = 0;
+    std::atomic<int64> sampleClock{ 0 };
+
+    // held by loadURL while the source is swapped, so the audio thread never
+    // reads from a source that is being deleted
+    SpinLock sourceSwapLock;
+    // set with the new source under sourceSwapLock: the resampler still holds the old one's samples
+    bool sourceChanged = false;
+    // set with the new source under sourceSwapLock: the event log's id for its
+    // URL, logged by the audio thread in the first block that plays it
+    int pendingLoadLogId = -1;
+
+    // a sequence lock: odd while the audio thread is writing the fields
+    std::atomic<uint32> snapshotSequence{ 0 };
+    std::atomic<double> snapshotPosition{ 0 };
+    std::atomic<double> snapshotLength{ 0 };
+    std::atomic<double> snapshotRate{ 0 };
+    std::atomic<double> snapshotTime{ 0 };
+    std::atomic<int64> snapshotClock{ 0 };
+    std::atomic<bool> snapshotPlaying{ false };
+    std::atomic<bool> snapshotScratching{ false };
+
+    AudioCallbackMonitor* monitor = nullptr;
+    EngineEventLog* eventLog = nullptr;
+    int deckIndex = 0;
+    int64 readerTicksThisBlock = 0;
 
 };
 
@@ -0,0 +1,419 @@
+/*
+  ==============================================================================
+
+    DeckFx.cpp
+    Created: 19 Oct 2026 11:05:27pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "DeckFx.h"
+
+namespace
+{
+    constexpr double maxEchoSecs = 1.5;
+    constexpr double maxFlangerSecs = 0.02;
+    constexpr float flangerFeedback = 0.5f;
+}
+
+DeckFx::DeckFx()
+{
+    for (auto& slot : slots)
+    {
+        for (auto& parameter : slot.parameters)
+            parameter.store(0.5f);
+        slot.seenParameters.fill(0.5f);
+    }
+}
+
+DeckFx::~DeckFx()
+{
+}
+
+void DeckFx::prepare(double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+    blockSize = jmax(1, maximumBlockSize);
+
+    wetBuffer.setSize(2, blockSize);
+    tempBuffer.setSize(1, blockSize);
+
+    echoLine.setSize(2, nextPowerOfTwo((int)(maxEchoSecs * sampleRate) + blockSize + 1));
+    echoMask = echoLine.getNumSamples() - 1;
+
+    flangerLine.setSize(2, nextPowerOfTwo((int)(maxFlangerSecs * sampleRate) + 2));
+    flangerMask = flangerLine.getNumSamples() - 1;
+
+    reverbTank.setSampleRate(sampleRate);
+    gateSmoothing = (float)(1.0 - std::exp(-1.0 / (0.001 * sampleRate)));
+
+    for (int e = 0; e < numEffects; ++e)
+    {
+        resetEffect((Effect)e);
+        slots[(size_t)e].active = false;
+        slots[(size_t)e].currentWet = 0.0f;
+        slots[(size_t)e].idle = true;
+        slots[(size_t)e].cleared = true;
+    }
+}
+
+void DeckFx::process(AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    if (blockSize == 0)
+        return;
+
+    // echo and flanger feedback decays into denormals, which cost far more than normal floats
+    const ScopedNoDenormals noDenormals;
+    const int numChannels = jmin(2, buffer.getNumChannels());
+
+    // devices may hand over bigger blocks than promised; the buffers stay as prepared
+    for (int done = 0; done < numSamples; done += blockSize)
+        processChunk(buffer, startSample + done, jmin(blockSize, numSamples - done), numChannels, done);
+}
+
+void DeckFx::processChunk(AudioBuffer<float>& buffer, int startSample, int numSamples, int numChannels, int sampleOffset) noexcept
+{
+    for (int e = 0; e < numEffects; ++e)
+    {
+        Slot& slot = slots[(size_t)e];
+
+        // read once, so what is logged is what this chunk runs with
+        const bool enabled = slot.enabled.load(std::memory_order_acquire);
+        const float wet = slot.wet.load(std::memory_order_relaxed);
+        const float a = slot.parameters[0].load(std::memory_order_relaxed);
+        const float b = slot.parameters[1].load(std::memory_order_relaxed);
+        logChanges((Effect)e, enabled, wet, a, b, sampleOffset);
+
+        if (!slot.active)
+        {
+            if (!enabled)
+                continue;
+
+            // switched on: start from silence rather than whatever was left in the
+            // lines. setEnabled() has normally done that already
+            if (!slot.cleared.exchange(false, std::memory_order_acquire))
+                resetEffect((Effect)e);
+            slot.active = true;
+            slot.idle.store(false, std::memory_order_relaxed);
+            slot.currentWet = 0.0f;
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            wetBuffer.copyFrom(ch, 0, buffer, ch, startSample, numSamples);
+
+        switch ((Effect)e)
+        {
+            case Effect::echo:       echo(numSamples, numChannels, a, b);       break;
+            case Effect::reverb:     reverb(numSamples, numChannels, a, b);     break;
+            case Effect::flanger:    flanger(numSamples, numChannels, a, b);    break;
+            case Effect::bitcrusher: bitcrusher(numSamples, numChannels, a, b); break;
+            case Effect::gate:       gate(numSamples, numChannels, a, b);       break;
+        }
+
+        // fade the mix over the chunk; a switched-off effect fades out and goes idle
+        const float targetWet = enabled ? wet : 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            buffer.applyGainRamp(ch, startSample, numSamples, 1.0f - slot.currentWet, 1.0f - targetWet);
+            buffer.addFromWithRamp(ch, startSample, wetBuffer.getReadPointer(ch), numSamples, slot.currentWet, targetWet);
+        }
+        slot.currentWet = targetWet;
+
+        if (!enabled)
+        {
+            slot.active = false;
+            slot.idle.store(true, std::memory_order_release);
+        }
+    }
+}
+
+void DeckFx::logChanges(Effect effect, bool enabled, float wet, float a, float b, int sampleOffset) noexcept
+{
+    Slot& slot = getSlot(effect);
+    if (enabled == slot.seenEnabled && wet == slot.seenWet
+        && a == slot.seenParameters[0] && b == slot.seenParameters[1])
+        return;
+
+    if (eventLog != nullptr)
+    {
+        using Setting = EngineEventLog::FxSetting;
+        auto log = [this, effect, sampleOffset](Setting setting, double value)
+        {
+            eventLog->logFromAudioThread(eventLogDeck, EngineEventLog::getFxEventType((int)effect, setting), value, sampleOffset);
+        };
+
+        if (enabled != slot.seenEnabled)          log(Setting::enabled, enabled ? 1.0 : 0.0);
+        if (wet != slot.seenWet)                  log(Setting::wet, wet);
+        if (a != slot.seenParameters[0])          log(Setting::parameter1, a);
+        if (b != slot.seenParameters[1])          log(Setting::parameter2, b);
+    }
+
+    slot.seenEnabled = enabled;
+    slot.seenWet = wet;
+    slot.seenParameters = { a, b };
+}
+
+void DeckFx::resetEffect(Effect effect) noexcept
+{
+    switch (effect)
+    {
+        case Effect::echo:
+            // up to 2^18 samples a channel: instead of clearing it, echo() reads
+            // nothing older than this as anything but silence
+            echoWritten = 0;
+            break;
+        case Effect::reverb:
+            reverbTank.reset();
+            break;
+        case Effect::flanger:
+            flangerLine.clear();
+            flangerWritePos = 0;
+            flangerPhase = 0;
+            break;
+        case Effect::bitcrusher:
+            crushHold = {};
+            crushCountdown = 0;
+            break;
+        case Effect::gate:
+            gatePhase = 0;
+            gateLevel = 0;
+            break;
+    }
+}
+
+//==============================================================================
+void DeckFx::echo(int numSamples, int numChannels, float time, float feedbackAmount) noexcept
+{
+    const int capacity = echoMask + 1;
+    const int delay = jlimit(1, capacity - blockSize - 1, roundToInt((0.02 + time * (maxEchoSecs - 0.02)) * sampleRate));
+    const float feedback = feedbackAmount * 0.9f;
+    float* delayed = tempBuffer.getWritePointer(0);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* line = echoLine.getWritePointer(ch);
+        float* io = wetBuffer.getWritePointer(ch);
+
+        // a run no longer than the delay only reads what was written before it,
+        // and one that doesn't cross the end of the ring is contiguous
+        for (int i = 0; i < numSamples;)
+        {
+            const int writeIndex = (echoWritePos + i) & echoMask;
+            const int readIndex = (echoWritePos + i - delay) & echoMask;
+            int run = jmin(numSamples - i, delay, capacity - writeIndex, capacity - readIndex);
+
+            // what the delay reaches back to from before the reset was never written
+            const int unwritten = delay - (echoWritten + i);
+            if (unwritten > 0)
+            {
+                run = jmin(run, unwritten);
+                FloatVectorOperations::clear(delayed, run);
+            }
+            else
+            {
+                FloatVectorOperations::copy(delayed, line + readIndex, run);
+            }
+            FloatVectorOperations::copy(line + writeIndex, io + i, run);
+            FloatVectorOperations::addWithMultiply(line + writeIndex, delayed, feedback, run);
+            FloatVectorOperations::copy(io + i, delayed, run);
+            i += run;
+        }
+    }
+
+    echoWritePos = (echoWritePos + numSamples) & echoMask;
+    echoWritten = jmin(capacity, echoWritten + numSamples);
+}
+
+void DeckFx::reverb(int numSamples, int numChannels, float size, float damping) noexcept
+{
+    Reverb::Parameters parameters;
+    parameters.roomSize = size;
+    parameters.damping = damping;
+    parameters.wetLevel = 1.0f / 3.0f;   // the tank's own gain staging; the slot does the mix
+    parameters.dryLevel = 0.0f;
+    parameters.width = 1.0f;
+    reverbTank.setParameters(parameters);
+
+    if (numChannels > 1)
+        reverbTank.processStereo(wetBuffer.getWritePointer(0), wetBuffer.getWritePointer(1), numSamples);
+    else
+        reverbTank.processMono(wetBuffer.getWritePointer(0), numSamples);
+}
+
+void DeckFx::flanger(int numSamples, int numChannels, float rate, float depth) noexcept
+{
+    const double increment = (0.05 + rate * 4.95) / sampleRate;
+    const float minDelay = (float)(0.0005 * sampleRate);
+    const float sweep = (float)(depth * 0.004 * sampleRate);
+
+    // the sweep is shared by both channels, so work it out once
+    float* delays = tempBuffer.getWritePointer(0);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        delays[i] = minDelay + sweep * 0.5f * (1.0f + (float)std::sin(MathConstants<double>::twoPi * flangerPhase));
+        flangerPhase += increment;
+        if (flangerPhase >= 1.0)
+            flangerPhase -= 1.0;
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* line = flangerLine.getWritePointer(ch);
+        float* io = wetBuffer.getWritePointer(ch);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const int writeIndex = (flangerWritePos + i) & flangerMask;
+            const float readPos = (float)(flangerWritePos + i) - delays[i];
+            const int index = (int)std::floor(readPos);
+            const float frac = readPos - (float)index;
+
+            const float a = line[index & flangerMask];
+            const float b = line[(index + 1) & flangerMask];
+            const float delayed = a + frac * (b - a);
+
+            line[writeIndex] = io[i] + flangerFeedback * delayed;
+            io[i] = delayed;
+        }
+    }
+
+    flangerWritePos = (flangerWritePos + numSamples) & flangerMask;
+}
+
+void DeckFx::bitcrusher(int numSamples, int numChannels, float bits, float downsample) noexcept
+{
+    const int factor = 1 + roundToInt(downsample * 31.0f);
+    if (factor > 1)
+    {
+        // sample-and-hold at a fraction of the rate: every channel sees the same countdown
+        int countdown = crushCountdown;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* io = wetBuffer.getWritePointer(ch);
+            float hold = crushHold[(size_t)ch];
+            countdown = crushCountdown;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                if (countdown <= 0)
+                {
+                    hold = io[i];
+                    countdown = factor;
+                }
+                io[i] = hold;
+                --countdown;
+            }
+            crushHold[(size_t)ch] = hold;
+        }
+        crushCountdown = countdown;
+    }
+
+    // truncating through int is a single vector instruction each way
+    const int numBits = 16 - roundToInt(bits * 14.0f);
+    const float steps = (float)(1 << (numBits - 1));
+    const float invSteps = 1.0f / steps;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* io = wetBuffer.getWritePointer(ch);
+        for (int i = 0; i < numSamples; ++i)
+            io[i] = (float)(int)(io[i] * steps) * invSteps;
+    }
+}
+
+void DeckFx::gate(int numSamples, int numChannels, float rate, float duty) noexcept
+{
+    const double increment = (1.0 + rate * 15.0) / sampleRate;
+    const double open = 0.1 + duty * 0.8;
+
+    // build the envelope once, then it is a plain multiply per channel
+    float* envelope = tempBuffer.getWritePointer(0);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float target = gatePhase < open ? 1.0f : 0.0f;
+        gateLevel += (target - gateLevel) * gateSmoothing;
+        envelope[i] = gateLevel;
+        gatePhase += increment;
+        if (gatePhase >= 1.0)
+            gatePhase -= 1.0;
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        FloatVectorOperations::multiply(wetBuffer.getWritePointer(ch), envelope, numSamples);
+}
+
+//==============================================================================
+DeckFx::Slot& DeckFx::getSlot(Effect effect)
+{
+    return slots[(size_t)effect];
+}
+
+const DeckFx::Slot& DeckFx::getSlot(Effect effect) const
+{
+    return slots[(size_t)effect];
+}
+
+void DeckFx::setEnabled(Effect effect, bool shouldBeEnabled)
+{
+    const SpinLock::ScopedLockType sl(enableLock);
+    Slot& slot = getSlot(effect);
+
+    // an idle effect isn't touched by the audio thread until it sees it enabled,
+    // so its reverb tank or delay line is cleared here, not in that block
+    if (shouldBeEnabled && !slot.enabled.load() && slot.idle.load(std::memory_order_acquire)
+        && !slot.cleared.load(std::memory_order_relaxed))
+    {
+        resetEffect(effect);
+        slot.cleared.store(true, std::memory_order_relaxed);
+    }
+    slot.enabled.store(shouldBeEnabled, std::memory_order_release);
+}
+
+bool DeckFx::isEnabled(Effect effect) const
+{
+    return getSlot(effect).enabled.load();
+}
+
+void DeckFx::setWet(Effect effect, float wet)
+{
+    getSlot(effect).wet = jlimit(0.0f, 1.0f, wet);
+}
+
+float DeckFx::getWet(Effect effect) const
+{
+    return getSlot(effect).wet.load();
+}
+
+void DeckFx::setParameter(Effect effect, int index, float value)
+{
+    if (isPositiveAndBelow(index, numParameters))
+        getSlot(effect).parameters[(size_t)index] = jlimit(0.0f, 1.0f, value);
+}
+
+float DeckFx::getParameter(Effect effect, int index) const
+{
+    return isPositiveAndBelow(index, numParameters) ? getSlot(effect).parameters[(size_t)index].load() : 0.0f;
+}
+
+void DeckFx::setEventLog(EngineEventLog* log, int deck)
+{
+    eventLogDeck = deck;
+    eventLog = log;
+}
+
+String DeckFx::getEffectName(Effect effect)
+{
+    static const char* const names[] = { "Echo", "Reverb", "Flanger", "Crush", "Gate" };
+    return names[(int)effect];
+}
+
+String DeckFx::getParameterName(Effect effect, int index)
+{
+    static const char* const names[numEffects][numParameters] = {
+        { "Time", "Feedback" },
+        { "Size", "Damping" },
+        { "Rate", "Depth" },
+        { "Bits", "Downsample" },
+        { "Rate", "Duty" }
+    };
+    return isPositiveAndBelow(index, numParameters) ? names[(int)effect][index] : "";
+}
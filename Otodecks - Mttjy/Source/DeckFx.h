@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+    DeckFx.h
+    Created: 19 Oct 2026 11:05:27pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <array>
+#include <atomic>
+#include "EngineEventLog.h"
+
+//==============================================================================
+/*
+    A deck's effect rack: echo, reverb, flanger, bitcrusher and gate, run in
+    that order on the deck's output, each with its own dry/wet mix and two
+    parameters (see getParameterName).
+
+    Every delay line, the reverb's tanks and all working buffers are
+    allocated in prepare(). The audio thread leaves an effect that has faded
+    out alone until it sees it switched on again, so setEnabled() clears its
+    state in the caller's thread first, and the audio thread only has to when
+    an effect comes back on before it has finished fading out. The echo's
+    line is never cleared: reads from before the switch-on count as silence.
+    Otherwise the message thread only touches atomics. The audio thread fades
+    an effect in and out over one block.
+
+    Wherever the maths allows, the kernels work on whole runs of samples with
+    FloatVectorOperations or loops the compiler vectorizes: echo copies and
+    scales contiguous stretches of its delay line, the bitcrusher quantizes a
+    block at a time, and the gate builds an envelope and multiplies by it.
+    The flanger's modulated read and the reverb's filters are per sample.
+
+    With an event log attached, every setting change is logged by the audio
+    thread as it picks it up, so a replay hears it on the same sample.
+*/
+class DeckFx
+{
+public:
+    enum class Effect
+    {
+        echo,
+        reverb,
+        flanger,
+        bitcrusher,
+        gate
+    };
+
+    static constexpr int numEffects = 5;
+    static constexpr int numParameters = 2;
+
+    DeckFx();
+    ~DeckFx();
+
+    /** allocates everything the effects will ever need for this rate and block size */
+    void prepare(double sampleRate, int maximumBlockSize);
+
+    /** audio thread: run the enabled effects over the first two channels */
+    void process(AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    /** any thread */
+    void setEnabled(Effect effect, bool shouldBeEnabled);
+    bool isEnabled(Effect effect) const;
+    /** 0 is dry only, 1 wet only */
+    void setWet(Effect effect, float wet);
+    float getWet(Effect effect) const;
+    /** 0 to 1, mapped onto each effect's own range */
+    void setParameter(Effect effect, int index, float value);
+    float getParameter(Effect effect, int index) const;
+
+    /** log setting changes under deck from now on, nullptr to stop */
+    void setEventLog(EngineEventLog* log, int deck);
+
+    static String getEffectName(Effect effect);
+    static String getParameterName(Effect effect, int index);
+
+private:
+    struct Slot
+    {
+        std::atomic<bool> enabled{ false };
+        std::atomic<float> wet{ 0.5f };
+        std::array<std::atomic<float>, numParameters> parameters;
+        // set by the audio thread once the effect has faded out and it no longer runs it
+        std::atomic<bool> idle{ true };
+        // set by setEnabled() after it has reset the idle effect's state
+        std::atomic<bool> cleared{ false };
+
+        // audio thread only
+        bool active = false;
+        float currentWet = 0.0f;
+        // the settings as last picked up, to log only what changed
+        bool seenEnabled = false;
+        float seenWet = 0.5f;
+        std::array<float, numParameters> seenParameters{};
+    };
+
+    void processChunk(AudioBuffer<float>& buffer, int startSample, int numSamples, int numChannels, int sampleOffset) noexcept;
+    void logChanges(Effect effect, bool enabled, float wet, float a, float b, int sampleOffset) noexcept;
+    void resetEffect(Effect effect) noexcept;
+
+    void echo(int numSamples, int numChannels, float time, float feedback) noexcept;
+    void reverb(int numSamples, int numChannels, float size, float damping) noexcept;
+    void flanger(int numSamples, int numChannels, float rate, float depth) noexcept;
+    void bitcrusher(int numSamples, int numChannels, float bits, float downsample) noexcept;
+    void gate(int numSamples, int numChannels, float rate, float duty) noexcept;
+
+    Slot& getSlot(Effect effect);
+    const Slot& getSlot(Effect effect) const;
+
+    std::array<Slot, numEffects> slots;
+    SpinLock enableLock;                // between threads calling setEnabled()
+    EngineEventLog* eventLog = nullptr;
+    int eventLogDeck = 0;
+
+    double sampleRate = 44100.0;
+    int blockSize = 0;
+
+    AudioBuffer<float> wetBuffer;
+    AudioBuffer<float> tempBuffer;
+
+    AudioBuffer<float> echoLine;        // power-of-two length, indexed with echoMask
+    int echoMask = 0;
+    int echoWritePos = 0;
+    int echoWritten = 0;                // since the last reset, up to the line's length
+
+    AudioBuffer<float> flangerLine;
+    int flangerMask = 0;
+    int flangerWritePos = 0;
+    double flangerPhase = 0;
+
+    Reverb reverbTank;
+
+    std::array<float, 2> crushHold{};
+    int crushCountdown = 0;
+
+    double gatePhase = 0;
+    float gateLevel = 0;
+    float gateSmoothing = 0;            // one-pole coefficient for a 1 ms edge
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckFx)
+};
@@ -15,9 +15,11 @@
 DeckGUI::DeckGUI(DJAudioPlayer* _player, 
                 AudioFormatManager & 	formatManagerToUse,
                 AudioThumbnailCache & 	cacheToUse,
+                BandAnalyser & analyserToUse,
                 PlaylistComponent* playlistComponent
            ) : player(_player), 
-               waveformDisplay(formatManagerToUse, cacheToUse),
+               waveformDisplay(formatManagerToUse, cacheToUse, analyserToUse),
+               fxPanel(_player->getFx()),
                _playlistComponent(playlistComponent)
 {
     addAndMakeVisible(nowPlayingLabel);
@@ -31,6 +33,7 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
 
     addAndMakeVisible(playButton);
     addAndMakeVisible(loopButton);
+    addAndMakeVisible(pflButton);
     addAndMakeVisible(loadButton);
     addAndMakeVisible(ffButton);
     addAndMakeVisible(resButton);
@@ -52,8 +55,22 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
 
     addAndMakeVisible(waveformDisplay);
 
+    // mouse events go straight to the player's command queue, so the platter
+    // is heard from the next audio block on
+    addAndMakeVisible(jogWheel);
+    jogWheel.onTouch = [this] { player->beginScratch(); };
+    jogWheel.onTurn = [this](double seconds) { player->jog(seconds); };
+    jogWheel.onRelease = [this] { player->endScratch(); };
+
+    // the rack sits over the dials and platter while it is open
+    addAndMakeVisible(fxButton);
+    fxButton.setClickingTogglesState(true);
+    fxButton.onClick = [this] { fxPanel.setVisible(fxButton.getToggleState()); };
+    addChildComponent(fxPanel);
+
     playButton.addListener(this);
     loopButton.addListener(this);
+    pflButton.addListener(this);
     loadButton.addListener(this);
     ffButton.addListener(this);
     resButton.addListener(this);
@@ -64,15 +81,18 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
 
     volSlider.setRange(0, 100, 1);
     volSlider.setValue(50);
-    speedSlider.setRange(1, 10, 0.25);
+    // the player's whole range, reverse included; the skew gives the middle
+    // half of each side of the dial to speeds up to 10x, where playing happens.
+    // The middle itself, 0, holds the deck still (see DJAudioPlayer::setSpeed)
+    speedSlider.setRange(-100.0, 100.0, 0.01);
+    speedSlider.setSkewFactor(0.3, true);
+    speedSlider.setNumDecimalPlacesToDisplay(2);
+    speedSlider.setValue(1.0, dontSendNotification);
     posSlider.setRange(0.0, 1.0);
-
-    startTimer(50);
 }
 
 DeckGUI::~DeckGUI()
 {
-    stopTimer();
 }
 
 void DeckGUI::paint (Graphics& g)
@@ -114,10 +134,16 @@ void DeckGUI::resized()
     posSlider.setBounds(0, rowH * 2.9, getWidth(), rowH);
     volSlider.setBounds(rowW * 1.5, rowH * 3.5, dialSize, dialSize);
     speedSlider.setBounds(rowW * 6.5, rowH * 3.5, dialSize, dialSize);
+    const double jogLeft = rowW * 1.5 + dialSize;
+    const double jogSize = jmin(rowW * 6.5 - jogLeft, rowH * 2.5);
+    jogWheel.setBounds(jogLeft + (rowW * 6.5 - jogLeft - jogSize) / 2, rowH * 3.6, jogSize, jogSize);
+    fxButton.setBounds(5, rowH * 3.5, 40, rowH * 0.6);
+    fxPanel.setBounds(50, rowH * 3.5, getWidth() - 55, rowH * 3.4);
     playButton.setBounds(getWidth()/3, rowH * 7, getWidth()/3, rowH);
     resButton.setBounds(getWidth()/5.1, rowH * 7.15, getWidth()/7.2, rowH*0.8);
     ffButton.setBounds(getWidth()/6*4, rowH * 7.15, getWidth()/8, rowH*0.8);
     loopButton.setBounds(getWidth()/6*5, rowH * 7, getWidth()/6, rowH);
+    pflButton.setBounds(5, rowH * 7, getWidth()/6, rowH);
     loadButton.setBounds(0, rowH * 8.28, getWidth(), rowH/1.3);
 }
 
@@ -135,14 +161,22 @@ void DeckGUI::buttonClicked(Button* button)
         else if (playButton.getButtonText() == "Play")
         {
             playButton.setButtonText("Stop");
-            player->start();
+            player->startAt(nextQuantizedSample());
         }
         else
         {
             playButton.setButtonText("Play");
-            player->stop();
+            player->stopAt(nextQuantizedSample());
         }
     }
+    if (button == &loopButton)
+    {
+        player->setLoopingAt(loopButton.getToggleState(), nextQuantizedSample());
+    }
+    if (button == &pflButton && onPflChanged)
+    {
+        onPflChanged(pflButton.getToggleState());
+    }
     if (button == &ffButton)
     {
         double newPosition = player->getCurrentPosition() + 5.0;
@@ -160,7 +194,7 @@ void DeckGUI::buttonClicked(Button* button)
                 String path = pathFile.loadFileAsString();
                 path = "file:///" + path.replace("\\", "/");
                 player->loadURL(path);
-                waveformDisplay.loadURL(path);
+                waveformDisplay.loadURL(path, player->getStreamingDownload());
                 fileIsLoaded = true;
                 posSlider.setValue(0);
                 //Display track time & update button
@@ -168,6 +202,7 @@ void DeckGUI::buttonClicked(Button* button)
                 String totalLengthStart = formatTime(totalLength, 2);
                 totalTimeLabel.setText("/ " + totalLengthStart, dontSendNotification);
                 playButton.setButtonText("Play");
+                seenURL = player->getLoadedURL();
             }
             else
             {
@@ -176,7 +211,8 @@ void DeckGUI::buttonClicked(Button* button)
                     "File Not Found",
                     "The file specified in the path file was not found.");
             }
-            nowPlayingLabel.setText("Now playing: " + file.getFileName(), dontSendNotification);
+            nowPlayingText = "Now playing: " + file.getFileName();
+            nowPlayingLabel.setText(nowPlayingText, dontSendNotification);
         }
         else
         {
@@ -189,8 +225,11 @@ void DeckGUI::buttonClicked(Button* button)
     if (button == &resButton)
     {
         if (fileIsLoaded) {
-            posSlider.setValue(0);
-            player->start();
+            // jump and start together, on the grid if quantize is on
+            const int64 when = nextQuantizedSample();
+            posSlider.setValue(0, dontSendNotification);
+            player->setPositionAt(0, when);
+            player->startAt(when);
             playButton.setButtonText("Stop");
         }
         else 
@@ -232,89 +271,127 @@ void DeckGUI::sliderValueChanged (Slider *slider)
 
 bool DeckGUI::isInterestedInFileDrag (const StringArray &files)
 {
-  std::cout << "DeckGUI::isInterestedInFileDrag" << std::endl;
+  ignoreUnused(files);
   return true; 
 }
 
 void DeckGUI::filesDropped (const StringArray &files, int x, int y)
 {
-  std::cout << "DeckGUI::filesDropped" << std::endl;
+  ignoreUnused(x, y);
   if (files.size() == 1)
   {
-    player->loadURL(URL{File{files[0]}});
-    waveformDisplay.loadURL(URL{File{files[0]}});
-    fileIsLoaded = true;
-
-    // Create the 'tracks' folder if it does not exist
-    File tracksFolder = File::getCurrentWorkingDirectory().getChildFile("tracks");
-    if (!tracksFolder.exists())
-        tracksFolder.createDirectory();
-
-    // Get the file name and extension of the dropped file
+    // Play straight from the dropped file; the library copy is made in the background
     File droppedFile(files[0]);
-    String fileName = droppedFile.getFileNameWithoutExtension();
-    String fileExtension = droppedFile.getFileExtension();
-
-    // Create a new file in the 'tracks' folder with the same name and extension as the dropped file
-    File newFile = tracksFolder.getChildFile(fileName + fileExtension);
+    player->loadURL(URL{droppedFile});
+    waveformDisplay.loadURL(URL{droppedFile}, player->getStreamingDownload());
+    fileIsLoaded = true;
 
     double totalLength = player->getTotalLength();
     String totalLengthStart = formatTime(totalLength, 2);
     totalTimeLabel.setText("/ " + totalLengthStart, dontSendNotification);
-    nowPlayingLabel.setText("Now playing: " + fileName + fileExtension, dontSendNotification);
+    nowPlayingText = "Now playing: " + droppedFile.getFileName();
+    nowPlayingLabel.setText(nowPlayingText, dontSendNotification);
+    seenURL = player->getLoadedURL();
 
-    // Check if the new file already exists in the 'tracks' folder
-    if (newFile.exists())
-    {
-        // Ask the user if they want to overwrite the file
-        if (AlertWindow::showOkCancelBox(AlertWindow::QuestionIcon,
-            "Overwrite File",
-            "A file with the same name already exists in folder. Do you want to overwrite it?",
-            "OK", "Cancel") == 0)
-        {
-            newFile.deleteFile();
-        }
-        else
-        {
-            return;
-        }
-    }
-    // Copy the dropped file to the new file in the 'tracks' folder
-    droppedFile.copyFileTo(newFile);
-    _playlistComponent->updateTrackTitles();
-    _playlistComponent->loadTracks();
+    importingFile = droppedFile;
+    _playlistComponent->importTrack(droppedFile);
   }
 }
 
-void DeckGUI::timerCallback()
+void DeckGUI::updateImportStatus()
 {
-    if (loopButton.getToggleState()) {
-        if (player->getPositionRelative() > 1) {
-            player->setPositionRelative(0);
-            player->start();
-        }
-    }
-    else
-    {
-        if (player->getPositionRelative() > 1) {
-            player->setPositionRelative(0);
-            posSlider.setValue(0);
-            player->stop();
-            playButton.setButtonText("Play");
-        }
-    }
-    
-    if (player->isLoaded()) {
-        double position = player->getCurrentPosition();
-        double totalLength = player->getTotalLength();
+    if (importingFile == File())
+        return;
 
-        posSlider.setValue(position / totalLength);
+    TrackImporter::Status status = _playlistComponent->getImporter().getStatus(importingFile);
+    String text = nowPlayingText;
+    if (!status.finished)
+        text << "  (importing " << roundToInt(status.progress * 100) << "%)";
+    else if (status.failed || status.duplicate)
+        text << "  (" << status.message << ")";
 
-        String currentPositionString = formatTime(position, 2);
+    if (status.finished)
+        importingFile = File();
 
-        currentTimeLabel.setText(currentPositionString, dontSendNotification);
+    nowPlayingLabel.setText(text, dontSendNotification);
+}
+
+void DeckGUI::refreshDisplay(double audibleMs)
+{
+    // the player stops and rewinds at the end of a track itself, on the exact
+    // block; the controls just follow it
+    const DJAudioPlayer::PlayheadSnapshot snapshot = player->getPlayheadSnapshot();
+
+    if (snapshot.lengthSecs > 0) {
+        const double position = snapshot.positionAt(audibleMs);
+        const double relative = position / snapshot.lengthSecs;
+
+        // the slider and waveform only move once the playhead has moved a pixel;
+        // don't echo the playhead back to the player as a seek
+        if (!posSlider.isMouseButtonDown()
+            && std::abs(relative - posSlider.getValue()) * posSlider.getWidth() >= 1.0)
+            posSlider.setValue(relative, dontSendNotification);
+
+        const String currentPositionString = formatTime(position, 2);
+        if (currentPositionString != currentTimeLabel.getText())
+            currentTimeLabel.setText(currentPositionString, dontSendNotification);
+
+        waveformDisplay.setPositionRelative(relative);
+        jogWheel.setPlayheadPosition(position);
     }
-    waveformDisplay.setPositionRelative(player->getPositionRelative());
+    updateImportStatus();
+    syncControls();
+}
+
+int64 DeckGUI::nextQuantizedSample() const
+{
+    return getQuantizedSample ? getQuantizedSample() : -1;
+}
+
+void DeckGUI::syncControls()
+{
+    // a MIDI controller changes the player directly. Only follow values that
+    // changed in the player, so a click isn't undone before the audio thread applies it
+    const bool playing = player->isPlaying();
+    if (playing != seenPlaying && fileIsLoaded)
+        playButton.setButtonText(playing ? "Stop" : "Play");
+    seenPlaying = playing;
+
+    const bool looping = player->isLooping();
+    if (looping != seenLooping)
+        loopButton.setToggleState(looping, dontSendNotification);
+    seenLooping = looping;
+
+    const double gain = player->getGain();
+    if (gain != seenGain && !volSlider.isMouseButtonDown())
+        volSlider.setValue(gain * 100, dontSendNotification);
+    seenGain = gain;
+
+    const double speed = player->getSpeed();
+    if (speed != seenSpeed && !speedSlider.isMouseButtonDown())
+        speedSlider.setValue(speed, dontSendNotification);
+    seenSpeed = speed;
+
+    const bool pfl = isPflEnabled && isPflEnabled();
+    if (pfl != seenPfl)
+        pflButton.setToggleState(pfl, dontSendNotification);
+    seenPfl = pfl;
+
+    const URL loaded = player->getLoadedURL();
+    if (loaded != seenURL)
+        showLoadedTrack(loaded);
+    seenURL = loaded;
+}
+
+void DeckGUI::showLoadedTrack(const URL& url)
+{
+    waveformDisplay.loadURL(url, player->getStreamingDownload());
+    fileIsLoaded = true;
+    posSlider.setValue(0, dontSendNotification);
+    totalTimeLabel.setText("/ " + formatTime(player->getTotalLength(), 2), dontSendNotification);
+    playButton.setButtonText(player->isPlaying() ? "Stop" : "Play");
+    nowPlayingText = "Now playing: " + (url.isLocalFile() ? url.getLocalFile().getFileName() : url.getFileName());
+    nowPlayingLabel.setText(nowPlayingText, dontSendNotification);
 }
 
 String DeckGUI::formatTime(double seconds, int decimalPlaces)
@@ -13,6 +13,8 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "DJAudioPlayer.h"
 #include "WaveformDisplay.h"
+#include "JogWheel.h"
+#include "FxPanel.h"
 #include "PlaylistComponent.h"
 
 //==============================================================================
@@ -21,13 +23,13 @@
 class DeckGUI    : public Component,
                    public Button::Listener, 
                    public Slider::Listener, 
-                   public FileDragAndDropTarget, 
-                   public Timer
+                   public FileDragAndDropTarget
 {
 public:
     DeckGUI(DJAudioPlayer* player, 
            AudioFormatManager & 	formatManagerToUse,
            AudioThumbnailCache & 	cacheToUse,
+           BandAnalyser & analyserToUse,
            PlaylistComponent* playlistComponent);
     ~DeckGUI();
 
@@ -43,11 +45,27 @@ public:
     bool isInterestedInFileDrag (const StringArray &files) override;
     void filesDropped (const StringArray &files, int x, int y) override; 
 
-    void timerCallback() override; 
+    /** called by the DisplayRefresher once per frame: follow the playhead
+        as it is heard at audibleMs, touching only what changed */
+    void refreshDisplay(double audibleMs);
+
+    /** called when the deck's PFL button is toggled */
+    std::function<void(bool)> onPflChanged;
+    /** asked on each DisplayRefresher frame, so the button follows PFL changes made elsewhere (e.g. MIDI) */
+    std::function<bool()> isPflEnabled;
+    /** where play, stop, restart and loop should land, -1 for straight away */
+    std::function<int64()> getQuantizedSample;
 
 private:
     String formatTime(double seconds, int decimalPlaces);
+    void updateImportStatus();
+    void syncControls();
+    /** show a track the player loaded without this deck's help (e.g. the auto-DJ) */
+    void showLoadedTrack(const URL& url);
+    int64 nextQuantizedSample() const;
     String selectedURL;
+    String nowPlayingText;
+    File importingFile;
 
     TextButton playButton{"PLAY"};
     TextButton stopButton{"STOP"};
@@ -55,6 +73,8 @@ private:
     TextButton ffButton{ "FF" };
     TextButton resButton{ "Restart" };
     ToggleButton loopButton{ "Loop" };
+    ToggleButton pflButton{ "PFL" };
+    TextButton fxButton{ "FX" };
   
     Slider volSlider; 
     Slider speedSlider;
@@ -66,8 +86,18 @@ private:
     FileChooser fChooser{"Select a file..."};
     bool fileIsLoaded = false;
 
+    // the player's state as of the last DisplayRefresher frame, see syncControls()
+    bool seenPlaying = false;
+    bool seenLooping = false;
+    double seenGain = 1.0;
+    double seenSpeed = 1.0;
+    bool seenPfl = false;
+    URL seenURL;
+
 
     WaveformDisplay waveformDisplay;
+    JogWheel jogWheel;
+    FxPanel fxPanel;
 
     DJAudioPlayer* player; 
     PlaylistComponent* _playlistComponent;
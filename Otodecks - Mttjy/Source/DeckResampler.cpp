@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    DeckResampler.cpp
+    Created: 21 Oct 2026 11:20:52am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "DeckResampler.h"
+
+namespace
+{
+    // every tap of the widest kernel, and one over for rounding
+    constexpr int margin = SincInterpolator::maxReach + 2;
+}
+
+DeckResampler::DeckResampler()
+{
+    reset();
+}
+
+void DeckResampler::reset() noexcept
+{
+    input.clear();
+    numInput = SincInterpolator::maxReach;
+    phase = SincInterpolator::maxReach;
+}
+
+double DeckResampler::getReadAhead() const noexcept
+{
+    return numInput - phase;
+}
+
+void DeckResampler::compact() noexcept
+{
+    const int drop = (int)phase - SincInterpolator::maxReach;
+    if (drop <= 0)
+        return;
+
+    const int keep = numInput - drop;
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        float* samples = input.getWritePointer(ch);
+        std::memmove(samples, samples + drop, sizeof(float) * (size_t)keep);
+    }
+    numInput = keep;
+    phase -= drop;
+}
+
+void DeckResampler::render(PositionableAudioSource& source, AudioBuffer<float>& out, int startSample, int numSamples,
+                           double speed) noexcept
+{
+    const int numChannels = out.getNumChannels();
+
+    for (int done = 0; done < numSamples;)
+    {
+        compact();
+
+        // as much of the block as the buffer holds the input for
+        const int count = jlimit(1, numSamples - done, (int)((capacity - margin - phase) / speed));
+        const int needed = (int)std::ceil(phase + speed * count) + margin;
+        if (needed > numInput)
+        {
+            source.getNextAudioBlock(AudioSourceChannelInfo(&input, numInput, needed - numInput));
+            numInput = needed;
+        }
+
+        if (speed == 1.0 && phase == std::floor(phase))
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                out.copyFrom(ch, startSample + done, input, jmin(ch, 1), (int)phase, count);
+            phase += count;
+        }
+        else
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                const double whole = std::floor(phase);
+                const int index = (int)whole;
+                int first = 0;
+                const int numTaps = interpolator.getWeights(phase - whole, speed, weights.data(), first);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    const float* samples = input.getReadPointer(jmin(ch, 1), index + first);
+                    float sum = 0.0f;
+                    for (int k = 0; k < numTaps; ++k)
+                        sum += weights[(size_t)k] * samples[k];
+                    out.setSample(ch, startSample + done + i, sum);
+                }
+                phase += speed;
+            }
+        }
+        done += count;
+    }
+}
@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    DeckResampler.h
+    Created: 21 Oct 2026 11:20:52am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <array>
+#include "SincInterpolator.h"
+
+//==============================================================================
+/*
+    Plays a deck's source forwards at any speed, on the audio thread, in
+    place of AudioTransportSource and ResamplingAudioSource: both of those
+    take a CriticalSection on every block, and the transport posts a change
+    message on every start and stop.
+
+    Source samples are pulled into a buffer that keeps SincInterpolator's
+    reach of history behind the playhead and reads ahead only as far as the
+    block needs. Each output sample is interpolated with a SincInterpolator,
+    so speeds above 1 are band-limited. At exactly unity speed on a whole
+    sample it copies. Everything is allocated by the constructor.
+
+    The source's read position less getReadAhead() is the sample being
+    played. After moving the source, call reset(): the history starts out
+    silent and the next sample out is the one the source was moved to.
+*/
+class DeckResampler
+{
+public:
+    DeckResampler();
+
+    /** audio thread: forget the history and what was read ahead */
+    void reset() noexcept;
+
+    /** audio thread: numSamples into out from source, moving speed (> 0) source samples per output sample */
+    void render(PositionableAudioSource& source, AudioBuffer<float>& out, int startSample, int numSamples, double speed) noexcept;
+
+    /** source samples read but not played yet */
+    double getReadAhead() const noexcept;
+
+private:
+    /** drop the history the interpolator can no longer reach */
+    void compact() noexcept;
+
+    static constexpr int capacity = 2 * SincInterpolator::maxReach + 8192;
+
+    SincInterpolator interpolator;
+    std::array<float, SincInterpolator::maxTaps> weights{};
+
+    AudioBuffer<float> input{ 2, capacity };
+    int numInput = 0;
+    double phase = 0;       // the playhead, in samples from input[0]
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckResampler)
+};
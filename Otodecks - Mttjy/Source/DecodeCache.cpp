@@ -0,0 +1,393 @@
+/*
+  ==============================================================================
+
+    DecodeCache.cpp
+    Created: 20 Oct 2026 6:12:37am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "DecodeCache.h"
+#include "TrackImporter.h"
+#include <algorithm>
+#include <set>
+
+namespace
+{
+    constexpr int decodeBlockSamples = 65536;
+}
+
+DecodeCache::DecodeCache(const File& cacheFolder)
+    : folder(cacheFolder), indexFile(cacheFolder.getChildFile("index.txt"))
+{
+    formatManager.registerBasicFormats();
+
+    enabled = folder.isDirectory();
+    if (enabled)
+        loadIndex();
+
+    decodeThread.addTimeSliceClient(this);
+    decodeThread.startThread();
+}
+
+DecodeCache::~DecodeCache()
+{
+    // stops a decode part way through rather than waiting for it
+    decodeThread.signalThreadShouldExit();
+    decodeThread.removeTimeSliceClient(this);
+    decodeThread.stopThread(5000);
+
+    const ScopedLock sl(lock);
+    if (numUnsaved > 0 && enabled)
+        saveIndex();
+}
+
+void DecodeCache::setEnabled(bool shouldBeEnabled)
+{
+    if (shouldBeEnabled == enabled)
+        return;
+
+    {
+        const ScopedLock sl(lock);
+        enabled = shouldBeEnabled;
+        if (enabled)
+        {
+            deletePending = false;
+            folder.createDirectory();
+            return;
+        }
+
+        // a decode under way sees enabled go, and is dropped
+        entries.clear();
+        numUnsaved = 0;
+        deletePending = true;
+    }
+
+    // no copy is handed out from here on; the idle readers of them go now,
+    // and the decode thread deletes the folder once nothing maps it
+    if (onDisabling != nullptr)
+        onDisabling();
+    decodeThread.moveToFrontOfQueue(this);
+}
+
+bool DecodeCache::isEnabled() const
+{
+    return enabled;
+}
+
+void DecodeCache::setMaxBytes(int64 newMaxBytes)
+{
+    maxBytes = jmax((int64)0, newMaxBytes);
+}
+
+void DecodeCache::addTracks(const Array<File>& files)
+{
+    const ScopedLock sl(lock);
+    if (queueNext == queue.size())
+    {
+        queue.clear();
+        queueNext = 0;
+    }
+    for (auto& file : files)
+        if (needsDecoding(file) && std::find(queue.begin() + (std::ptrdiff_t)queueNext, queue.end(), file) == queue.end())
+            queue.push_back(file);
+}
+
+void DecodeCache::removeTrack(const File& file)
+{
+    const ScopedLock sl(lock);
+    auto it = entries.find(file.getFullPathName());
+    if (it == entries.end())
+        return;
+
+    const uint64 hash = it->second.hash;
+    entries.erase(it);
+    deleteCopyIfUnused(hash);
+    ++numUnsaved;
+}
+
+File DecodeCache::getCachedFile(const File& file) const
+{
+    if (!enabled)
+        return {};
+
+    Entry entry;
+    {
+        const ScopedLock sl(lock);
+        auto it = entries.find(file.getFullPathName());
+        if (it == entries.end())
+            return {};
+        entry = it->second;
+    }
+
+    // changed since it was hashed: the copy may be of something else
+    if (file.getSize() != entry.size || file.getLastModificationTime().toMilliseconds() != entry.modified)
+        return {};
+
+    const File copy = getCopyFor(entry.hash);
+    if (!copy.existsAsFile())
+        return {};
+
+    // the most recently served copies are the last to go when the folder is full
+    copy.setLastModificationTime(Time::getCurrentTime());
+    return copy;
+}
+
+int DecodeCache::getNumCached() const
+{
+    const ScopedLock sl(lock);
+    return (int)entries.size();
+}
+
+int DecodeCache::getNumPending() const
+{
+    const ScopedLock sl(lock);
+    return (int)(queue.size() - queueNext);
+}
+
+//==============================================================================
+bool DecodeCache::needsDecoding(const File& file)
+{
+    return !file.hasFileExtension("wav;aif;aiff");
+}
+
+bool DecodeCache::decode(AudioFormatReader& reader, const File& destination, std::function<bool()> shouldStop)
+{
+    destination.deleteFile();
+    std::unique_ptr<FileOutputStream> out(destination.createOutputStream());
+    if (out == nullptr)
+        return false;
+
+    // 16 bits is what the compressed original carried at best, at half the size of float
+    WavAudioFormat wav;
+    std::unique_ptr<AudioFormatWriter> writer(wav.createWriterFor(out.get(), reader.sampleRate, reader.numChannels, 16, {}, 0));
+    if (writer == nullptr)
+        return false;
+    out.release();
+
+    AudioBuffer<float> block((int)reader.numChannels, decodeBlockSamples);
+    for (int64 position = 0; position < reader.lengthInSamples; position += decodeBlockSamples)
+    {
+        if (shouldStop != nullptr && shouldStop())
+            return false;
+
+        const int numSamples = (int)jmin((int64)decodeBlockSamples, reader.lengthInSamples - position);
+        if (!reader.read(&block, 0, numSamples, position, true, true)
+            || !writer->writeFromAudioSampleBuffer(block, 0, numSamples))
+            return false;
+    }
+    return writer->flush();
+}
+
+std::unique_ptr<AudioFormatReader> DecodeCache::openCopy(const File& copy)
+{
+    WavAudioFormat wav;
+    std::unique_ptr<MemoryMappedAudioFormatReader> reader(wav.createMemoryMappedReader(copy));
+    if (reader == nullptr || !reader->mapEntireFile())
+        return nullptr;
+    return std::unique_ptr<AudioFormatReader>(reader.release());
+}
+
+//==============================================================================
+int DecodeCache::useTimeSlice()
+{
+    if (!enabled)
+        return deleteFolderIfPending() ? 500 : 1000;
+
+    if (!strayCheckDone)
+    {
+        deleteStrayCopies();
+        strayCheckDone = true;
+    }
+
+    File file;
+    Entry previous;
+    bool known = false;
+    {
+        const ScopedLock sl(lock);
+        if (queueNext == queue.size())
+        {
+            if (numUnsaved > 0)
+                saveIndex();
+            return 250;
+        }
+
+        file = queue[queueNext++];
+        auto it = entries.find(file.getFullPathName());
+        known = it != entries.end();
+        if (known)
+            previous = it->second;
+    }
+
+    Entry entry;
+    entry.size = file.getSize();
+    entry.modified = file.getLastModificationTime().toMilliseconds();
+    if (known && previous.size == entry.size && previous.modified == entry.modified && getCopyFor(previous.hash).existsAsFile())
+        return 0;
+    if (!file.existsAsFile())
+        return 0;
+
+    auto shouldStop = [this] { return decodeThread.threadShouldExit() || !enabled; };
+    entry.hash = TrackImporter::hashFile(file, [&](double) { return !shouldStop(); });
+    if (entry.hash == 0)
+        return 0;
+
+    // the same content under another name, or touched without changing, is decoded already
+    const File copy = getCopyFor(entry.hash);
+    if (!copy.existsAsFile())
+    {
+        std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr)
+            return 0;
+
+        TemporaryFile temp(copy);
+        if (!decode(*reader, temp.getFile(), shouldStop) || !temp.overwriteTargetFileWithTemporary())
+            return 0;
+    }
+    else
+    {
+        copy.setLastModificationTime(Time::getCurrentTime());
+    }
+
+    bool save = false;
+    {
+        const ScopedLock sl(lock);
+        if (!enabled)
+            return 0;
+
+        entries[file.getFullPathName()] = entry;
+        if (known && previous.hash != entry.hash)
+            deleteCopyIfUnused(previous.hash);
+        save = ++numUnsaved >= saveEvery;
+        if (save)
+            saveIndex();
+    }
+
+    deleteOverBudget(copy);
+    sendChangeMessage();
+    return 0;
+}
+
+File DecodeCache::getCopyFor(uint64 hash) const
+{
+    return folder.getChildFile(String::toHexString((int64)hash).paddedLeft('0', 16) + ".wav");
+}
+
+void DecodeCache::deleteCopyIfUnused(uint64 hash)
+{
+    for (auto& item : entries)
+        if (item.second.hash == hash)
+            return;
+    getCopyFor(hash).deleteFile();
+}
+
+void DecodeCache::loadIndex()
+{
+    StringArray lines;
+    indexFile.readLines(lines);
+    for (auto& line : lines)
+    {
+        StringArray fields = StringArray::fromTokens(line, "|", "");
+        if (fields.size() != 4)
+            continue;
+
+        Entry entry;
+        entry.hash = (uint64)fields[0].getHexValue64();
+        entry.size = fields[1].getLargeIntValue();
+        entry.modified = fields[2].getLargeIntValue();
+        entries[fields[3]] = entry;
+    }
+}
+
+void DecodeCache::saveIndex()
+{
+    String text;
+    for (auto& item : entries)
+    {
+        text << String::toHexString((int64)item.second.hash) << "|" << item.second.size << "|"
+             << item.second.modified << "|" << item.first << "\n";
+    }
+
+    TemporaryFile temp(indexFile);
+    if (temp.getFile().replaceWithText(text))
+        temp.overwriteTargetFileWithTemporary();
+    numUnsaved = 0;
+}
+
+bool DecodeCache::deleteFolderIfPending()
+{
+    const ScopedLock sl(lock);
+    if (!deletePending || enabled)
+        return true;
+
+    // fails while a deck still has a copy mapped (on Windows)
+    folder.deleteRecursively();
+    deletePending = folder.exists();
+    if (!deletePending)
+        strayCheckDone = false;
+    return !deletePending;
+}
+
+void DecodeCache::deleteStrayCopies()
+{
+    std::set<String> used;
+    {
+        const ScopedLock sl(lock);
+        for (auto& item : entries)
+            used.insert(getCopyFor(item.second.hash).getFileName());
+    }
+
+    for (auto& file : folder.findChildFiles(File::findFiles, false, "*.wav"))
+        if (used.count(file.getFileName()) == 0)
+            file.deleteFile();
+}
+
+void DecodeCache::deleteOverBudget(const File& keep)
+{
+    Array<File> copies = folder.findChildFiles(File::findFiles, false, "*.wav");
+    int64 total = 0;
+    for (auto& file : copies)
+        total += file.getSize();
+
+    const int64 limit = maxBytes;
+    if (total <= limit)
+        return;
+
+    std::sort(copies.begin(), copies.end(), [](const File& a, const File& b)
+    {
+        return a.getLastModificationTime() < b.getLastModificationTime();
+    });
+
+    std::set<String> deleted;
+    for (auto& file : copies)
+    {
+        if (total <= limit)
+            break;
+
+        // one a deck has mapped can't be deleted on Windows; the next oldest goes instead
+        const int64 size = file.getSize();
+        if (file == keep || !file.deleteFile())
+            continue;
+        total -= size;
+        deleted.insert(file.getFileName());
+    }
+
+    if (deleted.empty())
+        return;
+
+    // those tracks are decoded again the next time a deck loads them
+    const ScopedLock sl(lock);
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        if (deleted.count(getCopyFor(it->second.hash).getFileName()) != 0)
+        {
+            it = entries.erase(it);
+            ++numUnsaved;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
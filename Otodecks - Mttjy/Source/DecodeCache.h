@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    DecodeCache.h
+    Created: 20 Oct 2026 6:12:37am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+#include <functional>
+#include <map>
+#include <vector>
+
+//==============================================================================
+/*
+    An optional ingest stage: each compressed track a deck loads is decoded
+    once, in the background, to a 16-bit WAV that is memory-mapped from then
+    on. Decks and analysers then skip the MP3 (or FLAC, or Ogg) decode every
+    time they play the track or seek in it. ReaderPool queues a track when
+    it opens one without a copy, and opens the copy in place of the
+    original whenever it is current.
+
+    The originals stay the source of truth. A copy is named after the
+    content hash of its original (TrackImporter::hashFile), so identical
+    tracks share one. decode_cache/index.txt records each track's hash with
+    the size and modification time it was hashed at:
+
+        hash|size|modified ms|full path
+
+    If a track's size or date changes, its copy isn't served until the
+    track has been hashed again, and decoded again if the content really
+    did change. A copy no track points at any more is deleted. WAV and
+    AIFF tracks are left alone, since they cost next to nothing to decode
+    already.
+
+    A 16-bit copy is still several times the size of an MP3, so the copies
+    are kept under setMaxBytes() between them. Serving a copy touches its
+    modification time, and once a new copy takes the folder over the limit
+    the least recently used ones are deleted, along with the index entries
+    that pointed at them.
+
+    The cache is off until setEnabled(true), which creates the folder.
+    Turning it off stops serving copies at once and calls onDisabling, so
+    whatever keeps idle readers of them (ReaderPool) can close them. The
+    folder is then deleted on the decode thread. A copy a deck is still
+    playing stays memory-mapped, and on Windows can't be deleted until the
+    deck lets it go, so the deletion is retried until it succeeds. A change
+    message goes out as tracks are decoded.
+*/
+class DecodeCache : public ChangeBroadcaster,
+                    private TimeSliceClient
+{
+public:
+    DecodeCache(const File& cacheFolder);
+    ~DecodeCache() override;
+
+    /** message thread */
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const;
+
+    /** any thread: the most the copies may take up between them */
+    void setMaxBytes(int64 newMaxBytes);
+
+    /** message thread, when the cache is turned off: close any idle readers of the copies */
+    std::function<void()> onDisabling;
+
+    /** any thread: decode these unless their copies are current or they are queued already */
+    void addTracks(const Array<File>& files);
+    /** message thread: forget file, and delete its copy unless another track shares it */
+    void removeTrack(const File& file);
+
+    /** any thread: file's decoded copy if it has a current one, otherwise a non-existent File */
+    File getCachedFile(const File& file) const;
+
+    int getNumCached() const;
+    int getNumPending() const;
+
+    /** true for the formats worth caching: everything but WAV and AIFF */
+    static bool needsDecoding(const File& file);
+    /** decode all of reader into destination in the cache format */
+    static bool decode(AudioFormatReader& reader, const File& destination, std::function<bool()> shouldStop = nullptr);
+    /** a memory-mapped reader over a decoded copy, or nullptr */
+    static std::unique_ptr<AudioFormatReader> openCopy(const File& copy);
+
+private:
+    struct Entry
+    {
+        uint64 hash = 0;
+        int64 size = 0;
+        int64 modified = 0;
+    };
+
+    static constexpr int saveEvery = 50;
+    static constexpr int64 defaultMaxBytes = (int64)4 * 1024 * 1024 * 1024;
+
+    int useTimeSlice() override;
+    File getCopyFor(uint64 hash) const;
+    /** with the lock held: delete hash's copy if no entry uses it */
+    void deleteCopyIfUnused(uint64 hash);
+    void loadIndex();
+    void saveIndex();
+    /** decoding thread: delete copies the index doesn't know, e.g. left by a crash */
+    void deleteStrayCopies();
+    /** decoding thread: delete the least recently used copies but keep until they fit under maxBytes */
+    void deleteOverBudget(const File& keep);
+    /** decoding thread: delete the folder after the cache was turned off; false to try again later */
+    bool deleteFolderIfPending();
+
+    const File folder;
+    const File indexFile;
+    AudioFormatManager formatManager;
+    TimeSliceThread decodeThread{ "Decode cache" };
+
+    mutable CriticalSection lock;
+    std::atomic<bool> enabled{ false };
+    std::atomic<int64> maxBytes{ defaultMaxBytes };
+    std::map<String, Entry> entries;        // by full path
+    std::vector<File> queue;
+    size_t queueNext = 0;
+    int numUnsaved = 0;
+    bool strayCheckDone = false;
+    bool deletePending = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DecodeCache)
+};
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    DisplayRefresher.cpp
+    Created: 19 Oct 2026 9:52:18pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "DisplayRefresher.h"
+
+DisplayRefresher::DisplayRefresher(Component& host, AudioDeviceManager& _deviceManager, MixEngine& _engine)
+    : deviceManager(_deviceManager), engine(_engine)
+{
+    deviceManager.addChangeListener(this);
+    updateLatency();
+
+   #if JUCE_MAJOR_VERSION >= 7
+    vblank = std::make_unique<VBlankAttachment>(&host, [this] { refresh(); });
+   #else
+    ignoreUnused(host);
+    startTimerHz(60);
+   #endif
+}
+
+DisplayRefresher::~DisplayRefresher()
+{
+    stopTimer();
+   #if JUCE_MAJOR_VERSION >= 7
+    vblank.reset();
+   #endif
+    deviceManager.removeChangeListener(this);
+}
+
+void DisplayRefresher::addDeck(DeckGUI* deck)
+{
+    decks.addIfNotAlreadyThere(deck);
+}
+
+double DisplayRefresher::getOutputLatencyMs() const
+{
+    return outputLatencyMs;
+}
+
+void DisplayRefresher::timerCallback()
+{
+    refresh();
+}
+
+void DisplayRefresher::changeListenerCallback(ChangeBroadcaster*)
+{
+    // the device, its buffer size or its sample rate changed
+    updateLatency();
+}
+
+void DisplayRefresher::updateLatency()
+{
+    outputLatencyMs = 0;
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+    {
+        const double sampleRate = device->getCurrentSampleRate();
+        // a rendered block waits for the one playing now, then for the driver
+        if (sampleRate > 0)
+            outputLatencyMs = (device->getOutputLatencyInSamples() + device->getCurrentBufferSizeSamples())
+                            * 1000.0 / sampleRate;
+    }
+}
+
+void DisplayRefresher::refresh()
+{
+    const double nowMs = Time::getMillisecondCounterHiRes();
+    if (lastFrameMs > 0)
+        frameMs += (jlimit(1.0, 100.0, nowMs - lastFrameMs) - frameMs) * 0.1;
+    lastFrameMs = nowMs;
+
+    // the frame drawn now is shown at the next refresh; the engine's delay
+    // changes as the decks' limiters go in and out of the path
+    const double sampleRate = engine.getSampleRate();
+    const double engineLatencyMs = sampleRate > 0 ? engine.getLatencySamples() * 1000.0 / sampleRate : 0.0;
+    const double audibleMs = nowMs + frameMs - outputLatencyMs - engineLatencyMs;
+    for (auto* deck : decks)
+        deck->refreshDisplay(audibleMs);
+}
@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    DisplayRefresher.h
+    Created: 19 Oct 2026 9:52:18pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DeckGUI.h"
+#include "MixEngine.h"
+
+//==============================================================================
+/*
+    Refreshes every deck's playhead display once per display frame, in place
+    of a timer per deck.
+
+    Decks draw from the snapshot their player publishes at the end of each
+    audio block, extrapolated to the moment the frame will be on screen and
+    moved back by the time audio takes to get from the callback to the
+    speakers, so the playhead shows what is being heard rather than what was
+    last rendered. That time includes the engine's own delay, read every
+    frame since it depends on which limiters are in the path. Frames are
+    timed by the display's vertical blank where JUCE offers it (7 and
+    later) and by a 60 Hz timer otherwise.
+*/
+class DisplayRefresher : private Timer,
+                         private ChangeListener
+{
+public:
+    DisplayRefresher(Component& host, AudioDeviceManager& deviceManager, MixEngine& engine);
+    ~DisplayRefresher() override;
+
+    void addDeck(DeckGUI* deck);
+
+    /** callback to speaker, in ms, as last read from the device; the engine's delay is on top */
+    double getOutputLatencyMs() const;
+
+private:
+    void timerCallback() override;
+    void changeListenerCallback(ChangeBroadcaster* source) override;
+
+    void refresh();
+    void updateLatency();
+
+    AudioDeviceManager& deviceManager;
+    MixEngine& engine;
+    Array<DeckGUI*> decks;
+
+    double outputLatencyMs = 0;
+    double lastFrameMs = 0;
+    double frameMs = 1000.0 / 60.0;    // smoothed interval between refreshes
+
+   #if JUCE_MAJOR_VERSION >= 7
+    std::unique_ptr<VBlankAttachment> vblank;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DisplayRefresher)
+};
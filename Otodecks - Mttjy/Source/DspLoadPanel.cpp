@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    DspLoadPanel.cpp
+    Created: 19 Oct 2026 9:48:12am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "DspLoadPanel.h"
+
+//==============================================================================
+DspLoadPanel::DspLoadPanel(AudioCallbackMonitor& _monitor, AudioDeviceManager& _deviceManager)
+    : monitor(_monitor),
+      deviceManager(_deviceManager)
+{
+    addAndMakeVisible(dumpButton);
+    dumpButton.onClick = [this] { dumpToFile(); };
+
+    startTimerHz(timerHz);
+}
+
+DspLoadPanel::~DspLoadPanel()
+{
+    stopTimer();
+}
+
+void DspLoadPanel::paint (Graphics& g)
+{
+    g.fillAll(Colour::fromRGB(15, 15, 15));
+
+    const bool overloaded = summary.overruns > 0 || summary.lateCallbacks > 0 || deviceXruns > 0;
+    g.setColour(overloaded ? Colours::orange : Colours::lightgrey);
+    g.setFont(12.0f);
+
+    String text;
+    text << "DSP " << String(summary.loadPercent, 1) << "%"
+         << "  p50 " << String(summary.p50Ms, 2) << " ms"
+         << "  p99 " << String(summary.p99Ms, 2) << " ms"
+         << "  max " << String(summary.maxMs, 2) << " ms"
+         << "  (budget " << String(summary.budgetMs, 2) << " ms)"
+         << "  overruns " << summary.overruns
+         << "  late " << summary.lateCallbacks
+         << "  device xruns " << deviceXruns;
+
+    for (int d = 0; d < AudioCallbackMonitor::maxDecks; ++d)
+    {
+        if (summary.deckReaderMs[d] > 0 || summary.deckResamplerMs[d] > 0)
+            text << "  | deck " << (d + 1) << " read " << String(summary.deckReaderMs[d], 3)
+                 << " / resample " << String(summary.deckResamplerMs[d], 3);
+    }
+    text << "  | mix " << String(summary.mixerMs, 3);
+
+    g.drawText(text, getLocalBounds().withTrimmedLeft(4).withTrimmedRight(dumpButton.getWidth() + 4),
+               Justification::centredLeft, true);
+}
+
+void DspLoadPanel::resized()
+{
+    dumpButton.setBounds(getWidth() - 60, 1, 58, getHeight() - 2);
+}
+
+void DspLoadPanel::timerCallback()
+{
+    summary = monitor.getSummary();
+
+    // swap the since-start stage averages for ones over the last second
+    const auto totals = monitor.getStageTotals();
+    auto& oldest = window[(size_t)windowPos];
+    if (oldest.numCallbacks > totals.numCallbacks)
+        oldest = AudioCallbackMonitor::StageTotals();     // reset since
+    AudioCallbackMonitor::setStageAverages(summary, oldest, totals);
+    oldest = totals;
+    windowPos = (windowPos + 1) % timerHz;
+
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+        deviceXruns = jmax(0, device->getXRunCount());
+    repaint();
+}
+
+void DspLoadPanel::dumpToFile()
+{
+    File dumpFile = File::getCurrentWorkingDirectory()
+        .getChildFile("perf_dump_" + Time::getCurrentTime().formatted("%Y%m%d_%H%M%S") + ".txt");
+
+    if (monitor.dumpToFile(dumpFile))
+    {
+        AlertWindow::showMessageBoxAsync(AlertWindow::InfoIcon,
+            "Performance Dump", "Written to " + dumpFile.getFullPathName());
+    }
+    else
+    {
+        AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon,
+            "Performance Dump", "Could not write " + dumpFile.getFullPathName());
+    }
+}
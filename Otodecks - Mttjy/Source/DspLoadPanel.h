@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    DspLoadPanel.h
+    Created: 19 Oct 2026 9:48:12am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AudioCallbackMonitor.h"
+#include <array>
+
+//==============================================================================
+/*
+    One-line readout of the audio callback monitor, with a button to dump the
+    callback history to a file after a set.
+
+    The three dropout counters are shown apart: a late callback is often the
+    device's own xrun seen from our side, so adding them up would count it
+    twice. The per-stage times are averaged over the last second.
+*/
+class DspLoadPanel  : public Component,
+                      public Timer
+{
+public:
+    DspLoadPanel(AudioCallbackMonitor& monitor, AudioDeviceManager& deviceManager);
+    ~DspLoadPanel() override;
+
+    void paint (Graphics&) override;
+    void resized() override;
+
+    void timerCallback() override;
+
+    /** writes perf_dump_<time>.txt into the working directory */
+    void dumpToFile();
+
+private:
+    AudioCallbackMonitor& monitor;
+    AudioDeviceManager& deviceManager;
+    AudioCallbackMonitor::Summary summary;
+    int deviceXruns = 0;
+
+    // the stage totals at each of the last timerHz ticks, oldest at windowPos
+    static constexpr int timerHz = 5;
+    std::array<AudioCallbackMonitor::StageTotals, timerHz> window;
+    int windowPos = 0;
+
+    TextButton dumpButton{ "Dump" };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DspLoadPanel)
+};
@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+
+    EngineEventLog.cpp
+    Created: 19 Oct 2026 1:34:50pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "EngineEventLog.h"
+#include <map>
+
+EngineEventLog::EngineEventLog()
+{
+}
+
+EngineEventLog::~EngineEventLog()
+{
+    close();
+    writerThread.stopThread(2000);
+}
+
+void EngineEventLog::setSampleClock(std::function<int64()> clock)
+{
+    sampleClock = std::move(clock);
+}
+
+bool EngineEventLog::open(const File& file, double sampleRate, int blockSize, String& error)
+{
+    close();
+
+    file.getParentDirectory().createDirectory();
+    file.deleteFile();
+    std::unique_ptr<FileOutputStream> newStream(file.createOutputStream());
+    if (newStream == nullptr)
+    {
+        error = "Cannot write " + file.getFullPathName();
+        return false;
+    }
+
+    newStream->write("OTEL", 4);
+    newStream->writeInt(version);
+    newStream->writeDouble(sampleRate);
+    newStream->writeInt(blockSize);
+    newStream->flush();
+
+    {
+        const ScopedLock sl(streamLock);
+        stream = std::move(newStream);
+        logFile = file;
+    }
+
+    queue.reset();
+    droppedEvents = 0;
+    active = true;
+
+    writerThread.addTimeSliceClient(this);
+    if (!writerThread.isThreadRunning())
+        writerThread.startThread();
+    return true;
+}
+
+void EngineEventLog::close()
+{
+    if (!active.exchange(false))
+        return;
+
+    writerThread.removeTimeSliceClient(this);
+
+    const ScopedLock sl(streamLock);
+    flushQueue();
+    stream.reset();
+}
+
+bool EngineEventLog::isOpen() const
+{
+    return active.load();
+}
+
+File EngineEventLog::getFile() const
+{
+    const ScopedLock sl(streamLock);
+    return logFile;
+}
+
+void EngineEventLog::logFromAudioThread(int deck, EventType type, double value, int sampleOffset) noexcept
+{
+    if (!active.load(std::memory_order_acquire))
+        return;
+
+    const auto scope = queue.write(1);
+    if (scope.blockSize1 + scope.blockSize2 == 0)
+    {
+        droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const int index = scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2;
+    pending[(size_t)index] = { (sampleClock ? sampleClock() : 0) + sampleOffset,
+                               nextSequence.fetch_add(1, std::memory_order_relaxed), (uint8)deck, type, value };
+}
+
+int EngineEventLog::addUrl(const String& url)
+{
+    if (!active.load())
+        return -1;
+
+    const ScopedLock sl(streamLock);
+    if (stream == nullptr)
+        return -1;
+
+    const int id = nextUrlId++;
+    writeEvent(sampleClock ? sampleClock() : 0, nextSequence.fetch_add(1), 0, EventType::url, id, url);
+    stream->flush();
+    return id;
+}
+
+void EngineEventLog::logFromMessageThread(int deck, EventType type, double value, const String& url)
+{
+    if (type == EventType::load)
+        value = addUrl(url);
+
+    if (!active.load())
+        return;
+
+    const ScopedLock sl(streamLock);
+    if (stream == nullptr)
+        return;
+
+    writeEvent(sampleClock ? sampleClock() : 0, nextSequence.fetch_add(1), deck, type, value, {});
+    stream->flush();
+}
+
+EngineEventLog::EventType EngineEventLog::getFxEventType(int effect, FxSetting setting)
+{
+    return (EventType)((int)EventType::fx + effect * numFxSettings + (int)setting);
+}
+
+bool EngineEventLog::isFxEvent(EventType type, int& effect, FxSetting& setting)
+{
+    const int index = (int)type - (int)EventType::fx;
+    if (index < 0)
+        return false;
+
+    effect = index / numFxSettings;
+    setting = (FxSetting)(index % numFxSettings);
+    return true;
+}
+
+int EngineEventLog::getNumDroppedEvents() const
+{
+    return droppedEvents.load();
+}
+
+int EngineEventLog::useTimeSlice()
+{
+    const ScopedLock sl(streamLock);
+    return flushQueue() > 0 ? 0 : 100;
+}
+
+int EngineEventLog::flushQueue()
+{
+    if (stream == nullptr)
+        return 0;
+
+    int numWritten = 0;
+    {
+        const auto scope = queue.read(queue.getNumReady());
+        scope.forEach([this, &numWritten](int index)
+        {
+            const auto& e = pending[(size_t)index];
+            writeEvent(e.sample, e.sequence, e.deck, e.type, e.value, {});
+            ++numWritten;
+        });
+    }
+
+    // flush per batch so a crash loses at most the last few events
+    if (numWritten > 0)
+        stream->flush();
+    return numWritten;
+}
+
+void EngineEventLog::writeEvent(int64 sample, uint32 sequence, int deck, EventType type, double value, const String& url)
+{
+    stream->writeInt64(sample);
+    stream->writeInt((int)sequence);
+    stream->writeByte((char)deck);
+    stream->writeByte((char)type);
+    stream->writeDouble(value);
+    if (type == EventType::url)
+        stream->writeString(url);
+}
+
+bool EngineEventLog::read(const File& file, double& sampleRate, int& blockSize, Array<Event>& events, String& error)
+{
+    FileInputStream in(file);
+    if (!in.openedOk())
+    {
+        error = "Cannot read " + file.getFullPathName();
+        return false;
+    }
+
+    char magic[4] = {};
+    const bool isLog = in.read(magic, 4) == 4 && memcmp(magic, "OTEL", 4) == 0;
+    const int fileVersion = isLog ? in.readInt() : 0;
+    if (fileVersion != version)
+    {
+        error = file.getFileName() + " is not an Otodecks event log";
+        return false;
+    }
+
+    sampleRate = in.readDouble();
+    blockSize = in.readInt();
+
+    // a crash can leave a partial record at the end; stop at the last whole one
+    const int recordSize = 8 + 4 + 1 + 1 + 8;
+    std::map<int, String> urls;
+    while (in.getNumBytesRemaining() >= recordSize)
+    {
+        Event e;
+        e.sample = in.readInt64();
+        e.sequence = (uint32)in.readInt();
+        e.deck = (uint8)in.readByte();
+        e.type = (EventType)(uint8)in.readByte();
+        e.value = in.readDouble();
+
+        if (e.type == EventType::url)
+        {
+            urls[(int)e.value] = in.readString();
+            continue;
+        }
+
+        if (e.type == EventType::load)
+        {
+            // written before the audio thread could log the load, so it is always ahead of it
+            auto it = urls.find((int)e.value);
+            if (it == urls.end())
+                continue;   // loaded as the log was reopened; the opening state has it
+            e.url = it->second;
+        }
+        events.add(e);
+    }
+
+    std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b)
+    {
+        return a.sample != b.sample ? a.sample < b.sample : a.sequence < b.sequence;
+    });
+    return true;
+}
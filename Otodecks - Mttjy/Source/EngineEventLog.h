@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+    EngineEventLog.h
+    Created: 19 Oct 2026 1:34:50pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <array>
+#include <atomic>
+#include <functional>
+
+//==============================================================================
+/*
+    Compact binary log of everything that reached the engine, stamped with the
+    sample at which the audio thread applied it. Replaying it offline with the
+    same block size reproduces the live render.
+
+    Deck effect changes are logged as the audio thread picks them up, at
+    the start of the block they first apply to. Loads are stamped by the
+    audio thread too, in the first block that plays
+    the new track. A load's value names a url record, which the loading
+    thread writes before the audio thread can see the track. Every event
+    also carries a sequence number counting events in the order they were
+    logged, so events on the same sample replay in that order whichever
+    thread wrote them to the file.
+
+    File layout (little endian):
+        "OTEL" magic, int32 version, double sample rate, int32 block size
+        then records of: int64 sample, uint32 sequence, uint8 deck, uint8 type,
+        double value and, for url records only, a null-terminated UTF-8 URL.
+*/
+class EngineEventLog : private TimeSliceClient
+{
+public:
+    enum class EventType : uint8
+    {
+        load = 1,
+        play,
+        stop,
+        speed,
+        gain,
+        position,
+        loop,
+        scratch,
+        jog,
+        fadeIn,
+        fadeOut,
+        url,        // not an event: the URL of the loads whose value is this id
+        fx = 32     // and up: a deck effect setting, see getFxEventType()
+    };
+
+    /** what a deck effect event changed; the value is the setting's new value */
+    enum class FxSetting : uint8
+    {
+        enabled,
+        wet,
+        parameter1,
+        parameter2
+    };
+
+    static constexpr int numFxSettings = 4;
+    /** one event type per effect (in DeckFx order) and setting */
+    static EventType getFxEventType(int effect, FxSetting setting);
+    /** false if type isn't a deck effect event */
+    static bool isFxEvent(EventType type, int& effect, FxSetting& setting);
+
+    struct Event
+    {
+        int64 sample = 0;
+        int deck = 0;
+        EventType type = EventType::play;
+        double value = 0;
+        String url;
+        uint32 sequence = 0;    // the order among events on the same sample
+    };
+
+    EngineEventLog();
+    ~EngineEventLog() override;
+
+    /** samples rendered so far by the engine being logged */
+    void setSampleClock(std::function<int64()> clock);
+
+    bool open(const File& file, double sampleRate, int blockSize, String& error);
+    void close();
+    bool isOpen() const;
+    File getFile() const;
+
+    /** audio thread: a deck command was applied sampleOffset samples into the current block */
+    void logFromAudioThread(int deck, EventType type, double value, int sampleOffset = 0) noexcept;
+
+    /** loading thread: writes a url record and returns its id, for the audio
+        thread to log the load with once it plays the track; -1 if not open */
+    int addUrl(const String& url);
+
+    /** message thread: state written when the log opens */
+    void logFromMessageThread(int deck, EventType type, double value, const String& url = {});
+
+    /** number of audio thread events that did not fit in the queue */
+    int getNumDroppedEvents() const;
+
+    static bool read(const File& file, double& sampleRate, int& blockSize, Array<Event>& events, String& error);
+
+private:
+    struct PendingEvent
+    {
+        int64 sample;
+        uint32 sequence;
+        uint8 deck;
+        EventType type;
+        double value;
+    };
+
+    static constexpr int queueSize = 1024;
+    static constexpr int version = 2;
+
+    int useTimeSlice() override;
+    void writeEvent(int64 sample, uint32 sequence, int deck, EventType type, double value, const String& url);
+    int flushQueue();
+
+    TimeSliceThread writerThread{ "Otodecks event log" };
+    std::function<int64()> sampleClock;
+
+    AbstractFifo queue{ queueSize };
+    std::array<PendingEvent, queueSize> pending;
+    std::atomic<int> droppedEvents{ 0 };
+    std::atomic<bool> active{ false };
+    // neither restarts when the log is reopened, so a url id handed out for
+    // the previous file is never mistaken for one in the new file
+    std::atomic<uint32> nextSequence{ 0 };
+    int nextUrlId = 0;      // under streamLock
+
+    CriticalSection streamLock;
+    std::unique_ptr<FileOutputStream> stream;
+    File logFile;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EngineEventLog)
+};
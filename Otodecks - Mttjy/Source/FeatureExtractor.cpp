@@ -0,0 +1,447 @@
+/*
+  ==============================================================================
+
+    FeatureExtractor.cpp
+    Created: 20 Oct 2026 3:24:51am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "FeatureExtractor.h"
+#include <complex>
+#include <vector>
+
+namespace
+{
+    constexpr int fftOrder = 11;
+    constexpr int fftSize = 1 << fftOrder;
+    constexpr int numBins = fftSize / 2 + 1;
+    constexpr int hopSize = 512;
+    constexpr double windowSecs = 90.0;
+
+    constexpr int numMelBands = 26;
+    constexpr int numCoefficients = 13;
+    constexpr int numSpreadCoefficients = 6;
+    constexpr int numContrastBands = 6;
+
+    // Krumhansl-Kessler probe-tone ratings, tonic first
+    const float majorProfile[12] = { 6.35f, 2.23f, 3.48f, 2.33f, 4.38f, 4.09f, 2.52f, 5.19f, 2.39f, 3.66f, 2.29f, 2.88f };
+    const float minorProfile[12] = { 6.33f, 2.68f, 3.52f, 5.38f, 2.60f, 3.53f, 2.54f, 4.75f, 3.98f, 2.69f, 3.34f, 3.17f };
+
+    /** in-place iterative radix-2 FFT of a fixed size */
+    class Fft
+    {
+    public:
+        Fft()
+            : bitReversed((size_t)fftSize), twiddles((size_t)fftSize / 2)
+        {
+            for (int i = 0; i < fftSize; ++i)
+            {
+                int reversed = 0;
+                for (int bit = 0; bit < fftOrder; ++bit)
+                    if (i & (1 << bit))
+                        reversed |= 1 << (fftOrder - 1 - bit);
+                bitReversed[(size_t)i] = reversed;
+            }
+
+            for (int i = 0; i < fftSize / 2; ++i)
+                twiddles[(size_t)i] = std::polar(1.0f, -MathConstants<float>::twoPi * (float)i / (float)fftSize);
+        }
+
+        void perform(std::complex<float>* data) const
+        {
+            for (int i = 0; i < fftSize; ++i)
+                if (i < bitReversed[(size_t)i])
+                    std::swap(data[i], data[bitReversed[(size_t)i]]);
+
+            for (int length = 2; length <= fftSize; length <<= 1)
+            {
+                const int half = length / 2;
+                const int stride = fftSize / length;
+                for (int start = 0; start < fftSize; start += length)
+                {
+                    for (int k = 0; k < half; ++k)
+                    {
+                        const std::complex<float> odd = twiddles[(size_t)(k * stride)] * data[start + k + half];
+                        data[start + k + half] = data[start + k] - odd;
+                        data[start + k] += odd;
+                    }
+                }
+            }
+        }
+
+    private:
+        std::vector<int> bitReversed;
+        std::vector<std::complex<float>> twiddles;
+    };
+
+    /** triangular filters on the mel scale, each stored from its first non-zero bin */
+    struct MelFilter
+    {
+        int firstBin = 0;
+        std::vector<float> weights;
+    };
+
+    std::vector<MelFilter> makeMelFilters(double sampleRate)
+    {
+        auto toMel = [](double hz) { return 2595.0 * std::log10(1.0 + hz / 700.0); };
+        auto toHz = [](double mel) { return 700.0 * (std::pow(10.0, mel / 2595.0) - 1.0); };
+
+        const double lowMel = toMel(20.0);
+        const double highMel = toMel(jmin(8000.0, sampleRate / 2));
+        const double binHz = sampleRate / fftSize;
+
+        double edges[numMelBands + 2];
+        for (int i = 0; i < numMelBands + 2; ++i)
+            edges[i] = toHz(lowMel + (highMel - lowMel) * i / (numMelBands + 1)) / binHz;
+
+        std::vector<MelFilter> filters((size_t)numMelBands);
+        for (int band = 0; band < numMelBands; ++band)
+        {
+            const double left = edges[band], centre = edges[band + 1], right = edges[band + 2];
+            MelFilter& filter = filters[(size_t)band];
+            filter.firstBin = (int)std::ceil(left);
+            for (int bin = filter.firstBin; bin <= (int)right && bin < numBins; ++bin)
+            {
+                const double weight = bin <= centre ? (bin - left) / jmax(1.0e-9, centre - left)
+                                                    : (right - bin) / jmax(1.0e-9, right - centre);
+                filter.weights.push_back((float)jmax(0.0, weight));
+            }
+        }
+        return filters;
+    }
+
+    float pearson(const float* a, const float* b, int n)
+    {
+        float meanA = 0, meanB = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            meanA += a[i];
+            meanB += b[i];
+        }
+        meanA /= n;
+        meanB /= n;
+
+        float covariance = 0, varA = 0, varB = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            covariance += (a[i] - meanA) * (b[i] - meanB);
+            varA += (a[i] - meanA) * (a[i] - meanA);
+            varB += (b[i] - meanB) * (b[i] - meanB);
+        }
+        return varA > 0 && varB > 0 ? covariance / std::sqrt(varA * varB) : 0.0f;
+    }
+
+    /** the tempo with the strongest periodicity in the onset envelope, leaning towards 120 BPM; 0 if there is none */
+    float estimateTempo(std::vector<float> onsets, double frameRate)
+    {
+        if (onsets.size() < 64)
+            return 0;
+
+        float mean = 0;
+        for (float o : onsets)
+            mean += o;
+        mean /= (float)onsets.size();
+        for (float& o : onsets)
+            o -= mean;
+
+        const int minLag = jmax(1, (int)std::floor(frameRate * 60.0 / 200.0));
+        const int maxLag = jmin((int)onsets.size() / 2, (int)std::ceil(frameRate * 60.0 / 60.0));
+        if (maxLag <= minLag + 1)
+            return 0;
+
+        std::vector<float> correlation((size_t)maxLag + 2, 0.0f);
+        for (int lag = minLag - 1; lag <= maxLag + 1; ++lag)
+        {
+            float sum = 0;
+            for (size_t i = (size_t)lag; i < onsets.size(); ++i)
+                sum += onsets[i] * onsets[i - (size_t)lag];
+            correlation[(size_t)lag] = sum;
+        }
+
+        int bestLag = -1;
+        float bestScore = 0;
+        for (int lag = minLag; lag <= maxLag; ++lag)
+        {
+            // perceived tempo sits around 120 BPM, an octave either way is less likely
+            const double octaves = std::log2(60.0 * frameRate / lag / 120.0);
+            const float score = correlation[(size_t)lag] * (float)std::exp(-0.5 * octaves * octaves);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestLag = lag;
+            }
+        }
+        if (bestLag < 0)
+            return 0;
+
+        // parabolic interpolation between the neighbouring lags
+        const float before = correlation[(size_t)bestLag - 1], at = correlation[(size_t)bestLag], after = correlation[(size_t)bestLag + 1];
+        const float denominator = before - 2 * at + after;
+        const float offset = denominator < 0 ? jlimit(-0.5f, 0.5f, 0.5f * (before - after) / denominator) : 0.0f;
+        return jlimit(60.0f, 200.0f, (float)(60.0 * frameRate / (bestLag + offset)));
+    }
+
+    /** the best of the 24 major and minor keys for a chroma vector, -1 if it is silent */
+    int estimateKey(const float* chroma)
+    {
+        float total = 0;
+        for (int i = 0; i < 12; ++i)
+            total += chroma[i];
+        if (total <= 0)
+            return -1;
+
+        int bestKey = -1;
+        float bestCorrelation = -2;
+        for (int tonic = 0; tonic < 12; ++tonic)
+        {
+            float major[12], minor[12];
+            for (int i = 0; i < 12; ++i)
+            {
+                major[i] = majorProfile[(i - tonic + 12) % 12];
+                minor[i] = minorProfile[(i - tonic + 12) % 12];
+            }
+
+            const float majorCorrelation = pearson(chroma, major, 12);
+            const float minorCorrelation = pearson(chroma, minor, 12);
+            if (majorCorrelation > bestCorrelation)
+            {
+                bestCorrelation = majorCorrelation;
+                bestKey = tonic;
+            }
+            if (minorCorrelation > bestCorrelation)
+            {
+                bestCorrelation = minorCorrelation;
+                bestKey = 12 + tonic;
+            }
+        }
+        return bestKey;
+    }
+}
+
+//==============================================================================
+String TrackFeatures::getKeyName(int key)
+{
+    static const char* const names[] = { "C", "C#", "D", "Eb", "E", "F", "F#", "G", "Ab", "A", "Bb", "B" };
+    if (key < 0 || key >= 24)
+        return {};
+    return String(names[key % 12]) + (key >= 12 ? "m" : "");
+}
+
+const float* TrackFeatures::getWeights()
+{
+    static const float* const weights = []
+    {
+        static float w[numDimensions];
+        const int groupSizes[] = { 1, 3, 1, 2, numContrastBands, numCoefficients, numSpreadCoefficients };
+        int dimension = 0;
+        for (int size : groupSizes)
+            for (int i = 0; i < size; ++i)
+                w[dimension++] = 1.0f / std::sqrt((float)size);
+        jassert(dimension == numDimensions);
+        return w;
+    }();
+    return weights;
+}
+
+//==============================================================================
+bool FeatureExtractor::extract(AudioFormatReader& reader, TrackFeatures& features, std::function<bool()> shouldStop)
+{
+    features = TrackFeatures();
+    if (reader.sampleRate <= 0 || reader.lengthInSamples <= 0)
+        return false;
+
+    // mono, averaged down to somewhere near 22 kHz
+    const int decimation = jmax(1, roundToInt(reader.sampleRate / 22050.0));
+    const double sampleRate = reader.sampleRate / decimation;
+
+    const int64 windowLength = jmin(reader.lengthInSamples, (int64)(windowSecs * reader.sampleRate));
+    const int64 start = jmax((int64)0, reader.lengthInSamples / 2 - windowLength / 2);
+    if (windowLength / decimation < fftSize * 8)
+        return false;
+
+    std::vector<float> mono;
+    mono.reserve((size_t)(windowLength / decimation));
+    {
+        const int numChannels = jlimit(1, 2, (int)reader.numChannels);
+        const int blockSize = 65536 - 65536 % decimation;
+        AudioBuffer<float> block(numChannels, blockSize);
+        for (int64 done = 0; done + decimation <= windowLength;)
+        {
+            if (shouldStop != nullptr && shouldStop())
+                return false;
+
+            const int numSamples = (int)jmin((int64)blockSize, windowLength - done);
+            reader.read(&block, 0, numSamples, start + done, true, numChannels > 1);
+            for (int i = 0; i + decimation <= numSamples; i += decimation)
+            {
+                float sum = 0;
+                for (int channel = 0; channel < numChannels; ++channel)
+                    for (int j = 0; j < decimation; ++j)
+                        sum += block.getSample(channel, i + j);
+                mono.push_back(sum / (float)(numChannels * decimation));
+            }
+            done += numSamples;
+        }
+    }
+
+    //==============================================================================
+    const Fft fft;
+    const std::vector<MelFilter> melFilters = makeMelFilters(sampleRate);
+    const double binHz = sampleRate / fftSize;
+
+    float window[fftSize];
+    for (int i = 0; i < fftSize; ++i)
+        window[i] = 0.5f - 0.5f * std::cos(MathConstants<float>::twoPi * (float)i / (float)fftSize);
+
+    float dct[numCoefficients][numMelBands];
+    for (int n = 0; n < numCoefficients; ++n)
+        for (int m = 0; m < numMelBands; ++m)
+            dct[n][m] = (float)std::cos(MathConstants<double>::pi * (n + 1) * (m + 0.5) / numMelBands);
+
+    int pitchClass[numBins];
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const double hz = bin * binHz;
+        pitchClass[bin] = hz < 60.0 || hz > 5000.0 ? -1 : ((roundToInt(12.0 * std::log2(hz / 440.0)) + 9) % 12 + 12) % 12;
+    }
+
+    int contrastEdges[numContrastBands + 1];
+    for (int band = 0; band < numContrastBands; ++band)
+        contrastEdges[band] = band == 0 ? 1 : jmin(numBins - 1, (int)(100.0 * (1 << band) / binHz));
+    contrastEdges[numContrastBands] = numBins;
+
+    std::vector<std::complex<float>> spectrum((size_t)fftSize);
+    std::vector<float> magnitudes((size_t)numBins), previousLog((size_t)numBins, 0.0f), scratch;
+    std::vector<float> onsets;
+
+    double centroidSum = 0, centroidSumSq = 0;
+    double contrastSum[numContrastBands] = {};
+    double coefficientSum[numCoefficients] = {}, coefficientSumSq[numCoefficients] = {};
+    float chroma[12] = {};
+    int numVoiced = 0;
+
+    const float scale = 4.0f / fftSize;     // a full-scale sine comes out near 1
+    for (size_t frame = 0; frame + fftSize <= mono.size(); frame += hopSize)
+    {
+        if ((frame / hopSize) % 256 == 0 && shouldStop != nullptr && shouldStop())
+            return false;
+
+        for (int i = 0; i < fftSize; ++i)
+            spectrum[(size_t)i] = std::complex<float>(mono[frame + (size_t)i] * window[i], 0.0f);
+        fft.perform(spectrum.data());
+
+        float magnitudeSum = 0, weightedSum = 0, flux = 0;
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            const float magnitude = std::abs(spectrum[(size_t)bin]) * scale;
+            magnitudes[(size_t)bin] = magnitude;
+            magnitudeSum += magnitude;
+            weightedSum += magnitude * (float)(bin * binHz);
+
+            const float compressed = std::log1p(100.0f * magnitude);
+            flux += jmax(0.0f, compressed - previousLog[(size_t)bin]);
+            previousLog[(size_t)bin] = compressed;
+
+            if (pitchClass[bin] >= 0)
+                chroma[pitchClass[bin]] += magnitude;
+        }
+        onsets.push_back(flux);
+
+        // silence has no timbre worth averaging
+        if (magnitudeSum < 1.0e-4f)
+            continue;
+        ++numVoiced;
+
+        const double centroid = weightedSum / magnitudeSum;
+        centroidSum += centroid;
+        centroidSumSq += centroid * centroid;
+
+        for (int band = 0; band < numContrastBands; ++band)
+        {
+            scratch.assign(magnitudes.begin() + contrastEdges[band], magnitudes.begin() + contrastEdges[band + 1]);
+            // the quietest fifth to the front and the loudest to the back, unsorted within
+            const size_t count = jmax((size_t)1, scratch.size() / 5);
+            std::nth_element(scratch.begin(), scratch.begin() + (std::ptrdiff_t)count, scratch.end());
+            std::nth_element(scratch.begin() + (std::ptrdiff_t)count, scratch.end() - (std::ptrdiff_t)count, scratch.end());
+            float valley = 0, peak = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                valley += scratch[i];
+                peak += scratch[scratch.size() - 1 - i];
+            }
+            contrastSum[band] += 20.0 * std::log10((peak + 1.0e-6) / (valley + 1.0e-6));
+        }
+
+        float logMel[numMelBands];
+        for (int band = 0; band < numMelBands; ++band)
+        {
+            const MelFilter& filter = melFilters[(size_t)band];
+            float energy = 0;
+            for (size_t i = 0; i < filter.weights.size(); ++i)
+            {
+                const float magnitude = magnitudes[(size_t)filter.firstBin + i];
+                energy += filter.weights[i] * magnitude * magnitude;
+            }
+            logMel[band] = std::log(energy + 1.0e-10f);
+        }
+        for (int n = 0; n < numCoefficients; ++n)
+        {
+            float coefficient = 0;
+            for (int m = 0; m < numMelBands; ++m)
+                coefficient += dct[n][m] * logMel[m];
+            coefficientSum[n] += coefficient;
+            coefficientSumSq[n] += (double)coefficient * coefficient;
+        }
+    }
+
+    if (numVoiced == 0)
+        return false;
+
+    //==============================================================================
+    double sumSq = 0;
+    for (float sample : mono)
+        sumSq += (double)sample * sample;
+    features.loudnessDb = (float)Decibels::gainToDecibels(std::sqrt(sumSq / (double)mono.size()), -100.0);
+    features.bpm = estimateTempo(std::move(onsets), sampleRate / hopSize);
+    features.key = estimateKey(chroma);
+
+    auto spread = [](double sum, double sumSq, int n)
+    {
+        const double mean = sum / n;
+        return (float)std::sqrt(jmax(0.0, sumSq / n - mean * mean));
+    };
+
+    float* v = features.values;
+    *v++ = features.bpm > 0 ? features.bpm : 120.0f;
+
+    if (features.key >= 0)
+    {
+        // relative majors and minors share a place on the circle of fifths
+        const int major = features.key < 12 ? features.key : (features.key + 3) % 12;
+        const float angle = MathConstants<float>::twoPi * (float)((major * 7) % 12) / 12.0f;
+        *v++ = std::cos(angle);
+        *v++ = std::sin(angle);
+        *v++ = features.key < 12 ? 1.0f : 0.0f;
+    }
+    else
+    {
+        *v++ = 0;
+        *v++ = 0;
+        *v++ = 0.5f;
+    }
+
+    *v++ = features.loudnessDb;
+    *v++ = (float)(centroidSum / numVoiced);
+    *v++ = spread(centroidSum, centroidSumSq, numVoiced);
+    for (int band = 0; band < numContrastBands; ++band)
+        *v++ = (float)(contrastSum[band] / numVoiced);
+    for (int n = 0; n < numCoefficients; ++n)
+        *v++ = (float)(coefficientSum[n] / numVoiced);
+    for (int n = 0; n < numSpreadCoefficients; ++n)
+        *v++ = spread(coefficientSum[n], coefficientSumSq[n], numVoiced);
+
+    jassert(v == features.values + TrackFeatures::numDimensions);
+    return true;
+}
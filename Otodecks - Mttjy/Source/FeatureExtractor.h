@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    FeatureExtractor.h
+    Created: 20 Oct 2026 3:24:51am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** what a track sounds like, in a form that can be compared by distance */
+struct TrackFeatures
+{
+    static constexpr int numDimensions = 32;
+
+    /** 0-11 C to B major, 12-23 C to B minor */
+    static String getKeyName(int key);
+
+    /** one weight per dimension, so every group (tempo, key, loudness,
+        centroid, contrast, MFCC means, MFCC spreads) counts the same once
+        each dimension has been scaled to unit variance */
+    static const float* getWeights();
+
+    float values[numDimensions] = {};
+    float bpm = 0;
+    int key = -1;
+    float loudnessDb = 0;
+};
+
+//==============================================================================
+/*
+    Works out a track's TrackFeatures from up to 90 seconds around its
+    middle, mixed to mono and halved to about 22 kHz:
+
+        0       tempo, from the autocorrelation of the spectral flux
+        1-3     key on the circle of fifths (cos, sin) and its mode, from
+                the chroma matched against Krumhansl's key profiles
+        4       loudness (RMS)
+        5-6     spectral centroid, mean and spread
+        7-12    spectral contrast in six octave bands
+        13-25   MFCCs 1-13, mean
+        26-31   MFCCs 1-6, spread
+
+    The FFT is a plain radix-2 one; at 2048 points it is nowhere near the
+    cost of decoding the audio.
+*/
+class FeatureExtractor
+{
+public:
+    /** analyse a track in the caller's thread; false if it is too short or shouldStop() said so */
+    static bool extract(AudioFormatReader& reader, TrackFeatures& features, std::function<bool()> shouldStop = nullptr);
+};
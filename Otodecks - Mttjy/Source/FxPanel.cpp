@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    FxPanel.cpp
+    Created: 19 Oct 2026 11:41:08pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "FxPanel.h"
+
+//==============================================================================
+FxPanel::FxPanel(DeckFx& _fx)
+    : fx(_fx)
+{
+    for (int e = 0; e < DeckFx::numEffects; ++e)
+    {
+        const auto effect = (DeckFx::Effect)e;
+        Row& row = rows[e];
+
+        addAndMakeVisible(row.toggle);
+        row.toggle.setButtonText(DeckFx::getEffectName(effect));
+        row.toggle.setToggleState(fx.isEnabled(effect), dontSendNotification);
+        row.toggle.onClick = [this, effect, &row] { fx.setEnabled(effect, row.toggle.getToggleState()); };
+
+        addAndMakeVisible(row.wet);
+        row.wet.setSliderStyle(Slider::LinearHorizontal);
+        row.wet.setTextBoxStyle(Slider::NoTextBox, true, 0, 0);
+        row.wet.setRange(0.0, 1.0);
+        row.wet.setValue(fx.getWet(effect), dontSendNotification);
+        row.wet.setTooltip("Dry/wet");
+        row.wet.onValueChange = [this, effect, &row] { fx.setWet(effect, (float)row.wet.getValue()); };
+
+        for (int p = 0; p < DeckFx::numParameters; ++p)
+        {
+            Slider& slider = row.parameters[p];
+            addAndMakeVisible(slider);
+            slider.setSliderStyle(Slider::RotaryVerticalDrag);
+            slider.setTextBoxStyle(Slider::NoTextBox, true, 0, 0);
+            slider.setColour(Slider::ColourIds::rotarySliderFillColourId, Colours::orange.withAlpha(0.5f));
+            slider.setRange(0.0, 1.0);
+            slider.setValue(fx.getParameter(effect, p), dontSendNotification);
+            slider.setDoubleClickReturnValue(true, 0.5);
+            slider.setTooltip(DeckFx::getParameterName(effect, p));
+            slider.onValueChange = [this, effect, p, &slider] { fx.setParameter(effect, p, (float)slider.getValue()); };
+        }
+    }
+}
+
+FxPanel::~FxPanel()
+{
+}
+
+void FxPanel::paint (Graphics& g)
+{
+    g.fillAll(Colour::fromRGB(15, 15, 15));
+}
+
+void FxPanel::resized()
+{
+    const int rowH = getHeight() / DeckFx::numEffects;
+    const int knob = jmax(0, rowH - 2);
+    const int toggleW = 72;
+    const int wetW = jmax(0, getWidth() - toggleW - 2 * knob - 8);
+
+    for (int e = 0; e < DeckFx::numEffects; ++e)
+    {
+        Row& row = rows[e];
+        const int y = e * rowH;
+        row.toggle.setBounds(0, y, toggleW, rowH);
+        row.wet.setBounds(toggleW, y, wetW, rowH);
+        for (int p = 0; p < DeckFx::numParameters; ++p)
+            row.parameters[p].setBounds(toggleW + wetW + 4 + p * (knob + 4), y + 1, knob, knob);
+    }
+}
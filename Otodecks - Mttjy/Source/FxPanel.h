@@ -0,0 +1,42 @@
+/*
+  ==============================================================================
+
+    FxPanel.h
+    Created: 19 Oct 2026 11:41:08pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DeckFx.h"
+
+//==============================================================================
+/*
+    One row per effect of a deck's rack: on/off, dry/wet and the effect's
+    two parameters. Every control writes straight to the rack's atomics.
+*/
+class FxPanel  : public Component
+{
+public:
+    FxPanel(DeckFx& fx);
+    ~FxPanel() override;
+
+    void paint (Graphics&) override;
+    void resized() override;
+
+private:
+    struct Row
+    {
+        ToggleButton toggle;
+        Slider wet;
+        Slider parameters[DeckFx::numParameters];
+    };
+
+    DeckFx& fx;
+    Row rows[DeckFx::numEffects];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FxPanel)
+};
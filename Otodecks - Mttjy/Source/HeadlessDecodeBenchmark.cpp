@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+    HeadlessDecodeBenchmark.cpp
+    Created: 20 Oct 2026 8:13:49am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "DecodeCache.h"
+#include <iostream>
+
+/*
+    --bench-decode puts a track through the decode cache (see DecodeCache)
+    and plays it on --decks decks at once, each pulling 512-sample blocks,
+    first from the original and then from the memory-mapped copy. It
+    prints the decode time per block and deck, as a share of real time,
+    and the median and 99th percentile time for a seek to land and play
+    its first block. It exits with 1 if the copy's samples differ from
+    the original's by more than a 16-bit copy can account for.
+*/
+namespace
+{
+    int runDecodeBenchmark(const HeadlessRunner::Args& args)
+    {
+        const File file = args.getFile("--bench-decode");
+        const int numDecks = jlimit(1, 64, args.getOption("--decks", "2").getIntValue());
+        const double seconds = jmax(1.0, args.getOption("--seconds", "30").getDoubleValue());
+        const int blockSize = 512;
+        const int numSeeks = 200;
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        std::unique_ptr<AudioFormatReader> original(formatManager.createReaderFor(file));
+        if (original == nullptr)
+        {
+            std::cerr << "can't read " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        auto msSince = [](int64 start) { return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) * 1000.0; };
+
+        TemporaryFile copy(".wav");
+        const int64 decodeStart = Time::getHighResolutionTicks();
+        if (!DecodeCache::decode(*original, copy.getFile()))
+        {
+            std::cerr << "couldn't decode into " << copy.getFile().getFullPathName() << std::endl;
+            return 1;
+        }
+        const double decodeMs = msSince(decodeStart);
+
+        const double sampleRate = original->sampleRate;
+        const int64 length = original->lengthInSamples;
+        if (length < blockSize * 4)
+        {
+            std::cerr << "track too short to measure" << std::endl;
+            return 1;
+        }
+
+        using OpenReader = std::function<std::unique_ptr<AudioFormatReader>()>;
+        const OpenReader openOriginal = [&] { return std::unique_ptr<AudioFormatReader>(formatManager.createReaderFor(file)); };
+        const OpenReader openCached = [&] { return DecodeCache::openCopy(copy.getFile()); };
+
+        struct Result
+        {
+            double usPerBlock = 0;
+            double seekMedianMs = 0;
+            double seekP99Ms = 0;
+        };
+
+        // each deck plays from its own place in the track, one block at a time as the
+        // audio callback would pull it, then the seeks land anywhere at random
+        auto measure = [&](const OpenReader& open)
+        {
+            Result result;
+            OwnedArray<AudioFormatReaderSource> decks;
+            for (int deck = 0; deck < numDecks; ++deck)
+            {
+                decks.add(new AudioFormatReaderSource(open().release(), true));
+                decks.getLast()->prepareToPlay(blockSize, sampleRate);
+                decks.getLast()->setLooping(true);
+                decks.getLast()->setNextReadPosition(length * deck / numDecks);
+            }
+
+            AudioBuffer<float> buffer(2, blockSize);
+            const int64 numBlocks = (int64)(seconds * sampleRate / blockSize);
+            const int64 start = Time::getHighResolutionTicks();
+            for (int64 i = 0; i < numBlocks; ++i)
+                for (auto* deck : decks)
+                {
+                    AudioSourceChannelInfo info(&buffer, 0, blockSize);
+                    deck->getNextAudioBlock(info);
+                }
+            result.usPerBlock = msSince(start) * 1000.0 / (double)(numBlocks * numDecks);
+
+            Random random(1);
+            std::vector<double> seekMs;
+            for (int seek = 0; seek < numSeeks; ++seek)
+            {
+                auto* deck = decks[seek % numDecks];
+                const int64 seekStart = Time::getHighResolutionTicks();
+                deck->setNextReadPosition((int64)(random.nextDouble() * (double)(length - blockSize)));
+                AudioSourceChannelInfo info(&buffer, 0, blockSize);
+                deck->getNextAudioBlock(info);
+                seekMs.push_back(msSince(seekStart));
+            }
+            std::sort(seekMs.begin(), seekMs.end());
+            result.seekMedianMs = seekMs[seekMs.size() / 2];
+            result.seekP99Ms = seekMs[(seekMs.size() * 99) / 100];
+
+            for (auto* deck : decks)
+                deck->releaseResources();
+            return result;
+        };
+
+        const Result before = measure(openOriginal);
+        const Result after = measure(openCached);
+
+        // the copy must hold what the decoder produces, to within a 16-bit step, clipped to full scale
+        std::unique_ptr<AudioFormatReader> a = openOriginal(), b = openCached();
+        const int channels = (int)a->numChannels;
+        const float tolerance = 2.0f / 32768.0f;
+        AudioBuffer<float> blockA(channels, 65536), blockB(channels, 65536);
+        float maxDifference = b == nullptr || b->lengthInSamples != length ? 1.0f : 0.0f;
+        for (int64 pos = 0; pos < length && maxDifference <= tolerance; pos += blockA.getNumSamples())
+        {
+            const int n = (int)jmin((int64)blockA.getNumSamples(), length - pos);
+            a->read(&blockA, 0, n, pos, true, true);
+            b->read(&blockB, 0, n, pos, true, true);
+            for (int ch = 0; ch < channels; ++ch)
+                for (int i = 0; i < n; ++i)
+                    maxDifference = jmax(maxDifference, std::abs(jlimit(-1.0f, 1.0f, blockA.getSample(ch, i)) - blockB.getSample(ch, i)));
+        }
+
+        const double blockUs = blockSize * 1.0e6 / sampleRate;
+        auto row = [&](const char* name, const Result& result)
+        {
+            std::cout << name << String(result.usPerBlock, 1).paddedLeft(' ', 8) << " us/block "
+                      << String(100.0 * result.usPerBlock / blockUs, 2).paddedLeft(' ', 6) << "% of real time   seek "
+                      << String(result.seekMedianMs, 3) << " ms median, " << String(result.seekP99Ms, 3) << " ms p99\n";
+        };
+        std::cout << file.getFileName() << ": " << String(length / sampleRate, 1) << " s, " << numDecks << " decks, "
+                  << blockSize << "-sample blocks\n"
+                  << "ingest decode       " << String(decodeMs, 1) << " ms to a " << String(copy.getFile().getSize() / 1.0e6, 1)
+                  << " MB copy (" << String(file.getSize() / 1.0e6, 1) << " MB original)\n";
+        row("original (per deck)", before);
+        row("cached   (per deck)", after);
+        std::cout << (maxDifference <= tolerance ? "cached samples match the original decode to within " + String(maxDifference)
+                                                 : "cached samples DIFFER by up to " + String(maxDifference)) << std::endl;
+        return maxDifference <= tolerance ? 0 : 1;
+    }
+
+    const HeadlessRunner::Mode mode{ "--bench-decode",
+        "<audio file> [--decks <n>] [--seconds <s>]",
+        runDecodeBenchmark };
+}
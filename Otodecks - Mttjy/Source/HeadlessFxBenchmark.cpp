@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    HeadlessFxBenchmark.cpp
+    Created: 20 Oct 2026 8:07:02am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "DeckFx.h"
+#include <iostream>
+
+/*
+    --bench-fx times each deck effect on its own at 44.1, 48 and 96 kHz with
+    blocks of 32 to 1024 samples, and prints the mean and the worst cost per
+    block as a share of the time the block lasts. Each effect is switched
+    off and on again every half second, and the blocks it fades out and
+    comes back on in are timed with the rest.
+*/
+namespace
+{
+    int runFxBenchmark(const HeadlessRunner::Args& args)
+    {
+        const double seconds = jmax(0.1, args.getOption("--seconds", "2").getDoubleValue());
+        const double sampleRates[] = { 44100.0, 48000.0, 96000.0 };
+        const int blockSizes[] = { 32, 64, 128, 256, 512, 1024 };
+
+        Random random(1);
+        AudioBuffer<float> noise(2, 1024);
+        for (int ch = 0; ch < noise.getNumChannels(); ++ch)
+            for (int i = 0; i < noise.getNumSamples(); ++i)
+                noise.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        std::cout << "each effect alone at 50% wet, parameters at half way, on white noise\n"
+                  << "effect     rate    block   us/block   worst us   % of block time (mean, worst)" << std::endl;
+
+        for (int e = 0; e < DeckFx::numEffects; ++e)
+        {
+            const auto effect = (DeckFx::Effect)e;
+            for (double sampleRate : sampleRates)
+            {
+                for (int blockSize : blockSizes)
+                {
+                    DeckFx fx;
+                    fx.prepare(sampleRate, blockSize);
+                    fx.setWet(effect, 0.5f);
+
+                    // off for the last block of each cycle, which it fades out in, and
+                    // back on for the first, the switch-on the app's users hear
+                    const int blocksPerCycle = jmax(2, (int)(0.5 * sampleRate / blockSize));
+                    const int numBlocks = jmax(1, (int)(seconds * sampleRate / blockSize));
+                    AudioBuffer<float> buffer(2, blockSize);
+                    int64 ticks = 0, worstTicks = 0;
+                    for (int b = 0; b < numBlocks; ++b)
+                    {
+                        if (b % blocksPerCycle == 0)
+                            fx.setEnabled(effect, true);
+                        else if (b % blocksPerCycle == blocksPerCycle - 1)
+                            fx.setEnabled(effect, false);
+
+                        for (int ch = 0; ch < 2; ++ch)
+                            buffer.copyFrom(ch, 0, noise, ch, 0, blockSize);
+
+                        const int64 start = Time::getHighResolutionTicks();
+                        fx.process(buffer, 0, blockSize);
+                        const int64 elapsed = Time::getHighResolutionTicks() - start;
+                        ticks += elapsed;
+                        worstTicks = jmax(worstTicks, elapsed);
+                    }
+
+                    const double usPerBlock = Time::highResolutionTicksToSeconds(ticks) * 1.0e6 / numBlocks;
+                    const double worstUs = Time::highResolutionTicksToSeconds(worstTicks) * 1.0e6;
+                    const double budgetUs = blockSize / sampleRate * 1.0e6;
+                    std::cout << DeckFx::getEffectName(effect).paddedRight(' ', 10)
+                              << String(sampleRate / 1000.0, 1).paddedRight(' ', 8)
+                              << String(blockSize).paddedRight(' ', 8)
+                              << String(usPerBlock, 2).paddedRight(' ', 11)
+                              << String(worstUs, 2).paddedRight(' ', 11)
+                              << String(usPerBlock / budgetUs * 100.0, 3) << ", "
+                              << String(worstUs / budgetUs * 100.0, 3) << std::endl;
+                }
+            }
+        }
+        return 0;
+    }
+
+    const HeadlessRunner::Mode mode{ "--bench-fx", "[--seconds <s>]", runFxBenchmark };
+}
@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+    HeadlessLimiterBenchmark.cpp
+    Created: 20 Oct 2026 8:14:36am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "Limiter.h"
+#include <array>
+#include <iostream>
+
+/*
+    --bench-limiter runs a Limiter over two decks' worth of overs at each
+    sample rate and block size, off (only its delay) and on, and prints the
+    time per block against the time the block lasts. That is the limiter's
+    CPU budget.
+
+    The final clip would hide any peak the limiter let through, so the
+    output isn't judged by its sample peak. It is metered 4x oversampled
+    over 48 taps, as BS.1770 measures true peak, with a Blackman window
+    where the Limiter's detector uses a Hann one, so the limiter isn't
+    checking itself. The two agree to a few hundredths of a dB. The mode
+    exits with 1 if the true peak went more than 0.05 dB over the ceiling,
+    or the clip caught anything past rounding.
+*/
+namespace
+{
+    /** the true peak of both channels, 4x oversampled: the samples and three points between each pair */
+    class TruePeakMeter
+    {
+    public:
+        explicit TruePeakMeter(int maximumBlockSize)
+            : input(2, numTaps - 1 + maximumBlockSize)
+        {
+            input.clear();
+
+            // a Blackman-windowed sinc per fractional position, scaled to unity gain at DC
+            const int centre = numTaps / 2 - 1;
+            for (int p = 0; p < numPhases; ++p)
+            {
+                const double fraction = (p + 1) / (double)(numPhases + 1);
+                double sum = 0;
+                for (int t = 0; t < numTaps; ++t)
+                {
+                    const double x = t - centre - fraction;
+                    const double sinc = std::sin(MathConstants<double>::pi * x) / (MathConstants<double>::pi * x);
+                    const double w = MathConstants<double>::pi * x / (numTaps / 2);
+                    const double window = 0.42 + 0.5 * std::cos(w) + 0.08 * std::cos(2.0 * w);
+                    coefficients[(size_t)p][(size_t)t] = (float)(sinc * window);
+                    sum += sinc * window;
+                }
+                for (auto& c : coefficients[(size_t)p])
+                    c = (float)(c / sum);
+            }
+        }
+
+        void add(const AudioBuffer<float>& buffer, int numSamples)
+        {
+            const int centre = numTaps / 2 - 1;
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                input.copyFrom(ch, numTaps - 1, buffer, ch, 0, numSamples);
+                float* history = input.getWritePointer(ch);
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    peak = jmax(peak, std::abs(history[i + centre]));
+                    for (auto& phase : coefficients)
+                    {
+                        float between = 0;
+                        for (int t = 0; t < numTaps; ++t)
+                            between += history[i + t] * phase[(size_t)t];
+                        peak = jmax(peak, std::abs(between));
+                    }
+                }
+
+                std::memmove(history, history + numSamples, sizeof(float) * (numTaps - 1));
+            }
+        }
+
+        float getPeak() const { return peak; }
+
+    private:
+        static constexpr int numTaps = 12;
+        static constexpr int numPhases = 3;
+
+        std::array<std::array<float, numTaps>, numPhases> coefficients{};
+        AudioBuffer<float> input;       // numTaps - 1 samples of history, then the block
+        float peak = 0;
+    };
+
+    int runLimiterBenchmark(const HeadlessRunner::Args& args)
+    {
+        const double seconds = jmax(0.1, args.getOption("--seconds", "2").getDoubleValue());
+        const double sampleRates[] = { 44100.0, 48000.0, 96000.0 };
+        const Array<int> blockSizes = args.getIntList("--blocks", { 16, 32, 64, 128, 256, 512 });
+
+        // two decks at full gain: a bass line and a lead over noise, peaking near 1.7
+        Random random(1);
+        const int signalLength = 1 << 16;
+        AudioBuffer<float> signal(2, signalLength);
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < signalLength; ++i)
+                signal.setSample(ch, i, 0.7f * std::sin(i * 0.0157f) + 0.7f * std::sin(i * (ch == 0 ? 0.327f : 0.331f))
+                                        + 0.3f * (random.nextFloat() * 2.0f - 1.0f));
+
+        std::cout << "two decks summed, peaking near +4.6 dBFS, ceiling -1 dBTP, 100 ms release\n"
+                  << "limiter    rate    block   us/block   % of block time   ns/sample   sample peak   true peak    clipped" << std::endl;
+
+        bool overCeiling = false;
+        for (int on = 0; on < 2; ++on)
+        {
+            for (double sampleRate : sampleRates)
+            {
+                for (int blockSize : blockSizes)
+                {
+                    Limiter limiter;
+                    limiter.prepare(sampleRate, blockSize);
+                    limiter.setEnabled(on == 1);
+
+                    const int numBlocks = jmax(1, (int)(seconds * sampleRate / blockSize));
+                    AudioBuffer<float> buffer(2, blockSize);
+                    int64 ticks = 0;
+                    float samplePeak = 0;
+                    TruePeakMeter truePeak(blockSize);
+                    for (int b = 0; b < numBlocks; ++b)
+                    {
+                        const int offset = (int)(((int64)b * blockSize) % (signalLength - blockSize));
+                        for (int ch = 0; ch < 2; ++ch)
+                            buffer.copyFrom(ch, 0, signal, ch, offset, blockSize);
+
+                        const int64 start = Time::getHighResolutionTicks();
+                        limiter.process(buffer, 0, blockSize);
+                        ticks += Time::getHighResolutionTicks() - start;
+
+                        for (int ch = 0; ch < 2; ++ch)
+                            samplePeak = jmax(samplePeak, buffer.getMagnitude(ch, 0, blockSize));
+                        truePeak.add(buffer, blockSize);
+                    }
+
+                    const double usPerBlock = Time::highResolutionTicksToSeconds(ticks) * 1.0e6 / numBlocks;
+                    const double budgetUs = blockSize / sampleRate * 1.0e6;
+                    const float samplePeakDb = Decibels::gainToDecibels(samplePeak);
+                    const float truePeakDb = Decibels::gainToDecibels(truePeak.getPeak());
+                    const int64 clipped = limiter.getNumClippedSamples();
+                    if (on == 1 && (truePeakDb > limiter.getCeilingDb() + 0.05f || clipped > 0))
+                        overCeiling = true;
+
+                    std::cout << String(on == 1 ? "on" : "off (delay)").paddedRight(' ', 11)
+                              << String(sampleRate / 1000.0, 1).paddedRight(' ', 8)
+                              << String(blockSize).paddedRight(' ', 8)
+                              << String(usPerBlock, 2).paddedRight(' ', 11)
+                              << String(usPerBlock / budgetUs * 100.0, 3).paddedRight(' ', 18)
+                              << String(usPerBlock * 1000.0 / blockSize, 1).paddedRight(' ', 12)
+                              << (String(samplePeakDb, 2) + " dBFS").paddedRight(' ', 14)
+                              << (String(truePeakDb, 2) + " dBTP").paddedRight(' ', 13)
+                              << clipped << std::endl;
+                }
+            }
+        }
+
+        if (overCeiling)
+            std::cout << "the limited output went over the ceiling, or the clip had to catch it" << std::endl;
+        return overCeiling ? 1 : 0;
+    }
+
+    const HeadlessRunner::Mode mode{ "--bench-limiter", "[--seconds <s>] [--blocks <n,n,...>]", runLimiterBenchmark };
+}
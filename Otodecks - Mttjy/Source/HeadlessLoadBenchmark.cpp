@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    HeadlessLoadBenchmark.cpp
+    Created: 20 Oct 2026 8:10:03am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "BandAnalyser.h"
+#include "DJAudioPlayer.h"
+#include "ReaderPool.h"
+#include <thread>
+#include <iostream>
+
+/*
+    --bench-load loads one track on deck 1, then deck 2, then deck 1 again,
+    the old way (fresh readers every time, the thumbnail decoding the file
+    on its own) and through the reader pool with one shared decode. It
+    prints the time to a finished waveform, the bytes read and the readers
+    opened for each load.
+*/
+namespace
+{
+    int runLoadBenchmark(const HeadlessRunner::Args& args)
+    {
+        const File file = args.getFile("--bench-load");
+        if (!file.existsAsFile())
+        {
+            std::cerr << "no such file: " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        const URL url{ file };
+        const int64 thumbHash = url.toString(true).hashCode64();
+        auto secondsSince = [](int64 start) { return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start); };
+
+        // deck 1 loads the track, deck 2 loads it too, then deck 1 loads it again
+        const int deckForLoad[] = { 0, 1, 0 };
+        const char* const loadNames[] = { "first load, deck 1", "same track, deck 2", "reload, deck 1    " };
+
+        struct Result
+        {
+            double ms[3] = {};
+            int64 bytes[3] = {};
+            int opened[3] = {};
+        };
+
+        // shared: pooled readers and one decode feeding the bands and the thumbnail. Otherwise the
+        // old way: fresh readers for every load, and the thumbnail decoding the file on its own
+        auto runLoads = [&](bool shared)
+        {
+            Result result;
+            ReaderPool readers(formatManager, shared ? 8 : 0);
+            BandAnalyser analyser(readers);
+            AudioThumbnailCache thumbCache(10);
+            DJAudioPlayer player1{ formatManager }, player2{ formatManager };
+            AudioThumbnail thumb1(BandWaveform::samplesPerColumn, formatManager, thumbCache);
+            AudioThumbnail thumb2(BandWaveform::samplesPerColumn, formatManager, thumbCache);
+            DJAudioPlayer* players[] = { &player1, &player2 };
+            AudioThumbnail* thumbs[] = { &thumb1, &thumb2 };
+            player1.setReaderPool(&readers);
+            player2.setReaderPool(&readers);
+
+            for (int load = 0; load < 3; ++load)
+            {
+                AudioThumbnail& thumb = *thumbs[deckForLoad[load]];
+                const ReaderPool::Stats startStats = readers.getStats();
+                const int64 start = Time::getHighResolutionTicks();
+
+                players[deckForLoad[load]]->loadURL(url);
+                const bool cached = thumbCache.loadThumb(thumb, thumbHash);
+                analyser.request(url, shared && !cached ? &thumb : nullptr);
+
+                // what AudioThumbnail::setSource did: a reader of its own on another thread
+                std::thread thumbnailThread;
+                if (!shared && !cached)
+                {
+                    thumbnailThread = std::thread([&]
+                    {
+                        std::unique_ptr<AudioFormatReader> reader = readers.acquire(url);
+                        if (reader == nullptr)
+                            return;
+                        thumb.reset((int)reader->numChannels, reader->sampleRate, reader->lengthInSamples);
+                        AudioBuffer<float> block((int)reader->numChannels, 65536);
+                        for (int64 pos = 0; pos < reader->lengthInSamples; pos += block.getNumSamples())
+                        {
+                            const int n = (int)jmin((int64)block.getNumSamples(), reader->lengthInSamples - pos);
+                            reader->read(&block, 0, n, pos, true, true);
+                            thumb.addBlock(pos, block, 0, n);
+                        }
+                    });
+                }
+
+                for (int waited = 0; analyser.getResult(url) == nullptr && waited < 120000; waited += 2)
+                    Thread::sleep(2);
+                if (thumbnailThread.joinable())
+                    thumbnailThread.join();
+                result.ms[load] = secondsSince(start) * 1000.0;
+                if (thumb.isFullyLoaded())
+                    thumbCache.storeThumb(thumb, thumbHash);
+
+                // let the scratch buffers' first fill land, so both sides count it
+                Thread::sleep(300);
+                result.bytes[load] = readers.getStats().bytesRead - startStats.bytesRead;
+                result.opened[load] = readers.getStats().numOpened - startStats.numOpened;
+            }
+
+            analyser.removeThumbnail(&thumb1);
+            analyser.removeThumbnail(&thumb2);
+            return result;
+        };
+
+        const Result before = runLoads(false);
+        const Result after = runLoads(true);
+
+        auto mb = [](int64 bytes) { return String(bytes / (1024.0 * 1024.0), 2) + " MB"; };
+        std::cout << file.getFileName() << " (" << mb(file.getSize()) << ")\n"
+                  << "                     before                          after\n";
+        for (int load = 0; load < 3; ++load)
+            std::cout << loadNames[load] << "   "
+                      << String(before.ms[load], 1).paddedLeft(' ', 7) << " ms " << mb(before.bytes[load]).paddedLeft(' ', 9)
+                      << " " << before.opened[load] << " opens      "
+                      << String(after.ms[load], 1).paddedLeft(' ', 7) << " ms " << mb(after.bytes[load]).paddedLeft(' ', 9)
+                      << " " << after.opened[load] << " opens\n";
+        std::cout << "(time until the coloured waveform is ready; bytes include the scratch buffers' first fill)" << std::endl;
+        return 0;
+    }
+
+    const HeadlessRunner::Mode mode{ "--bench-load", "<audio file>", runLoadBenchmark };
+}
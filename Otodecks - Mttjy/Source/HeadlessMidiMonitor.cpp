@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    HeadlessMidiMonitor.cpp
+    Created: 20 Oct 2026 8:05:31am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "MidiController.h"
+#include <iostream>
+
+/*
+    --midi-monitor drives two empty decks from the MIDI inputs and prints
+    every dispatched message with its latency. On Linux it also opens the
+    ALSA port "Otodecks", so a controller can be faked with e.g.
+    "aconnect 'Virtual Raw MIDI 1-0' Otodecks" and amidi, or sendmidi.
+*/
+namespace
+{
+    int runMidiMonitor(const HeadlessRunner::Args& args)
+    {
+        const double seconds = jmax(1.0, args.getOption("--seconds", "60").getDoubleValue());
+        const File mapping = args.getFile("--mapping", "midi_mapping.txt");
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        DJAudioPlayer player1{ formatManager };
+        DJAudioPlayer player2{ formatManager };
+        MixEngine engine;
+        engine.addDeck(&player1);
+        engine.addDeck(&player2);
+
+        // the decks only apply their queued commands when rendered, so keep a
+        // silent engine running at the real-time rate while listening
+        const int blockSize = 512;
+        const double sampleRate = 44100.0;
+        engine.prepareToPlay(blockSize, sampleRate);
+        AudioBuffer<float> buffer(2, blockSize);
+
+        MidiController controller(engine);
+        String error;
+        if (mapping.existsAsFile() && !controller.loadMapping(mapping, error))
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        controller.openInputs();
+
+        std::cout << controller.getBindings().size() << " bindings from " << mapping.getFullPathName() << "\n"
+                  << "listening on: " << controller.getOpenInputNames().joinIntoString(", ") << std::endl;
+
+        MidiController::Activity activity[256];
+        int numDispatched = 0;
+        double totalLatencyMs = 0, worstLatencyMs = 0;
+        int64 samplesRendered = 0;
+        const double startMs = Time::getMillisecondCounterHiRes();
+
+        while (Time::getMillisecondCounterHiRes() - startMs < seconds * 1000.0)
+        {
+            // read first, so the deck state printed below includes these messages
+            const int numRead = controller.readActivity(activity, 256);
+
+            const double elapsedSecs = (Time::getMillisecondCounterHiRes() - startMs) / 1000.0;
+            do
+            {
+                AudioSourceChannelInfo info(&buffer, 0, blockSize);
+                engine.getNextAudioBlock(info);
+                samplesRendered += blockSize;
+            }
+            while (samplesRendered < (int64)(elapsedSecs * sampleRate));
+
+            for (int i = 0; i < numRead; ++i)
+            {
+                const MidiController::Activity& a = activity[i];
+                const DJAudioPlayer* player = engine.getDeck(a.deck);
+                std::cout << "deck " << a.deck + 1 << " " << MidiController::getActionName(a.action)
+                          << " " << String(a.value, 4) << "  latency " << String(a.latencyMs, 3) << " ms"
+                          << "  (gain " << String(player->getGain(), 3) << ", speed " << String(player->getSpeed(), 4)
+                          << (player->isScratching() ? ", scratching)" : ")") << std::endl;
+
+                ++numDispatched;
+                totalLatencyMs += a.latencyMs;
+                worstLatencyMs = jmax(worstLatencyMs, a.latencyMs);
+            }
+
+            Thread::sleep(5);
+        }
+
+        controller.closeInputs();
+        engine.releaseResources();
+
+        std::cout << numDispatched << " messages dispatched";
+        if (numDispatched > 0)
+            std::cout << ", latency " << String(totalLatencyMs / numDispatched, 3) << " ms average, "
+                      << String(worstLatencyMs, 3) << " ms worst";
+        std::cout << std::endl;
+        return 0;
+    }
+
+    const HeadlessRunner::Mode mode{ "--midi-monitor", "[--seconds <s>] [--mapping <file>]", runMidiMonitor };
+}
@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    HeadlessPlaylistBenchmark.cpp
+    Created: 20 Oct 2026 8:04:52am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "PlaylistStore.h"
+#include <iostream>
+
+/*
+    --bench-playlists writes --lists playlists and crates of --entries
+    random tracks out of --tracks to a journal, opens it again, and times
+    switching the library between every list and saving one change.
+*/
+namespace
+{
+    int runPlaylistBenchmark(const HeadlessRunner::Args& args)
+    {
+        const int numLists = jmax(1, args.getOption("--lists", "500").getIntValue());
+        const int numEntries = jmax(1, args.getOption("--entries", "200").getIntValue());
+        const int numTracks = jmax(1, args.getOption("--tracks", "20000").getIntValue());
+
+        // the tracks never need to exist; the library only holds their paths
+        const File folder = File::getSpecialLocation(File::tempDirectory).getChildFile("otodecks_playlist_bench");
+        folder.deleteRecursively();
+        const File tracksFolder = folder.getChildFile("tracks");
+        const File storeFile = folder.getChildFile("playlists.otpl");
+
+        TrackLibrary library;
+        for (int i = 0; i < numTracks; ++i)
+            library.addTrack(tracksFolder.getChildFile("track " + String(i) + ".mp3"), 180.0);
+
+        auto secondsSince = [](int64 start) { return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start); };
+        String error;
+        Random random(1);
+
+        int64 start = Time::getHighResolutionTicks();
+        {
+            PlaylistStore store(storeFile, tracksFolder);
+            if (!store.open(error))
+            {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+
+            for (int l = 0; l < numLists; ++l)
+            {
+                Array<File> files;
+                for (int e = 0; e < numEntries; ++e)
+                    files.add(tracksFolder.getChildFile("track " + String(random.nextInt(numTracks)) + ".mp3"));
+
+                const auto id = store.createList("list " + String(l), l % 4 == 0 ? PlaylistStore::Kind::crate : PlaylistStore::Kind::playlist);
+                store.addTracks(id, files);
+            }
+        }
+        const double writeSecs = secondsSince(start);
+
+        start = Time::getHighResolutionTicks();
+        PlaylistStore store(storeFile, tracksFolder);
+        if (!store.open(error))
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        const double openSecs = secondsSince(start);
+
+        // the first switch resolves every key against the library; later ones are lookups
+        start = Time::getHighResolutionTicks();
+        store.bindLibrary(library);
+        library.setScope(store.resolve(store.getList(0).id));
+        const double firstSwitchSecs = secondsSince(start);
+
+        double worstSwitchSecs = 0;
+        start = Time::getHighResolutionTicks();
+        for (int i = 0; i < store.getNumLists(); ++i)
+        {
+            const int64 switchStart = Time::getHighResolutionTicks();
+            library.setScope(store.resolve(store.getList(i).id));
+            worstSwitchSecs = jmax(worstSwitchSecs, secondsSince(switchStart));
+        }
+        const double averageSwitchSecs = secondsSince(start) / store.getNumLists();
+
+        start = Time::getHighResolutionTicks();
+        store.addTracks(store.getList(0).id, { tracksFolder.getChildFile("track 0.mp3") });
+        const double saveSecs = secondsSince(start);
+
+        std::cout << store.getNumLists() << " lists x " << numEntries << " entries, " << numTracks << " tracks, "
+                  << String(storeFile.getSize() / 1024.0, 1) << " KB on disk\n"
+                  << "write all    " << String(writeSecs * 1000.0, 1) << " ms\n"
+                  << "open         " << String(openSecs * 1000.0, 3) << " ms\n"
+                  << "first switch " << String(firstSwitchSecs * 1000.0, 3) << " ms (resolves all keys)\n"
+                  << "switch       " << String(averageSwitchSecs * 1000.0, 3) << " ms average, "
+                  << String(worstSwitchSecs * 1000.0, 3) << " ms worst\n"
+                  << "save one     " << String(saveSecs * 1000.0, 3) << " ms" << std::endl;
+
+        store.close();
+        folder.deleteRecursively();
+        return 0;
+    }
+
+    const HeadlessRunner::Mode mode{ "--bench-playlists",
+        "[--lists <n>] [--entries <n>] [--tracks <n>]",
+        runPlaylistBenchmark };
+}
@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    HeadlessPreviewBenchmark.cpp
+    Created: 20 Oct 2026 8:15:20am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "PreviewCache.h"
+#include <iostream>
+
+/*
+    --bench-previews times building a playlist row's preview (see
+    PreviewCache) for the first tracks in a folder, against reading every
+    sample of them. It then scrolls through the whole folder a screen of
+    --rows a frame, the way the playlist paints, and prints how many
+    previews were requested, built and dropped as their rows went by. It
+    also prints the slowest cache lookup a paint made.
+*/
+namespace
+{
+    int runPreviewBenchmark(const HeadlessRunner::Args& args)
+    {
+        const File folder = args.getFile("--bench-previews");
+        const int numRows = jmax(1, args.getOption("--rows", "12").getIntValue());
+        const int frameMs = jmax(1, args.getOption("--frame-ms", "16").getIntValue());
+        auto msSince = [](int64 start) { return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) * 1000.0; };
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        Array<File> files = folder.findChildFiles(File::findFiles, true, formatManager.getWildcardForAllFormats());
+        files.sort();
+        if (files.isEmpty())
+        {
+            std::cerr << "no audio files in " << folder.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        // one preview at a time: windows from each column against reading every sample
+        const int numTimed = jmin(20, files.size());
+        double windowedMs = 0, fullMs = 0;
+        for (int i = 0; i < numTimed; ++i)
+        {
+            std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(files[i]));
+            if (reader == nullptr)
+                continue;
+
+            TrackPreview preview;
+            int64 start = Time::getHighResolutionTicks();
+            PreviewCache::build(*reader, preview);
+            windowedMs += msSince(start);
+
+            start = Time::getHighResolutionTicks();
+            Range<float> levels[2];
+            reader->readMaxLevels(0, reader->lengthInSamples, levels, jlimit(1, 2, (int)reader->numChannels));
+            fullMs += msSince(start);
+        }
+
+        // a fast scroll: the window moves a screenful every frame, painting as it goes
+        PreviewCache previews;
+        int numRequested = 0;
+        double slowestGetUs = 0;
+        const int64 scrollStart = Time::getHighResolutionTicks();
+        for (int first = 0; first < files.size(); first += numRows)
+        {
+            const Array<File> onScreen(files.begin() + first, jmin(numRows, files.size() - first));
+            previews.keepOnly(onScreen);
+            for (auto& file : onScreen)
+            {
+                const int64 start = Time::getHighResolutionTicks();
+                const bool built = previews.get(file) != nullptr;
+                slowestGetUs = jmax(slowestGetUs, msSince(start) * 1000.0);
+                if (!built)
+                {
+                    previews.request(file);
+                    ++numRequested;
+                }
+            }
+            Thread::sleep(frameMs);
+        }
+        const double scrollMs = msSince(scrollStart);
+
+        // whatever is on screen at the end is still wanted
+        for (int waited = 0; previews.getNumPending() > 0 && waited < 60000; waited += 10)
+            Thread::sleep(10);
+
+        int numBuilt = 0;
+        for (auto& file : files)
+            if (previews.get(file) != nullptr)
+                ++numBuilt;
+
+        std::cout << files.size() << " tracks in " << folder.getFullPathName() << "\n"
+                  << "preview             " << (int)sizeof(TrackPreview) << " bytes a track, "
+                  << String(windowedMs / jmax(1, numTimed), 1) << " ms to build against "
+                  << String(fullMs / jmax(1, numTimed), 1) << " ms to read every sample (" << numTimed << " tracks)\n"
+                  << "scroll              " << numRows << " rows a frame, " << String(scrollMs, 0) << " ms top to bottom, "
+                  << numRequested << " requested, " << numBuilt << " built, " << numRequested - numBuilt << " dropped\n"
+                  << "paint lookups       " << String(slowestGetUs, 1) << " us at worst" << std::endl;
+        return 0;
+    }
+
+    const HeadlessRunner::Mode mode{ "--bench-previews",
+        "<folder> [--rows <n>] [--frame-ms <ms>]",
+        runPreviewBenchmark };
+}
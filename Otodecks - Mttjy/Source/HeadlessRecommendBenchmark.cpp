@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    HeadlessRecommendBenchmark.cpp
+    Created: 20 Oct 2026 8:10:57am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "FeatureExtractor.h"
+#include "SimilarityIndex.h"
+#include <iostream>
+
+/*
+    --bench-recommend builds a similarity index over clustered random
+    feature vectors and times a thousand queries against it at 4, 8 and 16
+    probed lists, and against a scan of every vector, with the share of the
+    true ten nearest each one finds. With --file it also times the feature
+    extraction of one track and prints its tempo, key and vector.
+*/
+namespace
+{
+    int runRecommendBenchmark(const HeadlessRunner::Args& args)
+    {
+        constexpr int dims = TrackFeatures::numDimensions;
+        const int numTracks = jmax(100, args.getOption("--tracks", "100000").getIntValue());
+        const int numQueries = 1000;
+        const int k = 10;
+        auto msSince = [](int64 start) { return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) * 1000.0; };
+
+        if (args.contains("--file"))
+        {
+            const File file = args.getFile("--file");
+            AudioFormatManager formatManager;
+            formatManager.registerBasicFormats();
+            std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+            if (reader == nullptr)
+            {
+                std::cerr << "can't read " << file.getFullPathName() << std::endl;
+                return 1;
+            }
+
+            TrackFeatures features;
+            const int64 start = Time::getHighResolutionTicks();
+            const bool ok = FeatureExtractor::extract(*reader, features);
+            const double ms = msSince(start);
+            if (!ok)
+            {
+                std::cerr << "too short or silent: " << file.getFileName() << std::endl;
+                return 1;
+            }
+
+            String values;
+            for (float value : features.values)
+                values << String(value, 2) << " ";
+            std::cout << file.getFileName() << ": " << String(ms, 1) << " ms to extract, "
+                      << String(features.bpm, 1) << " BPM, key " << TrackFeatures::getKeyName(features.key) << ", "
+                      << String(features.loudnessDb, 1) << " dB\n" << values.trimEnd() << "\n" << std::endl;
+        }
+
+        // a library is lumpy: tracks bunch up around styles, so the vectors are too
+        Random random(2026);
+        const int numStyles = 200;
+        std::vector<float> styles((size_t)numStyles * dims), spreads(dims);
+        for (int d = 0; d < dims; ++d)
+            spreads[(size_t)d] = 0.5f + 4.0f * random.nextFloat();
+        for (auto& value : styles)
+            value = (random.nextFloat() * 2.0f - 1.0f) * 10.0f;
+
+        auto gaussian = [&random]
+        {
+            const float u = jmax(1.0e-7f, random.nextFloat());
+            return std::sqrt(-2.0f * std::log(u)) * std::cos(MathConstants<float>::twoPi * random.nextFloat());
+        };
+
+        std::vector<float> vectors((size_t)numTracks * dims);
+        std::vector<int> ids((size_t)numTracks);
+        for (int i = 0; i < numTracks; ++i)
+        {
+            const int style = random.nextInt(numStyles);
+            for (int d = 0; d < dims; ++d)
+                vectors[(size_t)i * dims + (size_t)d] = styles[(size_t)style * dims + (size_t)d] + spreads[(size_t)d] * gaussian();
+            ids[(size_t)i] = i;
+        }
+
+        SimilarityIndex index;
+        int64 start = Time::getHighResolutionTicks();
+        index.build(vectors.data(), ids.data(), numTracks);
+        const double buildMs = msSince(start);
+
+        std::vector<std::vector<float>> queries;
+        for (int q = 0; q < numQueries; ++q)
+        {
+            const float* track = vectors.data() + (size_t)random.nextInt(numTracks) * dims;
+            queries.emplace_back(track, track + dims);
+        }
+
+        // the exact answers, which the approximate ones are scored against
+        std::vector<std::vector<SimilarityIndex::Match>> exact;
+        std::vector<double> times;
+        for (auto& query : queries)
+        {
+            start = Time::getHighResolutionTicks();
+            exact.push_back(index.searchExact(query.data(), k));
+            times.push_back(msSince(start));
+        }
+
+        auto report = [&](const String& name, std::vector<double>& ms, double recall)
+        {
+            std::sort(ms.begin(), ms.end());
+            double total = 0;
+            for (double t : ms)
+                total += t;
+            std::cout << name.paddedRight(' ', 18)
+                      << String(total / (double)ms.size(), 3).paddedLeft(' ', 8) << " ms avg "
+                      << String(ms[ms.size() * 99 / 100], 3).paddedLeft(' ', 8) << " ms p99 "
+                      << String(recall * 100.0, 1).paddedLeft(' ', 6) << "% recall@" << k << "\n";
+        };
+
+        std::cout << numTracks << " tracks x " << dims << " floats (" << String(numTracks * dims * 4 / (1024.0 * 1024.0), 1)
+                  << " MB), " << index.getNumLists() << " lists, built in " << String(buildMs, 0) << " ms\n";
+        report("every vector", times, 1.0);
+
+        for (int probes : { 4, 8, 16 })
+        {
+            times.clear();
+            int found = 0;
+            for (size_t q = 0; q < queries.size(); ++q)
+            {
+                start = Time::getHighResolutionTicks();
+                const std::vector<SimilarityIndex::Match> matches = index.search(queries[q].data(), k, probes);
+                times.push_back(msSince(start));
+
+                for (auto& match : matches)
+                    for (auto& truth : exact[q])
+                        if (truth.id == match.id)
+                            ++found;
+            }
+            report(String(probes) + " lists probed", times, found / (double)(numQueries * k));
+        }
+        std::cout << "(the app probes 8)" << std::endl;
+        return 0;
+    }
+
+    const HeadlessRunner::Mode mode{ "--bench-recommend",
+        "[--tracks <n>] [--file <audio file>]",
+        runRecommendBenchmark };
+}
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    HeadlessRender.cpp
+    Created: 20 Oct 2026 8:02:11am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "OfflineRenderer.h"
+#include <iostream>
+
+/*
+    --render plays a mix script (see OfflineRenderer) through the decks and
+    the mixer as fast as they go and writes the master to a WAV. With
+    --record the master also goes through a MasterRecorder, whose buffer
+    and writer stall can be set to test it. --replay renders an engine
+    event log (see EngineEventLog) instead of a script: the deck commands
+    and effect settings, but not the cue or limiter settings, which the log
+    doesn't hold; the replay runs with their defaults. Both print the
+    samples per second, the real-time factor, the time each stage took
+    and the peak resident memory.
+*/
+namespace
+{
+    int runRender(const HeadlessRunner::Args& args, bool replay)
+    {
+        const String flag = replay ? "--replay" : "--render";
+        if (args.getArgument(flag, 2).isEmpty())
+        {
+            HeadlessRunner::printUsage();
+            return 1;
+        }
+
+        const File cwd = File::getCurrentWorkingDirectory();
+        OfflineRenderer::MixScript script;
+        String error;
+        const File input = cwd.getChildFile(args.getArgument(flag, 1));
+        if (!(replay ? OfflineRenderer::scriptFromEventLog(input, script, error)
+                     : OfflineRenderer::parseScript(input, script, error)))
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+
+        if (args.contains("--length"))
+            script.lengthSecs = args.getOption("--length").getDoubleValue();
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        OfflineRenderer renderer(formatManager);
+
+        MasterRecorder recorder;
+        if (args.contains("--record"))
+        {
+            if (args.contains("--record-buffer-secs"))
+                recorder.setBufferSeconds(args.getOption("--record-buffer-secs").getDoubleValue());
+            if (args.contains("--record-stall-ms"))
+                recorder.setWriterStallMs(args.getOption("--record-stall-ms").getIntValue());
+
+            renderer.setRecorder(&recorder, cwd.getChildFile(args.getOption("--record")));
+        }
+
+        if (!renderer.render(script, cwd.getChildFile(args.getArgument(flag, 2)), error))
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+
+        std::cout << renderer.getReport().toString(script.numDecks) << std::flush;
+        return 0;
+    }
+
+    const HeadlessRunner::Mode renderMode{ "--render",
+        "<mix script> <output.wav> [--record <file>] [--record-buffer-secs <s>] [--record-stall-ms <ms>]",
+        [](const HeadlessRunner::Args& args) { return runRender(args, false); } };
+    const HeadlessRunner::Mode replayMode{ "--replay",
+        "<event log> <output.wav> [--length <s>]  (cue and limiter settings aren't logged; defaults are used)",
+        [](const HeadlessRunner::Args& args) { return runRender(args, true); } };
+}
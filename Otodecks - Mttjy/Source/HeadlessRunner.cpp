@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+    HeadlessRunner.cpp
+    Created: 19 Oct 2026 5:35:44pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include <iostream>
+
+//==============================================================================
+HeadlessRunner::Args::Args(const String& commandLine)
+    : tokens(StringArray::fromTokens(commandLine, true))
+{
+    for (auto& token : tokens)
+        token = token.unquoted();
+}
+
+bool HeadlessRunner::Args::contains(const String& name) const
+{
+    return tokens.contains(name);
+}
+
+String HeadlessRunner::Args::getOption(const String& name, const String& defaultValue) const
+{
+    return getArgument(name, 1, defaultValue);
+}
+
+String HeadlessRunner::Args::getArgument(const String& name, int n, const String& defaultValue) const
+{
+    const int index = tokens.indexOf(name);
+    return (index >= 0 && index + n < tokens.size()) ? tokens[index + n] : defaultValue;
+}
+
+File HeadlessRunner::Args::getFile(const String& name, const String& defaultValue) const
+{
+    return File::getCurrentWorkingDirectory().getChildFile(getOption(name, defaultValue));
+}
+
+Array<int> HeadlessRunner::Args::getIntList(const String& name, const Array<int>& defaultValues) const
+{
+    if (!contains(name))
+        return defaultValues;
+
+    Array<int> values;
+    for (auto& value : StringArray::fromTokens(getOption(name), ",", {}))
+        if (value.getIntValue() > 0)
+            values.add(value.getIntValue());
+    return values;
+}
+
+const StringArray& HeadlessRunner::Args::getTokens() const
+{
+    return tokens;
+}
+
+//==============================================================================
+HeadlessRunner::Mode::Mode(const String& _flag, const String& _usage, Function _run)
+    : flag(_flag), usage(_usage), run(std::move(_run))
+{
+    getModes().add(this);
+}
+
+HeadlessRunner::Mode::~Mode()
+{
+    getModes().removeFirstMatchingValue(this);
+}
+
+Array<const HeadlessRunner::Mode*>& HeadlessRunner::getModes()
+{
+    // built while the statics in each mode's file are constructed, so it can't be a static member
+    static Array<const Mode*> modes;
+    return modes;
+}
+
+const HeadlessRunner::Mode* HeadlessRunner::findMode(const Args& args)
+{
+    // the first mode flag on the command line wins
+    for (auto& token : args.getTokens())
+        for (auto* mode : getModes())
+            if (token == mode->flag)
+                return mode;
+    return nullptr;
+}
+
+//==============================================================================
+bool HeadlessRunner::isHeadlessCommandLine(const String& commandLine)
+{
+    return findMode(Args(commandLine)) != nullptr;
+}
+
+HeadlessRunner::HeadlessRunner(const String& commandLine)
+    : Thread("Headless"), args(commandLine)
+{
+    startThread();
+}
+
+HeadlessRunner::~HeadlessRunner()
+{
+    // a mode that doesn't check shouldStop() gets its time to finish what it's writing
+    stopThread(10000);
+}
+
+bool HeadlessRunner::shouldStop()
+{
+    return Thread::currentThreadShouldExit();
+}
+
+void HeadlessRunner::run()
+{
+    const Mode* mode = findMode(args);
+    if (mode == nullptr)
+        printUsage();
+    const int result = mode != nullptr ? mode->run(args) : 1;
+
+    MessageManager::callAsync([result]
+    {
+        if (auto* app = JUCEApplicationBase::getInstance())
+        {
+            app->setApplicationReturnValue(result);
+            app->quit();
+        }
+    });
+}
+
+void HeadlessRunner::printUsage()
+{
+    Array<const Mode*> modes(getModes());
+    std::sort(modes.begin(), modes.end(), [](const Mode* a, const Mode* b) { return a->flag < b->flag; });
+
+    String usage;
+    for (auto* mode : modes)
+        usage << (usage.isEmpty() ? "usage: " : "       ") << "OtodecksFinal " << mode->flag << " " << mode->usage << "\n";
+    std::cerr << usage << std::flush;
+}
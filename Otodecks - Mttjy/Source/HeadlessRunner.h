@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    HeadlessRunner.h
+    Created: 19 Oct 2026 5:35:44pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <functional>
+
+//==============================================================================
+/*
+    Command-line modes that run without a window or an audio device, for
+    offline renders, benchmarks and tests on a headless box, e.g.
+
+        OtodecksFinal --render mix.txt out.wav
+        OtodecksFinal --stress --decks 8 --fast
+
+    Each mode lives in its own Headless*.cpp, with a comment saying what it
+    does, and adds itself to the list with a static Mode. Given a mode with
+    its arguments wrong, the app prints every mode's usage.
+
+    The mode runs on a thread of its own while the message loop carries on,
+    so anything it drives that posts change messages or async callbacks
+    behaves as it does in the app. When the mode returns, its result
+    becomes the process exit code and the app quits. A mode that runs until
+    stopped checks shouldStop().
+*/
+class HeadlessRunner  : private Thread
+{
+public:
+    //==============================================================================
+    /** the command line, with the helpers every mode parses its options with */
+    class Args
+    {
+    public:
+        explicit Args(const String& commandLine);
+
+        bool contains(const String& name) const;
+        /** the token after name, or defaultValue */
+        String getOption(const String& name, const String& defaultValue = {}) const;
+        /** the n-th token after name, or defaultValue */
+        String getArgument(const String& name, int n, const String& defaultValue = {}) const;
+        /** the option as a file, relative to the working directory */
+        File getFile(const String& name, const String& defaultValue = {}) const;
+        /** a comma-separated list of positive numbers, e.g. --blocks 64,128 */
+        Array<int> getIntList(const String& name, const Array<int>& defaultValues) const;
+
+        const StringArray& getTokens() const;
+
+    private:
+        StringArray tokens;
+    };
+
+    //==============================================================================
+    /** one mode: construct a static one in the mode's own file to add it to the list */
+    class Mode
+    {
+    public:
+        using Function = std::function<int(const Args&)>;
+
+        Mode(const String& flag, const String& usage, Function run);
+        ~Mode();
+
+        const String flag;
+        const String usage;
+        const Function run;
+
+        JUCE_DECLARE_NON_COPYABLE(Mode)
+    };
+
+    //==============================================================================
+    /** true if the app was launched to run one of the headless modes */
+    static bool isHeadlessCommandLine(const String& commandLine);
+
+    /** call from the app's initialise(): starts the mode on its own thread */
+    explicit HeadlessRunner(const String& commandLine);
+    /** asks a mode that is still running to stop, and waits for it */
+    ~HeadlessRunner() override;
+
+    /** from a mode's thread: true once the app is quitting */
+    static bool shouldStop();
+
+    static void printUsage();
+
+private:
+    void run() override;
+
+    static Array<const Mode*>& getModes();
+    static const Mode* findMode(const Args& args);
+
+    const Args args;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HeadlessRunner)
+};
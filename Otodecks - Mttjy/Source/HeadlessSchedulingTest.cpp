@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+    HeadlessSchedulingTest.cpp
+    Created: 20 Oct 2026 8:06:15am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "MixEngine.h"
+#include <iostream>
+
+/*
+    --test-scheduling plays a generated ramp through the engine with odd
+    block sizes, quantizes play, a cue jump, a loop toggle and a stop to
+    the grid, and checks each lands on its exact sample. The master
+    limiter stays on, as in the app, so each check looks at the output the
+    engine's latency later. It exits with 1 if any check fails.
+*/
+namespace
+{
+    int runSchedulingTest(const HeadlessRunner::Args& args)
+    {
+        const double sampleRate = 44100.0;
+        const int blockSize = jmax(1, args.getOption("--block", "333").getIntValue());
+
+        // a ramp that never touches zero: every output sample says which track sample it came from
+        const int trackLength = (int)sampleRate * 10;
+        auto rampAt = [trackLength](int64 index) { return 0.25f + 0.5f * (float)index / (float)trackLength; };
+
+        const File track = File::getSpecialLocation(File::tempDirectory).getChildFile("otodecks_schedule_ramp.wav");
+        {
+            AudioBuffer<float> ramp(2, trackLength);
+            for (int i = 0; i < trackLength; ++i)
+                ramp.setSample(0, i, rampAt(i));
+            ramp.copyFrom(1, 0, ramp, 0, 0, trackLength);
+
+            track.deleteFile();
+            WavAudioFormat wav;
+            std::unique_ptr<AudioFormatWriter> writer(wav.createWriterFor(track.createOutputStream().release(), sampleRate, 2, 32, {}, 0));
+            if (writer == nullptr || !writer->writeFromAudioSampleBuffer(ramp, 0, trackLength))
+            {
+                std::cerr << "cannot write " << track.getFullPathName() << std::endl;
+                return 1;
+            }
+        }
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        DJAudioPlayer player{ formatManager };
+        player.setRealtime(false);
+        MixEngine engine;
+        engine.addDeck(&player);
+        engine.prepareToPlay(blockSize, sampleRate);
+        engine.setTempo(120.0);
+
+        // the limiters hand out what the deck rendered this many samples earlier;
+        // the ramp stays under the ceiling, so they pass it through untouched
+        const int64 latency = engine.getLatencySamples();
+        player.loadURL(URL{ track });
+
+        // everything the engine plays, so checks can look back at any sample
+        AudioBuffer<float> output(2, (int)sampleRate * 20);
+        output.clear();
+        int64 rendered = 0;
+        AudioBuffer<float> block(2, blockSize);
+
+        // odd blocks, and the last one cut short to stop exactly at end
+        auto renderUntil = [&](int64 end)
+        {
+            while (rendered < end)
+            {
+                const int numSamples = (int)jmin((int64)blockSize, end - rendered);
+                AudioSourceChannelInfo info(&block, 0, numSamples);
+                engine.getNextAudioBlock(info);
+                output.copyFrom(0, (int)rendered, block, 0, 0, numSamples);
+                rendered += numSamples;
+            }
+        };
+
+        int failures = 0;
+        auto check = [&failures](bool ok, const String& what)
+        {
+            std::cout << (ok ? "pass  " : "FAIL  ") << what << std::endl;
+            if (!ok)
+                ++failures;
+        };
+        // what the deck rendered at index on the engine's clock
+        auto sampleAt = [&output, latency](int64 index) { return output.getSample(0, (int)(index + latency)); };
+        auto near = [](float a, float b) { return std::abs(a - b) < 1.0e-6f; };
+
+        renderUntil(1000);
+
+        engine.setQuantize(MixEngine::Quantize::beat);
+        const int64 playAt = engine.getQuantizedSample();
+        player.startAt(playAt);
+        check(playAt % 22050 == 0, "play quantized to a beat line (sample " + String(playAt) + ")");
+        renderUntil(playAt + 5000);
+        check(sampleAt(playAt - 1) == 0.0f && near(sampleAt(playAt), rampAt(0)),
+              "play starts on its sample");
+
+        engine.setQuantize(MixEngine::Quantize::bar);
+        const int64 jumpAt = engine.getQuantizedSample();
+        const double jumpTo = 2.0;
+        player.setPositionAt(jumpTo, jumpAt);
+        check(jumpAt % 88200 == 0, "cue jump quantized to a bar line (sample " + String(jumpAt) + ")");
+        renderUntil(jumpAt + 5000);
+        check(near(sampleAt(jumpAt - 1), rampAt(jumpAt - 1 - playAt)) && near(sampleAt(jumpAt), rampAt((int64)(jumpTo * sampleRate))),
+              "cue jump lands on its sample");
+
+        engine.setQuantize(MixEngine::Quantize::beat);
+        const int64 loopAt = engine.getQuantizedSample();
+        player.setLoopingAt(true, loopAt);
+        renderUntil(loopAt);
+        const bool loopingBefore = player.isLooping();
+        renderUntil(loopAt + 1);
+        check(!loopingBefore && player.isLooping(), "loop toggle lands on its sample (" + String(loopAt) + ")");
+
+        const int64 stopAt = engine.getQuantizedSample();
+        player.stopAt(stopAt);
+        renderUntil(stopAt + 5000);
+        const int64 expected = (int64)(jumpTo * sampleRate) + (stopAt - 1 - jumpAt);
+        bool silentAfter = true;
+        // the transport fades the first 256 samples out to avoid a click
+        for (int64 i = stopAt + 256; i < rendered - latency; ++i)
+            silentAfter = silentAfter && sampleAt(i) == 0.0f;
+        check(near(sampleAt(stopAt - 1), rampAt(expected)) && silentAfter, "stop lands on its sample (" + String(stopAt) + ")");
+
+        engine.releaseResources();
+        track.deleteFile();
+
+        std::cout << (failures == 0 ? "all scheduling checks passed" : String(failures) + " scheduling checks failed")
+                  << " with " << blockSize << "-sample blocks, " << latency << " samples of latency" << std::endl;
+        return failures == 0 ? 0 : 1;
+    }
+
+    const HeadlessRunner::Mode mode{ "--test-scheduling", "[--block <n>]", runSchedulingTest };
+}
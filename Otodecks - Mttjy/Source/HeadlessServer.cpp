@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    HeadlessServer.cpp
+    Created: 20 Oct 2026 8:12:22am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "LocalHttpServer.h"
+#include <iostream>
+
+/*
+    --serve serves a folder over HTTP on 127.0.0.1 until the app is quit
+    (see LocalHttpServer), with every response delayed by --latency-ms and
+    the bodies paced to --kbps kilobits a second, so a deck can be pointed
+    at one of the URLs it prints.
+*/
+namespace
+{
+    int runServer(const HeadlessRunner::Args& args)
+    {
+        const File folder = args.getFile("--serve");
+        if (!folder.isDirectory())
+        {
+            std::cerr << "no such folder: " << folder.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        LocalHttpServer::Options options;
+        options.port = args.getOption("--port", "8080").getIntValue();
+        options.latencyMs = jmax(0, args.getOption("--latency-ms", "0").getIntValue());
+        options.bytesPerSecond = jmax((int64)0, args.getOption("--kbps", "0").getLargeIntValue() * 1000 / 8);
+        options.supportRanges = !args.contains("--no-ranges");
+
+        LocalHttpServer server(folder, options);
+        String error;
+        if (!server.start(error))
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+
+        for (auto& file : folder.findChildFiles(File::findFiles, false))
+            std::cout << server.getURL(file).toString(false) << "\n";
+        std::cout << "serving " << folder.getFullPathName() << " with " << options.latencyMs << " ms latency, "
+                  << (options.bytesPerSecond > 0 ? String(options.bytesPerSecond * 8 / 1000) + " kbit/s" : String("no bandwidth limit"))
+                  << (options.supportRanges ? "" : ", no range requests") << std::endl;
+
+        // a line every five seconds while there is traffic, until the app is quit
+        int64 lastBytes = 0;
+        for (int tick = 1; !HeadlessRunner::shouldStop(); ++tick)
+        {
+            Thread::sleep(100);
+            if (tick % 50 != 0)
+                continue;
+
+            const LocalHttpServer::Stats stats = server.getStats();
+            if (stats.bytesSent != lastBytes)
+                std::cout << stats.numRequests << " requests (" << stats.numRangeRequests << " ranges), "
+                          << String(stats.bytesSent / 1.0e6, 1) << " MB sent" << std::endl;
+            lastBytes = stats.bytesSent;
+        }
+        return 0;
+    }
+
+    const HeadlessRunner::Mode mode{ "--serve",
+        "<folder> [--port <n>] [--latency-ms <ms>] [--kbps <n>] [--no-ranges]",
+        runServer };
+}
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+    HeadlessSessionBenchmark.cpp
+    Created: 20 Oct 2026 8:09:14am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "SessionSnapshot.h"
+#include <iostream>
+
+/*
+    --bench-session times a session snapshot's capture on the message thread
+    and its atomic write, then restores it into a fresh engine. It checks
+    that each deck comes back at the saved sample with its settings, and
+    exits with 1 if one doesn't.
+*/
+namespace
+{
+    int runSessionBenchmark(const HeadlessRunner::Args& args)
+    {
+        const double sampleRate = 44100.0;
+        const int blockSize = jmax(16, args.getOption("--block", "512").getIntValue());
+        const int numCaptures = 10000;
+        const int numWrites = 50;
+
+        // one minute of noise is enough to restore into the middle of
+        const File folder = File::getSpecialLocation(File::tempDirectory).getChildFile("otodecks_session_bench");
+        folder.deleteRecursively();
+        folder.createDirectory();
+        const File track = folder.getChildFile("track.wav");
+        {
+            AudioBuffer<float> noise(2, (int)sampleRate * 60);
+            Random random(1);
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < noise.getNumSamples(); ++i)
+                    noise.setSample(ch, i, random.nextFloat() * 0.5f - 0.25f);
+
+            WavAudioFormat wav;
+            std::unique_ptr<AudioFormatWriter> writer(wav.createWriterFor(track.createOutputStream().release(), sampleRate, 2, 16, {}, 0));
+            if (writer == nullptr || !writer->writeFromAudioSampleBuffer(noise, 0, noise.getNumSamples()))
+            {
+                std::cerr << "cannot write " << track.getFullPathName() << std::endl;
+                return 1;
+            }
+        }
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        AudioBuffer<float> block(4, blockSize);
+        auto renderBlocks = [&](MixEngine& engine, int numBlocks)
+        {
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                AudioSourceChannelInfo info(&block, 0, blockSize);
+                engine.getNextAudioBlock(info);
+            }
+        };
+        auto secondsSince = [](int64 start) { return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start); };
+
+        // a set in progress: two decks at odd places and settings
+        DJAudioPlayer player1{ formatManager }, player2{ formatManager };
+        MixEngine engine;
+        engine.addDeck(&player1);
+        engine.addDeck(&player2);
+        player1.setRealtime(false);
+        player2.setRealtime(false);
+        engine.prepareToPlay(blockSize, sampleRate);
+        player1.loadURL(URL{ track });
+        player2.loadURL(URL{ track });
+        player1.setPosition(12.345);
+        player2.setPosition(40.0);
+        player1.setSpeed(1.04);
+        player2.setGain(0.7);
+        player2.setLooping(true);
+        engine.setCueEnabled(1, true);
+        player1.start();
+        player2.start();
+        renderBlocks(engine, (int)(sampleRate / blockSize));
+        player1.stop();
+        player2.stop();
+        renderBlocks(engine, 1);
+
+        SessionSnapshot snapshot(engine, folder.getChildFile("session.otss"));
+
+        int64 start = Time::getHighResolutionTicks();
+        MemoryBlock data;
+        for (int i = 0; i < numCaptures; ++i)
+            data = SessionSnapshot::encode(snapshot.capture());
+        const double captureMicros = secondsSince(start) * 1.0e6 / numCaptures;
+
+        start = Time::getHighResolutionTicks();
+        for (int i = 0; i < numWrites; ++i)
+            SessionSnapshot::write(snapshot.getFile(), data);
+        const double writeMs = secondsSince(start) * 1000.0 / numWrites;
+
+        const SessionSnapshot::Session saved = snapshot.capture();
+
+        // a fresh engine, as after a relaunch: read, restore, and render until the decks are in place
+        DJAudioPlayer restored1{ formatManager }, restored2{ formatManager };
+        MixEngine restoredEngine;
+        restoredEngine.addDeck(&restored1);
+        restoredEngine.addDeck(&restored2);
+        restored1.setRealtime(false);
+        restored2.setRealtime(false);
+        restoredEngine.prepareToPlay(blockSize, sampleRate);
+
+        start = Time::getHighResolutionTicks();
+        SessionSnapshot::Session session;
+        if (!SessionSnapshot::read(snapshot.getFile(), session))
+        {
+            std::cerr << "cannot read back " << snapshot.getFile().getFullPathName() << std::endl;
+            return 1;
+        }
+        SessionSnapshot restorer(restoredEngine, snapshot.getFile());
+        const int numRestored = restorer.restore(session);
+        renderBlocks(restoredEngine, 1);
+        const double restoreMs = secondsSince(start) * 1000.0;
+
+        int failures = 0;
+        auto check = [&failures](bool ok, const String& what)
+        {
+            std::cout << (ok ? "pass  " : "FAIL  ") << what << std::endl;
+            if (!ok)
+                ++failures;
+        };
+
+        const SessionSnapshot::Session after = restorer.capture();
+        check(numRestored == 2, "both decks restored");
+        for (size_t i = 0; i < saved.decks.size() && i < after.decks.size(); ++i)
+        {
+            const auto& a = saved.decks[i];
+            const auto& b = after.decks[i];
+            const double errorSamples = std::abs(a.positionSecs - b.positionSecs) * sampleRate;
+            check(a.file == b.file && errorSamples < 1.0 && a.speed == b.speed && a.gain == b.gain
+                      && a.looping == b.looping && a.cue == b.cue,
+                  "deck " + String((int)i + 1) + " at " + String(b.positionSecs, 4) + " s (saved "
+                      + String(a.positionSecs, 4) + " s), speed " + String(b.speed, 2) + ", gain " + String(b.gain, 2));
+        }
+
+        std::cout << "capture + encode  " << String(captureMicros, 2) << " us on the message thread, "
+                  << (int)data.getSize() << " bytes\n"
+                  << "atomic write      " << String(writeMs, 2) << " ms on the writer thread (temp file, sync, rename)\n"
+                  << "restore           " << String(restoreMs, 2) << " ms from reading the file to the first block "
+                  << "playing from the saved positions" << std::endl;
+        return failures > 0 ? 1 : 0;
+    }
+
+    const HeadlessRunner::Mode mode{ "--bench-session", "[--block <n>]", runSessionBenchmark };
+}
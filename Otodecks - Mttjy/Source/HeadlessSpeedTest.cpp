@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+    HeadlessSpeedTest.cpp
+    Created: 21 Oct 2026 9:12:40am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "MixEngine.h"
+#include <iostream>
+
+/*
+    --test-speed plays a generated tone through the engine and turns the
+    deck's speed to 0, the middle of the speed dial, then sweeps it through
+    0 in the dial's smallest steps the way a drag does. At 0 the deck must
+    hold its place and fall silent, never handing the resampler a ratio of
+    0, and every sample must stay finite. It exits with 1 if any check
+    fails.
+*/
+namespace
+{
+    int runSpeedTest(const HeadlessRunner::Args& args)
+    {
+        const double sampleRate = 44100.0;
+        const int blockSize = jmax(1, args.getOption("--block", "512").getIntValue());
+
+        const int trackLength = (int)sampleRate * 10;
+        const File track = File::getSpecialLocation(File::tempDirectory).getChildFile("otodecks_speed_tone.wav");
+        {
+            AudioBuffer<float> tone(2, trackLength);
+            for (int i = 0; i < trackLength; ++i)
+                tone.setSample(0, i, 0.5f * (float)std::sin(MathConstants<double>::twoPi * 440.0 * i / sampleRate));
+            tone.copyFrom(1, 0, tone, 0, 0, trackLength);
+
+            track.deleteFile();
+            WavAudioFormat wav;
+            std::unique_ptr<AudioFormatWriter> writer(wav.createWriterFor(track.createOutputStream().release(), sampleRate, 2, 32, {}, 0));
+            if (writer == nullptr || !writer->writeFromAudioSampleBuffer(tone, 0, trackLength))
+            {
+                std::cerr << "cannot write " << track.getFullPathName() << std::endl;
+                return 1;
+            }
+        }
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        DJAudioPlayer player{ formatManager };
+        player.setRealtime(false);
+        MixEngine engine;
+        engine.addDeck(&player);
+        engine.prepareToPlay(blockSize, sampleRate);
+        player.loadURL(URL{ track });
+
+        AudioBuffer<float> block(2, blockSize);
+        bool allFinite = true;
+
+        // the loudest sample of numBlocks blocks
+        auto render = [&](int numBlocks)
+        {
+            float peak = 0;
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                AudioSourceChannelInfo info(&block, 0, blockSize);
+                engine.getNextAudioBlock(info);
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    const float* samples = block.getReadPointer(ch);
+                    for (int i = 0; i < blockSize; ++i)
+                        allFinite = allFinite && std::isfinite(samples[i]);
+                    peak = jmax(peak, block.getMagnitude(ch, 0, blockSize));
+                }
+            }
+            return peak;
+        };
+
+        int failures = 0;
+        auto check = [&failures](bool ok, const String& what)
+        {
+            std::cout << (ok ? "pass  " : "FAIL  ") << what << std::endl;
+            if (!ok)
+                ++failures;
+        };
+
+        // a second's worth of blocks, whatever the block size
+        const int blocksPerSecond = jmax(1, (int)sampleRate / blockSize);
+
+        player.start();
+        check(render(blocksPerSecond) > 0.1f, "plays at speed 1");
+
+        player.setSpeed(0.0);
+        render(blocksPerSecond / 4);
+        const double heldAt = player.getCurrentPosition();
+        const float heldPeak = render(blocksPerSecond);
+        check(std::abs(player.getCurrentPosition() - heldAt) < 1.0e-9, "speed 0 holds the playhead (at " + String(heldAt, 3) + " s)");
+        check(heldPeak == 0.0f, "speed 0 is silent, not a held sample (peak " + String(heldPeak, 6) + ")");
+
+        // a drag across the middle of the dial, one step a block
+        for (double speed = -0.05; speed <= 0.05; speed += 0.01)
+        {
+            player.setSpeed(std::abs(speed) < 0.005 ? 0.0 : speed);
+            render(1);
+        }
+        player.setSpeed(0.0);
+        render(4);
+
+        player.setSpeed(1.0);
+        const double resumedFrom = player.getCurrentPosition();
+        check(render(blocksPerSecond) > 0.1f, "plays again at speed 1");
+        check(player.getCurrentPosition() > resumedFrom + 0.5, "the playhead moves again");
+        check(allFinite, "every sample finite");
+
+        engine.releaseResources();
+        track.deleteFile();
+
+        std::cout << (failures == 0 ? "all speed checks passed" : String(failures) + " speed checks failed")
+                  << " with " << blockSize << "-sample blocks" << std::endl;
+        return failures == 0 ? 0 : 1;
+    }
+
+    const HeadlessRunner::Mode mode{ "--test-speed", "[--block <n>]", runSpeedTest };
+}
@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    HeadlessStartupBenchmark.cpp
+    Created: 20 Oct 2026 8:08:30am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "LibraryScanner.h"
+#include "TagReader.h"
+#include "TrackLibrary.h"
+#include <iostream>
+
+/*
+    --bench-startup fills a temporary tracks folder with tiny WAVs and
+    times the old blocking library load against the background scan, with
+    no index, with a full one and after a file changed and one was deleted.
+*/
+namespace
+{
+    int runStartupBenchmark(const HeadlessRunner::Args& args)
+    {
+        const int numTracks = jmax(1, args.getOption("--tracks", "50000").getIntValue());
+
+        const File folder = File::getSpecialLocation(File::tempDirectory).getChildFile("otodecks_startup_bench");
+        const File tracksFolder = folder.getChildFile("tracks");
+
+        // a tenth of a second of silence, written once and copied: the files only need to be real WAVs
+        if (tracksFolder.getNumberOfChildFiles(File::findFiles) != numTracks)
+        {
+            folder.deleteRecursively();
+            tracksFolder.createDirectory();
+
+            MemoryBlock wav;
+            {
+                WavAudioFormat format;
+                std::unique_ptr<AudioFormatWriter> writer(format.createWriterFor(new MemoryOutputStream(wav, false),
+                                                                                 8000.0, 1, 16, {}, 0));
+                AudioBuffer<float> silence(1, 800);
+                silence.clear();
+                writer->writeFromAudioSampleBuffer(silence, 0, silence.getNumSamples());
+            }
+
+            std::cout << "writing " << numTracks << " tracks to " << tracksFolder.getFullPathName() << "..." << std::endl;
+            for (int i = 0; i < numTracks; ++i)
+                tracksFolder.getChildFile("track " + String(i).paddedLeft('0', 6) + ".wav").replaceWithData(wav.getData(), wav.getSize());
+        }
+
+        auto secondsSince = [](int64 start) { return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start); };
+
+        // what the constructor used to do before the window could show
+        int64 start = Time::getHighResolutionTicks();
+        {
+            TrackLibrary library;
+            const Array<File> files = tracksFolder.findChildFiles(File::findFiles, false);
+            const std::vector<TrackTags> tags = TagReader::readTagsParallel(files);
+            for (int i = 0; i < files.size(); ++i)
+            {
+                AudioFormatManager formatManager;
+                formatManager.registerBasicFormats();
+                std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(files[i]));
+                const double duration = reader != nullptr ? reader->lengthInSamples / reader->sampleRate : 0.0;
+                library.setTags(library.addTrack(files[i], duration), tags[(size_t)i]);
+            }
+            library.updateView();
+        }
+        const double blockingMs = secondsSince(start) * 1000.0;
+
+        // the scanner, feeding a library the way the playlist does, with and without an index
+        auto runScan = [&](const char* name)
+        {
+            LibraryScanner scanner(tracksFolder);
+            TrackLibrary library;
+            Array<File> missing;
+            double shownMs = 0;
+
+            start = Time::getHighResolutionTicks();
+            const LibraryScanner::Stats stats = scanner.scan([&](std::vector<LibraryScanner::Track>& batch)
+            {
+                for (auto& track : batch)
+                {
+                    TrackLibrary::TrackId id = library.findTrack(track.file);
+                    if (id == TrackLibrary::invalidId)
+                        id = library.addTrack(track.file, track.duration);
+                    else
+                        library.setDuration(id, track.duration);
+                    library.setTags(id, track.tags);
+                }
+                library.updateView();
+                if (shownMs == 0)
+                    shownMs = secondsSince(start) * 1000.0;
+            }, missing);
+
+            std::cout << name << String(shownMs, 1) << " ms to the first rows, " << String(stats.totalMs, 1)
+                      << " ms to a complete library (" << stats.numIndexed << " from the index, "
+                      << stats.numOpened << " opened, " << stats.numMissing << " missing)\n";
+            return stats;
+        };
+
+        LibraryScanner(tracksFolder).getIndexFile().deleteFile();
+
+        std::cout << numTracks << " tracks\n"
+                  << "blocking scan (before)   " << String(blockingMs, 1) << " ms before the window could show\n";
+        runScan("first launch, no index   ");
+        runScan("next launch, from index  ");
+
+        // one changed and one deleted file: everything else still comes from the index
+        tracksFolder.getChildFile("track " + String(0).paddedLeft('0', 6) + ".wav").setLastModificationTime(Time::getCurrentTime());
+        const File removed = tracksFolder.getChildFile("track " + String(numTracks - 1).paddedLeft('0', 6) + ".wav");
+        MemoryBlock removedData;
+        removed.loadFileAsData(removedData);
+        removed.deleteFile();
+        runScan("after 1 change, 1 delete ");
+        removed.replaceWithData(removedData.getData(), removedData.getSize());
+
+        std::cout << "the window itself no longer waits for any of this; the app logs its own "
+                     "time to first frame and to playable in logs/startup.log" << std::endl;
+        return 0;
+    }
+
+    const HeadlessRunner::Mode mode{ "--bench-startup", "[--tracks <n>]", runStartupBenchmark };
+}
@@ -0,0 +1,166 @@
+/*
+  ==============================================================================
+
+    HeadlessStreamBenchmark.cpp
+    Created: 20 Oct 2026 8:13:05am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "LocalHttpServer.h"
+#include "DJAudioPlayer.h"
+#include <iostream>
+
+/*
+    --bench-stream serves a test track of its own, or --file, the way
+    --serve does, and streams it into a deck playing in real time. It
+    prints how long the load took, how long until the first sound, how
+    long a seek to three quarters took to play again, how often the deck
+    stalled, and the requests and bytes it took. It exits with 1 if the
+    deck never played or the downloaded bytes don't match the file.
+*/
+namespace
+{
+    int runStreamBenchmark(const HeadlessRunner::Args& args)
+    {
+        constexpr double sampleRate = 44100.0;
+        constexpr int blockSize = 512;
+
+        const File folder = File::getSpecialLocation(File::tempDirectory).getChildFile("otodecks_stream");
+        folder.createDirectory();
+
+        // a minute of 16-bit stereo, unless a track is given
+        File track = args.getFile("--file");
+        if (!args.contains("--file"))
+        {
+            track = folder.getChildFile("stream_test.wav");
+            const int length = (int)(60 * sampleRate);
+            AudioBuffer<float> sine(2, length);
+            for (int i = 0; i < length; ++i)
+                sine.setSample(0, i, 0.25f * (float)std::sin(MathConstants<double>::twoPi * 440.0 * i / sampleRate));
+            sine.copyFrom(1, 0, sine, 0, 0, length);
+
+            track.deleteFile();
+            WavAudioFormat wav;
+            std::unique_ptr<AudioFormatWriter> writer(wav.createWriterFor(track.createOutputStream().release(), sampleRate, 2, 16, {}, 0));
+            if (writer == nullptr || !writer->writeFromAudioSampleBuffer(sine, 0, length))
+            {
+                std::cerr << "cannot write " << track.getFullPathName() << std::endl;
+                return 1;
+            }
+        }
+        if (!track.existsAsFile())
+        {
+            std::cerr << "no such file: " << track.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        LocalHttpServer::Options serverOptions;
+        serverOptions.latencyMs = jmax(0, args.getOption("--latency-ms", "50").getIntValue());
+        serverOptions.bytesPerSecond = jmax((int64)0, args.getOption("--kbps", "4000").getLargeIntValue() * 1000 / 8);
+        serverOptions.supportRanges = !args.contains("--no-ranges");
+        LocalHttpServer server(track.getParentDirectory(), serverOptions);
+        String error;
+        if (!server.start(error))
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        const URL url = server.getURL(track);
+        std::cout << url.toString(false) << ": " << String(track.getSize() / 1.0e6, 1) << " MB, "
+                  << serverOptions.latencyMs << " ms latency, " << serverOptions.bytesPerSecond * 8 / 1000 << " kbit/s"
+                  << (serverOptions.supportRanges ? "" : ", no range requests") << "\n" << std::flush;
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        DJAudioPlayer player{ formatManager };
+        StreamingDownload::Options streamOptions;
+        streamOptions.prerollSeconds = jmax(0.0, args.getOption("--preroll", "2").getDoubleValue());
+        player.setStreamingOptions(streamOptions);
+        player.prepareToPlay(blockSize, sampleRate);
+
+        auto msSince = [](int64 start) { return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) * 1000.0; };
+        const int64 loadStart = Time::getHighResolutionTicks();
+        player.loadURL(url);
+        const double loadMs = msSince(loadStart);
+        StreamingDownload::Ptr download = player.getStreamingDownload();
+        if (download == nullptr)
+        {
+            std::cerr << "the deck could not open the stream" << std::endl;
+            return 1;
+        }
+        player.start();
+
+        // a device in real time: one block per block period
+        AudioBuffer<float> buffer(2, blockSize);
+        const int64 periodTicks = Time::secondsToHighResolutionTicks(blockSize / sampleRate);
+        const int64 playStart = Time::getHighResolutionTicks();
+        int64 block = 0;
+        int stalls = 0;
+        bool wasBuffering = true;
+        auto playFor = [&](double seconds, int64 since)
+        {
+            // how long after since the deck first made a sound, or -1
+            double firstSoundMs = -1;
+            const int64 numBlocks = (int64)(seconds * sampleRate / blockSize);
+            for (int64 i = 0; i < numBlocks; ++i, ++block)
+            {
+                const int64 due = playStart + block * periodTicks;
+                while (Time::getHighResolutionTicks() < due)
+                    Thread::sleep(1);
+
+                AudioSourceChannelInfo info(&buffer, 0, blockSize);
+                player.getNextAudioBlock(info);
+                if (firstSoundMs < 0 && buffer.getMagnitude(0, 0, blockSize) > 0.0f)
+                    firstSoundMs = msSince(since);
+
+                const bool nowBuffering = player.isBuffering();
+                if (nowBuffering && !wasBuffering)
+                    ++stalls;
+                wasBuffering = nowBuffering;
+            }
+            return firstSoundMs;
+        };
+
+        const double firstSoundMs = playFor(6.0, loadStart);
+        const int stallsBeforeSeek = stalls;
+        const int64 seekStart = Time::getHighResolutionTicks();
+        player.setPositionRelative(0.75);
+        const double seekMs = playFor(6.0, seekStart);
+        player.stop();
+        playFor(0.1, seekStart);
+
+        // everything should arrive in the end, and match the file byte for byte
+        const double downloadStart = Time::getMillisecondCounterHiRes();
+        while (!download->getStats().complete && !download->getStats().failed
+               && Time::getMillisecondCounterHiRes() - downloadStart < 600000)
+            Thread::sleep(20);
+
+        MemoryBlock original;
+        track.loadFileAsData(original);
+        std::unique_ptr<InputStream> stream = download->createStream(true);
+        MemoryBlock downloaded;
+        stream->readIntoMemoryBlock(downloaded);
+        const bool intact = downloaded == original;
+
+        const StreamingDownload::Stats stats = download->getStats();
+        std::cout << "load (headers)      " << String(loadMs, 1) << " ms\n"
+                  << "first sound         " << (firstSoundMs < 0 ? String("never") : String(firstSoundMs, 1) + " ms")
+                  << " after the load began, " << String(streamOptions.prerollSeconds, 1) << " s pre-roll\n"
+                  << "seek to 75%         " << (seekMs < 0 ? String("never played again") : String(seekMs, 1) + " ms") << " to sound\n"
+                  << "stalls              " << stallsBeforeSeek << " before the seek, " << stalls - stallsBeforeSeek << " after\n"
+                  << "download            " << stats.numRequests << " requests"
+                  << (stats.rangesSupported ? "" : " (no ranges)") << ", " << String(stats.bytesDownloaded / 1.0e6, 2) << " of "
+                  << String(stats.totalBytes / 1.0e6, 2) << " MB, " << stats.numUnderruns << " underruns, "
+                  << (intact ? "matches the file" : "DOES NOT MATCH the file") << std::endl;
+
+        player.releaseResources();
+        return firstSoundMs >= 0 && seekMs >= 0 && intact ? 0 : 1;
+    }
+
+    const HeadlessRunner::Mode mode{ "--bench-stream",
+        "[--file <audio file>] [--latency-ms <ms>] [--kbps <n>] [--preroll <s>] [--no-ranges]",
+        runStreamBenchmark };
+}
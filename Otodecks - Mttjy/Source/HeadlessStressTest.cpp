@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    HeadlessStressTest.cpp
+    Created: 20 Oct 2026 8:11:40am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "StressTester.h"
+#include "RealtimeCheck.h"
+#include <iostream>
+
+/*
+    --stress plays every deck through a simulated device at each block size
+    while they are seeked, sped up to 10x and down to 0.25x, reloaded,
+    started, stopped and looped at random (see StressTester). It prints the
+    worst callbacks, deadline misses and every glitch the output checks
+    caught, and exits with 1 if there were any glitches. --fast runs the
+    callbacks back to back instead of in real time. Built with the RtCheck
+    configuration it also prints every blocking call the audio thread made
+    (see RealtimeCheck), and any of those is a failure too.
+*/
+namespace
+{
+    int runStressTest(const HeadlessRunner::Args& args)
+    {
+        StressTester::Options options;
+        options.numDecks = args.getOption("--decks", String(options.numDecks)).getIntValue();
+        options.secondsPerCase = jmax(0.1, args.getOption("--seconds", "3").getDoubleValue());
+        options.commandIntervalMs = args.getOption("--interval-ms", "2").getIntValue();
+        options.seed = args.getOption("--seed", "1").getIntValue();
+        options.realtime = !args.contains("--fast");
+        options.blockSizes = args.getIntList("--blocks", options.blockSizes);
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        StressTester tester(formatManager);
+
+        String error;
+        if (!tester.prepare(File::getSpecialLocation(File::tempDirectory).getChildFile("otodecks_stress"), options, error))
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+
+        std::cout << options.numDecks << " decks, " << String(options.secondsPerCase, 1) << " s per block size, a command every "
+                  << options.commandIntervalMs << " ms on average" << (options.realtime ? "" : ", back to back") << "\n" << std::flush;
+
+        // setting up the decks above is not the audio thread's doing
+        RealtimeCheck::reset();
+
+        int glitches = 0;
+        for (auto& report : tester.run())
+        {
+            std::cout << report.toString() << std::flush;
+            glitches += report.getNumGlitches();
+        }
+
+        std::cout << (glitches == 0 ? "no glitches" : String(glitches) + " glitches") << std::endl;
+        if (RealtimeCheck::isEnabled())
+            std::cout << "\n" << RealtimeCheck::getReport() << std::flush;
+        return glitches > 0 || RealtimeCheck::getNumViolations() > 0 ? 1 : 0;
+    }
+
+    const HeadlessRunner::Mode mode{ "--stress",
+        "[--decks <n>] [--seconds <s>] [--blocks <n,n,...>] [--interval-ms <ms>] [--seed <n>] [--fast]",
+        runStressTest };
+}
@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    HeadlessTagBenchmark.cpp
+    Created: 20 Oct 2026 8:03:40am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "TagReader.h"
+#include <iostream>
+
+/*
+    --bench-tags reads the tags of every audio file under a folder on
+    --threads threads (0 for one per core) and prints the files a second
+    and the bytes read per file.
+*/
+namespace
+{
+    int runTagBenchmark(const HeadlessRunner::Args& args)
+    {
+        const File folder = args.getFile("--bench-tags");
+        if (!folder.isDirectory())
+        {
+            std::cerr << "not a folder: " << folder.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        const Array<File> files = folder.findChildFiles(File::findFiles | File::ignoreHiddenFiles, true,
+                                                        "*.mp3;*.flac;*.ogg;*.opus;*.wav");
+        const int threads = args.getOption("--threads", "0").getIntValue();
+
+        int64 bytesRead = 0;
+        const int64 start = Time::getHighResolutionTicks();
+        const std::vector<TrackTags> tags = TagReader::readTagsParallel(files, threads, &bytesRead);
+        const double secs = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+
+        int withTags = 0;
+        for (auto& t : tags)
+            if (!t.isEmpty())
+                ++withTags;
+
+        std::cout << "read tags of " << files.size() << " files (" << withTags << " tagged) in "
+                  << String(secs, 3) << " s: " << String(files.size() / jmax(secs, 1.0e-9), 0) << " files/s, "
+                  << String(bytesRead / (1024.0 * 1024.0), 1) << " MB read ("
+                  << String(bytesRead / (double)jmax(1, files.size()) / 1024.0, 1) << " KB per file)" << std::endl;
+        return 0;
+    }
+
+    const HeadlessRunner::Mode mode{ "--bench-tags", "<folder> [--threads <n>]", runTagBenchmark };
+}
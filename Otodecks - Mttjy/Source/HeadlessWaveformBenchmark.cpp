@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    HeadlessWaveformBenchmark.cpp
+    Created: 20 Oct 2026 8:07:48am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadlessRunner.h"
+#include "BandAnalyser.h"
+#include <iostream>
+
+/*
+    --bench-waveform times the band analysis of one track against its
+    length, and a deck's waveform paint with the thumbnail against the
+    coloured image that replaces it.
+*/
+namespace
+{
+    int runWaveformBenchmark(const HeadlessRunner::Args& args)
+    {
+        const File file = args.getFile("--bench-waveform");
+        const int width = jlimit(16, 8192, args.getOption("--width", "800").getIntValue());
+        const int height = 120;
+        const int numPaints = 200;
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr)
+        {
+            std::cerr << "can't read " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        auto secondsSince = [](int64 start) { return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start); };
+        const double trackSecs = reader->lengthInSamples / reader->sampleRate;
+
+        int64 start = Time::getHighResolutionTicks();
+        auto bands = BandAnalyser::analyse(*reader);
+        const double analyseSecs = secondsSince(start);
+
+        // the thumbnail the deck draws until the analysis is ready, fully loaded
+        AudioThumbnailCache cache(1);
+        AudioThumbnail thumbnail(BandWaveform::samplesPerColumn, formatManager, cache);
+        thumbnail.setSource(new FileInputSource(file));
+        for (int waited = 0; !thumbnail.isFullyLoaded() && waited < 60000; waited += 10)
+            Thread::sleep(10);
+
+        Image canvas(Image::ARGB, width, height, true);
+        Graphics g(canvas);
+
+        start = Time::getHighResolutionTicks();
+        for (int i = 0; i < numPaints; ++i)
+            thumbnail.drawChannel(g, canvas.getBounds(), 0, thumbnail.getTotalLength(), 0, 1.0f);
+        const double thumbnailMs = secondsSince(start) * 1000.0 / numPaints;
+
+        start = Time::getHighResolutionTicks();
+        const Image bandImage = BandAnalyser::render(*bands, width, height);
+        const double renderMs = secondsSince(start) * 1000.0;
+
+        start = Time::getHighResolutionTicks();
+        for (int i = 0; i < numPaints; ++i)
+            g.drawImageAt(bandImage, 0, 0);
+        const double bandsMs = secondsSince(start) * 1000.0 / numPaints;
+
+        std::cout << file.getFileName() << ": " << String(trackSecs, 1) << " s, "
+                  << bands->getNumColumns() << " columns\n"
+                  << "analysis          " << String(analyseSecs * 1000.0, 1) << " ms ("
+                  << String(trackSecs / jmax(1.0e-9, analyseSecs), 0) << "x real time)\n"
+                  << "paint, thumbnail  " << String(thumbnailMs, 3) << " ms (drawChannel, " << width << " px)\n"
+                  << "paint, bands      " << String(bandsMs, 3) << " ms (image blit; building it once took "
+                  << String(renderMs, 3) << " ms)" << std::endl;
+        return 0;
+    }
+
+    const HeadlessRunner::Mode mode{ "--bench-waveform", "<audio file> [--width <px>]", runWaveformBenchmark };
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    HeadphonePanel.cpp
+    Created: 19 Oct 2026 8:02:37pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "HeadphonePanel.h"
+
+//==============================================================================
+HeadphonePanel::HeadphonePanel(MixEngine& _engine, AudioDeviceManager& _deviceManager)
+    : engine(_engine),
+      deviceManager(_deviceManager)
+{
+    addAndMakeVisible(cueLabel);
+    cueLabel.setFont(12.0f);
+    cueLabel.setText("CUE -", dontSendNotification);
+
+    addAndMakeVisible(mixSlider);
+    mixSlider.setSliderStyle(Slider::LinearHorizontal);
+    mixSlider.setTextBoxStyle(Slider::NoTextBox, true, 0, 0);
+    mixSlider.setRange(0.0, 1.0);
+    mixSlider.setValue(engine.getCueMix(), dontSendNotification);
+    mixSlider.setDoubleClickReturnValue(true, 0.0);
+    mixSlider.onValueChange = [this] { engine.setCueMix((float)mixSlider.getValue()); };
+
+    addAndMakeVisible(splitButton);
+    splitButton.setToggleState(engine.isSplitCue(), dontSendNotification);
+    splitButton.onClick = [this]
+    {
+        engine.setSplitCue(splitButton.getToggleState());
+        timerCallback();
+    };
+
+    // the device can change under us
+    startTimer(1000);
+    timerCallback();
+}
+
+HeadphonePanel::~HeadphonePanel()
+{
+    stopTimer();
+}
+
+void HeadphonePanel::paint (Graphics& g)
+{
+    g.fillAll(Colour::fromRGB(15, 15, 15));
+}
+
+void HeadphonePanel::resized()
+{
+    cueLabel.setBounds(0, 0, 56, getHeight());
+    splitButton.setBounds(getWidth() - 60, 0, 60, getHeight());
+    mixSlider.setBounds(56, 0, getWidth() - 56 - 62, getHeight());
+}
+
+void HeadphonePanel::timerCallback()
+{
+    int numOutputs = 0;
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+        numOutputs = device->getActiveOutputChannels().countNumberOfSetBits();
+
+    // show which outputs carry the headphone feed, if any
+    String text = "CUE -";
+    if (numOutputs >= MixEngine::cueChannel + 2)
+        text = "CUE 3/4";
+    else if (engine.isSplitCue() && numOutputs >= 2)
+        text = "CUE 1/2";
+
+    cueLabel.setText(text, dontSendNotification);
+}
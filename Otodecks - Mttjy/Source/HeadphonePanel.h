@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    HeadphonePanel.h
+    Created: 19 Oct 2026 8:02:37pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MixEngine.h"
+
+//==============================================================================
+/*
+    Cue/master blend and split-cue switch for the headphone bus.
+*/
+class HeadphonePanel  : public Component,
+                        public Timer
+{
+public:
+    HeadphonePanel(MixEngine& engine, AudioDeviceManager& deviceManager);
+    ~HeadphonePanel() override;
+
+    void paint (Graphics&) override;
+    void resized() override;
+
+    void timerCallback() override;
+
+private:
+    MixEngine& engine;
+    AudioDeviceManager& deviceManager;
+
+    Label cueLabel;
+    Slider mixSlider;
+    ToggleButton splitButton{ "Split" };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HeadphonePanel)
+};
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    JogWheel.cpp
+    Created: 19 Oct 2026 7:21:05pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "JogWheel.h"
+
+JogWheel::JogWheel()
+{
+    setMouseCursor(MouseCursor::DraggingHandCursor);
+}
+
+JogWheel::~JogWheel()
+{
+}
+
+void JogWheel::paint(Graphics& g)
+{
+    const auto area = getLocalBounds().toFloat().reduced(2.0f);
+    const float size = jmin(area.getWidth(), area.getHeight());
+    const auto disc = area.withSizeKeepingCentre(size, size);
+    const auto centre = disc.getCentre();
+
+    g.setColour(Colours::darkgrey.darker());
+    g.fillEllipse(disc);
+    g.setColour(touched ? Colours::orange : Colours::grey);
+    g.drawEllipse(disc, 2.0f);
+
+    // the marker shows the platter turning with the music and under the hand
+    const float radius = size * 0.5f;
+    const Point<float> tip = centre.getPointOnCircumference(radius * 0.9f, angle);
+    g.setColour(Colours::white);
+    g.drawLine(Line<float>(centre.getPointOnCircumference(radius * 0.3f, angle), tip), 3.0f);
+    g.fillEllipse(Rectangle<float>(size * 0.12f, size * 0.12f).withCentre(centre));
+}
+
+float JogWheel::angleAt(Point<float> p) const
+{
+    return getLocalBounds().toFloat().getCentre().getAngleToPoint(p);
+}
+
+void JogWheel::mouseDown(const MouseEvent& e)
+{
+    touched = true;
+    lastMouseAngle = angleAt(e.position);
+    if (onTouch)
+        onTouch();
+    repaint();
+}
+
+void JogWheel::mouseDrag(const MouseEvent& e)
+{
+    const float mouseAngle = angleAt(e.position);
+    float delta = mouseAngle - lastMouseAngle;
+    lastMouseAngle = mouseAngle;
+
+    // crossing the +/- pi seam is a small turn, not almost a whole one
+    if (delta > MathConstants<float>::pi)
+        delta -= MathConstants<float>::twoPi;
+    else if (delta < -MathConstants<float>::pi)
+        delta += MathConstants<float>::twoPi;
+
+    angle += delta;
+    if (onTurn)
+        onTurn(delta / MathConstants<double>::twoPi * secondsPerTurn);
+    repaint();
+}
+
+void JogWheel::mouseUp(const MouseEvent&)
+{
+    touched = false;
+    if (onRelease)
+        onRelease();
+    repaint();
+}
+
+void JogWheel::setPlayheadPosition(double seconds)
+{
+    if (touched)
+        return;
+
+    const float newAngle = (float)std::fmod(seconds / secondsPerTurn * MathConstants<double>::twoPi,
+                                            MathConstants<double>::twoPi);
+    // repaint once the tip of the marker has moved about a pixel
+    const float radius = jmin(getWidth(), getHeight()) * 0.5f;
+    if (std::abs(newAngle - angle) * radius >= 1.0f)
+    {
+        angle = newAngle;
+        repaint();
+    }
+}
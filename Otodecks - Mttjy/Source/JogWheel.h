@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    JogWheel.h
+    Created: 19 Oct 2026 7:21:05pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/*
+    A platter to scratch with the mouse. Pressing puts a hand on the record,
+    dragging around the centre turns it, releasing lets go. One turn is
+    secondsPerTurn of audio, like a 33 1/3 rpm record.
+*/
+class JogWheel : public Component
+{
+public:
+    static constexpr double secondsPerTurn = 1.8;
+
+    JogWheel();
+    ~JogWheel() override;
+
+    void paint(Graphics&) override;
+
+    void mouseDown(const MouseEvent& e) override;
+    void mouseDrag(const MouseEvent& e) override;
+    void mouseUp(const MouseEvent& e) override;
+
+    /** turn the platter to follow the playhead while nobody is touching it */
+    void setPlayheadPosition(double seconds);
+
+    std::function<void()> onTouch;
+    /** seconds of audio the platter was turned by, negative for backwards */
+    std::function<void(double)> onTurn;
+    std::function<void()> onRelease;
+
+private:
+    float angleAt(Point<float> p) const;
+
+    float angle = 0.0f;
+    float lastMouseAngle = 0.0f;
+    bool touched = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(JogWheel)
+};
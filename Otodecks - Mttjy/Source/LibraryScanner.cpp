@@ -0,0 +1,287 @@
+/*
+  ==============================================================================
+
+    LibraryScanner.cpp
+    Created: 20 Oct 2026 1:52:37am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "LibraryScanner.h"
+
+class LibraryScanner::ScanJob : public ThreadPoolJob
+{
+public:
+    ScanJob(LibraryScanner& _owner)
+        : ThreadPoolJob("Library scan"), owner(_owner)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        Array<File> gone;
+        const Stats stats = owner.scan([this](std::vector<Track>& batch)
+        {
+            {
+                const ScopedLock sl(owner.resultLock);
+                for (auto& track : batch)
+                    owner.found.push_back(std::move(track));
+            }
+            owner.sendChangeMessage();
+        }, gone, [this] { return shouldExit(); });
+
+        if (shouldExit())
+            return jobHasFinished;
+
+        {
+            const ScopedLock sl(owner.resultLock);
+            owner.missing.addArray(gone);
+            owner.lastStats = stats;
+        }
+        owner.scanning = false;
+        owner.sendChangeMessage();
+        return jobHasFinished;
+    }
+
+private:
+    LibraryScanner& owner;
+};
+
+//==============================================================================
+LibraryScanner::LibraryScanner(const File& _tracksFolder)
+    : tracksFolder(_tracksFolder),
+      indexFile(_tracksFolder.getSiblingFile("library_index.otlx"))
+{
+    formatManager.registerBasicFormats();
+}
+
+LibraryScanner::~LibraryScanner()
+{
+    pool.removeAllJobs(true, 5000);
+}
+
+void LibraryScanner::startScan()
+{
+    pool.removeAllJobs(true, 5000);
+    {
+        const ScopedLock sl(resultLock);
+        found.clear();
+        missing.clear();
+    }
+    scanning = true;
+    pool.addJob(new ScanJob(*this), true);
+}
+
+bool LibraryScanner::isScanning() const
+{
+    return scanning.load();
+}
+
+std::vector<LibraryScanner::Track> LibraryScanner::takeFoundTracks()
+{
+    std::vector<Track> result;
+    const ScopedLock sl(resultLock);
+    result.swap(found);
+    return result;
+}
+
+Array<File> LibraryScanner::takeMissingFiles()
+{
+    Array<File> result;
+    const ScopedLock sl(resultLock);
+    result.swapWith(missing);
+    return result;
+}
+
+LibraryScanner::Stats LibraryScanner::getLastStats() const
+{
+    const ScopedLock sl(resultLock);
+    return lastStats;
+}
+
+File LibraryScanner::getIndexFile() const
+{
+    return indexFile;
+}
+
+//==============================================================================
+LibraryScanner::Stats LibraryScanner::scan(std::function<void(std::vector<Track>&)> onBatch, Array<File>& missingFiles,
+                                           std::function<bool()> shouldStop)
+{
+    const int64 start = Time::getHighResolutionTicks();
+    auto elapsedMs = [start] { return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) * 1000.0; };
+    auto stopping = [&shouldStop] { return shouldStop != nullptr && shouldStop(); };
+    Stats stats;
+
+    auto handOver = [&](std::vector<Track>& batch)
+    {
+        if (batch.empty())
+            return;
+        if (stats.firstBatchMs == 0)
+            stats.firstBatchMs = elapsedMs();
+        onBatch(batch);
+        batch.clear();
+    };
+
+    // last session's list goes over in one go, before the folder is touched
+    std::vector<Track> indexed;
+    readIndex(indexed);
+    stats.numIndexed = (int)indexed.size();
+    {
+        std::vector<Track> all(indexed);
+        handOver(all);
+    }
+
+    std::unordered_map<String, size_t> indexedByPath;
+    indexedByPath.reserve(indexed.size());
+    for (size_t i = 0; i < indexed.size(); ++i)
+        indexedByPath[indexed[i].file.getFullPathName()] = i;
+    std::vector<uint8> seen(indexed.size(), 0);
+
+    // one pass over the folder: the entries carry size and time, so unchanged files are never opened
+    std::vector<Track> current;
+    std::vector<size_t> toOpen;
+    current.reserve(indexed.size());
+    for (const auto& entry : RangedDirectoryIterator(tracksFolder, false, "*", File::findFiles))
+    {
+        if (stopping())
+            return stats;
+
+        Track track;
+        track.file = entry.getFile();
+        track.size = entry.getFileSize();
+        track.modified = entry.getModificationTime().toMilliseconds();
+
+        auto it = indexedByPath.find(track.file.getFullPathName());
+        if (it != indexedByPath.end())
+        {
+            seen[it->second] = 1;
+            const Track& old = indexed[it->second];
+            if (old.size == track.size && old.modified == track.modified)
+            {
+                current.push_back(old);
+                continue;
+            }
+        }
+
+        toOpen.push_back(current.size());
+        current.push_back(std::move(track));
+    }
+
+    for (size_t i = 0; i < indexed.size(); ++i)
+        if (seen[i] == 0)
+            missingFiles.add(indexed[i].file);
+    stats.numMissing = missingFiles.size();
+
+    // new and changed files: tags in parallel, lengths one after the other
+    for (size_t first = 0; first < toOpen.size(); first += batchSize)
+    {
+        const size_t last = jmin(toOpen.size(), first + (size_t)batchSize);
+        Array<File> files;
+        for (size_t i = first; i < last; ++i)
+            files.add(current[toOpen[i]].file);
+        std::vector<TrackTags> tags = TagReader::readTagsParallel(files);
+
+        std::vector<Track> batch;
+        for (size_t i = first; i < last; ++i)
+        {
+            if (stopping())
+                return stats;
+
+            Track& track = current[toOpen[i]];
+            track.tags = std::move(tags[i - first]);
+            track.duration = readDuration(track.file);
+            batch.push_back(track);
+        }
+        stats.numOpened += (int)batch.size();
+        handOver(batch);
+    }
+
+    writeIndex(current);
+    stats.totalMs = elapsedMs();
+    return stats;
+}
+
+double LibraryScanner::readDuration(const File& file)
+{
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->sampleRate <= 0)
+        return 0.0;
+    return reader->lengthInSamples / reader->sampleRate;
+}
+
+//==============================================================================
+bool LibraryScanner::readIndex(std::vector<Track>& tracks) const
+{
+    tracks.clear();
+
+    MemoryBlock data;
+    if (!indexFile.loadFileAsData(data) || data.getSize() < 12)
+        return false;
+
+    MemoryInputStream in(data, false);
+    char magic[4];
+    in.read(magic, 4);
+    if (memcmp(magic, "OTLX", 4) != 0 || in.readInt() != version)
+        return false;
+
+    const int count = in.readInt();
+    if (count < 0)
+        return false;
+    tracks.reserve((size_t)count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (in.isExhausted())
+        {
+            // cut short: trust none of it and rebuild from the folder
+            tracks.clear();
+            return false;
+        }
+
+        Track track;
+        track.file = tracksFolder.getChildFile(in.readString());
+        track.size = in.readInt64();
+        track.modified = in.readInt64();
+        track.duration = in.readDouble();
+        track.tags.title = in.readString();
+        track.tags.artist = in.readString();
+        track.tags.album = in.readString();
+        track.tags.genre = in.readString();
+        track.tags.comment = in.readString();
+        tracks.push_back(std::move(track));
+    }
+    return true;
+}
+
+bool LibraryScanner::writeIndex(const std::vector<Track>& tracks) const
+{
+    TemporaryFile temp(indexFile);
+    {
+        FileOutputStream out(temp.getFile());
+        if (!out.openedOk())
+            return false;
+
+        out.write("OTLX", 4);
+        out.writeInt(version);
+        out.writeInt((int)tracks.size());
+        for (auto& track : tracks)
+        {
+            out.writeString(track.file.getRelativePathFrom(tracksFolder));
+            out.writeInt64(track.size);
+            out.writeInt64(track.modified);
+            out.writeDouble(track.duration);
+            out.writeString(track.tags.title);
+            out.writeString(track.tags.artist);
+            out.writeString(track.tags.album);
+            out.writeString(track.tags.genre);
+            out.writeString(track.tags.comment);
+        }
+
+        out.flush();
+        if (out.getStatus().failed())
+            return false;
+    }
+    return temp.overwriteTargetFileWithTemporary();
+}
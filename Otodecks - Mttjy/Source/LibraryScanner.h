@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    LibraryScanner.h
+    Created: 20 Oct 2026 1:52:37am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+#include <unordered_map>
+#include "TagReader.h"
+
+//==============================================================================
+/*
+    Builds the library's track list on a background thread, so the window
+    never waits for the tracks folder.
+
+    The previous session's list is kept in library_index.otlx next to the
+    tracks folder. A scan reads that first and hands every track in it over
+    at once, so the table is full a few milliseconds after launch. Then it
+    walks the folder: files whose size and modification time match the
+    index are taken as they are, new or changed ones are opened for their
+    tags and length. Index entries whose file has gone are reported as
+    missing. Results are handed over in batches with a change message, and
+    the index is rewritten atomically when the scan is done.
+
+        "OTLX" int32 version, int32 count
+        count x { string relative path, int64 size, int64 modified ms,
+                  double duration, string title artist album genre comment }
+*/
+class LibraryScanner : public ChangeBroadcaster
+{
+public:
+    struct Track
+    {
+        File file;
+        int64 size = 0;
+        int64 modified = 0;
+        double duration = 0;
+        TrackTags tags;
+    };
+
+    struct Stats
+    {
+        int numIndexed = 0;       // tracks handed over from the index
+        int numOpened = 0;        // new or changed files that had to be opened
+        int numMissing = 0;
+        double firstBatchMs = 0;  // from the start of the scan to the first tracks handed over
+        double totalMs = 0;
+    };
+
+    LibraryScanner(const File& tracksFolder);
+    ~LibraryScanner() override;
+
+    /** rescan in the background; a scan already running is abandoned */
+    void startScan();
+    bool isScanning() const;
+
+    /** message thread: tracks found or changed since the last call */
+    std::vector<Track> takeFoundTracks();
+    /** message thread: indexed files that turned out to be gone */
+    Array<File> takeMissingFiles();
+    /** the figures of the last scan that finished */
+    Stats getLastStats() const;
+
+    /** the scan itself, on the calling thread; each batch goes to onBatch as it is ready,
+        and indexed files that are gone are added to missingFiles */
+    Stats scan(std::function<void(std::vector<Track>&)> onBatch, Array<File>& missingFiles,
+               std::function<bool()> shouldStop = nullptr);
+
+    /** length in seconds, 0 if no format can read it; safe from any thread */
+    double readDuration(const File& file);
+
+    File getIndexFile() const;
+
+private:
+    class ScanJob;
+
+    static constexpr int version = 1;
+    static constexpr int batchSize = 256;
+
+    bool readIndex(std::vector<Track>& tracks) const;
+    bool writeIndex(const std::vector<Track>& tracks) const;
+
+    File tracksFolder;
+    File indexFile;
+    AudioFormatManager formatManager;
+
+    ThreadPool pool{ 1 };
+
+    mutable CriticalSection resultLock;
+    std::vector<Track> found;
+    Array<File> missing;
+    Stats lastStats;
+    std::atomic<bool> scanning{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LibraryScanner)
+};
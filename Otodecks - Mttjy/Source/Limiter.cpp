@@ -0,0 +1,314 @@
+/*
+  ==============================================================================
+
+    Limiter.cpp
+    Created: 20 Oct 2026 6:41:19am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "Limiter.h"
+
+namespace
+{
+    // the detector's output for sample i is centred between its input samples i + 5 and i + 6
+    constexpr int centreTap = 5;
+}
+
+Limiter::Limiter()
+{
+    // a Hann-windowed sinc per fractional position, scaled to unity gain at DC
+    for (int p = 0; p < numPhases; ++p)
+    {
+        const double fraction = (p + 1) / (double)(numPhases + 1);
+        double sum = 0;
+        for (int t = 0; t < numTaps; ++t)
+        {
+            const double x = t - centreTap - fraction;
+            const double sinc = std::sin(MathConstants<double>::pi * x) / (MathConstants<double>::pi * x);
+            const double window = 0.5 + 0.5 * std::cos(MathConstants<double>::pi * x / (numTaps / 2));
+            coefficients[(size_t)p][(size_t)t] = (float)(sinc * window);
+            sum += sinc * window;
+        }
+        for (auto& c : coefficients[(size_t)p])
+            c = (float)(c / sum);
+    }
+}
+
+Limiter::~Limiter()
+{
+}
+
+void Limiter::prepare(double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+    blockSize = jmax(1, maximumBlockSize);
+
+    // a peak found at detector sample n is at input sample n - centreTap - 1, and the
+    // gain has come all the way down for it lookahead - 1 samples after it is found
+    lookahead = jmax(1, roundToInt(lookaheadMs * 0.001 * sampleRate));
+    latency = lookahead + centreTap;
+
+    detectorInput.setSize(2, numTaps - 1 + blockSize);
+    detectorInput.clear();
+    work.setSize(3, blockSize);
+    peak = work.getWritePointer(0);
+    estimate = work.getWritePointer(1);
+    gainCurve = work.getWritePointer(2);
+
+    delayLine.setSize(2, nextPowerOfTwo(latency + blockSize));
+    delayLine.clear();
+    delayMask = delayLine.getNumSamples() - 1;
+    delayWritePos = 0;
+
+    // up to lookahead + 1 candidates at once, and a full ring would look empty
+    const int minimumCapacity = nextPowerOfTwo(lookahead + 2);
+    minimumValue.allocate((size_t)minimumCapacity, true);
+    minimumSample.allocate((size_t)minimumCapacity, true);
+    minimumMask = minimumCapacity - 1;
+    averageHistory.allocate((size_t)lookahead, true);
+
+    active = false;
+    gain = 1.0f;
+    gainReductionDb = 0.0f;
+    numClippedSamples = 0;
+    resetGain();
+}
+
+void Limiter::reset() noexcept
+{
+    detectorInput.clear();
+    delayLine.clear();
+    delayWritePos = 0;
+    active = false;
+    gain = 1.0f;
+    gainReductionDb.store(0.0f, std::memory_order_relaxed);
+    resetGain();
+}
+
+int Limiter::getLatencySamples() const
+{
+    return latency;
+}
+
+void Limiter::process(AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    if (blockSize == 0)
+        return;
+
+    const int numChannels = jmin(2, buffer.getNumChannels());
+
+    // devices may hand over bigger blocks than promised; the buffers stay as prepared
+    for (int done = 0; done < numSamples; done += blockSize)
+        processChunk(buffer, startSample + done, jmin(blockSize, numSamples - done), numChannels);
+}
+
+void Limiter::processChunk(AudioBuffer<float>& buffer, int startSample, int numSamples, int numChannels) noexcept
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+        detectorInput.copyFrom(ch, numTaps - 1, buffer, ch, startSample, numSamples);
+
+    const bool shouldBeActive = enabled.load(std::memory_order_relaxed);
+    if (shouldBeActive && !active)
+        resetGain();    // nothing asked for below unity while it was off
+    active = shouldBeActive;
+
+    // off and fully released: only the delay is left to do
+    const bool limiting = active || gain < 1.0f;
+    const float ceiling = Decibels::decibelsToGain(ceilingDb.load(std::memory_order_relaxed));
+    if (limiting)
+    {
+        if (active)
+        {
+            detectPeaks(numSamples, numChannels);
+
+            // the gain that takes each peak down to the ceiling, and 1 where it is under
+            FloatVectorOperations::max(peak, peak, ceiling, numSamples);
+            for (int i = 0; i < numSamples; ++i)
+                peak[i] = ceiling / peak[i];
+        }
+        else
+        {
+            FloatVectorOperations::fill(peak, 1.0f, numSamples);
+        }
+
+        const double releaseSamples = releaseMs.load(std::memory_order_relaxed) * 0.001 * sampleRate;
+        computeGain(numSamples, (float)(1.0 - std::exp(-1.0 / jmax(1.0, releaseSamples))));
+    }
+
+    delay(buffer, startSample, numSamples, numChannels);
+
+    if (limiting)
+    {
+        // the clip only catches rounding, and the first lookahead after switching on,
+        // when the peaks coming out of the delay were never seen by the detector;
+        // anything it catches past rounding is counted, so a test can see a miss
+        const float clipThreshold = ceiling * 1.0001f;
+        int clipped = 0;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* io = buffer.getWritePointer(ch, startSample);
+            FloatVectorOperations::multiply(io, gainCurve, numSamples);
+            if (active)
+            {
+                const auto range = FloatVectorOperations::findMinAndMax(io, numSamples);
+                if (range.getEnd() > clipThreshold || range.getStart() < -clipThreshold)
+                    for (int i = 0; i < numSamples; ++i)
+                        clipped += std::abs(io[i]) > clipThreshold ? 1 : 0;
+                FloatVectorOperations::clip(io, io, -ceiling, ceiling, numSamples);
+            }
+        }
+        if (clipped > 0)
+            numClippedSamples.fetch_add(clipped, std::memory_order_relaxed);
+        gainReductionDb.store(Decibels::gainToDecibels(FloatVectorOperations::findMinimum(gainCurve, numSamples), -100.0f),
+                              std::memory_order_relaxed);
+    }
+    else
+    {
+        gainReductionDb.store(0.0f, std::memory_order_relaxed);
+    }
+
+    // keep the last numTaps - 1 samples for the next block's detector
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* history = detectorInput.getWritePointer(ch);
+        std::memmove(history, history + numSamples, sizeof(float) * (numTaps - 1));
+    }
+}
+
+void Limiter::detectPeaks(int numSamples, int numChannels) noexcept
+{
+    FloatVectorOperations::clear(peak, numSamples);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float* input = detectorInput.getReadPointer(ch);
+
+        // the sample itself...
+        FloatVectorOperations::abs(estimate, input + centreTap, numSamples);
+        FloatVectorOperations::max(peak, peak, estimate, numSamples);
+
+        // ...and the points between it and the next, a tap at a time across the block
+        for (auto& phase : coefficients)
+        {
+            FloatVectorOperations::multiply(estimate, input, phase[0], numSamples);
+            for (int t = 1; t < numTaps; ++t)
+                FloatVectorOperations::addWithMultiply(estimate, input + t, phase[(size_t)t], numSamples);
+            FloatVectorOperations::abs(estimate, estimate, numSamples);
+            FloatVectorOperations::max(peak, peak, estimate, numSamples);
+        }
+    }
+}
+
+void Limiter::computeGain(int numSamples, float releaseCoefficient) noexcept
+{
+    const double scale = 1.0 / lookahead;
+
+    for (int i = 0; i < numSamples; ++i, ++detectorSample)
+    {
+        // drop the candidates this one beats, and the one that has left the window
+        const float required = peak[i];
+        while (minimumTail != minimumHead && minimumValue[(minimumTail - 1) & minimumMask] >= required)
+            minimumTail = (minimumTail - 1) & minimumMask;
+        minimumValue[minimumTail] = required;
+        minimumSample[minimumTail] = detectorSample;
+        minimumTail = (minimumTail + 1) & minimumMask;
+        if (minimumSample[minimumHead] <= detectorSample - lookahead)
+            minimumHead = (minimumHead + 1) & minimumMask;
+
+        const float minimum = minimumValue[minimumHead];
+        averageSum += minimum - averageHistory[averagePos];
+        averageHistory[averagePos] = minimum;
+        if (++averagePos == lookahead)
+            averagePos = 0;
+
+        // the average only ramps down as fast as the lookahead allows; going back up is the release
+        const float target = jmin(1.0f, (float)(averageSum * scale));
+        gain = target < gain ? target : gain + (target - gain) * releaseCoefficient;
+        if (gain > 0.9999f && target >= 1.0f)
+            gain = 1.0f;
+        gainCurve[i] = gain;
+    }
+}
+
+void Limiter::delay(AudioBuffer<float>& buffer, int startSample, int numSamples, int numChannels) noexcept
+{
+    const int capacity = delayMask + 1;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* line = delayLine.getWritePointer(ch);
+        float* io = buffer.getWritePointer(ch, startSample);
+
+        // the whole block goes in before any of it comes out: the line is at
+        // least latency + blockSize long, so nothing is overwritten unread
+        for (int i = 0; i < numSamples;)
+        {
+            const int writeIndex = (delayWritePos + i) & delayMask;
+            const int run = jmin(numSamples - i, capacity - writeIndex);
+            FloatVectorOperations::copy(line + writeIndex, io + i, run);
+            i += run;
+        }
+        for (int i = 0; i < numSamples;)
+        {
+            const int readIndex = (delayWritePos + i - latency) & delayMask;
+            const int run = jmin(numSamples - i, capacity - readIndex);
+            FloatVectorOperations::copy(io + i, line + readIndex, run);
+            i += run;
+        }
+    }
+
+    delayWritePos = (delayWritePos + numSamples) & delayMask;
+}
+
+void Limiter::resetGain() noexcept
+{
+    minimumHead = minimumTail = 0;
+    detectorSample = 0;
+    for (int i = 0; i < lookahead; ++i)
+        averageHistory[i] = 1.0f;
+    averagePos = 0;
+    averageSum = lookahead;
+}
+
+//==============================================================================
+void Limiter::setEnabled(bool shouldBeEnabled)
+{
+    enabled = shouldBeEnabled;
+}
+
+bool Limiter::isEnabled() const
+{
+    return enabled.load();
+}
+
+void Limiter::setCeilingDb(float newCeilingDb)
+{
+    ceilingDb = jlimit(-12.0f, 0.0f, newCeilingDb);
+}
+
+float Limiter::getCeilingDb() const
+{
+    return ceilingDb.load();
+}
+
+void Limiter::setReleaseMs(float newReleaseMs)
+{
+    releaseMs = jlimit(10.0f, 1000.0f, newReleaseMs);
+}
+
+float Limiter::getReleaseMs() const
+{
+    return releaseMs.load();
+}
+
+float Limiter::getGainReductionDb() const
+{
+    return gainReductionDb.load();
+}
+
+int64 Limiter::getNumClippedSamples() const
+{
+    return numClippedSamples.load();
+}
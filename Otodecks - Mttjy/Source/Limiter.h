@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    Limiter.h
+    Created: 20 Oct 2026 6:41:19am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/*
+    A true-peak lookahead limiter for a stereo pair, linked across the two
+    channels. The engine runs one on the master and one on every deck, after
+    its effects, though the decks' are left out of the path while all of
+    them are off (see MixEngine).
+
+    The peak detector looks between samples as well as at them: three
+    points between each pair are interpolated with a windowed-sinc filter
+    (4x oversampling over 48 taps, as BS.1770 measures true peak). Every detected
+    peak asks for the gain that brings it down to the ceiling. Over the
+    lookahead the limiter takes the smallest gain asked for and averages
+    it, so the gain is already down by the time the peak comes out of the
+    delay. Afterwards it recovers with the release time. The detector, the
+    gain curve and applying the gain work on whole blocks with
+    FloatVectorOperations or loops the compiler vectorizes. The windowed
+    minimum and the release are per sample.
+
+    Every buffer is allocated in prepare(), and the delay stays the same
+    whether the limiter is on or off: getLatencySamples() never changes
+    mid-stream, and switching the limiter doesn't make the audio jump. Off,
+    the gain releases back to 1 and the limiter is only a delay.
+*/
+class Limiter
+{
+public:
+    static constexpr double lookaheadMs = 1.5;
+
+    Limiter();
+    ~Limiter();
+
+    /** allocates everything for this rate and block size, and clears the delay */
+    void prepare(double sampleRate, int maximumBlockSize);
+
+    /** audio thread: limit the first two channels in place */
+    void process(AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    /** audio thread: empty the delay and let the gain go, for a limiter put
+        back in the path after blocks it didn't see */
+    void reset() noexcept;
+
+    /** how far the output trails the input; fixed once prepared */
+    int getLatencySamples() const;
+
+    /** any thread */
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const;
+    /** in dB true peak, -12 to 0 */
+    void setCeilingDb(float ceilingDb);
+    float getCeilingDb() const;
+    /** time to recover 63% of the way back to unity gain, 10 to 1000 ms */
+    void setReleaseMs(float releaseMs);
+    float getReleaseMs() const;
+
+    /** the deepest gain reduction in the last block processed, in dB (0 or less) */
+    float getGainReductionDb() const;
+    /** samples over the ceiling that the final clip caught since prepare(), rounding
+        aside; anything after the first lookahead switched on is a miss */
+    int64 getNumClippedSamples() const;
+
+private:
+    static constexpr int numTaps = 12;
+    static constexpr int numPhases = 3;     // points between samples, at 1/4, 1/2 and 3/4
+
+    void processChunk(AudioBuffer<float>& buffer, int startSample, int numSamples, int numChannels) noexcept;
+    /** peak[i]: the highest true peak of either channel around detector sample i */
+    void detectPeaks(int numSamples, int numChannels) noexcept;
+    /** gain[i] from required[i]: windowed minimum, averaged, then released */
+    void computeGain(int numSamples, float releaseCoefficient) noexcept;
+    void delay(AudioBuffer<float>& buffer, int startSample, int numSamples, int numChannels) noexcept;
+    void resetGain() noexcept;
+
+    std::atomic<bool> enabled{ false };
+    std::atomic<float> ceilingDb{ -1.0f };
+    std::atomic<float> releaseMs{ 100.0f };
+    std::atomic<float> gainReductionDb{ 0.0f };
+    std::atomic<int64> numClippedSamples{ 0 };
+
+    double sampleRate = 44100.0;
+    int blockSize = 0;
+    int lookahead = 1;
+    int latency = 0;
+
+    std::array<std::array<float, numTaps>, numPhases> coefficients{};
+
+    // audio thread only
+    bool active = false;
+    float gain = 1.0f;
+
+    AudioBuffer<float> detectorInput;   // numTaps - 1 samples of history, then the block
+    AudioBuffer<float> work;            // peak, estimate, gain
+    float* peak = nullptr;
+    float* estimate = nullptr;
+    float* gainCurve = nullptr;
+
+    AudioBuffer<float> delayLine;       // power-of-two length, indexed with delayMask
+    int delayMask = 0;
+    int delayWritePos = 0;
+
+    // the smallest gain asked for over the lookahead: a ring of candidates, each
+    // smaller than the ones before it, so the oldest is the minimum
+    HeapBlock<float> minimumValue;
+    HeapBlock<int64> minimumSample;
+    int minimumMask = 0;
+    int minimumHead = 0;
+    int minimumTail = 0;
+    int64 detectorSample = 0;
+
+    // the running average of those minimums over the lookahead
+    HeapBlock<float> averageHistory;
+    int averagePos = 0;
+    double averageSum = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Limiter)
+};
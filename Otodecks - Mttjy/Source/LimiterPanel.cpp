@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    LimiterPanel.cpp
+    Created: 20 Oct 2026 7:02:54am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "LimiterPanel.h"
+
+//==============================================================================
+LimiterPanel::LimiterPanel(MixEngine& _engine)
+    : engine(_engine)
+{
+    Limiter& master = engine.getMasterLimiter();
+
+    addAndMakeVisible(masterButton);
+    masterButton.setToggleState(master.isEnabled(), dontSendNotification);
+    masterButton.onClick = [this] { engine.getMasterLimiter().setEnabled(masterButton.getToggleState()); };
+
+    addAndMakeVisible(ceilingSlider);
+    ceilingSlider.setSliderStyle(Slider::LinearHorizontal);
+    ceilingSlider.setTextBoxStyle(Slider::TextBoxRight, false, 56, 20);
+    ceilingSlider.setRange(-12.0, 0.0, 0.1);
+    ceilingSlider.setTextValueSuffix(" dBTP");
+    ceilingSlider.setValue(master.getCeilingDb(), dontSendNotification);
+    ceilingSlider.setDoubleClickReturnValue(true, -1.0);
+    ceilingSlider.setTooltip("Ceiling");
+    ceilingSlider.onValueChange = [this] { applySettings(); };
+
+    addAndMakeVisible(releaseSlider);
+    releaseSlider.setSliderStyle(Slider::LinearHorizontal);
+    releaseSlider.setTextBoxStyle(Slider::TextBoxRight, false, 50, 20);
+    releaseSlider.setRange(10.0, 1000.0, 1.0);
+    releaseSlider.setSkewFactorFromMidPoint(100.0);
+    releaseSlider.setTextValueSuffix(" ms");
+    releaseSlider.setValue(master.getReleaseMs(), dontSendNotification);
+    releaseSlider.setDoubleClickReturnValue(true, 100.0);
+    releaseSlider.setTooltip("Release");
+    releaseSlider.onValueChange = [this] { applySettings(); };
+
+    addAndMakeVisible(reductionLabel);
+    reductionLabel.setFont(12.0f);
+
+    startTimerHz(15);
+}
+
+LimiterPanel::~LimiterPanel()
+{
+    stopTimer();
+}
+
+void LimiterPanel::addDeck(DJAudioPlayer* player)
+{
+    players.add(player);
+
+    auto* button = deckButtons.add(new ToggleButton("D" + String(players.size())));
+    addAndMakeVisible(button);
+    button->setToggleState(player->getLimiter().isEnabled(), dontSendNotification);
+    button->onClick = [player, button] { player->getLimiter().setEnabled(button->getToggleState()); };
+
+    applySettings();
+    resized();
+}
+
+void LimiterPanel::paint (Graphics& g)
+{
+    g.fillAll(Colour::fromRGB(15, 15, 15));
+}
+
+void LimiterPanel::resized()
+{
+    auto area = getLocalBounds();
+    masterButton.setBounds(area.removeFromLeft(60));
+    for (auto* button : deckButtons)
+        button->setBounds(area.removeFromLeft(40));
+    reductionLabel.setBounds(area.removeFromRight(64));
+    const int sliderW = area.getWidth() / 2;
+    ceilingSlider.setBounds(area.removeFromLeft(sliderW));
+    releaseSlider.setBounds(area);
+}
+
+void LimiterPanel::timerCallback()
+{
+    const float reduction = engine.getMasterLimiter().getGainReductionDb();
+    reductionLabel.setText(reduction < -0.05f ? "GR " + String(reduction, 1) : "GR 0", dontSendNotification);
+    reductionLabel.setColour(Label::textColourId, reduction < -3.0f ? Colours::orange : Colours::lightgrey);
+}
+
+void LimiterPanel::applySettings()
+{
+    const float ceiling = (float)ceilingSlider.getValue();
+    const float release = (float)releaseSlider.getValue();
+
+    engine.getMasterLimiter().setCeilingDb(ceiling);
+    engine.getMasterLimiter().setReleaseMs(release);
+    for (auto* player : players)
+    {
+        player->getLimiter().setCeilingDb(ceiling);
+        player->getLimiter().setReleaseMs(release);
+    }
+}
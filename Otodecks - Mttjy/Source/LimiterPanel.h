@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    LimiterPanel.h
+    Created: 20 Oct 2026 7:02:54am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MixEngine.h"
+
+//==============================================================================
+/*
+    Master limiter switch, a switch per deck limiter, the ceiling and release
+    they all share, and the master's gain reduction.
+*/
+class LimiterPanel  : public Component,
+                      public Timer
+{
+public:
+    LimiterPanel(MixEngine& engine);
+    ~LimiterPanel() override;
+
+    /** a switch for player's limiter, which takes the panel's ceiling and release */
+    void addDeck(DJAudioPlayer* player);
+
+    void paint (Graphics&) override;
+    void resized() override;
+
+    void timerCallback() override;
+
+private:
+    void applySettings();
+
+    MixEngine& engine;
+    Array<DJAudioPlayer*> players;
+
+    ToggleButton masterButton{ "Limit" };
+    OwnedArray<ToggleButton> deckButtons;
+    Slider ceilingSlider;
+    Slider releaseSlider;
+    Label reductionLabel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LimiterPanel)
+};
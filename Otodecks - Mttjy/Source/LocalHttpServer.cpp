@@ -0,0 +1,233 @@
+/*
+  ==============================================================================
+
+    LocalHttpServer.cpp
+    Created: 20 Oct 2026 5:48:51am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "LocalHttpServer.h"
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <csignal>
+#endif
+
+namespace
+{
+    constexpr int maxHeaderBytes = 8192;
+    constexpr int sendBytes = 4096;
+    constexpr int requestTimeoutMs = 5000;
+
+    String getContentType(const File& file)
+    {
+        const String extension = file.getFileExtension().toLowerCase();
+        if (extension == ".wav")  return "audio/wav";
+        if (extension == ".aiff" || extension == ".aif") return "audio/aiff";
+        if (extension == ".mp3")  return "audio/mpeg";
+        if (extension == ".flac") return "audio/flac";
+        if (extension == ".ogg")  return "audio/ogg";
+        return "application/octet-stream";
+    }
+}
+
+/** one connection: a request and its response */
+class LocalHttpServer::ConnectionJob : public ThreadPoolJob
+{
+public:
+    ConnectionJob(LocalHttpServer& _owner, StreamingSocket* _socket)
+        : ThreadPoolJob("HTTP connection"), owner(_owner), socket(_socket)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        owner.serve(*socket, *this);
+        socket->close();
+        return jobHasFinished;
+    }
+
+private:
+    LocalHttpServer& owner;
+    std::unique_ptr<StreamingSocket> socket;
+};
+
+//==============================================================================
+LocalHttpServer::LocalHttpServer(const File& _folder, const Options& _options)
+    : Thread("HTTP stand-in"), folder(_folder), options(_options)
+{
+}
+
+LocalHttpServer::~LocalHttpServer()
+{
+    stop();
+}
+
+bool LocalHttpServer::start(String& error)
+{
+   #if JUCE_LINUX || JUCE_MAC
+    // a client dropping a connection to seek must not take the process with it
+    std::signal(SIGPIPE, SIG_IGN);
+   #endif
+
+    if (!listener.createListener(options.port, "127.0.0.1"))
+    {
+        error = "cannot listen on port " + String(options.port);
+        return false;
+    }
+    startThread();
+    return true;
+}
+
+void LocalHttpServer::stop()
+{
+    // closing the listener wakes the accept in run()
+    signalThreadShouldExit();
+    listener.close();
+    stopThread(2000);
+    pool.removeAllJobs(true, 5000);
+}
+
+int LocalHttpServer::getPort() const
+{
+    return listener.getBoundPort();
+}
+
+URL LocalHttpServer::getURL(const File& file) const
+{
+    return URL("http://127.0.0.1:" + String(getPort()) + "/" + URL::addEscapeChars(file.getFileName(), false));
+}
+
+LocalHttpServer::Stats LocalHttpServer::getStats() const
+{
+    Stats stats;
+    stats.numRequests = numRequests.load();
+    stats.numRangeRequests = numRangeRequests.load();
+    stats.bytesSent = bytesSent.load();
+    return stats;
+}
+
+//==============================================================================
+void LocalHttpServer::run()
+{
+    while (!threadShouldExit())
+    {
+        std::unique_ptr<StreamingSocket> connection(listener.waitForNextConnection());
+        if (connection == nullptr || threadShouldExit())
+            break;
+        pool.addJob(new ConnectionJob(*this, connection.release()), true);
+    }
+}
+
+void LocalHttpServer::serve(StreamingSocket& socket, const ThreadPoolJob& job)
+{
+    // the request line and headers, up to the blank line
+    String header;
+    while (!header.endsWith("\r\n\r\n"))
+    {
+        char byte = 0;
+        if (header.length() > maxHeaderBytes || job.shouldExit()
+            || socket.waitUntilReady(true, requestTimeoutMs) != 1 || socket.read(&byte, 1, true) != 1)
+            return;
+        header += byte;
+    }
+    ++numRequests;
+
+    const StringArray lines = StringArray::fromLines(header);
+    const StringArray requestLine = StringArray::fromTokens(lines[0], " ", {});
+    const String method = requestLine[0];
+    const File file = resolve(requestLine[1]);
+
+    int64 rangeStart = -1, rangeEnd = -1;
+    for (auto& line : lines)
+    {
+        if (!line.startsWithIgnoreCase("Range:"))
+            continue;
+        const String spec = line.fromFirstOccurrenceOf("bytes=", false, true).trim();
+        const String end = spec.fromFirstOccurrenceOf("-", false, false).trim();
+        rangeStart = spec.upToFirstOccurrenceOf("-", false, false).getLargeIntValue();
+        rangeEnd = end.isEmpty() ? -1 : end.getLargeIntValue();
+    }
+
+    Thread::sleep(options.latencyMs);
+
+    auto sendHeaders = [&socket](const String& status, const String& extraHeaders, int64 contentLength)
+    {
+        String response;
+        response << "HTTP/1.1 " << status << "\r\n" << extraHeaders
+                 << "Content-Length: " << contentLength << "\r\n"
+                 << "Connection: close\r\n\r\n";
+        return socket.write(response.toRawUTF8(), (int)response.getNumBytesAsUTF8()) > 0;
+    };
+
+    if (method != "GET" && method != "HEAD")
+    {
+        sendHeaders("405 Method Not Allowed", {}, 0);
+        return;
+    }
+    if (!file.existsAsFile())
+    {
+        sendHeaders("404 Not Found", {}, 0);
+        return;
+    }
+
+    const int64 size = file.getSize();
+    int64 first = 0, last = size - 1;
+    String extraHeaders;
+    extraHeaders << "Content-Type: " << getContentType(file) << "\r\n"
+                 << "Accept-Ranges: " << (options.supportRanges ? "bytes" : "none") << "\r\n";
+
+    const bool partial = rangeStart >= 0 && options.supportRanges;
+    if (partial)
+    {
+        ++numRangeRequests;
+        if (rangeStart >= size)
+        {
+            sendHeaders("416 Range Not Satisfiable", "Content-Range: bytes */" + String(size) + "\r\n", 0);
+            return;
+        }
+        first = rangeStart;
+        last = rangeEnd >= 0 ? jmin(rangeEnd, size - 1) : size - 1;
+        extraHeaders << "Content-Range: bytes " << first << "-" << last << "/" << size << "\r\n";
+    }
+
+    if (!sendHeaders(partial ? "206 Partial Content" : "200 OK", extraHeaders, last - first + 1) || method == "HEAD")
+        return;
+
+    FileInputStream in(file);
+    if (!in.openedOk() || !in.setPosition(first))
+        return;
+
+    HeapBlock<char> buffer(sendBytes);
+    const double startMs = Time::getMillisecondCounterHiRes();
+    int64 sent = 0;
+    for (int64 remaining = last - first + 1; remaining > 0 && !job.shouldExit();)
+    {
+        const int numRead = in.read(buffer, (int)jmin((int64)sendBytes, remaining));
+        // a failed write is the client hanging up, which it does to seek
+        if (numRead <= 0 || socket.write(buffer, numRead) != numRead)
+            return;
+
+        sent += numRead;
+        remaining -= numRead;
+        bytesSent += numRead;
+
+        if (options.bytesPerSecond > 0)
+        {
+            const double aheadMs = sent * 1000.0 / (double)options.bytesPerSecond - (Time::getMillisecondCounterHiRes() - startMs);
+            if (aheadMs >= 1.0)
+                Thread::sleep((int)aheadMs);
+        }
+    }
+}
+
+File LocalHttpServer::resolve(const String& path) const
+{
+    const String name = URL::removeEscapeChars(path.upToFirstOccurrenceOf("?", false, false)).trimCharactersAtStart("/");
+    if (name.isEmpty() || name.contains(".."))
+        return {};
+
+    const File file = folder.getChildFile(name);
+    return file.isAChildOf(folder) ? file : File();
+}
@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    LocalHttpServer.h
+    Created: 20 Oct 2026 5:48:51am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+
+//==============================================================================
+/*
+    A small HTTP/1.1 file server on 127.0.0.1 that stands in for a media
+    server, so streamed playback can be tried without one. It answers GET
+    and HEAD for the files in one folder, honours "Range: bytes=a-" and
+    "bytes=a-b" with 206 Partial Content, and closes every connection after
+    its response.
+
+    Both injected faults apply to every response: latencyMs passes before
+    the headers go out, as if it were a round trip, and the body is paced
+    to bytesPerSecond. Each connection gets a pool thread of its own, so a
+    client that drops one connection to seek can open the next straight
+    away.
+*/
+class LocalHttpServer : private Thread
+{
+public:
+    struct Options
+    {
+        int port = 0;               // 0 picks a free one
+        int latencyMs = 0;
+        int64 bytesPerSecond = 0;   // 0 for as fast as the socket goes
+        bool supportRanges = true;  // false answers every request with the whole file
+    };
+
+    struct Stats
+    {
+        int numRequests = 0;
+        int numRangeRequests = 0;
+        int64 bytesSent = 0;
+    };
+
+    LocalHttpServer(const File& folder, const Options& options);
+    ~LocalHttpServer() override;
+
+    /** false with error if the port can't be listened on */
+    bool start(String& error);
+    void stop();
+
+    int getPort() const;
+    /** the URL a file in the folder is served at */
+    URL getURL(const File& file) const;
+    Stats getStats() const;
+
+private:
+    class ConnectionJob;
+
+    void run() override;
+    void serve(StreamingSocket& socket, const ThreadPoolJob& job);
+    /** the file a request path names, or a non-existent File if it is outside the folder */
+    File resolve(const String& path) const;
+
+    const File folder;
+    const Options options;
+
+    StreamingSocket listener;
+    ThreadPool pool{ 8 };
+
+    std::atomic<int> numRequests{ 0 };
+    std::atomic<int> numRangeRequests{ 0 };
+    std::atomic<int64> bytesSent{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LocalHttpServer)
+};
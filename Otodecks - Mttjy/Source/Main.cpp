@@ -10,6 +10,8 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "MainComponent.h"
+#include "HeadlessRunner.h"
+#include "StartupTimer.h"
 
 //==============================================================================
 class OtoDecksApplication  : public JUCEApplication
@@ -25,6 +27,15 @@ public:
     void initialise (const String& commandLine) override
     {
         // This method is where you should put your application's initialisation code..
+        StartupTimer::markLaunch();
+
+        // headless runs (e.g. --render mix.txt out.wav) never open a window or an audio device;
+        // the mode runs on its own thread and quits the app when it is done
+        if (HeadlessRunner::isHeadlessCommandLine (commandLine))
+        {
+            headlessRunner.reset (new HeadlessRunner (commandLine));
+            return;
+        }
 
         mainWindow.reset (new MainWindow (getApplicationName()));
     }
@@ -34,6 +45,7 @@ public:
         // Add your application's shutdown code here..
 
         mainWindow = nullptr; // (deletes our window)
+        headlessRunner = nullptr;
     }
 
     //==============================================================================
@@ -98,6 +110,7 @@ public:
 
 private:
     std::unique_ptr<MainWindow> mainWindow;
+    std::unique_ptr<HeadlessRunner> headlessRunner;
 };
 
 //==============================================================================
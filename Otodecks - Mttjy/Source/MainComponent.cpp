@@ -8,56 +8,133 @@
 
 #include "MainComponent.h"
 
+namespace
+{
+    // one session log per device start; older ones go as new ones are opened
+    constexpr int maxSessionLogs = 20;
+
+    File getLogsFolder()
+    {
+        return File::getSpecialLocation(File::userApplicationDataDirectory).getChildFile("Otodecks").getChildFile("logs");
+    }
+
+    /** all but the newest keep session logs in folder */
+    void deleteOldSessionLogs(const File& folder, int keep)
+    {
+        Array<File> logs = folder.findChildFiles(File::findFiles, false, "session_*.otlog");
+        if (logs.size() <= keep)
+            return;
+
+        // the names sort by the time they were opened
+        std::sort(logs.begin(), logs.end(), [](const File& a, const File& b) { return a.getFileName() < b.getFileName(); });
+        for (int i = 0; i < logs.size() - keep; ++i)
+            logs.getReference(i).deleteFile();
+    }
+}
+
 //==============================================================================
 MainComponent::MainComponent()
 {
+    // the decks, the band analyser and the auto-DJ only hold a reference, but a
+    // track can be dropped on a deck as soon as the window is up
+    formatManager.registerBasicFormats();
+
     // Make sure you set the size of the component after
     // you add any child components.
     setSize (900, 700);
 
-    // Some platforms require permissions to open input channels so request that here
-    if (RuntimePermissions::isRequired (RuntimePermissions::recordAudio)
-        && ! RuntimePermissions::isGranted (RuntimePermissions::recordAudio))
-    {
-        RuntimePermissions::request (RuntimePermissions::recordAudio,
-                                     [&] (bool granted) { if (granted)  setAudioChannels (2, 2); });
-    }  
-    else
-    {
-        // Specify the number of input and output channels that we want to open
-        setAudioChannels (0, 2);
-    }  
+    // decks must be in the engine before the device starts calling it
+    mixEngine.addDeck(&player1);
+    mixEngine.addDeck(&player2);
+    player1.setReaderPool(&readerPool);
+    player2.setReaderPool(&readerPool);
+    readerPool.setDecodeCache(&playlistComponent.getDecodeCache());
+    bandAnalyser.setStoreDirectory(thumbnailCacheFile.getSiblingFile("bands"));
+    limiterPanel.addDeck(&player1);
+    limiterPanel.addDeck(&player2);
+    deckGUI1.onPflChanged = [this](bool on) { mixEngine.setCueEnabled(0, on); };
+    deckGUI2.onPflChanged = [this](bool on) { mixEngine.setCueEnabled(1, on); };
+    deckGUI1.isPflEnabled = [this] { return mixEngine.isCueEnabled(0); };
+    deckGUI2.isPflEnabled = [this] { return mixEngine.isCueEnabled(1); };
+    deckGUI1.getQuantizedSample = [this] { return mixEngine.getQuantizedSample(); };
+    deckGUI2.getQuantizedSample = [this] { return mixEngine.getQuantizedSample(); };
 
     addAndMakeVisible(deckGUI1); 
     addAndMakeVisible(deckGUI2);
+    displayRefresher.addDeck(&deckGUI1);
+    displayRefresher.addDeck(&deckGUI2);
 
     addAndMakeVisible(playlistComponent);
+    addAndMakeVisible(dspLoadPanel);
+    addAndMakeVisible(recorderPanel);
+    addAndMakeVisible(headphonePanel);
+    addAndMakeVisible(limiterPanel);
+    addAndMakeVisible(midiPanel);
+    addAndMakeVisible(tempoPanel);
+    addAndMakeVisible(autoDjPanel);
+    autoDjPanel.getQueue = [this] { return playlistComponent.getQueue(); };
+
+    addAndMakeVisible(recommendPanel);
+    recommendPanel.getDeckTrack = [this](int deck)
+    {
+        const URL url = (deck == 0 ? player1 : player2).getLoadedURL();
+        return url.isLocalFile() ? url.getLocalFile() : File();
+    };
+    recommendPanel.onPick = [this](const File& file) { playlistComponent.selectTrack(file); };
 
-
-    formatManager.registerBasicFormats();
+    // the audio device and MIDI inputs can take hundreds of milliseconds to open,
+    // so they wait for the first paint (see openDevices)
 }
 
 MainComponent::~MainComponent()
 {
+    // the playlist, and its cache, go before the pool does
+    readerPool.setDecodeCache(nullptr);
+    midiController.closeInputs();
+
+    // while the decks still hold what they were playing
+    sessionSnapshot.stop();
+    TemporaryFile thumbsTemp(thumbnailCacheFile);
+    {
+        FileOutputStream thumbsOut(thumbsTemp.getFile());
+        if (thumbsOut.openedOk())
+            thumbCache.writeToStream(thumbsOut);
+    }
+    thumbsTemp.overwriteTargetFileWithTemporary();
+
     // This shuts down the audio device and clears the audio source.
     shutdownAudio();
+    mixEngine.setEventLog(nullptr);
+    eventLog.close();
+    mixEngine.setRecorder(nullptr);
+    masterRecorder.stop();
+
+    // the RtCheck build's findings, for after a session of real use
+    const File logs = getLogsFolder();
+    if (RealtimeCheck::isEnabled() && logs.createDirectory().wasOk())
+        logs.getChildFile("realtime_check.txt").replaceWithText(RealtimeCheck::getReport());
 }
 
 //==============================================================================
 void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
-    player1.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    player2.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    
-    mixerSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-
-    mixerSource.addInputSource(&player1, false);
-    mixerSource.addInputSource(&player2, false);
-
- }
+    mixEngine.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    masterRecorder.prepare(sampleRate, 2);
+    StartupTimer::mark(StartupTimer::audioRunning);
+
+    // the engine's sample clock restarts here, so every device start gets its own log
+    const File logs = getLogsFolder();
+    deleteOldSessionLogs(logs, maxSessionLogs - 1);
+    File logFile = logs.getChildFile("session_" + Time::getCurrentTime().formatted("%Y%m%d_%H%M%S") + ".otlog");
+    String error;
+    if (eventLog.open(logFile, sampleRate, samplesPerBlockExpected, error))
+        mixEngine.setEventLog(&eventLog);
+    else
+        DBG("Event log disabled: " << error);
+}
 void MainComponent::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
 {
-    mixerSource.getNextAudioBlock(bufferToFill);
+    mixEngine.getNextAudioBlock(bufferToFill);
 }
 
 void MainComponent::releaseResources()
@@ -66,9 +143,7 @@ void MainComponent::releaseResources()
     // restarted due to a setting change.
 
     // For more details, see the help for AudioProcessor::releaseResources()
-    player1.releaseResources();
-    player2.releaseResources();
-    mixerSource.releaseResources();
+    mixEngine.releaseResources();
 }
 
 //==============================================================================
@@ -78,6 +153,62 @@ void MainComponent::paint (Graphics& g)
     //g.fillAll (getLookAndFeel().findColour (ResizableWindow::backgroundColourId));
 
     // You can add your drawing code here!
+
+    if (!devicesRequested)
+    {
+        devicesRequested = true;
+        StartupTimer::mark(StartupTimer::firstFrame);
+
+        // after this paint has reached the screen
+        MessageManager::callAsync([safeThis = Component::SafePointer<MainComponent>(this)]
+        {
+            if (safeThis != nullptr)
+                safeThis->openDevices();
+        });
+    }
+}
+
+void MainComponent::openDevices()
+{
+    // queued before the device opens, so the first block already plays from the right place
+    restoreSession();
+
+    // Some platforms require permissions to open input channels so request that here
+    if (RuntimePermissions::isRequired (RuntimePermissions::recordAudio)
+        && ! RuntimePermissions::isGranted (RuntimePermissions::recordAudio))
+    {
+        RuntimePermissions::request (RuntimePermissions::recordAudio,
+                                     [&] (bool granted) { if (granted)  setAudioChannels (2, 4); });
+    }  
+    else
+    {
+        // Specify the number of input and output channels that we want to open:
+        // master on 1/2 and the headphone cue on 3/4, where the device has them
+        setAudioChannels (0, 4);
+    }  
+
+    // controllers go straight to the decks, so only open them once the decks are in the engine
+    midiController.openInputs();
+}
+
+void MainComponent::restoreSession()
+{
+    const double startMs = Time::getMillisecondCounterHiRes();
+
+    // the waveforms of the restored tracks are drawn from here instead of a rescan
+    FileInputStream thumbsIn(thumbnailCacheFile);
+    if (thumbsIn.openedOk())
+        thumbCache.readFromStream(thumbsIn);
+
+    SessionSnapshot::Session last;
+    if (SessionSnapshot::read(sessionSnapshot.getFile(), last))
+    {
+        const int restored = sessionSnapshot.restore(last);
+        DBG("Restored " << restored << " decks from " << (last.cleanShutdown ? "a clean shutdown" : "a crash")
+            << " in " << String(Time::getMillisecondCounterHiRes() - startMs, 1) << " ms");
+    }
+
+    sessionSnapshot.start();
 }
 
 void MainComponent::resized()
@@ -85,10 +216,28 @@ void MainComponent::resized()
     int MIN_HEIGHT = 500;
     int MIN_WIDTH = 700;
 
-    double rH = getHeight() / 6;
+    // three rows of panels along the bottom
+    int panelH = 22;
+    double rH = (getHeight() - panelH * 3) / 6;
     deckGUI1.setBounds(0, 0, getWidth()/2, rH * 4);
     deckGUI2.setBounds(getWidth()/2, 0, getWidth()/2, rH * 4);
-    playlistComponent.setBounds(0, rH * 4, getWidth(), rH * 2);
+    int recommendW = jmin(320, getWidth() / 3);
+    playlistComponent.setBounds(0, rH * 4, getWidth() - recommendW, rH * 2);
+    recommendPanel.setBounds(getWidth() - recommendW, rH * 4, recommendW, rH * 2);
+    int recorderW = 320;
+    int headphoneW = 240;
+    int tempoW = 240;
+    int autoDjW = 360;
+    int row1 = getHeight() - panelH * 3;
+    int row2 = getHeight() - panelH * 2;
+    int row3 = getHeight() - panelH;
+    recorderPanel.setBounds(0, row1, recorderW, panelH);
+    headphonePanel.setBounds(recorderW, row1, headphoneW, panelH);
+    midiPanel.setBounds(recorderW + headphoneW, row1, getWidth() - recorderW - headphoneW, panelH);
+    tempoPanel.setBounds(0, row2, tempoW, panelH);
+    autoDjPanel.setBounds(tempoW, row2, autoDjW, panelH);
+    dspLoadPanel.setBounds(tempoW + autoDjW, row2, getWidth() - tempoW - autoDjW, panelH);
+    limiterPanel.setBounds(0, row3, getWidth(), panelH);
 
     if (getWidth() < MIN_WIDTH || getHeight() < MIN_HEIGHT)
     {
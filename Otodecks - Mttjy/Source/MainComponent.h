@@ -12,6 +12,22 @@
 #include "DJAudioPlayer.h"
 #include "DeckGUI.h"
 #include "PlaylistComponent.h"
+#include "MixEngine.h"
+#include "DspLoadPanel.h"
+#include "MasterRecorder.h"
+#include "RecorderPanel.h"
+#include "HeadphonePanel.h"
+#include "LimiterPanel.h"
+#include "MidiController.h"
+#include "MidiPanel.h"
+#include "DisplayRefresher.h"
+#include "TempoPanel.h"
+#include "AutoDJ.h"
+#include "AutoDjPanel.h"
+#include "EngineEventLog.h"
+#include "StartupTimer.h"
+#include "SessionSnapshot.h"
+#include "RecommendPanel.h"
 
 //==============================================================================
 /*
@@ -35,21 +51,49 @@ public:
     void resized() override;
 
 private:
+    /** open the audio device and the MIDI inputs; deferred until the window has been drawn */
+    void openDevices();
+    /** put the decks back the way the last run left them, and start snapshotting */
+    void restoreSession();
+
     //==============================================================================
     // Your private member variables go here...
      
     AudioFormatManager formatManager;
     AudioThumbnailCache thumbCache{100}; 
+    ReaderPool readerPool{formatManager};
+    BandAnalyser bandAnalyser{readerPool};
 
     DJAudioPlayer player1{formatManager};
-    DeckGUI deckGUI1{&player1, formatManager, thumbCache, &playlistComponent}; 
+    DeckGUI deckGUI1{&player1, formatManager, thumbCache, bandAnalyser, &playlistComponent}; 
 
     DJAudioPlayer player2{formatManager};
-    DeckGUI deckGUI2{&player2, formatManager, thumbCache, &playlistComponent}; 
+    DeckGUI deckGUI2{&player2, formatManager, thumbCache, bandAnalyser, &playlistComponent}; 
 
-    MixerAudioSource mixerSource; 
+    MixEngine mixEngine;
     
     PlaylistComponent playlistComponent;
+    RecommendPanel recommendPanel{playlistComponent.getRecommender()};
+
+    DspLoadPanel dspLoadPanel{mixEngine.getMonitor(), deviceManager};
+
+    EngineEventLog eventLog;
+    SessionSnapshot sessionSnapshot{mixEngine, File::getCurrentWorkingDirectory().getChildFile("session.otss")};
+    File thumbnailCacheFile{File::getCurrentWorkingDirectory().getChildFile("thumbnails.cache")};
+
+    MasterRecorder masterRecorder;
+    RecorderPanel recorderPanel{masterRecorder, mixEngine, deviceManager};
+    HeadphonePanel headphonePanel{mixEngine, deviceManager};
+    LimiterPanel limiterPanel{mixEngine};
+    TempoPanel tempoPanel{mixEngine, deviceManager};
+    AutoDJ autoDJ{mixEngine};
+    AutoDjPanel autoDjPanel{autoDJ};
+
+    MidiController midiController{mixEngine};
+    MidiPanel midiPanel{midiController, File::getCurrentWorkingDirectory().getChildFile("midi_mapping.txt")};
+
+    DisplayRefresher displayRefresher{*this, deviceManager, mixEngine};
+    bool devicesRequested = false;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
 };
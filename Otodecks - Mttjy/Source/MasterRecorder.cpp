@@ -0,0 +1,252 @@
+/*
+  ==============================================================================
+
+    MasterRecorder.cpp
+    Created: 19 Oct 2026 11:47:19am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "MasterRecorder.h"
+
+MasterRecorder::MasterRecorder()
+{
+}
+
+MasterRecorder::~MasterRecorder()
+{
+    stop();
+    writerThread.stopThread(2000);
+}
+
+void MasterRecorder::setBufferSeconds(double seconds)
+{
+    bufferSeconds = jmax(0.1, seconds);
+}
+
+void MasterRecorder::setRotationMinutes(double minutes)
+{
+    rotationMinutes = jmax(0.0, minutes);
+}
+
+void MasterRecorder::setWriterStallMs(int milliseconds)
+{
+    writerStallMs = jmax(0, milliseconds);
+}
+
+void MasterRecorder::prepare(double newSampleRate, int newNumChannels)
+{
+    newNumChannels = jmax(1, newNumChannels);
+    const int capacity = jmax(4096, (int)(bufferSeconds * newSampleRate));
+    if (newSampleRate == sampleRate && newNumChannels == numChannels && fifoBuffer.getNumSamples() == capacity)
+        return;
+
+    // once stopped the writer thread has let go of the FIFO, and the device isn't calling back
+    stop();
+
+    sampleRate = newSampleRate;
+    numChannels = newNumChannels;
+    fifoBuffer.setSize(numChannels, capacity);
+    fifoBuffer.clear();
+    fifo.setTotalSize(capacity);
+}
+
+bool MasterRecorder::start(const File& file, String& error)
+{
+    stop();
+
+    if (fifoBuffer.getNumSamples() == 0)
+    {
+        error = "The recorder hasn't been prepared for an audio device";
+        return false;
+    }
+
+    baseFile = file;
+    fileIndex = 0;
+    {
+        const ScopedLock sl(fileLock);
+        rotationError.clear();
+    }
+
+    if (!openWriter(file, error))
+        return false;
+
+    // anything still queued was pushed by a callback that saw the last recording running.
+    // Discarding it is the reading side's job, which is safe while the audio thread writes.
+    fifo.finishedRead(fifo.getNumReady());
+
+    droppedBlocks = 0;
+    samplesRecorded = 0;
+    recording = true;
+
+    writerThread.addTimeSliceClient(this);
+    if (!writerThread.isThreadRunning())
+        writerThread.startThread();
+    return true;
+}
+
+void MasterRecorder::stop()
+{
+    if (!recording.exchange(false))
+        return;
+
+    // once removed, the writer thread is no longer touching the file
+    writerThread.removeTimeSliceClient(this);
+
+    const ScopedLock sl(fileLock);
+    while (drainFifo() > 0) {}
+    writer.reset();
+}
+
+bool MasterRecorder::isRecording() const
+{
+    return recording.load();
+}
+
+void MasterRecorder::pushBlock(const AudioSourceChannelInfo& info) noexcept
+{
+    if (!recording.load(std::memory_order_acquire))
+        return;
+
+    if (fifo.getFreeSpace() < info.numSamples)
+    {
+        droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(info.numSamples, start1, size1, start2, size2);
+
+    const int channelsToCopy = jmin(numChannels, info.buffer->getNumChannels());
+    for (int ch = 0; ch < channelsToCopy; ++ch)
+    {
+        if (size1 > 0)
+            fifoBuffer.copyFrom(ch, start1, *info.buffer, ch, info.startSample, size1);
+        if (size2 > 0)
+            fifoBuffer.copyFrom(ch, start2, *info.buffer, ch, info.startSample + size1, size2);
+    }
+    for (int ch = channelsToCopy; ch < numChannels; ++ch)
+    {
+        if (size1 > 0)
+            fifoBuffer.clear(ch, start1, size1);
+        if (size2 > 0)
+            fifoBuffer.clear(ch, start2, size2);
+    }
+
+    fifo.finishedWrite(size1 + size2);
+}
+
+int MasterRecorder::getNumDroppedBlocks() const
+{
+    return droppedBlocks.load();
+}
+
+double MasterRecorder::getSecondsRecorded() const
+{
+    return samplesRecorded.load() / sampleRate;
+}
+
+File MasterRecorder::getCurrentFile() const
+{
+    const ScopedLock sl(fileLock);
+    return currentFile;
+}
+
+String MasterRecorder::getRotationError() const
+{
+    const ScopedLock sl(fileLock);
+    return rotationError;
+}
+
+int MasterRecorder::useTimeSlice()
+{
+    const int stall = writerStallMs.load();
+    if (stall > 0)
+        Thread::sleep(stall);
+
+    const ScopedLock sl(fileLock);
+    return drainFifo() > 0 ? 0 : 20;
+}
+
+int MasterRecorder::drainFifo()
+{
+    const int numReady = fifo.getNumReady();
+    if (numReady == 0 || writer == nullptr)
+        return 0;
+
+    const int64 rotationSamples = (int64)(rotationMinutes * 60.0 * sampleRate);
+    int numToWrite = numReady;
+    if (rotationSamples > 0)
+        numToWrite = (int)jmin((int64)numToWrite, rotationSamples - samplesInCurrentFile);
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numToWrite, start1, size1, start2, size2);
+    if (size1 > 0)
+        writer->writeFromAudioSampleBuffer(fifoBuffer, start1, size1);
+    if (size2 > 0)
+        writer->writeFromAudioSampleBuffer(fifoBuffer, start2, size2);
+    fifo.finishedRead(size1 + size2);
+
+    samplesInCurrentFile += size1 + size2;
+    samplesRecorded += size1 + size2;
+
+    if (rotationSamples > 0 && samplesInCurrentFile >= rotationSamples)
+    {
+        // losing the recording is worse than one long file, so a split that fails
+        // keeps writing where it was and is tried again a rotation period later
+        String error;
+        if (openWriter(getRotatedFile(fileIndex + 1), error))
+        {
+            ++fileIndex;
+            rotationError.clear();
+        }
+        else
+        {
+            DBG("MasterRecorder: " << error);
+            rotationError = error;
+            samplesInCurrentFile = 0;
+        }
+    }
+    return size1 + size2;
+}
+
+bool MasterRecorder::openWriter(const File& file, String& error)
+{
+    std::unique_ptr<AudioFormat> format;
+    if (file.hasFileExtension("flac"))
+        format = std::make_unique<FlacAudioFormat>();
+    else
+        format = std::make_unique<WavAudioFormat>();
+
+    file.deleteFile();
+    std::unique_ptr<FileOutputStream> stream(file.createOutputStream());
+    if (stream == nullptr)
+    {
+        error = "Cannot write " + file.getFullPathName();
+        return false;
+    }
+
+    std::unique_ptr<AudioFormatWriter> newWriter(format->createWriterFor(stream.get(), sampleRate, (unsigned int)numChannels, 24, {}, 0));
+    if (newWriter == nullptr)
+    {
+        error = "Cannot create a " + format->getFormatName() + " writer for " + file.getFullPathName();
+        return false;
+    }
+    stream.release(); // the writer owns it now
+
+    // the last file is finished off as its writer goes
+    writer = std::move(newWriter);
+    samplesInCurrentFile = 0;
+    currentFile = file;
+    return true;
+}
+
+File MasterRecorder::getRotatedFile(int index) const
+{
+    if (index == 0)
+        return baseFile;
+
+    return baseFile.getSiblingFile(baseFile.getFileNameWithoutExtension()
+                                   + "_part" + String(index + 1) + baseFile.getFileExtension());
+}
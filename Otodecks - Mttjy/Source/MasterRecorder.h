@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    MasterRecorder.h
+    Created: 19 Oct 2026 11:47:19am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+
+//==============================================================================
+/*
+    Records the master output to WAV or FLAC.
+
+    The audio thread only copies each block into a lock-free FIFO; a
+    background thread drains it into the file, like
+    AudioFormatWriter::ThreadedWriter. If the disk falls behind and the FIFO
+    is full the block is dropped and counted instead of waiting.
+    Long recordings are split into numbered files. If the next file can't
+    be opened, recording carries on in the current one, the error is kept
+    for the UI (getRotationError), and the split is tried again after
+    another rotation period.
+
+    The FIFO is allocated in prepare(), never by start() or stop(): a
+    callback that saw the last recording still running may be copying into
+    it while the next one starts.
+*/
+class MasterRecorder : private TimeSliceClient
+{
+public:
+    MasterRecorder();
+    ~MasterRecorder() override;
+
+    /** size of the FIFO between the audio thread and the disk, used by the next prepare() */
+    void setBufferSeconds(double seconds);
+    /** start a new file every so many minutes, 0 to never rotate */
+    void setRotationMinutes(double minutes);
+    /** make the writer sleep before every write, to check that disk stalls stay off the audio thread */
+    void setWriterStallMs(int milliseconds);
+
+    /** from prepareToPlay, while no audio callback is running: allocates the FIFO for
+        this rate, once. A recording at another rate or channel count is stopped. */
+    void prepare(double sampleRate, int numChannels);
+
+    /** open file (.wav or .flac) and start accepting blocks; needs prepare() first */
+    bool start(const File& file, String& error);
+    /** stop accepting blocks, flush what is queued and close the file */
+    void stop();
+    bool isRecording() const;
+
+    /** audio thread: queue a block, never blocks */
+    void pushBlock(const AudioSourceChannelInfo& info) noexcept;
+
+    int getNumDroppedBlocks() const;
+    double getSecondsRecorded() const;
+    File getCurrentFile() const;
+    /** why the last attempt to start the next file failed, empty once one succeeds */
+    String getRotationError() const;
+
+private:
+    int useTimeSlice() override;
+    int drainFifo();
+    /** switch to a new file; on failure the current one stays open */
+    bool openWriter(const File& file, String& error);
+    File getRotatedFile(int index) const;
+
+    TimeSliceThread writerThread{ "Otodecks recorder" };
+
+    AbstractFifo fifo{ 1 };
+    AudioBuffer<float> fifoBuffer;
+
+    std::unique_ptr<AudioFormatWriter> writer;
+    File baseFile;
+    File currentFile;
+    int fileIndex = 0;
+    int64 samplesInCurrentFile = 0;     // since the last split, or the last failed attempt at one
+    String rotationError;
+
+    double sampleRate = 44100.0;
+    int numChannels = 2;
+    double bufferSeconds = 10.0;
+    double rotationMinutes = 60.0;
+
+    std::atomic<bool> recording{ false };
+    std::atomic<int> droppedBlocks{ 0 };
+    std::atomic<int64> samplesRecorded{ 0 };
+    std::atomic<int> writerStallMs{ 0 };
+
+    CriticalSection fileLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MasterRecorder)
+};
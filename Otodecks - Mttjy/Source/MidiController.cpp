@@ -0,0 +1,417 @@
+/*
+  ==============================================================================
+
+    MidiController.cpp
+    Created: 19 Oct 2026 8:40:12pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "MidiController.h"
+#include "JogWheel.h"
+
+namespace
+{
+    const StringArray actionNames{ "play", "stop", "restart", "loop", "pfl", "volume", "speed", "jogtouch", "jog" };
+    const StringArray sourceNames{ "note", "cc", "cc14", "pitchbend" };
+
+    constexpr double defaultPitchRange = 0.08;
+}
+
+MidiController::MidiController(MixEngine& _engine)
+    : engine(_engine)
+{
+}
+
+MidiController::~MidiController()
+{
+    closeInputs();
+}
+
+void MidiController::openInputs()
+{
+    closeInputs();
+
+    for (auto& info : MidiInput::getAvailableDevices())
+    {
+        if (auto input = MidiInput::openDevice(info.identifier, this))
+        {
+            input->start();
+            inputs.add(input.release());
+        }
+    }
+
+   #if JUCE_LINUX || JUCE_MAC
+    // a port other programs can connect to, e.g. aconnect or a virtual keyboard
+    if (auto input = MidiInput::createNewDevice("Otodecks", this))
+    {
+        input->start();
+        inputs.add(input.release());
+    }
+   #endif
+}
+
+void MidiController::closeInputs()
+{
+    for (auto* input : inputs)
+        input->stop();
+    inputs.clear();
+}
+
+StringArray MidiController::getOpenInputNames() const
+{
+    StringArray names;
+    for (auto* input : inputs)
+        names.add(input->getName());
+    return names;
+}
+
+//==============================================================================
+void MidiController::setBindings(const Array<Binding>& newBindings)
+{
+    const SpinLock::ScopedLockType sl(bindingLock);
+    bindings.assign(newBindings.begin(), newBindings.end());
+    lastValues.assign(bindings.size(), -1);
+}
+
+Array<MidiController::Binding> MidiController::getBindings() const
+{
+    Array<Binding> result;
+    const SpinLock::ScopedLockType sl(bindingLock);
+    for (auto& b : bindings)
+        result.add(b);
+    return result;
+}
+
+void MidiController::addBinding(const Binding& binding)
+{
+    // one control drives one thing: a relearnt control replaces its old binding
+    for (size_t i = bindings.size(); i-- > 0;)
+    {
+        const Binding& b = bindings[i];
+        if (b.source == binding.source && b.channel == binding.channel && b.number == binding.number)
+        {
+            bindings.erase(bindings.begin() + (std::ptrdiff_t)i);
+            lastValues.erase(lastValues.begin() + (std::ptrdiff_t)i);
+        }
+    }
+
+    bindings.push_back(binding);
+    lastValues.push_back(-1);
+}
+
+String MidiController::getActionName(Action action)
+{
+    return actionNames[(int)action];
+}
+
+String MidiController::getSourceName(Source source)
+{
+    return sourceNames[(int)source];
+}
+
+bool MidiController::isContinuous(Action action)
+{
+    return action == Action::volume || action == Action::speed || action == Action::jog;
+}
+
+bool MidiController::loadMapping(const File& file, String& error)
+{
+    StringArray lines;
+    file.readLines(lines);
+
+    Array<Binding> loaded;
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        const String line = lines[i].upToFirstOccurrenceOf("#", false, false).trim();
+        if (line.isEmpty())
+            continue;
+
+        StringArray tokens = StringArray::fromTokens(line, " \t", "");
+        tokens.removeEmptyStrings();
+
+        const int action = actionNames.indexOf(tokens[1].toLowerCase());
+        const int source = sourceNames.indexOf(tokens[2].toLowerCase());
+        if (tokens.size() < 5 || action < 0 || source < 0)
+        {
+            error = file.getFileName() + " line " + String(i + 1)
+                  + ": expected <deck> <action> <source> <channel> <number> [relative] [scale <x>]";
+            return false;
+        }
+
+        Binding b;
+        b.deck = tokens[0].getIntValue() - 1;
+        b.action = (Action)action;
+        b.source = (Source)source;
+        b.channel = jlimit(0, 16, tokens[3].getIntValue());
+        b.number = jlimit(0, 127, tokens[4].getIntValue());
+        b.relative = tokens.contains("relative");
+        if (tokens.contains("scale"))
+            b.scale = tokens[tokens.indexOf("scale") + 1].getDoubleValue();
+        loaded.add(b);
+    }
+
+    setBindings(loaded);
+    return true;
+}
+
+bool MidiController::saveMapping(const File& file) const
+{
+    String text = "# deck action source channel number [relative] [scale x]\n";
+    for (auto& b : getBindings())
+    {
+        text << (b.deck + 1) << " " << getActionName(b.action) << " " << getSourceName(b.source)
+             << " " << b.channel << " " << b.number;
+        if (b.relative)
+            text << " relative";
+        if (b.scale != 0)
+            text << " scale " << b.scale;
+        text << "\n";
+    }
+
+    TemporaryFile temp(file);
+    return temp.getFile().replaceWithText(text) && temp.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+void MidiController::learn(int deck, Action action)
+{
+    const SpinLock::ScopedLockType sl(bindingLock);
+    learnDeck = deck;
+    learnAction = action;
+    learnMsbChannel = learnMsbNumber = -1;
+    learning = true;
+}
+
+void MidiController::cancelLearn()
+{
+    learning = false;
+}
+
+bool MidiController::isLearning() const
+{
+    return learning.load();
+}
+
+void MidiController::learnFrom(const MidiMessage& message)
+{
+    const int channel = message.getChannel();
+    if (channel == 0)
+        return;
+
+    Binding b;
+    b.deck = learnDeck;
+    b.action = learnAction;
+    b.channel = channel;
+
+    if (message.isNoteOn())
+    {
+        b.source = Source::note;
+        b.number = message.getNoteNumber();
+    }
+    else if (message.isPitchWheel())
+    {
+        b.source = Source::pitchBend;
+    }
+    else if (message.isController())
+    {
+        const int number = message.getControllerNumber();
+
+        if (learnMsbNumber >= 0 && channel == learnMsbChannel && number == learnMsbNumber + 32)
+        {
+            b.source = Source::cc14;
+            b.number = learnMsbNumber;
+        }
+        else if (learnMsbNumber >= 0)
+        {
+            // the MSB came without an LSB after it: a plain 7-bit controller
+            b.source = Source::cc;
+            b.number = learnMsbNumber;
+            b.channel = learnMsbChannel;
+        }
+        else if (isContinuous(learnAction) && number < 32)
+        {
+            // wait for the next message to see whether an LSB follows
+            learnMsbChannel = channel;
+            learnMsbNumber = number;
+            return;
+        }
+        else
+        {
+            b.source = Source::cc;
+            b.number = number;
+        }
+
+        // 7-bit jog wheels almost always send offsets, 14-bit ones positions
+        b.relative = learnAction == Action::jog && b.source == Source::cc;
+    }
+    else
+    {
+        return;
+    }
+
+    addBinding(b);
+    learning = false;
+    learnMsbChannel = learnMsbNumber = -1;
+    sendChangeMessage();
+}
+
+//==============================================================================
+void MidiController::handleIncomingMidiMessage(MidiInput*, const MidiMessage& message)
+{
+    const int channel = message.getChannel();
+    if (channel == 0)
+        return;
+
+    const SpinLock::ScopedLockType sl(bindingLock);
+
+    if (learning.load())
+    {
+        learnFrom(message);
+        return;
+    }
+
+    const double timestamp = message.getTimeStamp();
+
+    auto matches = [channel](const Binding& b, Source source)
+    {
+        return b.source == source && (b.channel == 0 || b.channel == channel);
+    };
+
+    if (message.isNoteOnOrOff())
+    {
+        const int note = message.getNoteNumber();
+        const int value = message.isNoteOn() ? 1 : 0;
+        for (size_t i = 0; i < bindings.size(); ++i)
+            if (matches(bindings[i], Source::note) && bindings[i].number == note)
+                dispatch(i, value, 1, timestamp);
+    }
+    else if (message.isController())
+    {
+        const int number = message.getControllerNumber();
+        const int value = message.getControllerValue();
+        if (number < 32)
+            controllerMsb[channel - 1][number] = (uint8)value;
+
+        for (size_t i = 0; i < bindings.size(); ++i)
+        {
+            const Binding& b = bindings[i];
+            if (matches(b, Source::cc) && b.number == number)
+                dispatch(i, value, 127, timestamp);
+            else if (matches(b, Source::cc14) && b.number < 32 && number == b.number + 32)
+                dispatch(i, (controllerMsb[channel - 1][b.number] << 7) | value, 16383, timestamp);
+        }
+    }
+    else if (message.isPitchWheel())
+    {
+        const int value = message.getPitchWheelValue();
+        for (size_t i = 0; i < bindings.size(); ++i)
+            if (matches(bindings[i], Source::pitchBend))
+                dispatch(i, value, 16383, timestamp);
+    }
+}
+
+void MidiController::dispatch(size_t bindingIndex, int value, int maxValue, double timestamp)
+{
+    const Binding& b = bindings[bindingIndex];
+    DJAudioPlayer* player = engine.getDeck(b.deck);
+    if (player == nullptr)
+        return;
+
+    const bool pressed = value > 0;
+    const int64 when = engine.getQuantizedSample();
+    const double normalised = (double)value / maxValue;
+    double applied = normalised;
+
+    switch (b.action)
+    {
+        case Action::play:
+            if (!pressed)
+                return;
+            if (player->isPlaying())
+                player->stopAt(when);
+            else
+                player->startAt(when);
+            break;
+        case Action::stop:
+            if (!pressed)
+                return;
+            player->stopAt(when);
+            break;
+        case Action::restart:
+            if (!pressed)
+                return;
+            player->setPositionAt(0, when);
+            player->startAt(when);
+            break;
+        case Action::loop:
+            if (!pressed)
+                return;
+            player->setLoopingAt(!player->isLooping(), when);
+            break;
+        case Action::pfl:
+            if (!pressed)
+                return;
+            engine.setCueEnabled(b.deck, !engine.isCueEnabled(b.deck));
+            break;
+        case Action::volume:
+            player->setGain(normalised);
+            break;
+        case Action::speed:
+            applied = 1.0 + (normalised * 2.0 - 1.0) * (b.scale > 0 ? b.scale : defaultPitchRange);
+            player->setSpeed(applied);
+            break;
+        case Action::jogTouch:
+            if (pressed)
+                player->beginScratch();
+            else
+                player->endScratch();
+            break;
+        case Action::jog:
+        {
+            const int range = maxValue + 1;
+            int delta = 0;
+            if (b.relative)
+            {
+                delta = value - range / 2;
+            }
+            else
+            {
+                // an absolute wheel wraps around; the short way round is the real movement
+                int& last = lastValues[bindingIndex];
+                delta = last < 0 ? 0 : value - last;
+                last = value;
+                if (delta > range / 2)
+                    delta -= range;
+                else if (delta < -range / 2)
+                    delta += range;
+            }
+            if (delta == 0)
+                return;
+
+            const double perStep = b.scale > 0 ? b.scale : JogWheel::secondsPerTurn / (maxValue > 127 ? 2048.0 : 128.0);
+            applied = delta * perStep;
+            player->jog(applied);
+            break;
+        }
+    }
+
+    Activity activity;
+    activity.deck = b.deck;
+    activity.action = b.action;
+    activity.value = applied;
+    activity.latencyMs = timestamp > 0 ? Time::getMillisecondCounterHiRes() - timestamp * 1000.0 : 0.0;
+
+    const auto scope = activityFifo.write(1);
+    if (scope.blockSize1 > 0)
+        activityQueue[scope.startIndex1] = activity;
+}
+
+int MidiController::readActivity(Activity* destination, int maxItems)
+{
+    int numRead = 0;
+    const auto scope = activityFifo.read(jmin(maxItems, activityFifo.getNumReady()));
+    scope.forEach([&](int index) { destination[numRead++] = activityQueue[index]; });
+    return numRead;
+}
@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    MidiController.h
+    Created: 19 Oct 2026 8:40:12pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MixEngine.h"
+#include <vector>
+
+//==============================================================================
+/*
+    Drives the decks from MIDI controllers.
+
+    Messages are decoded on the MIDI input thread and go straight to the
+    deck setters, which only push into the deck's lock-free command queue,
+    so nothing waits for the message loop. Faders and pitch use 14 bits
+    where the controller sends them: pitch bend, or a controller pair with
+    the MSB on CC n and the LSB on CC n + 32. A pair is applied when its LSB
+    arrives.
+
+    Mapping files have one binding per line:
+
+        <deck> <action> <source> <channel> <number> [relative] [scale <x>]
+
+        1 volume cc14 1 7
+        1 speed pitchbend 1 0 scale 0.08      (+/- 8%)
+        1 jogtouch note 1 54
+        1 jog cc 1 33 relative scale 0.014    (seconds per tick)
+
+    actions: play stop restart loop pfl volume speed jogtouch jog
+    sources: note cc cc14 pitchbend; channel 0 means any.
+*/
+class MidiController : private MidiInputCallback,
+                       public ChangeBroadcaster
+{
+public:
+    enum class Action : uint8
+    {
+        play,
+        stop,
+        restart,
+        loop,
+        pfl,
+        volume,
+        speed,
+        jogTouch,
+        jog
+    };
+
+    enum class Source : uint8
+    {
+        note,
+        cc,
+        cc14,
+        pitchBend
+    };
+
+    struct Binding
+    {
+        int deck = 0;
+        Action action = Action::play;
+        Source source = Source::cc;
+        int channel = 0;          // 1-16, 0 for any
+        int number = 0;           // note, or controller (the MSB for cc14)
+        bool relative = false;    // jog: offsets around the centre value instead of a position
+        double scale = 0;         // speed: +/- range, jog: seconds per step; 0 for the default
+    };
+
+    /** one dispatched message, for monitoring */
+    struct Activity
+    {
+        int deck = 0;
+        Action action = Action::play;
+        double value = 0;
+        double latencyMs = 0;     // from the driver's timestamp to the deck's queue
+    };
+
+    MidiController(MixEngine& engine);
+    ~MidiController() override;
+
+    /** open every MIDI input, plus a virtual "Otodecks" input where the OS has them */
+    void openInputs();
+    void closeInputs();
+    StringArray getOpenInputNames() const;
+
+    void setBindings(const Array<Binding>& bindings);
+    Array<Binding> getBindings() const;
+
+    bool loadMapping(const File& file, String& error);
+    bool saveMapping(const File& file) const;
+
+    /** bind the next note, controller or pitch bend received to this deck and action;
+        a change message is sent when it has been learnt */
+    void learn(int deck, Action action);
+    void cancelLearn();
+    bool isLearning() const;
+
+    /** message thread: take the messages dispatched since the last call */
+    int readActivity(Activity* destination, int maxItems);
+
+    static String getActionName(Action action);
+    static String getSourceName(Source source);
+
+private:
+    void handleIncomingMidiMessage(MidiInput* source, const MidiMessage& message) override;
+
+    void learnFrom(const MidiMessage& message);
+    void dispatch(size_t bindingIndex, int value, int maxValue, double timestamp);
+    void addBinding(const Binding& binding);
+    static bool isContinuous(Action action);
+
+    MixEngine& engine;
+    OwnedArray<MidiInput> inputs;
+
+    // read on the MIDI thread; the lock is only ever held for a lookup or an edit
+    SpinLock bindingLock;
+    std::vector<Binding> bindings;
+    std::vector<int> lastValues;    // per binding, for absolute jog wheels
+    uint8 controllerMsb[16][32] = {};
+
+    std::atomic<bool> learning{ false };
+    int learnDeck = 0;
+    Action learnAction = Action::play;
+    int learnMsbChannel = -1;       // a CC < 32 seen while learning, waiting to see if an LSB follows
+    int learnMsbNumber = -1;
+
+    static constexpr int activitySize = 256;
+    AbstractFifo activityFifo{ activitySize };
+    Activity activityQueue[activitySize];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiController)
+};
@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    MidiPanel.cpp
+    Created: 19 Oct 2026 9:14:51pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "MidiPanel.h"
+
+//==============================================================================
+MidiPanel::MidiPanel(MidiController& _controller, const File& _mappingFile)
+    : controller(_controller),
+      mappingFile(_mappingFile)
+{
+    addAndMakeVisible(midiButton);
+    midiButton.onClick = [this] { showMenu(); };
+
+    addAndMakeVisible(statusLabel);
+    statusLabel.setFont(12.0f);
+
+    controller.addChangeListener(this);
+    if (mappingFile.existsAsFile())
+        loadMapping(mappingFile);
+
+    startTimer(50);
+    timerCallback();
+}
+
+MidiPanel::~MidiPanel()
+{
+    stopTimer();
+    controller.removeChangeListener(this);
+}
+
+void MidiPanel::paint (Graphics& g)
+{
+    g.fillAll(Colour::fromRGB(15, 15, 15));
+}
+
+void MidiPanel::resized()
+{
+    midiButton.setBounds(0, 0, 50, getHeight());
+    statusLabel.setBounds(54, 0, getWidth() - 54, getHeight());
+}
+
+void MidiPanel::timerCallback()
+{
+    MidiController::Activity activity[64];
+    const int numRead = controller.readActivity(activity, 64);
+    if (numRead > 0)
+    {
+        const MidiController::Activity& last = activity[numRead - 1];
+        lastActivity = "D" + String(last.deck + 1) + " " + MidiController::getActionName(last.action)
+                     + " " + String(last.value, 3) + " (" + String(last.latencyMs, 1) + " ms)";
+    }
+
+    statusLabel.setText(describeStatus(), dontSendNotification);
+}
+
+void MidiPanel::changeListenerCallback(ChangeBroadcaster*)
+{
+    // a binding was learnt
+    if (!controller.saveMapping(mappingFile))
+        DBG("Could not save " << mappingFile.getFullPathName());
+    timerCallback();
+}
+
+String MidiPanel::describeStatus() const
+{
+    if (controller.isLearning())
+        return "Move a control...";
+    if (lastActivity.isNotEmpty())
+        return lastActivity;
+    return String(controller.getOpenInputNames().size()) + " in, "
+         + String(controller.getBindings().size()) + " bound";
+}
+
+void MidiPanel::loadMapping(const File& file)
+{
+    String error;
+    if (!controller.loadMapping(file, error))
+    {
+        AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon, "MIDI Mapping", error);
+        return;
+    }
+    if (file != mappingFile)
+        controller.saveMapping(mappingFile);
+}
+
+void MidiPanel::showMenu()
+{
+    const MidiController::Action actions[] = {
+        MidiController::Action::play, MidiController::Action::stop, MidiController::Action::restart,
+        MidiController::Action::loop, MidiController::Action::pfl, MidiController::Action::volume,
+        MidiController::Action::speed, MidiController::Action::jogTouch, MidiController::Action::jog
+    };
+
+    PopupMenu menu;
+    for (int deck = 0; deck < 2; ++deck)
+    {
+        PopupMenu learnMenu;
+        for (auto action : actions)
+            learnMenu.addItem(learnItemBase + deck * 16 + (int)action, MidiController::getActionName(action));
+        menu.addSubMenu("Learn deck " + String(deck + 1), learnMenu);
+    }
+    menu.addItem(cancelLearnItem, "Cancel learn", controller.isLearning());
+    menu.addSeparator();
+    menu.addItem(loadMappingItem, "Load mapping...");
+    menu.addItem(clearMappingItem, "Clear mapping", controller.getBindings().size() > 0);
+
+    Component::SafePointer<MidiPanel> safeThis(this);
+    menu.showMenuAsync(PopupMenu::Options().withTargetComponent(&midiButton), [safeThis](int result)
+    {
+        if (safeThis == nullptr || result == 0)
+            return;
+
+        MidiController& controller = safeThis->controller;
+        if (result >= learnItemBase)
+        {
+            const int item = result - learnItemBase;
+            safeThis->lastActivity.clear();
+            controller.learn(item / 16, (MidiController::Action)(item % 16));
+        }
+        else if (result == cancelLearnItem)
+        {
+            controller.cancelLearn();
+        }
+        else if (result == clearMappingItem)
+        {
+            controller.setBindings({});
+            controller.saveMapping(safeThis->mappingFile);
+        }
+        else if (result == loadMappingItem)
+        {
+            safeThis->chooser = std::make_unique<FileChooser>("Load a MIDI mapping", safeThis->mappingFile, "*.txt");
+            safeThis->chooser->launchAsync(FileBrowserComponent::openMode | FileBrowserComponent::canSelectFiles,
+                                           [safeThis](const FileChooser& fc)
+            {
+                if (safeThis != nullptr && fc.getResult() != File())
+                    safeThis->loadMapping(fc.getResult());
+            });
+        }
+        safeThis->timerCallback();
+    });
+}
@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    MidiPanel.h
+    Created: 19 Oct 2026 9:14:51pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MidiController.h"
+
+//==============================================================================
+/*
+    MIDI learn and mapping menu, with the last message the decks received.
+    Learnt bindings are saved to the mapping file straight away.
+*/
+class MidiPanel  : public Component,
+                   public Timer,
+                   private ChangeListener
+{
+public:
+    MidiPanel(MidiController& controller, const File& mappingFile);
+    ~MidiPanel() override;
+
+    void paint (Graphics&) override;
+    void resized() override;
+
+    void timerCallback() override;
+
+private:
+    void changeListenerCallback(ChangeBroadcaster* source) override;
+    void showMenu();
+    void loadMapping(const File& file);
+    String describeStatus() const;
+
+    enum MenuItem
+    {
+        cancelLearnItem = 1,
+        loadMappingItem,
+        clearMappingItem,
+        learnItemBase = 100    // + deck * 16 + action
+    };
+
+    MidiController& controller;
+    File mappingFile;
+    std::unique_ptr<FileChooser> chooser;
+
+    TextButton midiButton{ "MIDI" };
+    Label statusLabel;
+    String lastActivity;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiPanel)
+};
@@ -0,0 +1,333 @@
+/*
+  ==============================================================================
+
+    MixEngine.cpp
+    Created: 19 Oct 2026 10:31:05am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "MixEngine.h"
+
+MixEngine::MixEngine()
+{
+    masterLimiter.setEnabled(true);
+}
+
+MixEngine::~MixEngine()
+{
+}
+
+void MixEngine::addDeck(DJAudioPlayer* player)
+{
+    // the audio thread walks the deck list without a lock
+    jassert(player != nullptr && currentSampleRate.load() == 0.0);
+    jassert(decks.size() < AudioCallbackMonitor::maxDecks);
+
+    player->setMonitor(&monitor, decks.size());
+    player->setEventLog(eventLog);
+    decks.add(player);
+}
+
+int MixEngine::getNumDecks() const
+{
+    return decks.size();
+}
+
+DJAudioPlayer* MixEngine::getDeck(int index) const
+{
+    return decks[index];
+}
+
+void MixEngine::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    monitor.prepare(samplesPerBlockExpected, sampleRate);
+    currentSampleRate = sampleRate;
+    samplePosition = 0;
+    gridOrigin = 0;
+    largestBlock = samplesPerBlockExpected;
+
+    deckBuffer.setSize(2, samplesPerBlockExpected);
+    cueBuffer.setSize(2, samplesPerBlockExpected);
+    masterLimiter.prepare(sampleRate, samplesPerBlockExpected);
+    cueDelay.prepare(sampleRate, samplesPerBlockExpected);
+
+    for (auto* deck : decks)
+        deck->prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void MixEngine::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
+{
+    const int numSamples = bufferToFill.numSamples;
+    AudioCallbackMonitor::ScopedCallback monitorCallback(monitor, numSamples);
+    RealtimeCheck::ScopedRealtime realtime;
+
+    bufferToFill.clearActiveBufferRegion();
+    if (numSamples > largestBlock.load(std::memory_order_relaxed))
+        largestBlock.store(numSamples, std::memory_order_relaxed);
+
+    // some devices hand over more than they promised in prepareToPlay; the
+    // rest of a block like that is rendered in pieces the buffers were sized for
+    const int chunkSize = deckBuffer.getNumSamples();
+    if (chunkSize == 0)
+        return;
+
+    for (int done = 0; done < numSamples; done += chunkSize)
+        renderChunk(*bufferToFill.buffer, bufferToFill.startSample + done, jmin(chunkSize, numSamples - done));
+}
+
+void MixEngine::renderChunk(AudioBuffer<float>& out, int startSample, int numSamples)
+{
+    const int numMasterChannels = jmin(2, out.getNumChannels());
+    cueBuffer.clear(0, numSamples);
+
+    // one deck limiter on puts all of them in the path, so no deck trails the others
+    bool anyDeckLimiter = false;
+    for (auto* deck : decks)
+        anyDeckLimiter = anyDeckLimiter || deck->getLimiter().isEnabled();
+    deckLimitersInPath.store(anyDeckLimiter, std::memory_order_relaxed);
+
+    const AudioSourceChannelInfo deckInfo(&deckBuffer, 0, numSamples);
+    for (int d = 0; d < decks.size(); ++d)
+    {
+        DJAudioPlayer* deck = decks.getUnchecked(d);
+        deck->setLimiterInPath(anyDeckLimiter);
+        deck->renderPreFader(deckInfo);
+
+        if (cueEnabled[(size_t)d].load(std::memory_order_relaxed))
+            for (int ch = 0; ch < 2; ++ch)
+                cueBuffer.addFrom(ch, 0, deckBuffer, ch, 0, numSamples);
+
+        deck->applyFader(deckInfo);
+        for (int ch = 0; ch < numMasterChannels; ++ch)
+            out.addFrom(ch, startSample, deckBuffer, ch, 0, numSamples);
+    }
+
+    // two decks at full gain sum well past full scale
+    masterLimiter.process(out, startSample, numSamples);
+    cueDelay.process(cueBuffer, 0, numSamples);
+
+    // the recorder takes the master before a split cue can replace it
+    if (auto* r = recorder.load(std::memory_order_acquire))
+        r->pushBlock(AudioSourceChannelInfo(&out, startSample, numSamples));
+
+    mixHeadphones(out, startSample, numSamples);
+
+    samplePosition.fetch_add(numSamples, std::memory_order_release);
+}
+
+void MixEngine::mixHeadphones(AudioBuffer<float>& out, int startSample, int numSamples)
+{
+    const int numChannels = out.getNumChannels();
+    const bool split = splitCue.load(std::memory_order_relaxed);
+
+    int destination = -1;
+    if (numChannels >= cueChannel + 2)
+        destination = cueChannel;
+    else if (split && numChannels >= 2)
+        destination = 0;
+
+    if (destination < 0)
+        return; // nowhere to send the cue
+
+    if (split)
+    {
+        cueBuffer.addFrom(0, 0, cueBuffer, 1, 0, numSamples);
+        cueBuffer.applyGain(0, 0, numSamples, 0.5f);
+        cueBuffer.copyFrom(1, 0, out, 0, startSample, numSamples);
+        cueBuffer.addFrom(1, 0, out, 1, startSample, numSamples);
+        cueBuffer.applyGain(1, 0, numSamples, 0.5f);
+    }
+    else
+    {
+        const float mix = cueMix.load(std::memory_order_relaxed);
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            cueBuffer.applyGain(ch, 0, numSamples, 1.0f - mix);
+            cueBuffer.addFrom(ch, 0, out, ch, startSample, numSamples, mix);
+        }
+    }
+
+    for (int ch = 0; ch < 2; ++ch)
+        out.copyFrom(destination + ch, startSample, cueBuffer, ch, 0, numSamples);
+}
+
+void MixEngine::releaseResources()
+{
+    for (auto* deck : decks)
+        deck->releaseResources();
+}
+
+int64 MixEngine::getSamplePosition() const
+{
+    return samplePosition.load(std::memory_order_acquire);
+}
+
+double MixEngine::getSampleRate() const
+{
+    return currentSampleRate.load();
+}
+
+AudioCallbackMonitor& MixEngine::getMonitor()
+{
+    return monitor;
+}
+
+Limiter& MixEngine::getMasterLimiter()
+{
+    return masterLimiter;
+}
+
+int MixEngine::getLatencySamples() const
+{
+    // in the path, every deck's limiter delays it by the same amount
+    const int deckLatency = (decks.isEmpty() || !areDeckLimitersInPath()) ? 0 : decks.getFirst()->getLimiter().getLatencySamples();
+    return deckLatency + masterLimiter.getLatencySamples();
+}
+
+bool MixEngine::areDeckLimitersInPath() const
+{
+    return deckLimitersInPath.load(std::memory_order_relaxed);
+}
+
+void MixEngine::setCueEnabled(int deckIndex, bool shouldCue)
+{
+    if (isPositiveAndBelow(deckIndex, AudioCallbackMonitor::maxDecks))
+        cueEnabled[(size_t)deckIndex] = shouldCue;
+}
+
+bool MixEngine::isCueEnabled(int deckIndex) const
+{
+    return isPositiveAndBelow(deckIndex, AudioCallbackMonitor::maxDecks) && cueEnabled[(size_t)deckIndex].load();
+}
+
+void MixEngine::setCueMix(float mix)
+{
+    cueMix = jlimit(0.0f, 1.0f, mix);
+}
+
+float MixEngine::getCueMix() const
+{
+    return cueMix.load();
+}
+
+void MixEngine::setSplitCue(bool shouldSplit)
+{
+    splitCue = shouldSplit;
+}
+
+bool MixEngine::isSplitCue() const
+{
+    return splitCue.load();
+}
+
+void MixEngine::setTempo(double bpm)
+{
+    tempo = jlimit(20.0, 300.0, bpm);
+}
+
+double MixEngine::getTempo() const
+{
+    return tempo.load();
+}
+
+void MixEngine::setQuantize(Quantize mode)
+{
+    quantize = mode;
+}
+
+MixEngine::Quantize MixEngine::getQuantize() const
+{
+    return quantize.load();
+}
+
+void MixEngine::setGridOrigin(int64 sample)
+{
+    gridOrigin = sample;
+}
+
+double MixEngine::getGridSpacing() const
+{
+    const Quantize mode = quantize.load();
+    const double sampleRate = currentSampleRate.load();
+    if (mode == Quantize::off || sampleRate <= 0)
+        return 0.0;
+
+    return sampleRate * 60.0 / tempo.load() * (mode == Quantize::bar ? beatsPerBar : 1);
+}
+
+int64 MixEngine::getQuantizedSample() const
+{
+    const double lineSamples = getGridSpacing();
+    if (lineSamples <= 0)
+        return -1;
+
+    const int64 earliest = getEarliestCommandSample();
+    const int64 origin = gridOrigin.load();
+    const double lines = std::ceil((double)(earliest - origin) / lineSamples);
+    return origin + (int64)std::llround(lines * lineSamples);
+}
+
+int64 MixEngine::getEarliestCommandSample() const
+{
+    // the block in flight may already have read the decks' queues, so
+    // only the one after it is sure to see a command sent now
+    return getSamplePosition() + 2 * (int64)largestBlock.load();
+}
+
+int64 MixEngine::getGridLineBefore(int64 sample) const
+{
+    const double lineSamples = getGridSpacing();
+    if (lineSamples <= 0)
+        return sample;
+
+    const int64 origin = gridOrigin.load();
+    const double lines = std::floor((double)(sample - origin) / lineSamples);
+    return origin + (int64)std::llround(lines * lineSamples);
+}
+
+void MixEngine::setRecorder(MasterRecorder* newRecorder)
+{
+    recorder = newRecorder;
+}
+
+void MixEngine::setEventLog(EngineEventLog* log)
+{
+    eventLog = log;
+
+    if (log != nullptr)
+    {
+        log->setSampleClock([this] { return getSamplePosition(); });
+
+        using Type = EngineEventLog::EventType;
+        for (int d = 0; d < decks.size(); ++d)
+        {
+            DJAudioPlayer* deck = decks[d];
+            if (deck->getLoadedURL().isEmpty())
+                continue;
+
+            log->logFromMessageThread(d, Type::load, 0, deck->getLoadedURL().toString(false));
+            log->logFromMessageThread(d, Type::position, deck->getCurrentPosition());
+            log->logFromMessageThread(d, Type::speed, deck->getSpeed());
+            log->logFromMessageThread(d, Type::gain, deck->getGain());
+            log->logFromMessageThread(d, Type::loop, deck->isLooping() ? 1.0 : 0.0);
+            if (deck->isPlaying())
+                log->logFromMessageThread(d, Type::play, 0);
+
+            const DeckFx& fx = deck->getFx();
+            using Setting = EngineEventLog::FxSetting;
+            for (int e = 0; e < DeckFx::numEffects; ++e)
+            {
+                const auto effect = (DeckFx::Effect)e;
+                log->logFromMessageThread(d, EngineEventLog::getFxEventType(e, Setting::wet), fx.getWet(effect));
+                log->logFromMessageThread(d, EngineEventLog::getFxEventType(e, Setting::parameter1), fx.getParameter(effect, 0));
+                log->logFromMessageThread(d, EngineEventLog::getFxEventType(e, Setting::parameter2), fx.getParameter(effect, 1));
+                log->logFromMessageThread(d, EngineEventLog::getFxEventType(e, Setting::enabled), fx.isEnabled(effect) ? 1.0 : 0.0);
+            }
+        }
+    }
+
+    for (auto* deck : decks)
+        deck->setEventLog(log);
+}
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    MixEngine.h
+    Created: 19 Oct 2026 10:31:05am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DJAudioPlayer.h"
+#include "AudioCallbackMonitor.h"
+#include "MasterRecorder.h"
+#include "EngineEventLog.h"
+#include "RealtimeCheck.h"
+#include "Limiter.h"
+#include <array>
+
+//==============================================================================
+/*
+    The audio path shared by the app and the headless renderer: the decks,
+    the master and cue buses they are summed into, and the callback monitor
+    timing it all.
+
+    Each deck renders once per block into a scratch buffer. A cued deck is
+    added to the cue bus from there, before its fader. Then the fader is
+    applied and the deck is added to the master on outputs 1/2. The
+    headphone feed goes to outputs 3/4 when the device has them. In split
+    mode the feed is the cue in the left ear and the master in the right;
+    a device with a single stereo pair plays that instead of the master.
+
+    The master goes through a true-peak limiter (see Limiter), on unless
+    switched off, and every deck has one of its own after its effects, off
+    unless switched on. The master's delays the mix by the same fixed
+    amount whether it is on or not, and the cue bus is delayed to match.
+    The decks' are only in the path while at least one of them is on: then
+    every deck runs its own, on or off, so the decks stay in step, and while
+    all are off none of them delays anything. Switching the first one on or
+    the last one off moves the decks by that delay once.
+    getLatencySamples() is the total for the limiters in the path, which
+    the displays add to the device's latency so the playheads stay on what
+    is being heard.
+
+    Transport changes can be quantized to a beat grid laid out from the
+    master tempo: getQuantizedSample() gives the next beat or bar line a
+    command sent now can still land on exactly, and the decks' *At()
+    calls take it.
+*/
+class MixEngine : public AudioSource
+{
+public:
+    MixEngine();
+    ~MixEngine() override;
+
+    /** first output channel of the headphone pair */
+    static constexpr int cueChannel = 2;
+    static constexpr int beatsPerBar = 4;
+
+    enum class Quantize
+    {
+        off,
+        beat,
+        bar
+    };
+
+    /** register a deck before the engine is prepared; its index is used for monitoring and logging */
+    void addDeck(DJAudioPlayer* player);
+    int getNumDecks() const;
+    DJAudioPlayer* getDeck(int index) const;
+
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    /** number of samples rendered since prepareToPlay */
+    int64 getSamplePosition() const;
+    double getSampleRate() const;
+
+    AudioCallbackMonitor& getMonitor();
+
+    Limiter& getMasterLimiter();
+    /** from a deck rendering a sample to the master putting it out, once prepared;
+        it includes the decks' limiters only while they are in the path */
+    int getLatencySamples() const;
+    /** true if the last block went through the decks' limiters, i.e. one of them is on */
+    bool areDeckLimitersInPath() const;
+
+    /** pre-fader listen: send the deck to the cue bus */
+    void setCueEnabled(int deckIndex, bool shouldCue);
+    bool isCueEnabled(int deckIndex) const;
+    /** headphone blend: 0 is only the cue bus, 1 only the master */
+    void setCueMix(float mix);
+    float getCueMix() const;
+    /** cue in the left ear and master in the right, both in mono */
+    void setSplitCue(bool shouldSplit);
+    bool isSplitCue() const;
+
+    void setTempo(double bpm);
+    double getTempo() const;
+    void setQuantize(Quantize mode);
+    Quantize getQuantize() const;
+    /** put the first downbeat of the grid on this sample */
+    void setGridOrigin(int64 sample);
+
+    /** the first grid line, at the quantize setting, that a deck command sent
+        now is still in time for; -1 when quantize is off or nothing is running */
+    int64 getQuantizedSample() const;
+    /** the first sample a deck command sent now is sure to be in time for */
+    int64 getEarliestCommandSample() const;
+    /** the last grid line, at the quantize setting, at or before sample; sample itself when quantize is off */
+    int64 getGridLineBefore(int64 sample) const;
+
+    /** the master mix is handed to recorder after every block, nullptr to detach */
+    void setRecorder(MasterRecorder* recorder);
+
+    /** log every deck command against this engine's sample clock, nullptr to detach.
+        When attaching, the current state of every deck is written first so the
+        log replays on its own. Call from the message thread. */
+    void setEventLog(EngineEventLog* log);
+
+private:
+    /** one stretch of a block, no longer than the buffers were prepared for */
+    void renderChunk(AudioBuffer<float>& out, int startSample, int numSamples);
+    void mixHeadphones(AudioBuffer<float>& out, int startSample, int numSamples);
+    /** samples between grid lines at the quantize setting, 0 when there is no grid */
+    double getGridSpacing() const;
+
+    Array<DJAudioPlayer*> decks;
+    AudioCallbackMonitor monitor;
+
+    AudioBuffer<float> deckBuffer;
+    AudioBuffer<float> cueBuffer;
+    Limiter masterLimiter;
+    Limiter cueDelay;                   // never switched on: only keeps the cue in step with the master
+    std::array<std::atomic<bool>, AudioCallbackMonitor::maxDecks> cueEnabled{};
+    std::atomic<float> cueMix{ 0.0f };
+    std::atomic<bool> splitCue{ false };
+    std::atomic<MasterRecorder*> recorder{ nullptr };
+    EngineEventLog* eventLog = nullptr;
+
+    std::atomic<int64> samplePosition{ 0 };
+    std::atomic<double> currentSampleRate{ 0.0 };
+    std::atomic<int> largestBlock{ 0 };
+    std::atomic<bool> deckLimitersInPath{ false };
+
+    std::atomic<double> tempo{ 120.0 };
+    std::atomic<Quantize> quantize{ Quantize::off };
+    std::atomic<int64> gridOrigin{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MixEngine)
+};
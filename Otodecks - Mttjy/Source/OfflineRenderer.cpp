@@ -0,0 +1,437 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.cpp
+    Created: 19 Oct 2026 11:02:37am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#ifdef _WIN32
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+ #include <psapi.h>
+ #pragma comment (lib, "psapi.lib")
+#else
+ #include <sys/resource.h>
+#endif
+
+#include "OfflineRenderer.h"
+
+namespace
+{
+    // the script's names for the deck effects, in DeckFx order, and for their
+    // settings in EngineEventLog::FxSetting order, e.g. "echo.wet"
+    const StringArray effectNames{ "echo", "reverb", "flanger", "bitcrusher", "gate" };
+    const StringArray fxSettingNames{ "on", "wet", "1", "2" };
+
+    /** the effect a script command names, and the setting after its dot (-1 for none); false if it isn't one */
+    bool parseFxCommand(const String& command, int& effect, int& setting)
+    {
+        effect = effectNames.indexOf(command.upToFirstOccurrenceOf(".", false, false));
+        setting = command.containsChar('.') ? fxSettingNames.indexOf(command.fromFirstOccurrenceOf(".", false, false)) : -1;
+        return effect >= 0 && (setting >= 0 || !command.containsChar('.'));
+    }
+}
+
+//==============================================================================
+double OfflineRenderer::Report::getSamplesPerSecond() const
+{
+    return wallSecs > 0 ? samplesRendered / wallSecs : 0.0;
+}
+
+double OfflineRenderer::Report::getRealtimeFactor() const
+{
+    return (wallSecs > 0 && sampleRate > 0) ? (samplesRendered / sampleRate) / wallSecs : 0.0;
+}
+
+String OfflineRenderer::Report::toString(int numDecks) const
+{
+    const double callbacks = (double)stages.numCallbacks;
+    String text;
+    text << "rendered " << String(samplesRendered / sampleRate, 2) << " s (" << samplesRendered << " samples)"
+         << " in " << String(wallSecs, 3) << " s: "
+         << String(getSamplesPerSecond(), 0) << " samples/s, "
+         << String(getRealtimeFactor(), 1) << "x real time\n";
+    text << "stage totals: load " << String(loadMs, 1) << " ms";
+    for (int d = 0; d < jmin(numDecks, AudioCallbackMonitor::maxDecks); ++d)
+    {
+        text << ", deck " << (d + 1) << " reader " << String(stages.deckReaderMs[d] * callbacks, 1) << " ms"
+             << ", deck " << (d + 1) << " resampler " << String(stages.deckResamplerMs[d] * callbacks, 1) << " ms";
+    }
+    text << ", mixer " << String(stages.mixerMs * callbacks, 1) << " ms"
+         << ", writer " << String(writerMs, 1) << " ms\n";
+    text << "block p50 " << String(stages.p50Ms, 3) << " ms, p99 " << String(stages.p99Ms, 3)
+         << " ms, max " << String(stages.maxMs, 3) << " ms\n";
+    if (recorded)
+        text << "recorder dropped blocks " << droppedRecorderBlocks << "\n";
+    text << "peak memory " << String(peakMemoryBytes / (1024.0 * 1024.0), 1) << " MB\n";
+    return text;
+}
+
+//==============================================================================
+OfflineRenderer::OfflineRenderer(AudioFormatManager& _formatManager)
+: formatManager(_formatManager)
+{
+}
+
+OfflineRenderer::~OfflineRenderer()
+{
+}
+
+bool OfflineRenderer::parseScript(const File& file, MixScript& script, String& error)
+{
+    if (!file.existsAsFile())
+    {
+        error = "Script not found: " + file.getFullPathName();
+        return false;
+    }
+    script.baseDirectory = file.getParentDirectory();
+    return parseScript(file.loadFileAsString(), script, error);
+}
+
+bool OfflineRenderer::parseScript(const String& text, MixScript& script, String& error)
+{
+    StringArray lines;
+    lines.addLines(text);
+
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        String line = lines[i].upToFirstOccurrenceOf("#", false, false).trim();
+        if (line.isEmpty())
+            continue;
+
+        StringArray tokens = StringArray::fromTokens(line, " \t", "\"");
+        tokens.removeEmptyStrings();
+        for (auto& token : tokens)
+            token = token.unquoted();
+
+        const String where = "line " + String(i + 1) + ": ";
+        const String keyword = tokens[0].toLowerCase();
+
+        if (keyword == "samplerate")       { script.sampleRate = tokens[1].getDoubleValue(); continue; }
+        if (keyword == "blocksize")        { script.blockSize = tokens[1].getIntValue();     continue; }
+        if (keyword == "length")           { script.lengthSecs = tokens[1].getDoubleValue(); continue; }
+        if (keyword == "decks")            { script.numDecks = tokens[1].getIntValue();      continue; }
+        if (keyword == "channels")         { script.numChannels = tokens[1].getIntValue();   continue; }
+        if (keyword == "cuemix")           { script.cueMix = tokens[1].getFloatValue();      continue; }
+        if (keyword == "splitcue")         { script.splitCue = tokens[1].getIntValue() != 0; continue; }
+        if (keyword == "tempo")            { script.tempo = tokens[1].getDoubleValue();      continue; }
+        if (keyword == "quantize")
+        {
+            static const StringArray modes{ "off", "beat", "bar" };
+            const int mode = modes.indexOf(tokens[1].toLowerCase());
+            if (mode < 0)
+            {
+                error = where + "quantize must be off, beat or bar";
+                return false;
+            }
+            script.quantize = (MixEngine::Quantize)mode;
+            continue;
+        }
+
+        ScriptEvent event;
+        int t = 0;
+        if (keyword == "at")
+        {
+            event.timeSecs = tokens[1].getDoubleValue();
+            t = 2;
+        }
+
+        if (tokens[t].toLowerCase() != "deck" || tokens.size() < t + 3)
+        {
+            error = where + "expected [at <seconds>] deck <n> <command> [value]";
+            return false;
+        }
+
+        event.deck = tokens[t + 1].getIntValue() - 1;
+        event.command = tokens[t + 2].toLowerCase();
+        event.argument = tokens.size() > t + 3 ? tokens[t + 3] : String();
+
+        static const StringArray commands{ "load", "play", "stop", "speed", "gain", "position", "loop", "scratch", "jog", "cue",
+                                             "fadein", "fadeout" };
+        int effect = 0, setting = 0;
+        if (!commands.contains(event.command) && !parseFxCommand(event.command, effect, setting))
+        {
+            error = where + "unknown command '" + event.command + "'";
+            return false;
+        }
+        script.events.add(event);
+    }
+
+    if (script.sampleRate <= 0 || script.blockSize <= 0 || script.lengthSecs <= 0
+        || !isPositiveAndNotGreaterThan(script.numDecks, AudioCallbackMonitor::maxDecks))
+    {
+        error = "samplerate, blocksize and length must be positive and decks between 1 and "
+              + String(AudioCallbackMonitor::maxDecks);
+        return false;
+    }
+
+    if (!isPositiveAndNotGreaterThan(script.numChannels, 8))
+    {
+        error = "channels must be between 1 and 8";
+        return false;
+    }
+
+    for (auto& event : script.events)
+    {
+        if (!isPositiveAndBelow(event.deck, script.numDecks))
+        {
+            error = "deck " + String(event.deck + 1) + " is out of range";
+            return false;
+        }
+    }
+
+    // keep script order for events that share a time
+    std::stable_sort(script.events.begin(), script.events.end(),
+                     [](const ScriptEvent& a, const ScriptEvent& b) { return a.timeSecs < b.timeSecs; });
+    return true;
+}
+
+void OfflineRenderer::applyEvent(const MixScript& script, const ScriptEvent& event, MixEngine& engine)
+{
+    DJAudioPlayer* player = engine.getDeck(event.deck);
+
+    if (event.command == "load")
+    {
+        const int64 start = Time::getHighResolutionTicks();
+        File track = script.baseDirectory.getChildFile(event.argument);
+        player->loadURL(URL{ track });
+        report.loadMs += Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) * 1000.0;
+    }
+    else if (event.command == "play")     player->startAt(engine.getQuantizedSample());
+    else if (event.command == "stop")     player->stopAt(engine.getQuantizedSample());
+    else if (event.command == "speed")    player->setSpeed(event.argument.getDoubleValue());
+    else if (event.command == "gain")     player->setGain(event.argument.getDoubleValue());
+    else if (event.command == "position") player->setPositionAt(event.argument.getDoubleValue(), engine.getQuantizedSample());
+    else if (event.command == "loop")     player->setLoopingAt(event.argument.getIntValue() != 0, engine.getQuantizedSample());
+    else if (event.command == "scratch")
+    {
+        if (event.argument.getIntValue() != 0)
+            player->beginScratch();
+        else
+            player->endScratch();
+    }
+    else if (event.command == "jog")      player->jog(event.argument.getDoubleValue());
+    else if (event.command == "cue")      engine.setCueEnabled(event.deck, event.argument.getIntValue() != 0);
+    else if (event.command == "fadein")   player->fadeInAt(-1, event.argument.getDoubleValue());
+    else if (event.command == "fadeout")  player->fadeOutAt(-1, event.argument.getDoubleValue());
+    else
+    {
+        // the rest are the deck's effects
+        int e = 0, setting = 0;
+        parseFxCommand(event.command, e, setting);
+        const auto effect = (DeckFx::Effect)e;
+        const float value = (float)event.argument.getDoubleValue();
+        DeckFx& fx = player->getFx();
+
+        using Setting = EngineEventLog::FxSetting;
+        if (setting < 0)
+        {
+            fx.setEnabled(effect, value > 0.0f);
+            if (value > 0.0f)
+                fx.setWet(effect, value);
+        }
+        else if ((Setting)setting == Setting::enabled)      fx.setEnabled(effect, value > 0.5f);
+        else if ((Setting)setting == Setting::wet)          fx.setWet(effect, value);
+        else if ((Setting)setting == Setting::parameter1)   fx.setParameter(effect, 0, value);
+        else                                                fx.setParameter(effect, 1, value);
+    }
+}
+
+int64 OfflineRenderer::getEventSample(const MixScript& script, const ScriptEvent& event)
+{
+    return event.sample >= 0 ? event.sample : (int64)(event.timeSecs * script.sampleRate);
+}
+
+bool OfflineRenderer::scriptFromEventLog(const File& logFile, MixScript& script, String& error)
+{
+    Array<EngineEventLog::Event> events;
+    if (!EngineEventLog::read(logFile, script.sampleRate, script.blockSize, events, error))
+        return false;
+
+    script.numDecks = 1;
+    script.events.clear();
+
+    using Type = EngineEventLog::EventType;
+    for (auto& e : events)
+    {
+        ScriptEvent event;
+        event.sample = e.sample;
+        event.timeSecs = e.sample / script.sampleRate;
+        event.deck = e.deck;
+
+        switch (e.type)
+        {
+            case Type::load:
+            {
+                URL url(e.url);
+                event.command = "load";
+                event.argument = url.isLocalFile() ? url.getLocalFile().getFullPathName() : e.url;
+                break;
+            }
+            case Type::play:     event.command = "play"; break;
+            case Type::stop:     event.command = "stop"; break;
+            case Type::speed:    event.command = "speed"; break;
+            case Type::gain:     event.command = "gain"; break;
+            case Type::position: event.command = "position"; break;
+            case Type::loop:     event.command = "loop"; break;
+            case Type::scratch:  event.command = "scratch"; break;
+            case Type::jog:      event.command = "jog"; break;
+            case Type::fadeIn:   event.command = "fadein"; break;
+            case Type::fadeOut:  event.command = "fadeout"; break;
+            default:
+            {
+                int effect = 0;
+                auto setting = EngineEventLog::FxSetting::enabled;
+                if (!EngineEventLog::isFxEvent(e.type, effect, setting) || !isPositiveAndBelow(effect, DeckFx::numEffects))
+                {
+                    error = "unknown event type " + String((int)e.type);
+                    return false;
+                }
+                event.command = effectNames[effect] + "." + fxSettingNames[(int)setting];
+                break;
+            }
+        }
+        if (e.type == Type::loop || e.type == Type::scratch)
+            event.argument = String(e.value > 0.5 ? 1 : 0);
+        else if (e.type != Type::load)
+            event.argument = String(e.value, 17);
+
+        script.numDecks = jmax(script.numDecks, event.deck + 1);
+        script.events.add(event);
+    }
+
+    // play on for a while after the last action
+    const double lastEventSecs = events.isEmpty() ? 0.0 : events.getLast().sample / script.sampleRate;
+    script.lengthSecs = lastEventSecs + 10.0;
+    return true;
+}
+
+bool OfflineRenderer::render(const MixScript& script, const File& outputFile, String& error)
+{
+    report = Report();
+    report.sampleRate = script.sampleRate;
+
+    MixEngine engine;
+    OwnedArray<DJAudioPlayer> players;
+    for (int d = 0; d < script.numDecks; ++d)
+    {
+        engine.addDeck(players.add(new DJAudioPlayer(formatManager)));
+        players.getLast()->setRealtime(false);
+    }
+    engine.setCueMix(script.cueMix);
+    engine.setSplitCue(script.splitCue);
+    engine.setTempo(script.tempo);
+    engine.setQuantize(script.quantize);
+
+    outputFile.deleteFile();
+    std::unique_ptr<FileOutputStream> stream(outputFile.createOutputStream());
+    if (stream == nullptr)
+    {
+        error = "Cannot write " + outputFile.getFullPathName();
+        return false;
+    }
+
+    WavAudioFormat wavFormat;
+    std::unique_ptr<AudioFormatWriter> writer(wavFormat.createWriterFor(stream.get(), script.sampleRate, (unsigned int)script.numChannels, 24, {}, 0));
+    if (writer == nullptr)
+    {
+        error = "Cannot create a WAV writer for " + outputFile.getFullPathName();
+        return false;
+    }
+    stream.release(); // the writer owns it now
+
+    engine.prepareToPlay(script.blockSize, script.sampleRate);
+    AudioBuffer<float> buffer(script.numChannels, script.blockSize);
+
+    if (recorder != nullptr)
+    {
+        recorder->prepare(script.sampleRate, 2);
+        if (!recorder->start(recordFile, error))
+            return false;
+        engine.setRecorder(recorder);
+        report.recorded = true;
+    }
+
+    const int64 totalSamples = (int64)(script.lengthSecs * script.sampleRate);
+    int nextEvent = 0;
+    int64 writerTicks = 0;
+    const int64 startTicks = Time::getHighResolutionTicks();
+
+    for (int64 position = 0; position < totalSamples; )
+    {
+        while (nextEvent < script.events.size()
+               && getEventSample(script, script.events.getReference(nextEvent)) <= position)
+        {
+            applyEvent(script, script.events.getReference(nextEvent++), engine);
+        }
+
+        // cut the block short at the next event so it lands on its exact sample
+        int64 blockEnd = jmin(position + script.blockSize, totalSamples);
+        if (nextEvent < script.events.size())
+            blockEnd = jmin(blockEnd, getEventSample(script, script.events.getReference(nextEvent)));
+        const int numSamples = (int)(blockEnd - position);
+
+        buffer.clear();
+        AudioSourceChannelInfo info(&buffer, 0, numSamples);
+        engine.getNextAudioBlock(info);
+
+        const int64 writeStart = Time::getHighResolutionTicks();
+        writer->writeFromAudioSampleBuffer(buffer, 0, numSamples);
+        writerTicks += Time::getHighResolutionTicks() - writeStart;
+
+        position += numSamples;
+    }
+
+    writer.reset();
+    engine.releaseResources();
+
+    if (recorder != nullptr)
+    {
+        engine.setRecorder(nullptr);
+        report.droppedRecorderBlocks = recorder->getNumDroppedBlocks();
+        recorder->stop();
+    }
+
+    report.wallSecs = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
+    report.samplesRendered = totalSamples;
+    report.writerMs = Time::highResolutionTicksToSeconds(writerTicks) * 1000.0;
+    report.stages = engine.getMonitor().getSummary();
+    report.peakMemoryBytes = getPeakMemoryBytes();
+    return true;
+}
+
+void OfflineRenderer::setRecorder(MasterRecorder* _recorder, const File& _recordFile)
+{
+    recorder = _recorder;
+    recordFile = _recordFile;
+}
+
+const OfflineRenderer::Report& OfflineRenderer::getReport() const
+{
+    return report;
+}
+
+//==============================================================================
+int64 OfflineRenderer::getPeakMemoryBytes()
+{
+   #ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return (int64)counters.PeakWorkingSetSize;
+    return 0;
+   #else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+   #if JUCE_MAC
+    return (int64)usage.ru_maxrss;          // bytes on macOS
+   #else
+    return (int64)usage.ru_maxrss * 1024;   // kilobytes on Linux
+   #endif
+   #endif
+}
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.h
+    Created: 19 Oct 2026 11:02:37am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MixEngine.h"
+
+//==============================================================================
+/*
+    Renders a scripted mix through the same decks and mixer as the app, with
+    no audio device or window, as fast as the machine allows.
+
+    Script format, one statement per line ('#' starts a comment):
+
+        samplerate 44100
+        blocksize 512
+        length 90                 (seconds of output)
+        decks 2
+        channels 4                (outputs 3/4 carry the headphone cue)
+        cuemix 0.5                (0 = cue only, 1 = master only)
+        splitcue 0
+        tempo 124                 (bpm of the quantize grid, first downbeat at 0)
+        quantize bar              (off, beat or bar: play, stop, position and
+                                   loop wait for the next line of the grid)
+        deck 1 load tracks/a.mp3  (paths are relative to the script)
+        at 0 deck 1 play
+        at 12.5 deck 1 speed 1.25
+        at 30 deck 2 gain 0.8
+        at 31 deck 2 position 45  (seconds into the track)
+        at 45 deck 1 loop 1
+        at 50 deck 1 speed -1     (negative speeds play backwards)
+        at 52 deck 1 scratch 1    (hand on the platter)
+        at 52.1 deck 1 jog -0.25  (move it by seconds of audio)
+        at 53 deck 1 scratch 0
+        at 55 deck 2 cue 1        (pre-fader listen)
+        at 58 deck 1 echo 0.4     (echo, reverb, flanger, bitcrusher or gate:
+                                   the dry/wet mix, 0 switches it off)
+        at 59 deck 1 echo.2 0.7   (one setting: .on 1 or 0, .wet, or the
+                                   effect's first or second parameter .1 .2)
+        at 60 deck 1 stop
+        at 62 deck 2 fadeout 4    (mix level down to silence over 4 s; fadein
+                                   brings it up, as auto-DJ crossfades do)
+
+    Statements without "at" happen at time zero. Blocks are split so every
+    event lands on its exact sample.
+
+    See HeadlessRunner for the command line. Its --record options push every
+    block through a MasterRecorder too; with a stalled writer the report
+    shows dropped blocks while the block timings stay unchanged, i.e. the
+    disk never holds up the audio path.
+*/
+class OfflineRenderer
+{
+public:
+    struct ScriptEvent
+    {
+        double timeSecs = 0;
+        int64 sample = -1;      // exact sample if known, else derived from timeSecs
+        int deck = 0;
+        String command;
+        String argument;
+    };
+
+    struct MixScript
+    {
+        double sampleRate = 44100.0;
+        int blockSize = 512;
+        double lengthSecs = 60.0;
+        int numDecks = 2;
+        int numChannels = 2;
+        float cueMix = 0.0f;
+        bool splitCue = false;
+        double tempo = 120.0;
+        MixEngine::Quantize quantize = MixEngine::Quantize::off;
+        Array<ScriptEvent> events;
+        File baseDirectory;
+    };
+
+    struct Report
+    {
+        int64 samplesRendered = 0;
+        double sampleRate = 0;
+        double wallSecs = 0;
+        double loadMs = 0;
+        double writerMs = 0;
+        AudioCallbackMonitor::Summary stages;
+        int64 peakMemoryBytes = 0;
+        bool recorded = false;
+        int droppedRecorderBlocks = 0;
+
+        double getSamplesPerSecond() const;
+        double getRealtimeFactor() const;
+        String toString(int numDecks) const;
+    };
+
+    OfflineRenderer(AudioFormatManager& formatManager);
+    ~OfflineRenderer();
+
+    static bool parseScript(const String& text, MixScript& script, String& error);
+    static bool parseScript(const File& file, MixScript& script, String& error);
+
+    /** turn an EngineEventLog into a script that replays it sample for sample */
+    static bool scriptFromEventLog(const File& logFile, MixScript& script, String& error);
+
+    /** also feed the master mix to recorder while rendering, as the live engine would */
+    void setRecorder(MasterRecorder* recorder, const File& recordFile);
+
+    /** renders the whole script into a 24-bit stereo WAV file */
+    bool render(const MixScript& script, const File& outputFile, String& error);
+
+    const Report& getReport() const;
+
+    /** peak resident memory of this process, 0 if unknown */
+    static int64 getPeakMemoryBytes();
+
+private:
+    void applyEvent(const MixScript& script, const ScriptEvent& event, MixEngine& engine);
+    static int64 getEventSample(const MixScript& script, const ScriptEvent& event);
+
+    AudioFormatManager& formatManager;
+    MasterRecorder* recorder = nullptr;
+    File recordFile;
+    Report report;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OfflineRenderer)
+};
@@ -9,6 +9,7 @@
 */
 
 #include "PlaylistComponent.h"
+#include "StartupTimer.h"
 #include <iostream>
 #include <fstream>
 
@@ -21,12 +22,25 @@ PlaylistComponent::PlaylistComponent()
     File urlFile = File::getCurrentWorkingDirectory().getChildFile("current_url.txt");
     urlFile.deleteFile();
 
-    tableComponent.getHeader().addColumn("Track title", 1, 200);
-    tableComponent.getHeader().addColumn("Duration", 2, 200);
+    tableComponent.getHeader().addColumn("Track title", TrackLibrary::titleColumn, 200);
+    tableComponent.getHeader().addColumn("Preview", previewColumn, 100, 30, -1,
+                                         TableHeaderComponent::visible | TableHeaderComponent::resizable
+                                         | TableHeaderComponent::draggable);
+    tableComponent.getHeader().addColumn("Artist", TrackLibrary::artistColumn, 100);
+    tableComponent.getHeader().addColumn("Album", TrackLibrary::albumColumn, 100);
+    tableComponent.getHeader().addColumn("Genre", TrackLibrary::genreColumn, 100);
+    tableComponent.getHeader().addColumn("Duration", TrackLibrary::durationColumn, 100);
+    tableComponent.getHeader().addColumn("BPM", TrackLibrary::bpmColumn, 100);
+    tableComponent.getHeader().addColumn("Key", TrackLibrary::keyColumn, 100);
+    tableComponent.getHeader().addColumn("Comment", TrackLibrary::commentColumn, 100);
+    // hidden until picked from the header's right-click menu
+    tableComponent.getHeader().setColumnVisible(TrackLibrary::commentColumn, false);
+
+    String error;
+    if (!store.open(error))
+        DBG(error);
 
     tableComponent.setModel(this);
-    updateTrackTitles();
-    loadTracks();
     addAndMakeVisible(tableComponent);
 
     addAndMakeVisible(deleteButton);
@@ -34,14 +48,34 @@ PlaylistComponent::PlaylistComponent()
     deleteButton.setButtonText("Delete");
     deleteButton.onClick = [this] { deleteSelectedTrack(); };
 
+    // off deletes the cache; on decodes each track as the decks load it
+    addAndMakeVisible(decodeCacheToggle);
+    decodeCacheToggle.setTooltip("Keep decoded copies of the compressed tracks the decks load, so they aren't decoded again as they play");
+    decodeCacheToggle.setToggleState(decodeCache.isEnabled(), dontSendNotification);
+    decodeCacheToggle.onClick = [this] { decodeCache.setEnabled(decodeCacheToggle.getToggleState()); };
+
     searchBox.setTextToShowWhenEmpty("Search for tracks...", Colours::lightgrey);
     searchBox.setFont(18.0f);
-    searchBox.onTextChange = [this] { updateTrackTitles(); };
+    searchBox.onTextChange = [this] { loadTracks(); };
     addAndMakeVisible(searchBox);
+
+    listBox.onChange = [this] { listBoxChanged(); };
+    refreshListBox();
+    addAndMakeVisible(listBox);
+
+    importer.addChangeListener(this);
+    scanner.addChangeListener(this);
+    recommender.addChangeListener(this);
+    previews.addChangeListener(this);
+    updateTrackTitles();
 }
 
 PlaylistComponent::~PlaylistComponent()
 {
+    previews.removeChangeListener(this);
+    recommender.removeChangeListener(this);
+    scanner.removeChangeListener(this);
+    importer.removeChangeListener(this);
 }
 
 void PlaylistComponent::paint (juce::Graphics& g)
@@ -62,57 +96,81 @@ void PlaylistComponent::paint (juce::Graphics& g)
 void PlaylistComponent::resized()
 {
     deleteButton.setBounds((getWidth() / 6) * 5, 0, (getWidth() / 6) * 1, 35);
-    searchBox.setBounds(0, 0, (getWidth()/6)*5, 35);
+    decodeCacheToggle.setBounds((getWidth() / 6) * 4, 0, (getWidth() / 6) * 1, 35);
+    listBox.setBounds(0, 0, getWidth() / 6, 35);
+    searchBox.setBounds(getWidth() / 6, 0, (getWidth() / 6) * 3, 35);
     int tableWidth = getWidth();
-    int columnWidth = tableWidth / 2;
-    tableComponent.getHeader().setColumnWidth(1, columnWidth);
-    tableComponent.getHeader().setColumnWidth(2, columnWidth);
+    int columnWidth = tableWidth / 12;
+    tableComponent.getHeader().setColumnWidth(TrackLibrary::titleColumn, columnWidth * 3);
+    tableComponent.getHeader().setColumnWidth(previewColumn, columnWidth * 2);
+    tableComponent.getHeader().setColumnWidth(TrackLibrary::artistColumn, columnWidth * 2);
+    tableComponent.getHeader().setColumnWidth(TrackLibrary::albumColumn, columnWidth * 2);
+    tableComponent.getHeader().setColumnWidth(TrackLibrary::genreColumn, columnWidth);
+    tableComponent.getHeader().setColumnWidth(TrackLibrary::durationColumn, columnWidth);
+    tableComponent.getHeader().setColumnWidth(TrackLibrary::bpmColumn, columnWidth / 2);
+    tableComponent.getHeader().setColumnWidth(TrackLibrary::keyColumn, columnWidth / 2);
+    tableComponent.getHeader().setColumnWidth(TrackLibrary::commentColumn, columnWidth * 2);
     tableComponent.setBounds(0, 35, tableWidth, getHeight() - 35);
     tableComponent.getViewport()->setScrollBarsShown(true, false);
 }
 
 int PlaylistComponent::getNumRows()
 {
-    return trackTitles.size();
+    return library.getNumRows();
 }
 
 void PlaylistComponent::paintRowBackground(Graphics& g, int rowNumber, int width, int height, bool rowIsSelected)
 {
-    if (rowIsSelected && rowNumber != lastSelectedRow) // check if row changed
+    if (rowIsSelected)
     {
         g.fillAll(Colour::fromRGB(200, 135, 220));
-        File selectedFile = File::getCurrentWorkingDirectory().getChildFile("tracks").getChildFile(trackTitles[rowNumber]);
-        currentURL = selectedFile.getFullPathName().toStdString()+".mp3";
-        File urlFile = File::getCurrentWorkingDirectory().getChildFile("current_url.txt");
-        urlFile.deleteFile();
-        if (!urlFile.exists())
-        {
-            urlFile.create();
-        }
-        FileOutputStream outputStream(urlFile);
-        outputStream << currentURL;
-        outputStream.flush();
-        lastSelectedRow = rowNumber;
     }
-    else if (!rowIsSelected)
+    else
     {
         g.fillAll(Colour::fromRGB(200, 200, 200));
     }
-    else if (rowIsSelected && rowNumber == lastSelectedRow)
+}
+
+void PlaylistComponent::paintCell(Graphics& g, int rowNumber, int columnID, int width, int height, bool rowIsSelected)
+{
+    if (columnID == previewColumn)
     {
-        g.fillAll(Colour::fromRGB(200, 135, 220));
+        paintPreview(g, rowNumber, width, height, rowIsSelected);
+        return;
     }
+
+    // cell text is formatted once when the track is added
+    g.drawText(library.getCellText(rowNumber, columnID), 2, 0, width - 4, height, Justification::centredLeft, true);
 }
 
-void PlaylistComponent::paintCell(Graphics& g, int rowNumber, int columnID, int width, int height, bool rowIsSelected)
+void PlaylistComponent::paintPreview(Graphics& g, int rowNumber, int width, int height, bool rowIsSelected)
 {
-    if (columnID == 1)
+    // only rows being painted ask for a preview, so only the ones on screen get built
+    const File file = library.getFile(library.getIdForRow(rowNumber));
+    const std::shared_ptr<const TrackPreview> preview = previews.get(file);
+    if (preview == nullptr)
     {
-        g.drawText(trackTitles[rowNumber], 2, 0, width - 4, height, Justification::centredLeft, true);
+        previews.request(file);
+        return;
     }
-    else if (columnID == 2)
+
+    // several columns to a pixel when the cell is narrow, one stretched over several when it is wide
+    constexpr int numColumns = TrackPreview::numColumns;
+    const int drawWidth = width - 4;
+    const float centre = height * 0.5f;
+    const float scale = (height - 4) / 254.0f;
+    g.setColour(rowIsSelected ? Colour::fromRGB(70, 20, 90) : Colour::fromRGB(70, 70, 70));
+    for (int x = 0; x < drawWidth; ++x)
     {
-        g.drawText(trackDurations[rowNumber], 2, 0, width - 4, height, Justification::centredLeft, true);
+        const int first = x * numColumns / drawWidth;
+        const int last = jmax(first + 1, (x + 1) * numColumns / drawWidth);
+        int low = 127, high = -127;
+        for (int c = first; c < last; ++c)
+        {
+            low = jmin(low, (int)preview->minimum[(size_t)c]);
+            high = jmax(high, (int)preview->maximum[(size_t)c]);
+        }
+        g.drawVerticalLine(2 + x, centre - high * scale, centre - low * scale + 1.0f);
     }
 }
 
@@ -121,64 +179,191 @@ Component* PlaylistComponent::refreshComponentForCell(int rowNumber, int columnI
     return existingComponentToUpdate;
 }
 
-void PlaylistComponent::updateTrackTitles()
+void PlaylistComponent::cellClicked(int rowNumber, int columnId, const MouseEvent& e)
 {
-    trackTitles.clear();
-    trackDurations.clear();
+    if (e.mods.isPopupMenu())
+        showTrackMenu(rowNumber);
+}
+
+void PlaylistComponent::sortOrderChanged(int newSortColumnId, bool isForwards)
+{
+    const TrackLibrary::TrackId selected = library.getIdForRow(tableComponent.getSelectedRow());
+    library.setSortOrder(newSortColumnId, isForwards);
+    tableComponent.updateContent();
+
+    // keep the same track selected wherever it moved to
+    const int row = library.getRowForId(selected);
+    if (row >= 0)
+        tableComponent.selectRow(row, true, true);
+    tableComponent.repaint();
+    dropHiddenPreviews();
+}
+
+void PlaylistComponent::selectedRowsChanged(int lastRowSelected)
+{
+    const TrackLibrary::TrackId id = library.getIdForRow(lastRowSelected);
+    if (!library.isValid(id))
+        return;
+
+    // the decks' LOAD buttons pick the selection up from current_url.txt
+    currentURL = library.getFile(id).getFullPathName();
+    File urlFile = File::getCurrentWorkingDirectory().getChildFile("current_url.txt");
+    urlFile.replaceWithText(currentURL);
+}
+
+void PlaylistComponent::listWasScrolled()
+{
+    dropHiddenPreviews();
+}
 
-    // Get a list of all the files in the "tracks" directory
-    File tracksDir = File::getCurrentWorkingDirectory().getChildFile("tracks");
-    Array<File> files = tracksDir.findChildFiles(File::TypesOfFileToFind::findFiles, false);
+void PlaylistComponent::dropHiddenPreviews()
+{
+    const int rowHeight = jmax(1, tableComponent.getRowHeight());
+    const Viewport* viewport = tableComponent.getViewport();
+    const int first = viewport->getViewPositionY() / rowHeight;
+    const int last = jmin(library.getNumRows(), first + viewport->getViewHeight() / rowHeight + 2);
+
+    Array<File> onScreen;
+    for (int row = first; row < last; ++row)
+        onScreen.add(library.getFile(library.getIdForRow(row)));
+    previews.keepOnly(onScreen);
+}
 
-    // Loop through the files and add their paths to the trackTitles vector if they match the search query
-    for (int i = 0; i < files.size(); ++i)
+void PlaylistComponent::changeListenerCallback(ChangeBroadcaster* source)
+{
+    if (source == &previews)
     {
-        std::string filePath = files[i].getFullPathName().toStdString();
-        std::string trackTitle = files[i].getFileNameWithoutExtension().toStdString();
-        if (searchBox.getText().isEmpty() || trackTitle.find(searchBox.getText().toStdString()) != std::string::npos)
-        {
-            trackTitles.push_back(trackTitle);
+        tableComponent.repaint();
+        return;
+    }
 
-            AudioFormatManager formatManager;
-            formatManager.registerBasicFormats();
-            std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(files[i]));
+    if (source == &scanner)
+    {
+        addScannedTracks();
+        return;
+    }
 
-            if (reader != nullptr)
-            {
-                double durationInSeconds = reader->lengthInSamples / (double)reader->sampleRate;
-                int minutes = (int)durationInSeconds / 60;
-                int seconds = (int)durationInSeconds % 60;
-                std::stringstream ss;
-                ss << std::setw(2) << std::setfill('0') << minutes << ":" << std::setw(2) << std::setfill('0') << seconds;
-                trackDurations.push_back(ss.str());
-            }
-            else
-            {
-                trackDurations.push_back("");
-            }
-        }
+    if (source == &recommender)
+    {
+        addAnalysedTracks();
+        return;
     }
-    tableComponent.updateContent();
+
+    if (source != &importer)
+        return;
+
+    const Array<TrackImporter::Status> finished = importer.takeImported();
+    if (finished.isEmpty())
+        return;
+
+    Array<File> imported;
+    for (auto& status : finished)
+    {
+        imported.add(status.destination);
+        if (library.findTrack(status.destination) == TrackLibrary::invalidId)
+            library.setTags(library.addTrack(status.destination, status.duration), status.tags);
+    }
+    recommender.addTracks(imported);
+
+    // lists may reference tracks that only just arrived
+    store.bindLibrary(library);
+    if (currentList != 0)
+        library.setScope(store.resolve(currentList));
+    loadTracks();
 }
 
+File PlaylistComponent::getTracksFolder() const
+{
+    return File::getCurrentWorkingDirectory().getChildFile("tracks");
+}
 
-void PlaylistComponent::loadTracks()
+void PlaylistComponent::updateTrackTitles()
+{
+    library.clear();
+    store.bindLibrary(library);
+    if (currentList != 0)
+        library.setScope(store.resolve(currentList));
+    loadTracks();
+
+    scanner.startScan();
+}
+
+void PlaylistComponent::addScannedTracks()
 {
-    File tracksFolder = File::getCurrentWorkingDirectory().getChildFile("tracks");
-    if (!tracksFolder.exists())
+    // checked before taking, so a finished scan has handed everything over
+    const bool finished = !scanner.isScanning();
+    std::vector<LibraryScanner::Track> tracks = scanner.takeFoundTracks();
+    const Array<File> gone = scanner.takeMissingFiles();
+
+    if (!tracks.empty() || gone.size() > 0)
     {
-        std::cerr << "Error: tracks folder does not exist" << std::endl;
-        return;
+        // a track already in the table was changed on disk, or came from the index first
+        Array<File> files;
+        for (auto& track : tracks)
+        {
+            TrackLibrary::TrackId id = library.findTrack(track.file);
+            if (id == TrackLibrary::invalidId)
+                id = library.addTrack(track.file, track.duration);
+            else
+                library.setDuration(id, track.duration);
+            library.setTags(id, track.tags);
+            // changed on disk since its preview was built
+            previews.remove(track.file);
+
+            float bpm = 0;
+            int key = -1;
+            if (recommender.getTempoAndKey(track.file, bpm, key))
+                library.setBpmAndKey(id, bpm, TrackFeatures::getKeyName(key));
+            files.add(track.file);
+        }
+        // analysed in the background unless they were last time, unchanged
+        recommender.addTracks(files);
+
+        for (auto& file : gone)
+        {
+            library.removeTrack(library.findTrack(file));
+            recommender.removeTrack(file);
+            decodeCache.removeTrack(file);
+            previews.remove(file);
+        }
+
+        store.bindLibrary(library);
+        if (currentList != 0)
+            library.setScope(store.resolve(currentList));
+        loadTracks();
     }
 
-    trackTitles.clear();
-    DirectoryIterator iter(tracksFolder, false, "*", File::TypesOfFileToFind::findFiles);
-    while (iter.next())
+    if (library.getNumTracks() > 0 || finished)
+        StartupTimer::mark(StartupTimer::libraryShown);
+    if (finished)
+        StartupTimer::mark(StartupTimer::libraryComplete);
+}
+
+void PlaylistComponent::addAnalysedTracks()
+{
+    const Array<File> analysed = recommender.takeAnalysedFiles();
+    if (analysed.isEmpty())
+        return;
+
+    for (auto& file : analysed)
     {
-        trackTitles.push_back(iter.getFile().getFileNameWithoutExtension().toStdString());
+        float bpm = 0;
+        int key = -1;
+        const TrackLibrary::TrackId id = library.findTrack(file);
+        if (id != TrackLibrary::invalidId && recommender.getTempoAndKey(file, bpm, key))
+            library.setBpmAndKey(id, bpm, TrackFeatures::getKeyName(key));
     }
+    // rows stay where they are; a BPM or key sort picks the new values up next time
+    tableComponent.repaint();
+}
+
 
+void PlaylistComponent::loadTracks()
+{
+    library.setFilter(searchBox.getText());
     tableComponent.updateContent();
+    tableComponent.repaint();
+    dropHiddenPreviews();
 }
 
 void PlaylistComponent::writeStringToFile(const String& text, const File& file)
@@ -195,8 +380,9 @@ void PlaylistComponent::writeStringToFile(const String& text, const File& file)
 void PlaylistComponent::deleteSelectedTrack()
 {
     int selectedRow = tableComponent.getSelectedRow();
+    TrackLibrary::TrackId id = library.getIdForRow(selectedRow);
 
-    if (selectedRow < 0 || selectedRow >= trackTitles.size())
+    if (!library.isValid(id))
     {
         // show an error window if no file is selected
         AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon,
@@ -204,29 +390,243 @@ void PlaylistComponent::deleteSelectedTrack()
         return;
     }
 
-    // ask for confirmation
-    int result = AlertWindow::showOkCancelBox(AlertWindow::QuestionIcon,
-        "Delete Track", "Are you sure you want to delete " + trackTitles[selectedRow] + ".mp3 ?");
+    const File trackFile = library.getFile(id);
 
-    if (result == 1)
+    // ask for confirmation; the table may have changed by the time it is given
+    Component::SafePointer<PlaylistComponent> safeThis(this);
+    AlertWindow::showOkCancelBox(AlertWindow::QuestionIcon,
+        "Delete Track", "Are you sure you want to delete " + trackFile.getFileName() + " ?",
+        {}, {}, this, ModalCallbackFunction::create([safeThis, trackFile](int result)
     {
-        File tracksDir = File::getCurrentWorkingDirectory().getChildFile("tracks");
-        File trackFile = tracksDir.getChildFile(trackTitles[selectedRow] + ".mp3");
+        if (safeThis == nullptr || result != 1)
+            return;
+
         trackFile.deleteFile();
+        const TrackLibrary::TrackId current = safeThis->library.findTrack(trackFile);
+        if (current != TrackLibrary::invalidId)
+            safeThis->library.removeTrack(current);
+        safeThis->recommender.removeTrack(trackFile);
+        safeThis->decodeCache.removeTrack(trackFile);
+        safeThis->previews.remove(trackFile);
+        safeThis->loadTracks();
+        safeThis->tableComponent.deselectAllRows();
+    }));
+}
+
+void PlaylistComponent::importTrack(const File& file)
+{
+    importer.importFile(file);
+}
+
+TrackImporter& PlaylistComponent::getImporter()
+{
+    return importer;
+}
+
+//==============================================================================
+void PlaylistComponent::showList(PlaylistStore::ListId id)
+{
+    if (store.findList(id) == nullptr)
+        id = 0;
+
+    currentList = id;
+    if (id == 0)
+        library.clearScope();
+    else
+        library.setScope(store.resolve(id));
+
+    tableComponent.deselectAllRows();
+    loadTracks();
+    listBox.setSelectedId(id == 0 ? (int)allTracksItem : (int)listItemBase + (int)id, dontSendNotification);
+}
+
+Array<File> PlaylistComponent::getQueue() const
+{
+    Array<File> queue;
+    for (int row = jmax(0, tableComponent.getSelectedRow()); row < library.getNumRows(); ++row)
+        queue.add(library.getFile(library.getIdForRow(row)));
+    return queue;
+}
+
+void PlaylistComponent::selectTrack(const File& file)
+{
+    const TrackLibrary::TrackId id = library.findTrack(file);
+    if (!library.isValid(id))
+        return;
+
+    int row = library.getRowForId(id);
+    if (row < 0)
+    {
+        searchBox.clear();
+        showList(0);
+        refreshListBox();
+        row = library.getRowForId(id);
+    }
+    if (row < 0)
+        return;
+
+    tableComponent.selectRow(row);
+    tableComponent.scrollToEnsureRowIsOnscreen(row);
+}
+
+TrackRecommender& PlaylistComponent::getRecommender()
+{
+    return recommender;
+}
+
+DecodeCache& PlaylistComponent::getDecodeCache()
+{
+    return decodeCache;
+}
 
-        trackTitles.erase(trackTitles.begin() + selectedRow);
-        trackDurations.erase(trackDurations.begin() + selectedRow);
+void PlaylistComponent::refreshListBox()
+{
+    listBox.clear(dontSendNotification);
+    listBox.addItem("All tracks", allTracksItem);
+
+    for (auto kind : { PlaylistStore::Kind::playlist, PlaylistStore::Kind::crate })
+    {
+        bool headingAdded = false;
+        for (int i = 0; i < store.getNumLists(); ++i)
+        {
+            const PlaylistStore::List& list = store.getList(i);
+            if (list.kind != kind)
+                continue;
 
-        tableComponent.updateContent();
-        tableComponent.deselectAllRows();
+            if (!headingAdded)
+            {
+                listBox.addSectionHeading(kind == PlaylistStore::Kind::playlist ? "Playlists" : "Crates");
+                headingAdded = true;
+            }
+            listBox.addItem(list.name, (int)listItemBase + (int)list.id);
+        }
     }
-    else // user clicked "Cancel" or closed the dialog
+
+    listBox.addSeparator();
+    listBox.addItem("New playlist...", newPlaylistItem);
+    listBox.addItem("New crate...", newCrateItem);
+    listBox.addItem("Rename list...", renameListItem);
+    listBox.addItem("Delete list", deleteListItem);
+    listBox.setItemEnabled(renameListItem, currentList != 0);
+    listBox.setItemEnabled(deleteListItem, currentList != 0);
+
+    listBox.setSelectedId(currentList == 0 ? (int)allTracksItem : (int)listItemBase + (int)currentList, dontSendNotification);
+}
+
+void PlaylistComponent::listBoxChanged()
+{
+    const int item = listBox.getSelectedId();
+
+    if (item == allTracksItem)
+    {
+        showList(0);
+        refreshListBox();
+    }
+    else if (item >= listItemBase)
+    {
+        showList((PlaylistStore::ListId)(item - listItemBase));
+        refreshListBox();
+    }
+    else if (item == newPlaylistItem || item == newCrateItem)
     {
+        const auto kind = item == newPlaylistItem ? PlaylistStore::Kind::playlist : PlaylistStore::Kind::crate;
+        // the action items are never a selection; the box goes back to the list shown
+        refreshListBox();
+        askForListName(item == newPlaylistItem ? "New playlist" : "New crate", {}, [this, kind](const String& name)
+        {
+            showList(store.createList(name, kind));
+            refreshListBox();
+        });
+    }
+    else if (item == renameListItem && currentList != 0)
+    {
+        const PlaylistStore::ListId id = currentList;
+        refreshListBox();
+        askForListName("Rename list", store.findList(id)->name, [this, id](const String& name)
+        {
+            store.renameList(id, name);
+            refreshListBox();
+        });
+    }
+    else if (item == deleteListItem && currentList != 0)
+    {
+        const PlaylistStore::ListId id = currentList;
+        const String name = store.findList(id)->name;
+        refreshListBox();
+
+        // only the list goes; the tracks stay in the library
+        Component::SafePointer<PlaylistComponent> safeThis(this);
+        AlertWindow::showOkCancelBox(AlertWindow::QuestionIcon,
+            "Delete List", "Are you sure you want to delete the list " + name + " ?",
+            {}, {}, this, ModalCallbackFunction::create([safeThis, id](int result)
+        {
+            if (safeThis == nullptr || result != 1 || safeThis->store.findList(id) == nullptr)
+                return;
+
+            safeThis->store.removeList(id);
+            if (safeThis->currentList == id)
+                safeThis->showList(0);
+            safeThis->refreshListBox();
+        }));
+    }
+    else
+    {
+        refreshListBox();
+    }
+}
+
+void PlaylistComponent::showTrackMenu(int row)
+{
+    const TrackLibrary::TrackId id = library.getIdForRow(row);
+    if (!library.isValid(id))
         return;
-        tableComponent.updateContent();
-        tableComponent.deselectAllRows();
+
+    tableComponent.selectRow(row);
+
+    PopupMenu addTo;
+    for (int i = 0; i < store.getNumLists(); ++i)
+    {
+        const PlaylistStore::List& list = store.getList(i);
+        addTo.addItem((int)listItemBase + (int)list.id,
+                      list.kind == PlaylistStore::Kind::crate ? list.name + " (crate)" : list.name);
     }
 
+    PopupMenu menu;
+    menu.addSubMenu("Add to", addTo, store.getNumLists() > 0);
+    if (currentList != 0)
+        menu.addItem(1, "Remove from " + store.findList(currentList)->name);
+
+    const File file = library.getFile(id);
+    const PlaylistStore::ListId shownList = currentList;
+    Component::SafePointer<PlaylistComponent> safeThis(this);
+
+    menu.showMenuAsync(PopupMenu::Options(), [safeThis, file, shownList](int result)
+    {
+        if (safeThis == nullptr || result == 0)
+            return;
+
+        if (result == 1)
+            safeThis->store.removeTrack(shownList, file);
+        else if (result >= listItemBase)
+            safeThis->store.addTracks((PlaylistStore::ListId)(result - listItemBase), { file });
+
+        if (safeThis->currentList != 0)
+            safeThis->showList(safeThis->currentList);
+    });
 }
 
+void PlaylistComponent::askForListName(const String& title, const String& initialName, std::function<void(const String&)> onName)
+{
+    auto* window = new AlertWindow(title, "Name:", AlertWindow::NoIcon);
+    window->addTextEditor("name", initialName);
+    window->addButton("OK", 1, KeyPress(KeyPress::returnKey));
+    window->addButton("Cancel", 0, KeyPress(KeyPress::escapeKey));
 
+    Component::SafePointer<PlaylistComponent> safeThis(this);
+    window->enterModalState(true, ModalCallbackFunction::create([safeThis, window, onName](int result)
+    {
+        const String name = window->getTextEditorContents("name").trim();
+        if (safeThis != nullptr && result == 1 && name.isNotEmpty())
+            onName(name);
+    }), true);
+}
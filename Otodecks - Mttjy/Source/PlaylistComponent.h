@@ -13,12 +13,19 @@
 #include <JuceHeader.h>
 #include <vector>
 #include <string>
+#include "TrackLibrary.h"
+#include "TrackImporter.h"
+#include "PlaylistStore.h"
+#include "LibraryScanner.h"
+#include "TrackRecommender.h"
+#include "DecodeCache.h"
+#include "PreviewCache.h"
 
 
 //==============================================================================
 /*
 */
-class PlaylistComponent  : public Component, public TableListBoxModel
+class PlaylistComponent  : public Component, public TableListBoxModel, public ChangeListener
 {
 public:
     PlaylistComponent();
@@ -35,20 +42,78 @@ public:
 
     Component* refreshComponentForCell(int rowNumber, int columnId, bool isRowSelected, Component* existingComponentToUpdate) override;
 
+    void cellClicked(int rowNumber, int columnId, const MouseEvent& e) override;
+    void sortOrderChanged(int newSortColumnId, bool isForwards) override;
+    void selectedRowsChanged(int lastRowSelected) override;
+    void listWasScrolled() override;
+
+    void changeListenerCallback(ChangeBroadcaster* source) override;
+
     void writeStringToFile(const String& text, const File& file);
+    /** re-apply the search filter and sort order to the table */
     void loadTracks();
+    /** rescan the tracks folder in the background; rows stream in as they are found */
     void updateTrackTitles();
     void deleteSelectedTrack();
 
+    /** copy a dropped file into the tracks folder in the background */
+    void importTrack(const File& file);
+    TrackImporter& getImporter();
+
+    /** show a playlist or crate in the table, or the whole library for id 0 */
+    void showList(PlaylistStore::ListId id);
+
+    /** the tracks in the table, in table order, from the selected row on
+        (from the top if nothing is selected): the auto-DJ's queue */
+    Array<File> getQueue() const;
+
+    /** select a library track, showing the whole library if the current list doesn't have it */
+    void selectTrack(const File& file);
+    TrackRecommender& getRecommender();
+    DecodeCache& getDecodeCache();
+
 private:
-    std::string searchQuery;
+    enum ListBoxItem
+    {
+        allTracksItem = 1,
+        newPlaylistItem,
+        newCrateItem,
+        renameListItem,
+        deleteListItem,
+        listItemBase = 100
+    };
+
+    /** past TrackLibrary's columns; drawn here rather than looked up */
+    static constexpr int previewColumn = 100;
+
+    File getTracksFolder() const;
+    void paintPreview(Graphics& g, int rowNumber, int width, int height, bool rowIsSelected);
+    /** stop building previews for rows that are no longer on screen */
+    void dropHiddenPreviews();
+    /** message thread: put what the scanner has found so far into the table */
+    void addScannedTracks();
+    /** message thread: fill in the BPM and key of tracks the recommender has analysed */
+    void addAnalysedTracks();
+
+    void refreshListBox();
+    void listBoxChanged();
+    void showTrackMenu(int row);
+    void askForListName(const String& title, const String& initialName, std::function<void(const String&)> onName);
+
+    ComboBox listBox;
     juce::TextEditor searchBox;
     TableListBox tableComponent;
-    std::vector<std::string> trackTitles;
-    std::vector<std::string> trackDurations;
+    TrackLibrary library;
+    TrackImporter importer{ getTracksFolder() };
+    LibraryScanner scanner{ getTracksFolder() };
+    TrackRecommender recommender{ getTracksFolder() };
+    DecodeCache decodeCache{ getTracksFolder().getSiblingFile("decode_cache") };
+    PreviewCache previews{ &decodeCache };
+    PlaylistStore store{ File::getCurrentWorkingDirectory().getChildFile("playlists.otpl"), getTracksFolder() };
+    PlaylistStore::ListId currentList = 0;
     String currentURL;
-    int lastSelectedRow = -1;
     TextButton deleteButton;
+    ToggleButton decodeCacheToggle{ "Fast decode" };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PlaylistComponent)
 };
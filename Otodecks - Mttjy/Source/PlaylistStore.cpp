@@ -0,0 +1,450 @@
+/*
+  ==============================================================================
+
+    PlaylistStore.cpp
+    Created: 19 Oct 2026 6:02:13pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "PlaylistStore.h"
+#include <algorithm>
+
+PlaylistStore::PlaylistStore(const File& storeFile, const File& tracks)
+    : file(storeFile), tracksFolder(tracks)
+{
+}
+
+PlaylistStore::~PlaylistStore()
+{
+    close();
+}
+
+bool PlaylistStore::open(String& error)
+{
+    close();
+    lists.clear();
+    keyPaths.clear();
+    keyForPath.clear();
+    trackForKey.clear();
+    nextListId = 1;
+    numSupersededRecords = 0;
+
+    int64 validEnd = 0;
+    if (file.existsAsFile() && file.getSize() > 0)
+    {
+        // map rather than read, so a big store costs page faults for what
+        // is actually parsed and nothing else
+        MemoryMappedFile mapped(file, MemoryMappedFile::readOnly);
+        if (mapped.getData() == nullptr)
+        {
+            error = "Cannot read " + file.getFullPathName();
+            return false;
+        }
+
+        if (!replay(mapped.getData(), mapped.getSize(), validEnd))
+        {
+            error = file.getFullPathName() + " is not a playlist store";
+            return false;
+        }
+    }
+
+    if (!openJournal(validEnd))
+    {
+        error = "Cannot write " + file.getFullPathName();
+        return false;
+    }
+
+    compactIfNeeded();
+    return true;
+}
+
+void PlaylistStore::close()
+{
+    if (journal != nullptr)
+        journal->flush();
+    journal.reset();
+}
+
+bool PlaylistStore::openJournal(int64 validEnd)
+{
+    file.getParentDirectory().createDirectory();
+    journal.reset(new FileOutputStream(file));
+    if (!journal->openedOk())
+    {
+        journal.reset();
+        return false;
+    }
+
+    if (validEnd < headerSize)
+    {
+        journal->setPosition(0);
+        journal->truncate();
+        journal->write("OTPL", 4);
+        journal->writeInt(version);
+    }
+    else if (validEnd < journal->getPosition())
+    {
+        // drop whatever a crash left half written
+        journal->setPosition(validEnd);
+        journal->truncate();
+    }
+    journal->flush();
+    return true;
+}
+
+//==============================================================================
+bool PlaylistStore::replay(const void* data, size_t size, int64& validEnd)
+{
+    validEnd = 0;
+    if (size < (size_t)headerSize)
+        return true; // a header cut short is treated as an empty store
+
+    const char* bytes = static_cast<const char*>(data);
+    if (memcmp(bytes, "OTPL", 4) != 0 || ByteOrder::littleEndianInt(bytes + 4) != (uint32)version)
+        return false;
+
+    size_t pos = (size_t)headerSize;
+    validEnd = headerSize;
+
+    while (pos + 9 <= size)
+    {
+        const RecordType type = (RecordType)(uint8)bytes[pos];
+        const size_t payloadSize = ByteOrder::littleEndianInt(bytes + pos + 1);
+        const size_t payloadStart = pos + 5;
+        if (payloadSize > size - payloadStart - 4)
+            break;
+
+        const char* payload = bytes + payloadStart;
+        if (ByteOrder::littleEndianInt(payload + payloadSize) != checksum(type, payload, payloadSize))
+            break;
+
+        MemoryInputStream in(payload, payloadSize, false);
+        if (type == trackKeyRecord)
+        {
+            const TrackKey key = (TrackKey)in.readInt();
+            const String path = readString(in);
+            if (key >= keyPaths.size())
+                keyPaths.resize((size_t)key + 1);
+            keyPaths[key] = path;
+            keyForPath.set(path, key);
+        }
+        else if (type == listRecord)
+        {
+            List list;
+            list.id = (ListId)in.readInt();
+            list.kind = (Kind)(uint8)in.readByte();
+            list.name = readString(in);
+            const uint32 count = (uint32)in.readInt();
+            if ((size_t)count * 4 > (size_t)in.getNumBytesRemaining())
+                break;
+
+            list.entries.resize(count);
+            for (auto& key : list.entries)
+                key = (TrackKey)in.readInt();
+
+            if (List* existing = findListForWriting(list.id))
+            {
+                *existing = std::move(list);
+                ++numSupersededRecords;
+            }
+            else
+            {
+                nextListId = jmax(nextListId, list.id + 1);
+                lists.push_back(std::move(list));
+            }
+        }
+        else if (type == removeRecord)
+        {
+            const ListId id = (ListId)in.readInt();
+            lists.erase(std::remove_if(lists.begin(), lists.end(), [id](const List& l) { return l.id == id; }), lists.end());
+            numSupersededRecords += 2;
+        }
+
+        pos = payloadStart + payloadSize + 4;
+        validEnd = (int64)pos;
+    }
+    return true;
+}
+
+uint32 PlaylistStore::checksum(RecordType type, const void* data, size_t size)
+{
+    uint32 hash = 2166136261u;
+    hash = (hash ^ (uint8)type) * 16777619u;
+
+    const uint8* bytes = static_cast<const uint8*>(data);
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+void PlaylistStore::writeString(OutputStream& out, const String& s)
+{
+    const size_t numBytes = s.getNumBytesAsUTF8();
+    out.writeInt((int)numBytes);
+    out.write(s.toRawUTF8(), numBytes);
+}
+
+String PlaylistStore::readString(MemoryInputStream& in)
+{
+    const int numBytes = in.readInt();
+    if (numBytes <= 0 || numBytes > in.getNumBytesRemaining())
+        return {};
+
+    const char* start = static_cast<const char*>(in.getData()) + in.getPosition();
+    in.skipNextBytes(numBytes);
+    return String::fromUTF8(start, numBytes);
+}
+
+void PlaylistStore::writeRecord(OutputStream& out, RecordType type, const MemoryBlock& payload)
+{
+    out.writeByte((char)type);
+    out.writeInt((int)payload.getSize());
+    out.write(payload.getData(), payload.getSize());
+    out.writeInt((int)checksum(type, payload.getData(), payload.getSize()));
+}
+
+void PlaylistStore::appendRecord(RecordType type, const MemoryBlock& payload)
+{
+    if (journal == nullptr)
+        return;
+
+    // build the whole record first so it reaches the file in one write
+    MemoryOutputStream record;
+    writeRecord(record, type, payload);
+    journal->write(record.getData(), record.getDataSize());
+    journal->flush();
+}
+
+void PlaylistStore::writeList(const List& list, MemoryOutputStream& out) const
+{
+    out.writeInt((int)list.id);
+    out.writeByte((char)list.kind);
+    writeString(out, list.name);
+    out.writeInt((int)list.entries.size());
+    for (TrackKey key : list.entries)
+        out.writeInt((int)key);
+}
+
+//==============================================================================
+void PlaylistStore::compactIfNeeded()
+{
+    if (numSupersededRecords > jmax(64, (int)lists.size()))
+        compact();
+}
+
+bool PlaylistStore::compact()
+{
+    MemoryOutputStream out;
+    out.write("OTPL", 4);
+    out.writeInt(version);
+
+    // keys keep their numbers, so the lists can be written out unchanged
+    for (TrackKey key = 0; key < (TrackKey)keyPaths.size(); ++key)
+    {
+        if (keyPaths[key].isEmpty())
+            continue;
+
+        MemoryOutputStream payload;
+        payload.writeInt((int)key);
+        writeString(payload, keyPaths[key]);
+        writeRecord(out, trackKeyRecord, payload.getMemoryBlock());
+    }
+
+    for (auto& list : lists)
+    {
+        MemoryOutputStream payload;
+        writeList(list, payload);
+        writeRecord(out, listRecord, payload.getMemoryBlock());
+    }
+
+    close();
+
+    TemporaryFile temp(file);
+    bool ok = temp.getFile().replaceWithData(out.getData(), out.getDataSize())
+           && temp.overwriteTargetFileWithTemporary();
+    if (ok)
+        numSupersededRecords = 0;
+
+    ok = openJournal((int64)file.getSize()) && ok;
+    return ok;
+}
+
+//==============================================================================
+int PlaylistStore::getNumLists() const
+{
+    return (int)lists.size();
+}
+
+const PlaylistStore::List& PlaylistStore::getList(int index) const
+{
+    return lists[(size_t)index];
+}
+
+const PlaylistStore::List* PlaylistStore::findList(ListId id) const
+{
+    for (auto& list : lists)
+        if (list.id == id)
+            return &list;
+    return nullptr;
+}
+
+PlaylistStore::List* PlaylistStore::findListForWriting(ListId id)
+{
+    for (auto& list : lists)
+        if (list.id == id)
+            return &list;
+    return nullptr;
+}
+
+PlaylistStore::ListId PlaylistStore::createList(const String& name, Kind kind)
+{
+    List list;
+    list.id = nextListId++;
+    list.kind = kind;
+    list.name = name;
+
+    MemoryOutputStream payload;
+    writeList(list, payload);
+    appendRecord(listRecord, payload.getMemoryBlock());
+
+    lists.push_back(std::move(list));
+    return lists.back().id;
+}
+
+void PlaylistStore::renameList(ListId id, const String& name)
+{
+    List* list = findListForWriting(id);
+    if (list == nullptr || list->name == name)
+        return;
+
+    list->name = name;
+    MemoryOutputStream payload;
+    writeList(*list, payload);
+    appendRecord(listRecord, payload.getMemoryBlock());
+    ++numSupersededRecords;
+    compactIfNeeded();
+}
+
+void PlaylistStore::removeList(ListId id)
+{
+    if (findList(id) == nullptr)
+        return;
+
+    lists.erase(std::remove_if(lists.begin(), lists.end(), [id](const List& l) { return l.id == id; }), lists.end());
+
+    MemoryOutputStream payload;
+    payload.writeInt((int)id);
+    appendRecord(removeRecord, payload.getMemoryBlock());
+    numSupersededRecords += 2;
+    compactIfNeeded();
+}
+
+void PlaylistStore::addTracks(ListId id, const Array<File>& files)
+{
+    if (findList(id) == nullptr || files.isEmpty())
+        return;
+
+    // new keys are journalled before the list that uses them
+    std::vector<TrackKey> keys;
+    for (auto& f : files)
+        keys.push_back(getKeyFor(f));
+
+    List* list = findListForWriting(id);
+    for (TrackKey key : keys)
+    {
+        if (list->kind == Kind::crate
+            && std::find(list->entries.begin(), list->entries.end(), key) != list->entries.end())
+            continue;
+        list->entries.push_back(key);
+    }
+
+    MemoryOutputStream payload;
+    writeList(*list, payload);
+    appendRecord(listRecord, payload.getMemoryBlock());
+    ++numSupersededRecords;
+    compactIfNeeded();
+}
+
+void PlaylistStore::removeTrack(ListId id, const File& f)
+{
+    List* list = findListForWriting(id);
+    const String path = getPathFor(f);
+    if (list == nullptr || !keyForPath.contains(path))
+        return;
+
+    const TrackKey key = keyForPath[path];
+    const size_t before = list->entries.size();
+    list->entries.erase(std::remove(list->entries.begin(), list->entries.end(), key), list->entries.end());
+    if (list->entries.size() == before)
+        return;
+
+    MemoryOutputStream payload;
+    writeList(*list, payload);
+    appendRecord(listRecord, payload.getMemoryBlock());
+    ++numSupersededRecords;
+    compactIfNeeded();
+}
+
+String PlaylistStore::getPathFor(const File& f) const
+{
+    // relative paths survive moving the whole working folder
+    return f.isAChildOf(tracksFolder) ? f.getRelativePathFrom(tracksFolder) : f.getFullPathName();
+}
+
+PlaylistStore::TrackKey PlaylistStore::getKeyFor(const File& f)
+{
+    const String path = getPathFor(f);
+    if (keyForPath.contains(path))
+        return keyForPath[path];
+
+    const TrackKey key = (TrackKey)keyPaths.size();
+    keyPaths.push_back(path);
+    keyForPath.set(path, key);
+
+    MemoryOutputStream payload;
+    payload.writeInt((int)key);
+    writeString(payload, path);
+    appendRecord(trackKeyRecord, payload.getMemoryBlock());
+    return key;
+}
+
+//==============================================================================
+void PlaylistStore::bindLibrary(const TrackLibrary& newLibrary)
+{
+    library = &newLibrary;
+    trackForKey.clear();
+}
+
+std::vector<TrackLibrary::TrackId> PlaylistStore::resolve(ListId id) const
+{
+    std::vector<TrackLibrary::TrackId> ids;
+    const List* list = findList(id);
+    if (list == nullptr || library == nullptr)
+        return ids;
+
+    // keys are resolved against the library once, after that a switch is a table lookup
+    if (trackForKey.size() < keyPaths.size())
+    {
+        const size_t first = trackForKey.size();
+        trackForKey.resize(keyPaths.size());
+        for (size_t key = first; key < keyPaths.size(); ++key)
+            trackForKey[key] = keyPaths[key].isEmpty() ? TrackLibrary::invalidId
+                                                       : library->findTrack(tracksFolder.getChildFile(keyPaths[key]));
+    }
+
+    ids.reserve(list->entries.size());
+    for (TrackKey key : list->entries)
+    {
+        const TrackLibrary::TrackId track = key < trackForKey.size() ? trackForKey[key] : TrackLibrary::invalidId;
+        if (library->isValid(track))
+            ids.push_back(track);
+    }
+    return ids;
+}
+
+File PlaylistStore::getFile() const
+{
+    return file;
+}
@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    PlaylistStore.h
+    Created: 19 Oct 2026 6:02:13pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+#include "TrackLibrary.h"
+
+//==============================================================================
+/*
+    Named playlists (ordered, may repeat a track) and crates (unordered sets)
+    kept in one binary journal, playlists.otpl.
+
+    Tracks are referenced by a TrackKey, a small integer that stands for a
+    path relative to the tracks folder and stays the same across sessions.
+    The file is a header followed by checksummed records:
+
+        "OTPL" int32 version
+        uint8 type, uint32 size, <size bytes>, uint32 FNV-1a of type + payload
+
+        trackKey  uint32 key, string path
+        list      uint32 id, uint8 kind, string name, uint32 count, count x uint32 key
+        remove    uint32 id
+
+    Every change appends one record and flushes, so a save costs a few
+    hundred bytes no matter how big the library is. A later list record
+    replaces an earlier one with the same id. Opening maps the file and
+    replays it; a record cut short by a crash fails its checksum and is
+    dropped along with anything after it. When superseded records outnumber
+    live ones the journal is rewritten to a temporary file and swapped in
+    atomically.
+*/
+class PlaylistStore
+{
+public:
+    using ListId = uint32;
+    using TrackKey = uint32;
+
+    enum class Kind : uint8
+    {
+        playlist = 0,
+        crate = 1
+    };
+
+    struct List
+    {
+        ListId id = 0;
+        Kind kind = Kind::playlist;
+        String name;
+        std::vector<TrackKey> entries;
+    };
+
+    PlaylistStore(const File& storeFile, const File& tracksFolder);
+    ~PlaylistStore();
+
+    /** read the journal, dropping a torn tail, and get ready to append */
+    bool open(String& error);
+    void close();
+
+    int getNumLists() const;
+    /** lists in creation order */
+    const List& getList(int index) const;
+    const List* findList(ListId id) const;
+
+    ListId createList(const String& name, Kind kind);
+    void renameList(ListId id, const String& name);
+    void removeList(ListId id);
+
+    /** playlists append, crates ignore tracks they already hold */
+    void addTracks(ListId id, const Array<File>& files);
+    /** remove every entry for file from the list */
+    void removeTrack(ListId id, const File& file);
+
+    /** point the store at the library whose TrackIds resolve() returns */
+    void bindLibrary(const TrackLibrary& library);
+    /** the list's tracks as TrackIds of the bound library; missing files are skipped */
+    std::vector<TrackLibrary::TrackId> resolve(ListId id) const;
+
+    File getFile() const;
+
+private:
+    enum RecordType : uint8
+    {
+        trackKeyRecord = 1,
+        listRecord = 2,
+        removeRecord = 3
+    };
+
+    static constexpr int version = 1;
+    static constexpr int headerSize = 8;
+
+    TrackKey getKeyFor(const File& file);
+    String getPathFor(const File& file) const;
+    List* findListForWriting(ListId id);
+
+    bool replay(const void* data, size_t size, int64& validEnd);
+    void writeList(const List& list, MemoryOutputStream& out) const;
+    void appendRecord(RecordType type, const MemoryBlock& payload);
+    static void writeRecord(OutputStream& out, RecordType type, const MemoryBlock& payload);
+    static uint32 checksum(RecordType type, const void* data, size_t size);
+    static void writeString(OutputStream& out, const String& s);
+    static String readString(MemoryInputStream& in);
+
+    void compactIfNeeded();
+    bool compact();
+    bool openJournal(int64 validEnd);
+
+    File file;
+    File tracksFolder;
+    std::unique_ptr<FileOutputStream> journal;
+
+    std::vector<List> lists;
+    ListId nextListId = 1;
+
+    std::vector<String> keyPaths;
+    HashMap<String, TrackKey> keyForPath;
+    int numSupersededRecords = 0;
+
+    const TrackLibrary* library = nullptr;
+    mutable std::vector<TrackLibrary::TrackId> trackForKey;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlaylistStore)
+};
@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+    PreviewCache.cpp
+    Created: 20 Oct 2026 7:24:10am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "PreviewCache.h"
+
+namespace
+{
+    int8 toByte(float level)
+    {
+        return (int8)jlimit(-127, 127, roundToInt(level * 127.0f));
+    }
+}
+
+//==============================================================================
+class PreviewCache::PreviewJob : public ThreadPoolJob
+{
+public:
+    PreviewJob(PreviewCache& _owner, const File& _file)
+        : ThreadPoolJob("Preview " + _file.getFileName()), owner(_owner), file(_file), key(_file.getFullPathName())
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        // scrolled past while it was queued
+        if (!owner.isWanted(key))
+            return jobHasFinished;
+
+        // built by an earlier request for the same row; the key is still pending, so let it go
+        if (owner.get(file) != nullptr)
+        {
+            owner.dropPending(key);
+            return jobHasFinished;
+        }
+
+        std::unique_ptr<AudioFormatReader> reader;
+        if (owner.decodeCache != nullptr)
+        {
+            const File copy = owner.decodeCache->getCachedFile(file);
+            if (copy.existsAsFile())
+                reader = DecodeCache::openCopy(copy);
+        }
+        if (reader == nullptr)
+            reader.reset(owner.formatManager.createReaderFor(file));
+
+        // an unreadable track gets a flat line, so its row doesn't ask again on every paint
+        auto preview = std::make_shared<TrackPreview>();
+        if (reader != nullptr && !build(*reader, *preview, [this] { return shouldExit() || !owner.isWanted(key); }))
+            return jobHasFinished;
+
+        owner.finished(key, preview);
+        return jobHasFinished;
+    }
+
+private:
+    PreviewCache& owner;
+    const File file;
+    const String key;
+};
+
+//==============================================================================
+PreviewCache::PreviewCache(DecodeCache* _decodeCache)
+    : decodeCache(_decodeCache)
+{
+    formatManager.registerBasicFormats();
+}
+
+PreviewCache::~PreviewCache()
+{
+    pool.removeAllJobs(true, 5000);
+}
+
+std::shared_ptr<const TrackPreview> PreviewCache::get(const File& file) const
+{
+    const ScopedLock sl(lock);
+    auto it = previews.find(file.getFullPathName());
+    return it != previews.end() ? it->second : nullptr;
+}
+
+void PreviewCache::request(const File& file)
+{
+    const String key = file.getFullPathName();
+    {
+        const ScopedLock sl(lock);
+        if (previews.count(key) > 0 || pendingKeys.count(key) > 0)
+            return;
+        pendingKeys.insert(key);
+    }
+
+    pool.addJob(new PreviewJob(*this, file), true);
+}
+
+void PreviewCache::keepOnly(const Array<File>& files)
+{
+    std::set<String> keep;
+    for (auto& file : files)
+        keep.insert(file.getFullPathName());
+
+    // the jobs themselves notice they are no longer wanted
+    const ScopedLock sl(lock);
+    for (auto it = pendingKeys.begin(); it != pendingKeys.end();)
+        it = keep.count(*it) == 0 ? pendingKeys.erase(it) : std::next(it);
+}
+
+void PreviewCache::remove(const File& file)
+{
+    const String key = file.getFullPathName();
+    const ScopedLock sl(lock);
+    pendingKeys.erase(key);
+    if (previews.erase(key) > 0)
+        recentKeys.removeString(key);
+}
+
+int PreviewCache::getNumPending() const
+{
+    const ScopedLock sl(lock);
+    return (int)pendingKeys.size();
+}
+
+bool PreviewCache::isWanted(const String& key) const
+{
+    const ScopedLock sl(lock);
+    return pendingKeys.count(key) > 0;
+}
+
+void PreviewCache::dropPending(const String& key)
+{
+    const ScopedLock sl(lock);
+    pendingKeys.erase(key);
+}
+
+void PreviewCache::finished(const String& key, std::shared_ptr<const TrackPreview> preview)
+{
+    {
+        const ScopedLock sl(lock);
+        if (pendingKeys.erase(key) == 0)
+            return;     // removed, or scrolled past, after its last column was read
+        previews[key] = preview;
+        recentKeys.removeString(key);
+        recentKeys.add(key);
+
+        while (recentKeys.size() > maxPreviews)
+        {
+            previews.erase(recentKeys[0]);
+            recentKeys.remove(0);
+        }
+    }
+
+    sendChangeMessage();
+}
+
+//==============================================================================
+bool PreviewCache::build(AudioFormatReader& reader, TrackPreview& preview, std::function<bool()> shouldStop)
+{
+    const int64 length = reader.lengthInSamples;
+    const int numChannels = jlimit(1, 2, (int)reader.numChannels);
+    Range<float> levels[2];
+
+    for (int c = 0; c < TrackPreview::numColumns; ++c)
+    {
+        if (shouldStop != nullptr && shouldStop())
+            return false;
+
+        // one window from the middle of the column; the whole column if it is shorter
+        const int64 columnStart = length * c / TrackPreview::numColumns;
+        const int64 columnLength = length * (c + 1) / TrackPreview::numColumns - columnStart;
+        const int64 numSamples = jmin(columnLength, (int64)windowSamples);
+        if (numSamples <= 0)
+            continue;
+
+        reader.readMaxLevels(columnStart + (columnLength - numSamples) / 2, numSamples, levels, numChannels);
+        Range<float> both = levels[0];
+        if (numChannels > 1)
+            both = both.getUnionWith(levels[1]);
+
+        preview.minimum[(size_t)c] = toByte(both.getStart());
+        preview.maximum[(size_t)c] = toByte(both.getEnd());
+    }
+    return true;
+}
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    PreviewCache.h
+    Created: 20 Oct 2026 7:24:10am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <array>
+#include <map>
+#include <memory>
+#include <set>
+#include "DecodeCache.h"
+
+//==============================================================================
+/*
+    The overview drawn in a playlist row: for each of numColumns stretches
+    of the track, the lowest and highest sample of both channels in one
+    window from the middle of the stretch (the whole stretch when it is
+    shorter), as signed bytes. It is 256 bytes whatever the track's length.
+    A peak outside the windows doesn't show.
+*/
+struct TrackPreview
+{
+    static constexpr int numColumns = 128;
+
+    std::array<int8, numColumns> minimum{};
+    std::array<int8, numColumns> maximum{};
+};
+
+//==============================================================================
+/*
+    Builds TrackPreviews on a small pool of background threads, for the rows
+    the playlist is showing, and keeps the most recently used ones.
+
+    A preview doesn't need the whole track decoded: each column reads one
+    window of windowSamples from its middle. That is about a twentieth of
+    a typical track, and a track with a current DecodeCache copy is read
+    from the memory-mapped copy without decoding at all.
+
+    Painting calls get(), which only looks in the cache, then request() for
+    a miss. When the table scrolls, keepOnly() is handed the rows now on
+    screen. A queued preview for any other row is dropped when it reaches a
+    thread, and one already being built stops at its next column, so a fast
+    scroll through the library leaves nothing behind it to wait for. A
+    change message goes out as previews arrive.
+*/
+class PreviewCache : public ChangeBroadcaster
+{
+public:
+    static constexpr int windowSamples = 4096;
+    static constexpr int maxPreviews = 4096;
+
+    /** decodeCache, if given, is read from instead of the originals where it has a copy */
+    PreviewCache(DecodeCache* decodeCache = nullptr);
+    ~PreviewCache() override;
+
+    /** any thread, never waits on a decode: the preview if it is built, else nullptr */
+    std::shared_ptr<const TrackPreview> get(const File& file) const;
+
+    /** message thread: build file's preview in the background, unless it is built or queued */
+    void request(const File& file);
+    /** message thread: drop every queued or running request but these */
+    void keepOnly(const Array<File>& files);
+    /** message thread: forget file's preview, e.g. after it was deleted */
+    void remove(const File& file);
+
+    int getNumPending() const;
+
+    /** the preview of a whole track, in the caller's thread; false if shouldStop() said so */
+    static bool build(AudioFormatReader& reader, TrackPreview& preview, std::function<bool()> shouldStop = nullptr);
+
+private:
+    class PreviewJob;
+
+    /** the job's side: still on screen? */
+    bool isWanted(const String& key) const;
+    void finished(const String& key, std::shared_ptr<const TrackPreview> preview);
+    /** the job's side: nothing to build after all */
+    void dropPending(const String& key);
+
+    DecodeCache* decodeCache;
+    AudioFormatManager formatManager;
+    ThreadPool pool{ 2 };
+
+    mutable CriticalSection lock;
+    std::map<String, std::shared_ptr<const TrackPreview>> previews;
+    StringArray recentKeys;         // least recently built first
+    std::set<String> pendingKeys;   // requested, and not finished or dropped
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PreviewCache)
+};
@@ -0,0 +1,173 @@
+/*
+  ==============================================================================
+
+    ReaderPool.cpp
+    Created: 20 Oct 2026 2:58:04am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "ReaderPool.h"
+
+//==============================================================================
+ReaderPool::ReaderPool(AudioFormatManager& _formatManager, int _maxIdle)
+    : formatManager(_formatManager), maxIdle(jmax(0, _maxIdle))
+{
+}
+
+ReaderPool::~ReaderPool()
+{
+    clear();
+}
+
+std::unique_ptr<AudioFormatReader> ReaderPool::acquire(const URL& url)
+{
+    if (!url.isLocalFile())
+        return std::unique_ptr<AudioFormatReader>(formatManager.createReaderFor(url.createInputStream(false)));
+
+    const File file = url.getLocalFile();
+    const String path = file.getFullPathName();
+    const int64 size = file.getSize();
+    const Time modified = file.getLastModificationTime();
+    const File copy = decodeCache != nullptr ? decodeCache->getCachedFile(file) : File();
+
+    {
+        const ScopedLock sl(lock);
+        for (size_t i = idle.size(); i-- > 0;)
+        {
+            if (idle[i].path != path)
+                continue;
+
+            // the file was replaced since: that reader's headers are stale. Or it has been
+            // decoded since, and the copy is cheaper to read, or its copy has gone
+            const bool mapped = isCopy(*idle[i].reader);
+            if (idle[i].size != size || idle[i].modified != modified || mapped != copy.existsAsFile())
+            {
+                idle.erase(idle.begin() + (std::ptrdiff_t)i);
+                continue;
+            }
+
+            std::unique_ptr<AudioFormatReader> reader = std::move(idle[i].reader);
+            idle.erase(idle.begin() + (std::ptrdiff_t)i);
+            ++numReused;
+            return reader;
+        }
+    }
+
+    if (copy.existsAsFile())
+    {
+        if (std::unique_ptr<AudioFormatReader> reader = DecodeCache::openCopy(copy))
+        {
+            ++numOpened;
+            ++numFromCache;
+            return reader;
+        }
+    }
+
+    // decoded in the background for next time
+    if (decodeCache != nullptr && decodeCache->isEnabled())
+        decodeCache->addTracks({ file });
+
+    std::unique_ptr<AudioFormatReader> reader = openInMemory(formatManager, file, &bytesRead);
+    if (reader != nullptr)
+        ++numOpened;
+    return reader;
+}
+
+std::unique_ptr<AudioFormatReader> ReaderPool::openInMemory(AudioFormatManager& formatManager, const File& file,
+                                                            std::atomic<int64>* bytesLoaded)
+{
+    MemoryBlock data;
+    if (!file.loadFileAsData(data))
+        return nullptr;
+
+    if (bytesLoaded != nullptr)
+        bytesLoaded->fetch_add((int64)data.getSize(), std::memory_order_relaxed);
+
+    // the format manager deletes the stream if no format takes it
+    return std::unique_ptr<AudioFormatReader>(formatManager.createReaderFor(std::make_unique<MemoryInputStream>(std::move(data))));
+}
+
+void ReaderPool::release(const URL& url, std::unique_ptr<AudioFormatReader> reader)
+{
+    if (reader == nullptr || !url.isLocalFile() || maxIdle == 0)
+        return;
+
+    // the cache was turned off while this was out: its copy is waiting to be deleted
+    if (isCopy(*reader) && (decodeCache == nullptr || !decodeCache->isEnabled()))
+        return;
+
+    Idle entry;
+    entry.path = url.getLocalFile().getFullPathName();
+    entry.size = url.getLocalFile().getSize();
+    entry.modified = url.getLocalFile().getLastModificationTime();
+    entry.reader = std::move(reader);
+
+    std::unique_ptr<AudioFormatReader> evicted;
+    {
+        const ScopedLock sl(lock);
+        idle.push_back(std::move(entry));
+        if ((int)idle.size() > maxIdle)
+        {
+            evicted = std::move(idle.front().reader);
+            idle.erase(idle.begin());
+        }
+    }
+    // closed outside the lock
+}
+
+void ReaderPool::clear()
+{
+    std::vector<Idle> closing;
+    {
+        const ScopedLock sl(lock);
+        closing.swap(idle);
+    }
+}
+
+void ReaderPool::clearCopies()
+{
+    std::vector<Idle> closing;
+    {
+        const ScopedLock sl(lock);
+        for (size_t i = idle.size(); i-- > 0;)
+        {
+            if (isCopy(*idle[i].reader))
+            {
+                closing.push_back(std::move(idle[i]));
+                idle.erase(idle.begin() + (std::ptrdiff_t)i);
+            }
+        }
+    }
+}
+
+bool ReaderPool::isCopy(const AudioFormatReader& reader)
+{
+    return dynamic_cast<const MemoryMappedAudioFormatReader*>(&reader) != nullptr;
+}
+
+ReaderPool::Stats ReaderPool::getStats() const
+{
+    Stats stats;
+    stats.numOpened = numOpened.load();
+    stats.numReused = numReused.load();
+    stats.numFromCache = numFromCache.load();
+    stats.bytesRead = bytesRead.load();
+    return stats;
+}
+
+AudioFormatManager& ReaderPool::getFormatManager()
+{
+    return formatManager;
+}
+
+void ReaderPool::setDecodeCache(DecodeCache* cache)
+{
+    if (decodeCache != nullptr)
+        decodeCache->onDisabling = nullptr;
+
+    decodeCache = cache;
+    if (decodeCache != nullptr)
+        decodeCache->onDisabling = [this] { clearCopies(); };
+}
@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    ReaderPool.h
+    Created: 20 Oct 2026 2:58:04am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+#include <vector>
+#include "DecodeCache.h"
+
+//==============================================================================
+/*
+    Opens AudioFormatReaders with the app's one AudioFormatManager, and keeps
+    the ones handed back so the next user of the same file skips opening it.
+    Opening is not free: it parses the headers, and for an MP3 without a
+    length header it scans every frame.
+
+    A reader is used by one client at a time. acquire() hands out an idle
+    reader for the file if there is one, as long as the file's size and
+    modification time haven't changed, and opens a new one otherwise.
+    release() gives it back, and the least recently released readers are
+    closed once more than maxIdle are waiting.
+
+    Decks read on the audio thread, so a local file is read into memory
+    whole when its reader is opened and nothing is read from disk after
+    that. Every byte loaded is counted, so loads can be measured.
+
+    With a DecodeCache set, a track that has a current decoded copy is read
+    from that, memory-mapped, and idle readers of the original are dropped.
+    A track opened without one is queued for the cache to decode.
+    When the cache is turned off, idle readers of copies are closed at once,
+    and ones handed back afterwards are closed rather than kept, so the
+    cache can delete its copies.
+
+    URLs that aren't local files are opened through their stream every time.
+*/
+class ReaderPool
+{
+public:
+    struct Stats
+    {
+        int numOpened = 0;
+        int numReused = 0;
+        int numFromCache = 0;       // of numOpened
+        int64 bytesRead = 0;
+    };
+
+    ReaderPool(AudioFormatManager& formatManager, int maxIdle = 8);
+    ~ReaderPool();
+
+    /** any thread: a reader for url, or nullptr if no format can read it */
+    std::unique_ptr<AudioFormatReader> acquire(const URL& url);
+    /** any thread: done with a reader acquire() gave out for url */
+    void release(const URL& url, std::unique_ptr<AudioFormatReader> reader);
+
+    /** close every idle reader */
+    void clear();
+    /** close the idle readers of decoded copies */
+    void clearCopies();
+
+    Stats getStats() const;
+    AudioFormatManager& getFormatManager();
+
+    /** any thread: a reader for a local file, loaded into memory whole; bytesLoaded,
+        if given, has the file's size added to it */
+    static std::unique_ptr<AudioFormatReader> openInMemory(AudioFormatManager& formatManager, const File& file,
+                                                           std::atomic<int64>* bytesLoaded = nullptr);
+
+    /** read decoded copies from cache where there are any; nullptr to stop */
+    void setDecodeCache(DecodeCache* cache);
+
+private:
+    static bool isCopy(const AudioFormatReader& reader);
+
+    struct Idle
+    {
+        String path;
+        int64 size = 0;
+        Time modified;
+        std::unique_ptr<AudioFormatReader> reader;
+    };
+
+    AudioFormatManager& formatManager;
+    const int maxIdle;
+
+    CriticalSection lock;
+    std::vector<Idle> idle;     // least recently released first
+    DecodeCache* decodeCache = nullptr;
+
+    std::atomic<int> numOpened{ 0 };
+    std::atomic<int> numReused{ 0 };
+    std::atomic<int> numFromCache{ 0 };
+    std::atomic<int64> bytesRead{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReaderPool)
+};
@@ -0,0 +1,472 @@
+/*
+  ==============================================================================
+
+    RealtimeCheck.cpp
+    Created: 20 Oct 2026 5:02:44am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "RealtimeCheck.h"
+
+#if OTODECKS_RT_CHECK
+
+#include <atomic>
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <execinfo.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <time.h>
+ #include <unistd.h>
+ #include <fcntl.h>
+ #include <stdarg.h>
+#elif JUCE_WINDOWS
+ #include <crtdbg.h>
+ extern "C" __declspec(dllimport) unsigned short __stdcall RtlCaptureStackBackTrace(unsigned long, unsigned long, void**, unsigned long*);
+#endif
+
+namespace
+{
+    constexpr int maxSites = 256;
+    constexpr int maxFrames = 32;
+    constexpr int framesToSkip = 3;     // capture, record and the interceptor
+
+    /** one distinct call stack; filled in by whichever thread claims it first */
+    struct Site
+    {
+        std::atomic<uint64> hash{ 0 };
+        std::atomic<bool> ready{ false };
+        std::atomic<int> count{ 0 };
+        RealtimeCheck::Kind kind = RealtimeCheck::Kind::allocation;
+        const char* function = "";
+        String stackTrace;
+    };
+
+    Site sites[maxSites];
+    std::atomic<int> numViolations{ 0 };
+    std::atomic<int> numUnrecorded{ 0 };
+
+    // plain ints, so reading them from inside malloc never allocates
+    thread_local int realtimeDepth = 0;
+    thread_local bool recording = false;
+
+    int captureFrames(void** frames)
+    {
+       #if JUCE_LINUX
+        return backtrace(frames, maxFrames);
+       #elif JUCE_WINDOWS
+        return (int)RtlCaptureStackBackTrace(0, (unsigned long)maxFrames, frames, nullptr);
+       #else
+        ignoreUnused(frames);
+        return 0;
+       #endif
+    }
+
+    uint64 hashFrames(RealtimeCheck::Kind kind, void** frames, int numFrames)
+    {
+        uint64 hash = 14695981039346656037ull ^ (uint64)kind;
+        for (int i = 0; i < numFrames; ++i)
+            hash = (hash ^ (uint64)(pointer_sized_uint)frames[i]) * 1099511628211ull;
+        return hash == 0 ? 1 : hash;
+    }
+}
+
+//==============================================================================
+RealtimeCheck::ScopedRealtime::ScopedRealtime() noexcept
+{
+    ++realtimeDepth;
+}
+
+RealtimeCheck::ScopedRealtime::~ScopedRealtime() noexcept
+{
+    --realtimeDepth;
+}
+
+bool RealtimeCheck::isRealtimeThread() noexcept
+{
+    return realtimeDepth > 0 && !recording;
+}
+
+void RealtimeCheck::record(Kind kind, const char* function) noexcept
+{
+    if (!isRealtimeThread())
+        return;
+
+    // everything below may allocate or lock itself
+    recording = true;
+    ++numViolations;
+
+    void* frames[maxFrames];
+    const int numFrames = captureFrames(frames);
+    const uint64 hash = hashFrames(kind, frames + jmin(framesToSkip, numFrames), jmax(0, numFrames - framesToSkip));
+
+    bool stored = false;
+    for (int probe = 0; probe < maxSites && !stored; ++probe)
+    {
+        Site& site = sites[(hash + (uint64)probe) % maxSites];
+        uint64 expected = site.hash.load();
+        if (expected == hash)
+        {
+            ++site.count;
+            stored = true;
+        }
+        else if (expected == 0 && site.hash.compare_exchange_strong(expected, hash))
+        {
+            // first time this stack has been seen: symbolise it now, once
+            site.kind = kind;
+            site.function = function;
+            site.stackTrace = SystemStats::getStackBacktrace();
+            site.count = 1;
+            site.ready.store(true, std::memory_order_release);
+            Logger::outputDebugString("Realtime check: " + getKindName(kind) + " (" + function + ") on the audio thread\n"
+                                      + site.stackTrace);
+            stored = true;
+        }
+        else if (expected == hash)
+        {
+            ++site.count;
+            stored = true;
+        }
+    }
+    if (!stored)
+        ++numUnrecorded;
+
+    recording = false;
+}
+
+//==============================================================================
+std::vector<RealtimeCheck::Violation> RealtimeCheck::getViolations()
+{
+    std::vector<Violation> violations;
+    for (Site& site : sites)
+    {
+        if (!site.ready.load(std::memory_order_acquire))
+            continue;
+        Violation violation;
+        violation.kind = site.kind;
+        violation.function = site.function;
+        violation.count = site.count.load();
+        violation.stackTrace = site.stackTrace;
+        violations.push_back(violation);
+    }
+    std::sort(violations.begin(), violations.end(),
+              [](const Violation& a, const Violation& b) { return a.count > b.count; });
+    return violations;
+}
+
+int RealtimeCheck::getNumViolations()
+{
+    return numViolations.load();
+}
+
+void RealtimeCheck::reset()
+{
+    // only between runs: nothing may be recording now
+    for (Site& site : sites)
+    {
+        site.ready = false;
+        site.count = 0;
+        site.stackTrace = {};
+        site.hash = 0;
+    }
+    numViolations = 0;
+    numUnrecorded = 0;
+}
+
+String RealtimeCheck::getReport()
+{
+    const std::vector<Violation> violations = getViolations();
+    if (violations.empty())
+        return "Realtime check: no blocking calls on the audio thread\n";
+
+    String text;
+    text << "Realtime check: " << getNumViolations() << " blocking calls on the audio thread from "
+         << (int)violations.size() << " places";
+    if (numUnrecorded.load() > 0)
+        text << " (" << numUnrecorded.load() << " more from places past the first " << maxSites << ")";
+    text << "\n";
+
+    for (const Violation& violation : violations)
+        text << "\n" << getKindName(violation.kind) << ": " << violation.function << ", "
+             << violation.count << (violation.count == 1 ? " time\n" : " times\n")
+             << violation.stackTrace;
+    return text;
+}
+
+#else
+
+//==============================================================================
+std::vector<RealtimeCheck::Violation> RealtimeCheck::getViolations()  { return {}; }
+int RealtimeCheck::getNumViolations()                                 { return 0; }
+void RealtimeCheck::reset()                                           {}
+void RealtimeCheck::record(Kind, const char*) noexcept                {}
+bool RealtimeCheck::isRealtimeThread() noexcept                       { return false; }
+
+String RealtimeCheck::getReport()
+{
+    return "Realtime check: not in this build (use the RtCheck configuration)\n";
+}
+
+#endif
+
+String RealtimeCheck::getKindName(Kind kind)
+{
+    switch (kind)
+    {
+        case Kind::allocation:      return "allocation";
+        case Kind::deallocation:    return "free";
+        case Kind::lock:            return "lock";
+        case Kind::contendedLock:   return "contended lock";
+        case Kind::wait:            return "wait";
+        case Kind::sleep:           return "sleep";
+        case Kind::io:              return "I/O";
+    }
+    return {};
+}
+
+//==============================================================================
+// The interceptors. Each does its own work exactly as before and only
+// records the call when it is made inside a ScopedRealtime.
+#if OTODECKS_RT_CHECK && JUCE_LINUX
+
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void __libc_free(void*);
+}
+
+namespace
+{
+    /** the next definition of a libc function, looked up on first use */
+    void* real(std::atomic<void*>& cached, const char* name)
+    {
+        void* function = cached.load(std::memory_order_relaxed);
+        if (function == nullptr)
+        {
+            function = dlsym(RTLD_NEXT, name);
+            cached.store(function, std::memory_order_relaxed);
+        }
+        return function;
+    }
+
+    #define OTODECKS_REAL(name) \
+        static std::atomic<void*> cached_##name{ nullptr }; \
+        auto real_##name = (decltype(&::name))real(cached_##name, #name);
+
+    /** looks up everything and loads the unwinder before any audio runs */
+    struct Installer
+    {
+        Installer()
+        {
+            void* frames[4];
+            backtrace(frames, 4);
+            dlsym(RTLD_NEXT, "pthread_mutex_lock");
+        }
+    };
+    const Installer installer;
+}
+
+extern "C"
+{
+    void* malloc(size_t size)
+    {
+        RealtimeCheck::record(RealtimeCheck::Kind::allocation, "malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        RealtimeCheck::record(RealtimeCheck::Kind::allocation, "calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size)
+    {
+        RealtimeCheck::record(RealtimeCheck::Kind::allocation, "realloc");
+        return __libc_realloc(pointer, size);
+    }
+
+    void* memalign(size_t alignment, size_t size)
+    {
+        RealtimeCheck::record(RealtimeCheck::Kind::allocation, "memalign");
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size)
+    {
+        RealtimeCheck::record(RealtimeCheck::Kind::allocation, "aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** pointer, size_t alignment, size_t size)
+    {
+        RealtimeCheck::record(RealtimeCheck::Kind::allocation, "posix_memalign");
+        *pointer = __libc_memalign(alignment, size);
+        return *pointer != nullptr ? 0 : ENOMEM;
+    }
+
+    void free(void* pointer)
+    {
+        if (pointer != nullptr)
+            RealtimeCheck::record(RealtimeCheck::Kind::deallocation, "free");
+        __libc_free(pointer);
+    }
+
+    //==============================================================================
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        OTODECKS_REAL(pthread_mutex_lock)
+        if (RealtimeCheck::isRealtimeThread())
+        {
+            OTODECKS_REAL(pthread_mutex_trylock)
+            if (real_pthread_mutex_trylock(mutex) == 0)
+            {
+                RealtimeCheck::record(RealtimeCheck::Kind::lock, "pthread_mutex_lock");
+                return 0;
+            }
+            RealtimeCheck::record(RealtimeCheck::Kind::contendedLock, "pthread_mutex_lock");
+        }
+        return real_pthread_mutex_lock(mutex);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock)
+    {
+        OTODECKS_REAL(pthread_rwlock_rdlock)
+        RealtimeCheck::record(RealtimeCheck::Kind::lock, "pthread_rwlock_rdlock");
+        return real_pthread_rwlock_rdlock(lock);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock)
+    {
+        OTODECKS_REAL(pthread_rwlock_wrlock)
+        RealtimeCheck::record(RealtimeCheck::Kind::lock, "pthread_rwlock_wrlock");
+        return real_pthread_rwlock_wrlock(lock);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        OTODECKS_REAL(pthread_cond_wait)
+        RealtimeCheck::record(RealtimeCheck::Kind::wait, "pthread_cond_wait");
+        return real_pthread_cond_wait(condition, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* until)
+    {
+        OTODECKS_REAL(pthread_cond_timedwait)
+        RealtimeCheck::record(RealtimeCheck::Kind::wait, "pthread_cond_timedwait");
+        return real_pthread_cond_timedwait(condition, mutex, until);
+    }
+
+    int sem_wait(sem_t* semaphore)
+    {
+        OTODECKS_REAL(sem_wait)
+        RealtimeCheck::record(RealtimeCheck::Kind::wait, "sem_wait");
+        return real_sem_wait(semaphore);
+    }
+
+    int sem_timedwait(sem_t* semaphore, const struct timespec* until)
+    {
+        OTODECKS_REAL(sem_timedwait)
+        RealtimeCheck::record(RealtimeCheck::Kind::wait, "sem_timedwait");
+        return real_sem_timedwait(semaphore, until);
+    }
+
+    //==============================================================================
+    int nanosleep(const struct timespec* duration, struct timespec* remaining)
+    {
+        OTODECKS_REAL(nanosleep)
+        RealtimeCheck::record(RealtimeCheck::Kind::sleep, "nanosleep");
+        return real_nanosleep(duration, remaining);
+    }
+
+    int usleep(useconds_t micros)
+    {
+        OTODECKS_REAL(usleep)
+        RealtimeCheck::record(RealtimeCheck::Kind::sleep, "usleep");
+        return real_usleep(micros);
+    }
+
+    //==============================================================================
+    ssize_t read(int fd, void* buffer, size_t size)
+    {
+        OTODECKS_REAL(read)
+        RealtimeCheck::record(RealtimeCheck::Kind::io, "read");
+        return real_read(fd, buffer, size);
+    }
+
+    ssize_t write(int fd, const void* buffer, size_t size)
+    {
+        OTODECKS_REAL(write)
+        RealtimeCheck::record(RealtimeCheck::Kind::io, "write");
+        return real_write(fd, buffer, size);
+    }
+
+    ssize_t pread(int fd, void* buffer, size_t size, off_t offset)
+    {
+        OTODECKS_REAL(pread)
+        RealtimeCheck::record(RealtimeCheck::Kind::io, "pread");
+        return real_pread(fd, buffer, size, offset);
+    }
+
+    int open(const char* path, int flags, ...)
+    {
+        OTODECKS_REAL(open)
+        mode_t mode = 0;
+        if ((flags & O_CREAT) != 0)
+        {
+            va_list args;
+            va_start(args, flags);
+            mode = (mode_t)va_arg(args, int);
+            va_end(args);
+        }
+        RealtimeCheck::record(RealtimeCheck::Kind::io, "open");
+        return real_open(path, flags, mode);
+    }
+
+    int close(int fd)
+    {
+        OTODECKS_REAL(close)
+        RealtimeCheck::record(RealtimeCheck::Kind::io, "close");
+        return real_close(fd);
+    }
+
+    int fsync(int fd)
+    {
+        OTODECKS_REAL(fsync)
+        RealtimeCheck::record(RealtimeCheck::Kind::io, "fsync");
+        return real_fsync(fd);
+    }
+}
+
+#undef OTODECKS_REAL
+
+#elif OTODECKS_RT_CHECK && JUCE_WINDOWS && defined(_DEBUG)
+
+namespace
+{
+    int allocHook(int type, void*, size_t, int blockType, long, const unsigned char*, int)
+    {
+        // the CRT's own bookkeeping blocks are not the app's doing
+        if (blockType != _CRT_BLOCK)
+            RealtimeCheck::record(type == _HOOK_FREE ? RealtimeCheck::Kind::deallocation : RealtimeCheck::Kind::allocation,
+                                  type == _HOOK_FREE ? "free" : type == _HOOK_REALLOC ? "realloc" : "malloc");
+        return 1;
+    }
+
+    struct Installer
+    {
+        Installer()
+        {
+            _CrtSetAllocHook(allocHook);
+        }
+    };
+    const Installer installer;
+}
+
+#endif
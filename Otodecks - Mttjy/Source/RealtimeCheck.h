@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    RealtimeCheck.h
+    Created: 20 Oct 2026 5:02:44am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+
+#ifndef OTODECKS_RT_CHECK
+ #define OTODECKS_RT_CHECK 0
+#endif
+
+//==============================================================================
+/*
+    Catches the audio thread doing anything that can block: allocating or
+    freeing memory, taking a lock, waiting, sleeping, or file and console
+    I/O.
+
+    It is compiled in only with OTODECKS_RT_CHECK=1, which the RtCheck
+    build configuration sets. Everything inside a ScopedRealtime is checked
+    (MixEngine::getNextAudioBlock opens one, so the app, the offline
+    renderer and the stress test are all covered). Elsewhere it costs
+    nothing.
+
+        Linux      malloc, calloc, realloc, free and the aligned allocators;
+                   pthread mutex, rwlock, condition and semaphore waits (a
+                   lock is tried first, so contended and uncontended are
+                   told apart); sleeps; read, write, open, close and fsync
+        Windows    allocations and frees, through the debug CRT's hook
+
+    Each distinct call stack is recorded once with a symbolised stack trace,
+    and counted after that. The first time a stack is seen it is also
+    written to the debug log. Recording a violation allocates and locks
+    too, but those are not counted.
+*/
+class RealtimeCheck
+{
+public:
+    enum class Kind
+    {
+        allocation,
+        deallocation,
+        lock,
+        contendedLock,
+        wait,
+        sleep,
+        io
+    };
+
+    struct Violation
+    {
+        Kind kind = Kind::allocation;
+        String function;
+        int count = 0;
+        String stackTrace;
+    };
+
+    /** true if this build intercepts anything */
+    static constexpr bool isEnabled() { return OTODECKS_RT_CHECK != 0; }
+
+    /** marks the calling thread as real-time while it exists; may be nested */
+    class ScopedRealtime
+    {
+    public:
+       #if OTODECKS_RT_CHECK
+        ScopedRealtime() noexcept;
+        ~ScopedRealtime() noexcept;
+       #else
+        ScopedRealtime() noexcept {}
+       #endif
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtime)
+    };
+
+    /** every distinct violation so far, most frequent first */
+    static std::vector<Violation> getViolations();
+    /** how many intercepted calls there have been in total */
+    static int getNumViolations();
+    static void reset();
+
+    /** the violations as text, or a line saying there were none */
+    static String getReport();
+    static String getKindName(Kind kind);
+
+    /** audio thread, from the interceptors */
+    static void record(Kind kind, const char* function) noexcept;
+    static bool isRealtimeThread() noexcept;
+};
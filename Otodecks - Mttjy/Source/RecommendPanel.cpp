@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+    RecommendPanel.cpp
+    Created: 20 Oct 2026 4:16:02am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "RecommendPanel.h"
+
+//==============================================================================
+RecommendPanel::RecommendPanel(TrackRecommender& _recommender)
+    : recommender(_recommender)
+{
+    for (int i = 0; i < 2; ++i)
+    {
+        TextButton& button = deckButtons[i];
+        button.setButtonText("Deck " + String(i + 1));
+        button.setClickingTogglesState(true);
+        button.setRadioGroupId(1);
+        button.setToggleState(i == deck, dontSendNotification);
+        button.onClick = [this, i]
+        {
+            if (!deckButtons[i].getToggleState() || deck == i)
+                return;
+            deck = i;
+            refresh();
+        };
+        addAndMakeVisible(button);
+    }
+
+    addAndMakeVisible(statusLabel);
+    statusLabel.setFont(12.0f);
+
+    list.setRowHeight(20);
+    list.setColour(ListBox::backgroundColourId, Colour::fromRGB(200, 200, 200));
+    addAndMakeVisible(list);
+
+    recommender.addChangeListener(this);
+    startTimer(500);
+}
+
+RecommendPanel::~RecommendPanel()
+{
+    stopTimer();
+    recommender.removeChangeListener(this);
+}
+
+void RecommendPanel::paint (Graphics& g)
+{
+    g.fillAll(Colour::fromRGB(15, 15, 15));
+}
+
+void RecommendPanel::resized()
+{
+    deckButtons[0].setBounds(0, 0, getWidth() / 4, 35);
+    deckButtons[1].setBounds(getWidth() / 4, 0, getWidth() / 4, 35);
+    statusLabel.setBounds(getWidth() / 2, 0, getWidth() / 2, 35);
+    list.setBounds(0, 35, getWidth(), getHeight() - 35);
+}
+
+//==============================================================================
+int RecommendPanel::getNumRows()
+{
+    return (int)suggestions.size();
+}
+
+void RecommendPanel::paintListBoxItem(int rowNumber, Graphics& g, int width, int height, bool rowIsSelected)
+{
+    if (rowNumber < 0 || rowNumber >= (int)suggestions.size())
+        return;
+
+    const TrackRecommender::Suggestion& suggestion = suggestions[(size_t)rowNumber];
+    if (rowIsSelected)
+        g.fillAll(Colour::fromRGB(200, 135, 220));
+
+    String details;
+    if (suggestion.bpm > 0)
+        details << String(suggestion.bpm, 1) << " ";
+    details << TrackFeatures::getKeyName(suggestion.key);
+
+    const int detailsWidth = 70;
+    g.setColour(Colours::black);
+    g.setFont(14.0f);
+    g.drawText(suggestion.file.getFileNameWithoutExtension(), 4, 0, width - detailsWidth - 8, height, Justification::centredLeft, true);
+    g.drawText(details, width - detailsWidth - 4, 0, detailsWidth, height, Justification::centredRight, true);
+}
+
+void RecommendPanel::listBoxItemDoubleClicked(int row, const MouseEvent&)
+{
+    if (row >= 0 && row < (int)suggestions.size() && onPick)
+        onPick(suggestions[(size_t)row].file);
+}
+
+//==============================================================================
+void RecommendPanel::changeListenerCallback(ChangeBroadcaster*)
+{
+    // the deck's track may only now have been analysed, or the index rebuilt
+    if (suggestions.empty())
+        refresh();
+}
+
+void RecommendPanel::timerCallback()
+{
+    if (getDeckTrack == nullptr)
+        return;
+
+    if (getDeckTrack(deck) != shownFor || getDeckTrack(1 - deck) != shownAgainst)
+        refresh();
+    else if (recommender.getNumPending() > 0 && suggestions.empty())
+        statusLabel.setText("Analysing " + String(recommender.getNumPending()), dontSendNotification);
+}
+
+void RecommendPanel::refresh()
+{
+    shownFor = getDeckTrack != nullptr ? getDeckTrack(deck) : File();
+    shownAgainst = getDeckTrack != nullptr ? getDeckTrack(1 - deck) : File();
+
+    Array<File> exclude;
+    if (shownAgainst != File())
+        exclude.add(shownAgainst);
+
+    if (shownFor == File())
+    {
+        suggestions.clear();
+        statusLabel.setText("No track loaded", dontSendNotification);
+    }
+    else if (!recommender.findSimilar(shownFor, numSuggestions, suggestions, exclude))
+    {
+        statusLabel.setText(recommender.getNumPending() > 0 ? "Analysing " + String(recommender.getNumPending())
+                                                            : String("Not analysed"), dontSendNotification);
+    }
+    else
+    {
+        statusLabel.setText(String(recommender.getLastQueryMs(), 2) + " ms", dontSendNotification);
+    }
+
+    list.updateContent();
+    list.deselectAllRows();
+    list.repaint();
+}
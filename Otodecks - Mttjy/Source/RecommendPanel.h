@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    RecommendPanel.h
+    Created: 20 Oct 2026 4:16:02am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+#include "TrackRecommender.h"
+
+//==============================================================================
+/*
+    What to play next: the tracks that sound most like the one on the
+    chosen deck, leaving out whatever the other deck has loaded. The list
+    follows the deck as tracks are loaded and as the library gets analysed.
+    Double-clicking a suggestion picks it for the decks' LOAD buttons.
+*/
+class RecommendPanel  : public Component,
+                        public ListBoxModel,
+                        public ChangeListener,
+                        public Timer
+{
+public:
+    RecommendPanel(TrackRecommender& recommender);
+    ~RecommendPanel() override;
+
+    void paint (Graphics&) override;
+    void resized() override;
+
+    int getNumRows() override;
+    void paintListBoxItem(int rowNumber, Graphics&, int width, int height, bool rowIsSelected) override;
+    void listBoxItemDoubleClicked(int row, const MouseEvent&) override;
+
+    void changeListenerCallback(ChangeBroadcaster* source) override;
+    void timerCallback() override;
+
+    /** the file loaded on deck 0 or 1, or File() */
+    std::function<File(int)> getDeckTrack;
+    /** a suggestion was double-clicked */
+    std::function<void(const File&)> onPick;
+
+private:
+    void refresh();
+
+    static constexpr int numSuggestions = 12;
+
+    TrackRecommender& recommender;
+
+    TextButton deckButtons[2];
+    Label statusLabel;
+    ListBox list{ "Suggestions", this };
+
+    int deck = 0;
+    File shownFor;
+    File shownAgainst;
+    std::vector<TrackRecommender::Suggestion> suggestions;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RecommendPanel)
+};
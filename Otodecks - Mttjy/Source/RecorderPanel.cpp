@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    RecorderPanel.cpp
+    Created: 19 Oct 2026 12:20:53pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "RecorderPanel.h"
+
+//==============================================================================
+RecorderPanel::RecorderPanel(MasterRecorder& _recorder, MixEngine& _engine, AudioDeviceManager& _deviceManager)
+    : recorder(_recorder),
+      engine(_engine),
+      deviceManager(_deviceManager)
+{
+    addAndMakeVisible(recordButton);
+    recordButton.setClickingTogglesState(false);
+    recordButton.onClick = [this] { toggleRecording(); };
+
+    addAndMakeVisible(formatBox);
+    formatBox.addItem("WAV", 1);
+    formatBox.addItem("FLAC", 2);
+    formatBox.setSelectedId(1, dontSendNotification);
+
+    addAndMakeVisible(statusLabel);
+    statusLabel.setFont(12.0f);
+    statusLabel.setText("not recording", dontSendNotification);
+}
+
+RecorderPanel::~RecorderPanel()
+{
+    stopTimer();
+}
+
+void RecorderPanel::paint (Graphics& g)
+{
+    g.fillAll(Colour::fromRGB(15, 15, 15));
+}
+
+void RecorderPanel::resized()
+{
+    recordButton.setBounds(1, 1, 50, getHeight() - 2);
+    formatBox.setBounds(53, 1, 70, getHeight() - 2);
+    statusLabel.setBounds(125, 0, getWidth() - 125, getHeight());
+}
+
+void RecorderPanel::toggleRecording()
+{
+    if (recorder.isRecording())
+    {
+        engine.setRecorder(nullptr);
+        recorder.stop();
+        stopTimer();
+        recordButton.setColour(TextButton::buttonColourId, getLookAndFeel().findColour(TextButton::buttonColourId));
+        statusLabel.setText("saved " + recorder.getCurrentFile().getFileName(), dontSendNotification);
+        return;
+    }
+
+    auto* device = deviceManager.getCurrentAudioDevice();
+    if (device == nullptr)
+    {
+        AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon,
+            "Recording", "No audio device is running.");
+        return;
+    }
+
+    File recordingsFolder = File::getCurrentWorkingDirectory().getChildFile("recordings");
+    recordingsFolder.createDirectory();
+    const String extension = formatBox.getSelectedId() == 2 ? ".flac" : ".wav";
+    File file = recordingsFolder.getChildFile("mix_" + Time::getCurrentTime().formatted("%Y%m%d_%H%M%S") + extension);
+
+    String error;
+    if (!recorder.start(file, error))
+    {
+        AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon, "Recording", error);
+        return;
+    }
+
+    engine.setRecorder(&recorder);
+    recordButton.setColour(TextButton::buttonColourId, Colour::fromRGB(180, 10, 10));
+    startTimerHz(2);
+    timerCallback();
+}
+
+void RecorderPanel::timerCallback()
+{
+    const int seconds = (int)recorder.getSecondsRecorded();
+    String text = String::formatted("%d:%02d:%02d", seconds / 3600, (seconds % 3600) / 60, seconds % 60);
+    text << "  " << recorder.getCurrentFile().getFileName();
+
+    const int dropped = recorder.getNumDroppedBlocks();
+    if (dropped > 0)
+        text << "  dropped " << dropped;
+
+    // still recording, into the file shown, but it won't be split until this clears
+    const String rotationError = recorder.getRotationError();
+    if (rotationError.isNotEmpty())
+        text << "  " << rotationError;
+
+    statusLabel.setColour(Label::textColourId, dropped > 0 || rotationError.isNotEmpty() ? Colours::orange : Colours::white);
+    statusLabel.setText(text, dontSendNotification);
+}
@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    RecorderPanel.h
+    Created: 19 Oct 2026 12:20:53pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MasterRecorder.h"
+#include "MixEngine.h"
+
+//==============================================================================
+/*
+    Record button for the master output, with elapsed time and dropped blocks.
+*/
+class RecorderPanel  : public Component,
+                       public Timer
+{
+public:
+    RecorderPanel(MasterRecorder& recorder, MixEngine& engine, AudioDeviceManager& deviceManager);
+    ~RecorderPanel() override;
+
+    void paint (Graphics&) override;
+    void resized() override;
+
+    void timerCallback() override;
+
+private:
+    void toggleRecording();
+
+    MasterRecorder& recorder;
+    MixEngine& engine;
+    AudioDeviceManager& deviceManager;
+
+    TextButton recordButton{ "REC" };
+    ComboBox formatBox;
+    Label statusLabel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RecorderPanel)
+};
@@ -0,0 +1,275 @@
+/*
+  ==============================================================================
+
+    ScratchBuffer.cpp
+    Created: 19 Oct 2026 6:48:30pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "ScratchBuffer.h"
+
+namespace
+{
+    // validStart is parked here while the window is being moved, so every
+    // range check fails until the new one is published
+    constexpr int64 emptyMarker = std::numeric_limits<int64>::max();
+
+    // how often the fill thread looks for the deck arming the buffer, and how
+    // long it sleeps with no track at all (setReader() wakes it)
+    constexpr int disarmedPollMs = 5;
+    constexpr int noReaderPollMs = 1000;
+}
+
+ScratchBuffer::ScratchBuffer()
+{
+    ring.clear();
+    thread.addTimeSliceClient(this);
+    thread.startThread();
+}
+
+ScratchBuffer::~ScratchBuffer()
+{
+    thread.removeTimeSliceClient(this);
+    thread.stopThread(2000);
+}
+
+std::unique_ptr<AudioFormatReader> ScratchBuffer::setReader(AudioFormatReader* newReader)
+{
+    const ScopedLock sl(fillLock);
+    std::unique_ptr<AudioFormatReader> previous(reader.release());
+
+    validStart.store(emptyMarker);
+    validEnd.store(0);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    reader.reset(newReader);
+    sourceSampleRate = reader != nullptr ? reader->sampleRate : 44100.0;
+    lengthInSamples = reader != nullptr ? reader->lengthInSamples : 0;
+    playhead = 0.0;
+    ++generation;
+
+    validEnd.store(0);
+    validStart.store(0);
+    thread.moveToFrontOfQueue(this);
+    return previous;
+}
+
+void ScratchBuffer::setBlockingFill(bool shouldBlock)
+{
+    const ScopedLock sl(fillLock);
+    blockingFill = shouldBlock;
+}
+
+void ScratchBuffer::setPlayhead(double sourcePosition, double velocity) noexcept
+{
+    playhead.store(sourcePosition, std::memory_order_relaxed);
+    movingBackwards.store(velocity < 0, std::memory_order_relaxed);
+}
+
+void ScratchBuffer::setArmed(bool shouldFill) noexcept
+{
+    armed.store(shouldFill, std::memory_order_relaxed);
+}
+
+double ScratchBuffer::getSourceSampleRate() const
+{
+    return sourceSampleRate.load();
+}
+
+int64 ScratchBuffer::getLengthInSamples() const
+{
+    return lengthInSamples.load();
+}
+
+uint32 ScratchBuffer::getGeneration() const
+{
+    return generation.load();
+}
+
+int ScratchBuffer::getNumUnderruns() const
+{
+    return underruns.load();
+}
+
+//==============================================================================
+bool ScratchBuffer::covers(int64 first, int64 last) const noexcept
+{
+    // anything outside the track reads as silence, so only the part inside it must be present
+    first = jmax((int64)0, first);
+    last = jmin(lengthInSamples.load(std::memory_order_relaxed), last);
+    if (last <= first)
+        return true;
+
+    const int64 start = validStart.load(std::memory_order_acquire);
+    const int64 end = validEnd.load(std::memory_order_acquire);
+    return start <= first && last <= end;
+}
+
+float ScratchBuffer::sampleAt(int channel, int64 index) const noexcept
+{
+    if (index < 0 || index >= lengthInSamples.load(std::memory_order_relaxed))
+        return 0.0f;
+    return ring.getSample(channel, (int)(index & mask));
+}
+
+bool ScratchBuffer::render(AudioBuffer<float>& out, int startSample, int numSamples,
+                           double& position, double startVelocity, double endVelocity) noexcept
+{
+    // the velocity ramps linearly, so the playhead stays within this bound for
+    // the block, and the interpolator's taps within maxReach either side of it
+    const double reach = numSamples * jmax(std::abs(startVelocity), std::abs(endVelocity));
+    const int64 first = (int64)std::floor(position - reach) - SincInterpolator::maxReach;
+    const int64 last = (int64)std::floor(position + reach) + SincInterpolator::maxReach + 1;
+
+    if (!covers(first, last) && blockingFill)
+    {
+        // only offline renders get here; there is no deadline to miss
+        const ScopedLock sl(fillLock);
+        setPlayhead(position, endVelocity);
+        while (fillStep() && !covers(first, last)) {}
+    }
+
+    if (!covers(first, last))
+    {
+        out.clear(startSample, numSamples);
+        underruns.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    const int numChannels = out.getNumChannels();
+    const double velocityStep = numSamples > 0 ? (endVelocity - startVelocity) / numSamples : 0.0;
+    double velocity = startVelocity;
+    double pos = position;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double whole = std::floor(pos);
+        const int64 index = (int64)whole;
+        int firstTap = 0;
+        const int numTaps = interpolator.getWeights(pos - whole, velocity, weights.data(), firstTap);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const int source = jmin(ch, 1);
+            float sum = 0.0f;
+            for (int k = 0; k < numTaps; ++k)
+                sum += weights[(size_t)k] * sampleAt(source, index + firstTap + k);
+            out.setSample(ch, startSample + i, sum);
+        }
+
+        pos += velocity;
+        velocity += velocityStep;
+    }
+
+    // the filler narrows the range before it overwrites, so a range that still
+    // covers the block now means nothing was overwritten while we read it
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!covers(first, last))
+    {
+        out.clear(startSample, numSamples);
+        underruns.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    position = pos;
+    return true;
+}
+
+//==============================================================================
+int ScratchBuffer::useTimeSlice()
+{
+    const ScopedLock sl(fillLock);
+    if (reader == nullptr)
+        return noReaderPollMs;
+    if (!armed.load(std::memory_order_relaxed))
+        return disarmedPollMs;
+    return fillStep() ? 0 : disarmedPollMs;
+}
+
+bool ScratchBuffer::fillStep()
+{
+    if (reader == nullptr)
+        return false;
+
+    const int64 length = lengthInSamples.load();
+    const int64 head = jlimit((int64)0, jmax((int64)0, length - 1), (int64)playhead.load(std::memory_order_relaxed));
+    const bool backwards = movingBackwards.load(std::memory_order_relaxed);
+
+    int64 start = validStart.load();
+    int64 end = validEnd.load();
+
+    if (head < start || head >= end)
+    {
+        // the playhead jumped out of the window: start a new one around it
+        validStart.store(emptyMarker);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        validEnd.store(head);
+        validStart.store(head);
+        start = end = head;
+    }
+
+    // three quarters of the window ahead of the playhead, one behind
+    const int64 behind = backwards ? capacity * 3 / 4 : capacity / 4;
+    const int64 wantStart = jmax((int64)0, head - behind);
+    const int64 wantEnd = jmin(length, wantStart + capacity - chunkSize);
+
+    auto fillForwards = [&]
+    {
+        const int num = (int)jmin((int64)chunkSize, wantEnd - end);
+        const int64 newStart = jmax(start, end + num - capacity);
+        if (newStart > start)
+        {
+            validStart.store(newStart);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+        writeToRing(end, num);
+        validEnd.store(end + num, std::memory_order_release);
+    };
+
+    auto fillBackwards = [&]
+    {
+        const int num = (int)jmin((int64)chunkSize, start - wantStart);
+        const int64 newEnd = jmin(end, start - num + capacity);
+        if (newEnd < end)
+        {
+            validEnd.store(newEnd);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+        writeToRing(start - num, num);
+        validStart.store(start - num, std::memory_order_release);
+    };
+
+    // the side the playhead is heading for goes first
+    const bool needsForwards = end < wantEnd;
+    const bool needsBackwards = start > wantStart;
+
+    if (backwards && needsBackwards)
+        fillBackwards();
+    else if (needsForwards)
+        fillForwards();
+    else if (needsBackwards)
+        fillBackwards();
+    else
+        return false;
+
+    return true;
+}
+
+void ScratchBuffer::writeToRing(int64 start, int numSamples)
+{
+    chunk.setSize(2, numSamples, false, false, true);
+    reader->read(&chunk, 0, numSamples, start, true, true);
+    if (reader->numChannels == 1)
+        chunk.copyFrom(1, 0, chunk, 0, 0, numSamples);
+
+    const int offset = (int)(start & mask);
+    const int firstPart = jmin(numSamples, capacity - offset);
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        ring.copyFrom(ch, offset, chunk, ch, 0, firstPart);
+        if (firstPart < numSamples)
+            ring.copyFrom(ch, 0, chunk, ch, firstPart, numSamples - firstPart);
+    }
+}
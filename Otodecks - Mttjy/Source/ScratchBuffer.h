@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    ScratchBuffer.h
+    Created: 19 Oct 2026 6:48:30pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <array>
+#include <atomic>
+#include "SincInterpolator.h"
+
+//==============================================================================
+/*
+    A window of decoded audio around a deck's playhead, so the deck can play
+    at any velocity, backwards included, without the audio thread ever
+    touching the decoder.
+
+    Sample s of the track lives in slot s % capacity of a ring. The range
+    [validStart, validEnd) says which slots hold real data. While the deck
+    has armed it, a background thread keeps the window around the playhead,
+    most of it on the side the playhead is moving towards. Disarmed, it
+    decodes nothing, and what is in the ring stays there for the next time
+    the deck plays from it nearby. It narrows the range before overwriting a
+    slot and widens it afterwards, so the audio thread can check the range,
+    read without a lock and then check again to detect a torn read.
+
+    render() interpolates with a SincInterpolator, whose cutoff comes down
+    as the platter speeds up, so a fast scratch doesn't alias.
+*/
+class ScratchBuffer : private TimeSliceClient
+{
+public:
+    /** 2^19 samples: about 12 s at 44.1 kHz */
+    static constexpr int capacity = 1 << 19;
+
+    ScratchBuffer();
+    ~ScratchBuffer() override;
+
+    /** message thread: decode from newReader from now on (takes ownership, may be nullptr).
+        Returns the previous reader, which the fill thread no longer touches. */
+    std::unique_ptr<AudioFormatReader> setReader(AudioFormatReader* newReader);
+
+    /** offline rendering: fill in the caller's thread when render() finds data missing */
+    void setBlockingFill(bool shouldBlock);
+
+    /** audio thread: where the playhead is, in source samples, and which way it is going */
+    void setPlayhead(double sourcePosition, double velocity) noexcept;
+    /** audio thread: fill the window while the deck plays from it, and stop decoding after */
+    void setArmed(bool shouldFill) noexcept;
+
+    /** audio thread: render numSamples into out, starting at position (in source samples)
+        and moving by a velocity that ramps from startVelocity to endVelocity source samples
+        per output sample. position is advanced. Returns false and leaves silence if the
+        window does not cover that stretch yet. */
+    bool render(AudioBuffer<float>& out, int startSample, int numSamples,
+                double& position, double startVelocity, double endVelocity) noexcept;
+
+    double getSourceSampleRate() const;
+    int64 getLengthInSamples() const;
+    /** bumped by every setReader() */
+    uint32 getGeneration() const;
+    int getNumUnderruns() const;
+
+private:
+    int useTimeSlice() override;
+    /** decode one chunk towards the wanted window; false once it is complete */
+    bool fillStep();
+    void writeToRing(int64 start, int numSamples);
+    bool covers(int64 first, int64 last) const noexcept;
+    float sampleAt(int channel, int64 index) const noexcept;
+
+    static constexpr int mask = capacity - 1;
+    static constexpr int chunkSize = 8192;
+
+    TimeSliceThread thread{ "Scratch buffer" };
+    CriticalSection fillLock;
+    std::unique_ptr<AudioFormatReader> reader;
+    AudioBuffer<float> chunk{ 2, chunkSize };
+    bool blockingFill = false;
+
+    AudioBuffer<float> ring{ 2, capacity };
+    std::atomic<int64> validStart{ 0 };
+    std::atomic<int64> validEnd{ 0 };
+
+    // audio thread only
+    SincInterpolator interpolator;
+    std::array<float, SincInterpolator::maxTaps> weights{};
+
+    std::atomic<double> playhead{ 0 };
+    std::atomic<bool> movingBackwards{ false };
+    std::atomic<bool> armed{ false };
+    std::atomic<double> sourceSampleRate{ 44100.0 };
+    std::atomic<int64> lengthInSamples{ 0 };
+    std::atomic<uint32> generation{ 0 };
+    std::atomic<int> underruns{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScratchBuffer)
+};
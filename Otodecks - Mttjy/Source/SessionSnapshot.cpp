@@ -0,0 +1,270 @@
+/*
+  ==============================================================================
+
+    SessionSnapshot.cpp
+    Created: 20 Oct 2026 2:31:48am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "SessionSnapshot.h"
+
+namespace
+{
+    constexpr int version = 1;
+
+    uint32 fnv1a(const void* data, size_t size)
+    {
+        uint32 hash = 2166136261u;
+        const uint8* bytes = static_cast<const uint8*>(data);
+        for (size_t i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * 16777619u;
+        return hash;
+    }
+}
+
+SessionSnapshot::SessionSnapshot(MixEngine& _engine, const File& snapshotFile)
+    : engine(_engine), file(snapshotFile)
+{
+}
+
+SessionSnapshot::~SessionSnapshot()
+{
+    stopTimer();
+    writerThread.removeTimeSliceClient(this);
+    writerThread.stopThread(2000);
+}
+
+void SessionSnapshot::start(int intervalMs)
+{
+    captureTicks = 0;
+    numCaptures = 0;
+    writeTicks = 0;
+    numWrites = 0;
+
+    writerThread.addTimeSliceClient(this);
+    writerThread.startThread();
+    startTimer(intervalMs);
+}
+
+void SessionSnapshot::stop()
+{
+    stopTimer();
+    writerThread.removeTimeSliceClient(this);
+    writerThread.stopThread(2000);
+
+    // only written if the engine ever ran, so a launch that never got going keeps the last set
+    if (engine.getSamplePosition() == 0)
+        return;
+
+    Session session = capture();
+    session.cleanShutdown = true;
+    write(file, encode(session));
+}
+
+File SessionSnapshot::getFile() const
+{
+    return file;
+}
+
+double SessionSnapshot::getAverageCaptureMicros() const
+{
+    return numCaptures > 0 ? Time::highResolutionTicksToSeconds(captureTicks) * 1.0e6 / numCaptures : 0.0;
+}
+
+double SessionSnapshot::getAverageWriteMs() const
+{
+    const int writes = numWrites.load();
+    return writes > 0 ? Time::highResolutionTicksToSeconds(writeTicks.load()) * 1000.0 / writes : 0.0;
+}
+
+int SessionSnapshot::getNumWrites() const
+{
+    return numWrites.load();
+}
+
+//==============================================================================
+SessionSnapshot::Session SessionSnapshot::capture() const
+{
+    Session session;
+    session.timeMs = Time::currentTimeMillis();
+
+    for (int i = 0; i < engine.getNumDecks(); ++i)
+    {
+        DJAudioPlayer* player = engine.getDeck(i);
+        const DJAudioPlayer::PlayheadSnapshot playhead = player->getPlayheadSnapshot();
+        const URL url = player->getLoadedURL();
+
+        DeckState deck;
+        if (url.isLocalFile())
+            deck.file = url.getLocalFile();
+        deck.positionSecs = playhead.positionSecs;
+        deck.speed = player->getSpeed();
+        deck.gain = player->getGain();
+        deck.looping = player->isLooping();
+        deck.playing = playhead.playing;
+        deck.cue = engine.isCueEnabled(i);
+        session.decks.push_back(deck);
+    }
+    return session;
+}
+
+int SessionSnapshot::restore(const Session& session)
+{
+    int restored = 0;
+    for (int i = 0; i < jmin(engine.getNumDecks(), (int)session.decks.size()); ++i)
+    {
+        const DeckState& deck = session.decks[(size_t)i];
+        DJAudioPlayer* player = engine.getDeck(i);
+        if (!deck.file.existsAsFile())
+            continue;
+
+        // opening the readers only parses headers; the waveform comes from the thumbnail cache
+        const URL url{ deck.file };
+        player->loadURL(url);
+        if (player->getLoadedURL() != url)
+            continue;
+
+        player->setSpeed(deck.speed);
+        player->setGain(jlimit(0.0, 1.0, deck.gain));
+        player->setLooping(deck.looping);
+        player->setPosition(deck.positionSecs);
+        engine.setCueEnabled(i, deck.cue);
+
+        // after a crash the set carries on; after a normal quit the decks wait where they were
+        if (deck.playing && !session.cleanShutdown)
+            player->start();
+        ++restored;
+    }
+    return restored;
+}
+
+//==============================================================================
+MemoryBlock SessionSnapshot::encode(const Session& session)
+{
+    MemoryBlock data;
+    {
+        MemoryOutputStream out(data, false);
+        out.write("OTSS", 4);
+        out.writeInt(version);
+        out.writeByte(session.cleanShutdown ? 1 : 0);
+        out.writeInt64(session.timeMs);
+        out.writeInt((int)session.decks.size());
+        for (auto& deck : session.decks)
+        {
+            out.writeString(deck.file.getFullPathName());
+            out.writeDouble(deck.positionSecs);
+            out.writeDouble(deck.speed);
+            out.writeDouble(deck.gain);
+            out.writeByte(deck.looping ? 1 : 0);
+            out.writeByte(deck.playing ? 1 : 0);
+            out.writeByte(deck.cue ? 1 : 0);
+        }
+    }
+
+    const uint32 hash = ByteOrder::swapIfBigEndian(fnv1a(data.getData(), data.getSize()));
+    data.append(&hash, sizeof(hash));
+    return data;
+}
+
+bool SessionSnapshot::decode(const MemoryBlock& data, Session& session)
+{
+    session = Session();
+    if (data.getSize() < 4 + 4 + 1 + 8 + 4 + sizeof(uint32))
+        return false;
+
+    const size_t payloadSize = data.getSize() - sizeof(uint32);
+    if (ByteOrder::littleEndianInt(static_cast<const uint8*>(data.getData()) + payloadSize)
+        != fnv1a(data.getData(), payloadSize))
+        return false;
+
+    MemoryInputStream in(data.getData(), payloadSize, false);
+    char magic[4];
+    in.read(magic, 4);
+    if (memcmp(magic, "OTSS", 4) != 0 || in.readInt() != version)
+        return false;
+
+    session.cleanShutdown = in.readByte() != 0;
+    session.timeMs = in.readInt64();
+    const int numDecks = in.readInt();
+    if (numDecks < 0 || numDecks > 64)
+        return false;
+
+    for (int i = 0; i < numDecks; ++i)
+    {
+        DeckState deck;
+        const String path = in.readString();
+        if (path.isNotEmpty())
+            deck.file = File(path);
+        deck.positionSecs = in.readDouble();
+        deck.speed = in.readDouble();
+        deck.gain = in.readDouble();
+        deck.looping = in.readByte() != 0;
+        deck.playing = in.readByte() != 0;
+        deck.cue = in.readByte() != 0;
+        session.decks.push_back(deck);
+    }
+    return true;
+}
+
+bool SessionSnapshot::read(const File& snapshotFile, Session& session)
+{
+    MemoryBlock data;
+    return snapshotFile.loadFileAsData(data) && decode(data, session);
+}
+
+bool SessionSnapshot::write(const File& snapshotFile, const MemoryBlock& data)
+{
+    TemporaryFile temp(snapshotFile);
+    {
+        FileOutputStream out(temp.getFile());
+        if (!out.openedOk() || !out.write(data.getData(), data.getSize()))
+            return false;
+        // flushing a FileOutputStream syncs it, so the rename never exposes an empty file
+        out.flush();
+        if (out.getStatus().failed())
+            return false;
+    }
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+void SessionSnapshot::timerCallback()
+{
+    // until the audio thread has run, the decks only hold what restore() queued
+    if (engine.getSamplePosition() == 0)
+        return;
+
+    const int64 start = Time::getHighResolutionTicks();
+    MemoryBlock data = encode(capture());
+    captureTicks += Time::getHighResolutionTicks() - start;
+    ++numCaptures;
+
+    {
+        const ScopedLock sl(pendingLock);
+        pending.swapWith(data);
+        hasPending = true;
+    }
+    writerThread.moveToFrontOfQueue(this);
+}
+
+int SessionSnapshot::useTimeSlice()
+{
+    MemoryBlock data;
+    {
+        const ScopedLock sl(pendingLock);
+        if (!hasPending)
+            return 500;
+        data.swapWith(pending);
+        hasPending = false;
+    }
+
+    const int64 start = Time::getHighResolutionTicks();
+    if (write(file, data))
+    {
+        writeTicks += Time::getHighResolutionTicks() - start;
+        ++numWrites;
+    }
+    return 500;
+}
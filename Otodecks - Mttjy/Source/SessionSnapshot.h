@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    SessionSnapshot.h
+    Created: 20 Oct 2026 2:31:48am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+#include "MixEngine.h"
+
+//==============================================================================
+/*
+    Keeps session.otss up to date with what is on the decks, so a crash or
+    a restart in the middle of a set loses at most a second of it.
+
+    Once a second the message thread reads each deck's published state
+    (track, playhead, speed, gain, loop, play and cue). Those are all
+    lock-free getters, so this costs a few microseconds and the audio thread
+    never knows. The encoded bytes go to a background thread. It writes them
+    to a temporary file, syncs it and renames it over the snapshot, so the
+    file on disk always holds one complete snapshot. A snapshot that arrives
+    while a write is still going replaces the pending one. Nothing is
+    captured until the engine has rendered, so a restore that hasn't reached
+    the audio thread yet is never overwritten by empty decks.
+
+        "OTSS" int32 version, uint8 clean shutdown, int64 time ms, int32 numDecks
+        numDecks x { string path, double position, double speed, double gain,
+                     uint8 looping, uint8 playing, uint8 cue }
+        uint32 FNV-1a of everything before it
+*/
+class SessionSnapshot : private Timer,
+                        private TimeSliceClient
+{
+public:
+    struct DeckState
+    {
+        File file;
+        double positionSecs = 0;
+        double speed = 1.0;
+        double gain = 1.0;
+        bool looping = false;
+        bool playing = false;
+        bool cue = false;
+    };
+
+    struct Session
+    {
+        bool cleanShutdown = false;
+        int64 timeMs = 0;
+        std::vector<DeckState> decks;
+    };
+
+    SessionSnapshot(MixEngine& engine, const File& snapshotFile);
+    ~SessionSnapshot() override;
+
+    /** snapshot every intervalMs from now on */
+    void start(int intervalMs = 1000);
+    /** stop, and write one last snapshot marked as a clean shutdown in the calling thread */
+    void stop();
+
+    /** message thread: load each deck's track and queue its position and
+        settings for the audio thread. Decks that were playing only start
+        again if the last run didn't shut down cleanly. Returns the number
+        of decks restored. */
+    int restore(const Session& session);
+
+    /** message thread: the decks as the audio thread last left them */
+    Session capture() const;
+
+    static MemoryBlock encode(const Session& session);
+    static bool decode(const MemoryBlock& data, Session& session);
+    static bool read(const File& file, Session& session);
+    /** temporary file, sync, rename */
+    static bool write(const File& file, const MemoryBlock& data);
+
+    File getFile() const;
+
+    /** averages since start() */
+    double getAverageCaptureMicros() const;
+    double getAverageWriteMs() const;
+    int getNumWrites() const;
+
+private:
+    void timerCallback() override;
+    int useTimeSlice() override;
+
+    MixEngine& engine;
+    File file;
+
+    TimeSliceThread writerThread{ "Session snapshot" };
+    CriticalSection pendingLock;
+    MemoryBlock pending;
+    bool hasPending = false;
+
+    int64 captureTicks = 0;
+    int numCaptures = 0;
+    std::atomic<int64> writeTicks{ 0 };
+    std::atomic<int> numWrites{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SessionSnapshot)
+};
@@ -0,0 +1,269 @@
+/*
+  ==============================================================================
+
+    SimilarityIndex.cpp
+    Created: 20 Oct 2026 3:41:17am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "SimilarityIndex.h"
+
+namespace
+{
+    constexpr int trainingIterations = 8;
+    constexpr int samplesPerList = 64;
+}
+
+bool SimilarityIndex::build(const float* vectors, const int* ids, int _numItems, int numLists,
+                            std::function<bool()> shouldStop)
+{
+    mean.clear();
+    scale.clear();
+    centroids.clear();
+    lists.clear();
+    numItems = 0;
+    builtSize = 0;
+    if (_numItems <= 0)
+        return true;
+
+    // unit variance per dimension, then the feature weights
+    const float* weights = TrackFeatures::getWeights();
+    mean.assign(numDimensions, 0.0f);
+    scale.assign(numDimensions, 0.0f);
+    for (int d = 0; d < numDimensions; ++d)
+    {
+        double sum = 0, sumSq = 0;
+        for (int i = 0; i < _numItems; ++i)
+        {
+            const double value = vectors[(size_t)i * numDimensions + (size_t)d];
+            sum += value;
+            sumSq += value * value;
+        }
+        const double m = sum / _numItems;
+        const double deviation = std::sqrt(jmax(0.0, sumSq / _numItems - m * m));
+        mean[(size_t)d] = (float)m;
+        scale[(size_t)d] = weights[d] / (float)jmax(1.0e-6, deviation);
+    }
+
+    std::vector<float> normalised((size_t)_numItems * numDimensions);
+    for (int i = 0; i < _numItems; ++i)
+        normalise(vectors + (size_t)i * numDimensions, normalised.data() + (size_t)i * numDimensions);
+
+    //==============================================================================
+    // k-means on a random sample is as good as on everything, and far quicker
+    if (numLists <= 0)
+        numLists = roundToInt(std::sqrt((double)_numItems));
+    numLists = jlimit(1, _numItems, numLists);
+
+    Random random(0x0715);
+    std::vector<int> order((size_t)_numItems);
+    for (int i = 0; i < _numItems; ++i)
+        order[(size_t)i] = i;
+    const int numSamples = jmin(_numItems, numLists * samplesPerList);
+    for (int i = 0; i < numSamples; ++i)
+        std::swap(order[(size_t)i], order[(size_t)(i + random.nextInt(_numItems - i))]);
+
+    centroids.assign((size_t)numLists * numDimensions, 0.0f);
+    for (int c = 0; c < numLists; ++c)
+        std::copy_n(normalised.data() + (size_t)order[(size_t)c] * numDimensions, numDimensions,
+                    centroids.data() + (size_t)c * numDimensions);
+    lists.resize((size_t)numLists);
+
+    std::vector<double> sums((size_t)numLists * numDimensions);
+    std::vector<int> counts((size_t)numLists);
+    for (int iteration = 0; iteration < trainingIterations; ++iteration)
+    {
+        if (shouldStop != nullptr && shouldStop())
+        {
+            build(nullptr, nullptr, 0);
+            return false;
+        }
+
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (int s = 0; s < numSamples; ++s)
+        {
+            const float* vector = normalised.data() + (size_t)order[(size_t)s] * numDimensions;
+            const int c = nearestCentroid(vector);
+            ++counts[(size_t)c];
+            for (int d = 0; d < numDimensions; ++d)
+                sums[(size_t)c * numDimensions + (size_t)d] += vector[d];
+        }
+
+        for (int c = 0; c < numLists; ++c)
+        {
+            float* centroid = centroids.data() + (size_t)c * numDimensions;
+            if (counts[(size_t)c] == 0)
+            {
+                // an empty cluster starts again from a random sample
+                std::copy_n(normalised.data() + (size_t)order[(size_t)random.nextInt(numSamples)] * numDimensions,
+                            numDimensions, centroid);
+                continue;
+            }
+            for (int d = 0; d < numDimensions; ++d)
+                centroid[d] = (float)(sums[(size_t)c * numDimensions + (size_t)d] / counts[(size_t)c]);
+        }
+    }
+
+    //==============================================================================
+    std::vector<int> assignment((size_t)_numItems);
+    std::fill(counts.begin(), counts.end(), 0);
+    for (int i = 0; i < _numItems; ++i)
+    {
+        if ((i & 4095) == 0 && shouldStop != nullptr && shouldStop())
+        {
+            build(nullptr, nullptr, 0);
+            return false;
+        }
+        assignment[(size_t)i] = nearestCentroid(normalised.data() + (size_t)i * numDimensions);
+        ++counts[(size_t)assignment[(size_t)i]];
+    }
+
+    for (int c = 0; c < numLists; ++c)
+    {
+        lists[(size_t)c].vectors.reserve((size_t)counts[(size_t)c] * numDimensions);
+        lists[(size_t)c].ids.reserve((size_t)counts[(size_t)c]);
+    }
+    for (int i = 0; i < _numItems; ++i)
+    {
+        List& list = lists[(size_t)assignment[(size_t)i]];
+        const float* vector = normalised.data() + (size_t)i * numDimensions;
+        list.vectors.insert(list.vectors.end(), vector, vector + numDimensions);
+        list.ids.push_back(ids[i]);
+    }
+
+    numItems = _numItems;
+    builtSize = _numItems;
+    return true;
+}
+
+void SimilarityIndex::add(int id, const float* vector)
+{
+    // never built: one list, scaled by the weights alone
+    if (lists.empty())
+    {
+        mean.assign(numDimensions, 0.0f);
+        scale.assign(TrackFeatures::getWeights(), TrackFeatures::getWeights() + numDimensions);
+        centroids.assign(numDimensions, 0.0f);
+        lists.resize(1);
+    }
+
+    float normalised[numDimensions];
+    normalise(vector, normalised);
+    List& list = lists[(size_t)nearestCentroid(normalised)];
+    list.vectors.insert(list.vectors.end(), normalised, normalised + numDimensions);
+    list.ids.push_back(id);
+    ++numItems;
+}
+
+//==============================================================================
+std::vector<SimilarityIndex::Match> SimilarityIndex::search(const float* query, int k, int numProbes,
+                                                            const std::function<bool(int)>& exclude) const
+{
+    std::vector<Match> best;
+    if (numItems == 0 || k <= 0)
+        return best;
+
+    float normalised[numDimensions];
+    normalise(query, normalised);
+
+    std::vector<Match> nearestLists(lists.size());
+    for (size_t c = 0; c < lists.size(); ++c)
+        nearestLists[c] = { (int)c, distance(normalised, centroids.data() + c * numDimensions) };
+    numProbes = jlimit(1, (int)lists.size(), numProbes);
+    std::partial_sort(nearestLists.begin(), nearestLists.begin() + numProbes, nearestLists.end(),
+                      [](const Match& a, const Match& b) { return a.distance < b.distance; });
+
+    best.reserve((size_t)k + 1);
+    for (int p = 0; p < numProbes; ++p)
+        scan(lists[(size_t)nearestLists[(size_t)p].id], normalised, k, exclude, best);
+    return best;
+}
+
+std::vector<SimilarityIndex::Match> SimilarityIndex::searchExact(const float* query, int k,
+                                                                 const std::function<bool(int)>& exclude) const
+{
+    std::vector<Match> best;
+    if (numItems == 0 || k <= 0)
+        return best;
+
+    float normalised[numDimensions];
+    normalise(query, normalised);
+
+    best.reserve((size_t)k + 1);
+    for (const List& list : lists)
+        scan(list, normalised, k, exclude, best);
+    return best;
+}
+
+int SimilarityIndex::size() const
+{
+    return numItems;
+}
+
+int SimilarityIndex::getNumLists() const
+{
+    return (int)lists.size();
+}
+
+int SimilarityIndex::getBuiltSize() const
+{
+    return builtSize;
+}
+
+//==============================================================================
+void SimilarityIndex::normalise(const float* vector, float* out) const
+{
+    for (int d = 0; d < numDimensions; ++d)
+        out[d] = (vector[d] - mean[(size_t)d]) * scale[(size_t)d];
+}
+
+int SimilarityIndex::nearestCentroid(const float* normalised) const
+{
+    int nearest = 0;
+    float nearestDistance = std::numeric_limits<float>::max();
+    for (size_t c = 0; c < lists.size(); ++c)
+    {
+        const float d = distance(normalised, centroids.data() + c * numDimensions);
+        if (d < nearestDistance)
+        {
+            nearestDistance = d;
+            nearest = (int)c;
+        }
+    }
+    return nearest;
+}
+
+float SimilarityIndex::distance(const float* a, const float* b)
+{
+    float sum = 0;
+    for (int d = 0; d < numDimensions; ++d)
+    {
+        const float difference = a[d] - b[d];
+        sum += difference * difference;
+    }
+    return sum;
+}
+
+void SimilarityIndex::scan(const List& list, const float* query, int k,
+                           const std::function<bool(int)>& exclude, std::vector<Match>& best)
+{
+    const float* vector = list.vectors.data();
+    for (size_t i = 0; i < list.ids.size(); ++i, vector += numDimensions)
+    {
+        const float d = distance(query, vector);
+        if ((int)best.size() == k && d >= best.back().distance)
+            continue;
+        if (exclude != nullptr && exclude(list.ids[i]))
+            continue;
+
+        // k is small, so a sorted insert beats a heap
+        auto position = std::upper_bound(best.begin(), best.end(), d,
+                                         [](float value, const Match& m) { return value < m.distance; });
+        best.insert(position, { list.ids[i], d });
+        if ((int)best.size() > k)
+            best.pop_back();
+    }
+}
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    SimilarityIndex.h
+    Created: 20 Oct 2026 3:41:17am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+#include "FeatureExtractor.h"
+
+//==============================================================================
+/*
+    Approximate nearest neighbours over TrackFeatures vectors, as an
+    inverted file:
+
+    build() scales every dimension to unit variance and multiplies it by
+    its TrackFeatures weight, so the distance is a plain squared L2. It then
+    runs k-means over a sample of the vectors to find about sqrt(n)
+    centroids, and files each vector under its nearest centroid. Each list
+    keeps its vectors back to back in one block of floats, with their ids
+    alongside.
+
+    search() ranks the centroids and then scans only the lists of the
+    nearest numProbes of them. With 100,000 tracks that is a few thousand
+    vectors, read straight through memory. searchExact() scans everything
+    and is the yardstick for how much the shortcut misses.
+
+    Vectors added after build() go to the list of their nearest centroid
+    with the scaling it already has. Once the library has grown well past
+    what it was built from, build a new index.
+*/
+class SimilarityIndex
+{
+public:
+    static constexpr int numDimensions = TrackFeatures::numDimensions;
+
+    struct Match
+    {
+        int id = -1;
+        float distance = 0;
+    };
+
+    SimilarityIndex() = default;
+
+    /** numItems vectors of numDimensions floats, back to back; numLists 0 picks sqrt(numItems).
+        Returns false if shouldStop() said so, leaving the index empty. */
+    bool build(const float* vectors, const int* ids, int numItems, int numLists = 0,
+               std::function<bool()> shouldStop = nullptr);
+
+    void add(int id, const float* vector);
+
+    /** the k nearest that aren't excluded, nearest first */
+    std::vector<Match> search(const float* query, int k, int numProbes = 8,
+                              const std::function<bool(int)>& exclude = nullptr) const;
+    std::vector<Match> searchExact(const float* query, int k,
+                                   const std::function<bool(int)>& exclude = nullptr) const;
+
+    int size() const;
+    int getNumLists() const;
+    /** the number of vectors in the index when it was built */
+    int getBuiltSize() const;
+
+private:
+    struct List
+    {
+        std::vector<float> vectors;
+        std::vector<int> ids;
+    };
+
+    void normalise(const float* vector, float* out) const;
+    int nearestCentroid(const float* normalised) const;
+    static float distance(const float* a, const float* b);
+    static void scan(const List& list, const float* query, int k,
+                     const std::function<bool(int)>& exclude, std::vector<Match>& best);
+
+    std::vector<float> mean, scale;
+    std::vector<float> centroids;
+    std::vector<List> lists;
+    int numItems = 0;
+    int builtSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SimilarityIndex)
+};
@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    SincInterpolator.cpp
+    Created: 21 Oct 2026 10:03:27am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "SincInterpolator.h"
+
+SincInterpolator::SincInterpolator()
+{
+    // the kernel at distance u from the point, in zero crossings; exactly 1 at
+    // 0 and 0 on every other whole number, so a point on a sample is exact
+    table[0] = 1.0f;
+    for (int i = 1; i < tableSize; ++i)
+    {
+        if (i % resolution == 0 || i >= zeroCrossings * resolution)
+            continue;
+
+        const double u = i / (double)resolution;
+        const double sinc = std::sin(MathConstants<double>::pi * u) / (MathConstants<double>::pi * u);
+        const double w = MathConstants<double>::pi * u / zeroCrossings;
+        table[(size_t)i] = (float)(sinc * (0.42 + 0.5 * std::cos(w) + 0.08 * std::cos(2.0 * w)));
+    }
+}
+
+int SincInterpolator::getWeights(double fraction, double speed, float* weights, int& first) const noexcept
+{
+    const double stretch = jlimit(1.0, (double)maxStretch, std::abs(speed));
+    const int reach = (int)std::ceil(zeroCrossings * stretch);
+    first = 1 - reach;
+
+    // a wider kernel sums to stretch over whole samples, so each weight is scaled back
+    const double scale = resolution / stretch;
+    const float gain = (float)(1.0 / stretch);
+    const int numTaps = 2 * reach;
+
+    for (int k = 0; k < numTaps; ++k)
+    {
+        const double position = std::abs(first + k - fraction) * scale;
+        const int index = (int)position;
+        if (index >= zeroCrossings * resolution)
+        {
+            weights[k] = 0.0f;
+            continue;
+        }
+
+        const float t = (float)(position - index);
+        const float a = table[(size_t)index];
+        weights[k] = (t == 0.0f ? a : a + (table[(size_t)index + 1] - a) * t) * gain;
+    }
+    return numTaps;
+}
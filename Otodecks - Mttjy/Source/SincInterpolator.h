@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    SincInterpolator.h
+    Created: 21 Oct 2026 10:03:27am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <array>
+
+//==============================================================================
+/*
+    Band-limited interpolation for a playhead moving at any speed, backwards
+    included: a Blackman-windowed sinc with zeroCrossings on each side, read
+    from a table.
+
+    Up to unity speed the cutoff is the source's Nyquist frequency and the
+    kernel is 2 * zeroCrossings taps. Faster than that, whatever lies above
+    the output's Nyquist would fold back as aliasing, so the cutoff comes
+    down with the speed and the kernel widens to match. Past maxStretch the
+    widening stops, since the cost grows with it, and a playhead moving that
+    fast aliases again.
+
+    Callers ask for the weights once per output sample and apply them to
+    every channel. A point exactly on a sample at unity speed or slower
+    gives that sample unchanged.
+*/
+class SincInterpolator
+{
+public:
+    static constexpr int zeroCrossings = 8;
+    static constexpr int maxStretch = 8;
+    /** the most taps getWeights() hands back */
+    static constexpr int maxTaps = 2 * zeroCrossings * maxStretch;
+    /** how far either side of a position the taps can reach, in source samples */
+    static constexpr int maxReach = zeroCrossings * maxStretch;
+
+    SincInterpolator();
+
+    /** the taps for a point fraction (0 to 1) past source sample n, for a playhead
+        moving at speed source samples per output sample: weights[k] goes with
+        source sample n + first + k. Returns the number of taps. */
+    int getWeights(double fraction, double speed, float* weights, int& first) const noexcept;
+
+private:
+    static constexpr int resolution = 512;      // table points per zero crossing
+    static constexpr int tableSize = zeroCrossings * resolution + 2;
+
+    std::array<float, tableSize> table{};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SincInterpolator)
+};
@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    StartupTimer.cpp
+    Created: 20 Oct 2026 2:07:15am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "StartupTimer.h"
+#include <atomic>
+
+namespace
+{
+    std::atomic<double> launchMs{ 0 };
+    std::atomic<double> milestoneMs[StartupTimer::numMilestones];
+    std::atomic<bool> reported{ false };
+
+    const char* const milestoneNames[] = { "first frame", "audio", "library shown", "library complete" };
+}
+
+void StartupTimer::markLaunch()
+{
+    launchMs = Time::getMillisecondCounterHiRes();
+    for (auto& ms : milestoneMs)
+        ms = 0;
+    reported = false;
+}
+
+void StartupTimer::mark(Milestone milestone)
+{
+    if (launchMs.load() == 0)
+        return;
+
+    double expected = 0;
+    const double now = jmax(1.0e-3, Time::getMillisecondCounterHiRes() - launchMs.load());
+    if (!milestoneMs[milestone].compare_exchange_strong(expected, now))
+        return;
+
+    for (auto& ms : milestoneMs)
+        if (ms.load() == 0)
+            return;
+
+    // prepareToPlay may come from the device's thread; the log is written on the message thread
+    if (!reported.exchange(true))
+        MessageManager::callAsync([] { writeReport(); });
+}
+
+double StartupTimer::getMs(Milestone milestone)
+{
+    return milestoneMs[milestone].load();
+}
+
+double StartupTimer::getPlayableMs()
+{
+    const double audio = getMs(audioRunning);
+    const double library = getMs(libraryShown);
+    return (audio > 0 && library > 0) ? jmax(audio, library) : 0.0;
+}
+
+String StartupTimer::getReport()
+{
+    String report;
+    for (int i = 0; i < numMilestones; ++i)
+        report << milestoneNames[i] << " " << String(getMs((Milestone)i), 1) << " ms, ";
+    report << "playable " << String(getPlayableMs(), 1) << " ms";
+    return report;
+}
+
+void StartupTimer::writeReport()
+{
+    const String line = Time::getCurrentTime().toISO8601(true) + "  " + getReport();
+    DBG("Startup: " << line);
+
+    File logFile = File::getCurrentWorkingDirectory().getChildFile("logs").getChildFile("startup.log");
+    logFile.getParentDirectory().createDirectory();
+    logFile.appendText(line + "\n");
+}
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    StartupTimer.h
+    Created: 20 Oct 2026 2:07:15am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/*
+    Milestones of one launch, in milliseconds since JUCEApplication::initialise.
+
+    "Playable" is the later of the audio device running and the first tracks
+    showing in the library: from then on a track can be loaded and heard.
+    Once every milestone has been reached one line is appended to
+    logs/startup.log, so regressions show up across builds.
+*/
+class StartupTimer
+{
+public:
+    enum Milestone
+    {
+        firstFrame,        // the main window painted for the first time
+        audioRunning,      // the device called prepareToPlay
+        libraryShown,      // the first tracks are in the table (or the scan found none)
+        libraryComplete,   // the folder scan finished
+        numMilestones
+    };
+
+    /** call first thing at launch */
+    static void markLaunch();
+    /** any thread; only the first call for each milestone counts */
+    static void mark(Milestone milestone);
+
+    /** ms since launch, or 0 if not reached yet */
+    static double getMs(Milestone milestone);
+    /** ms since launch to playable, or 0 if not reached yet */
+    static double getPlayableMs();
+
+    static String getReport();
+
+private:
+    static void writeReport();
+};
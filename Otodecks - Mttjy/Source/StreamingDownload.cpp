@@ -0,0 +1,343 @@
+/*
+  ==============================================================================
+
+    StreamingDownload.cpp
+    Created: 20 Oct 2026 5:31:08am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "StreamingDownload.h"
+
+namespace
+{
+    constexpr int maxRetries = 3;
+    constexpr int readBytes = 16 * 1024;
+    // a request this many chunks past the download is left to the connection
+    // already running; past that, a new range request is quicker
+    constexpr int64 aheadChunksToWaitFor = 4;
+}
+
+/** reads from the download's buffer with a position of its own */
+class StreamingDownload::Stream : public InputStream
+{
+public:
+    Stream(StreamingDownload& _owner, bool _blocking)
+        : owner(&_owner), blocking(_blocking)
+    {
+    }
+
+    void setBlocking(bool shouldBlock) { blocking = shouldBlock; }
+
+    int64 getTotalLength() override
+    {
+        if (blocking && owner->getTotalLength() < 0)
+            owner->waitFor(0, 0);
+        return owner->getTotalLength();
+    }
+
+    bool isExhausted() override
+    {
+        const int64 length = owner->getTotalLength();
+        return length >= 0 && position >= length;
+    }
+
+    int64 getPosition() override { return position; }
+
+    bool setPosition(int64 newPosition) override
+    {
+        position = jmax((int64)0, newPosition);
+        return true;
+    }
+
+    int read(void* destBuffer, int maxBytesToRead) override
+    {
+        const int64 length = getTotalLength();
+        if (length < 0 || maxBytesToRead <= 0)
+            return 0;
+
+        const int64 numBytes = jmin((int64)maxBytesToRead, length - position);
+        if (numBytes <= 0)
+            return 0;
+
+        if (!owner->isAvailable(position, numBytes))
+        {
+            if (blocking)
+            {
+                if (!owner->waitFor(position, numBytes))
+                    return 0;
+            }
+            else
+            {
+                // whatever is here, up to the first gap
+                owner->prefetch(position);
+                ++owner->numUnderruns;
+                const int64 chunkBytes = owner->options.chunkBytes;
+                int64 numHere = 0;
+                while (numHere < numBytes && owner->isChunkComplete((position + numHere) / chunkBytes))
+                    numHere = jmin(numBytes, ((position + numHere) / chunkBytes + 1) * chunkBytes - position);
+                memcpy(destBuffer, owner->data.get() + position, (size_t)numHere);
+                position += numHere;
+                return (int)numHere;
+            }
+        }
+
+        memcpy(destBuffer, owner->data.get() + position, (size_t)numBytes);
+        position += numBytes;
+        return (int)numBytes;
+    }
+
+private:
+    StreamingDownload::Ptr owner;
+    bool blocking;
+    int64 position = 0;
+};
+
+//==============================================================================
+bool StreamingDownload::canStream(const URL& url)
+{
+    const String scheme = url.getScheme().toLowerCase();
+    return scheme == "http" || scheme == "https";
+}
+
+StreamingDownload::StreamingDownload(const URL& _url, const Options& _options)
+    : Thread("Streaming download"), url(_url), options(_options)
+{
+    startThread();
+}
+
+StreamingDownload::~StreamingDownload()
+{
+    stopThread(options.timeoutMs + 1000);
+}
+
+std::unique_ptr<AudioFormatReader> StreamingDownload::createReader(AudioFormatManager& formatManager, bool forAudioThread,
+                                                                   String& error)
+{
+    auto stream = std::make_unique<Stream>(*this, true);
+    Stream* view = stream.get();
+    if (view->getTotalLength() < 0)
+    {
+        error = failed ? "the server did not answer with the track's length" : "timed out connecting";
+        return nullptr;
+    }
+
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(std::unique_ptr<InputStream>(stream.release())));
+    if (reader == nullptr)
+    {
+        error = "no format can read " + url.getFileName();
+        return nullptr;
+    }
+    view->setBlocking(!forAudioThread);
+    return reader;
+}
+
+std::unique_ptr<InputStream> StreamingDownload::createStream(bool blocking)
+{
+    return std::make_unique<Stream>(*this, blocking);
+}
+
+bool StreamingDownload::isAvailable(int64 start, int64 numBytes) const noexcept
+{
+    const int64 length = totalBytes.load(std::memory_order_acquire);
+    if (length < 0)
+        return false;
+
+    const int64 end = jmin(length, start + numBytes);
+    for (int64 chunk = jmax((int64)0, start) / options.chunkBytes; chunk * options.chunkBytes < end; ++chunk)
+        if (!isChunkComplete(chunk))
+            return false;
+    return true;
+}
+
+void StreamingDownload::prefetch(int64 byte) noexcept
+{
+    requested.store(jmax((int64)0, byte), std::memory_order_relaxed);
+}
+
+int64 StreamingDownload::getTotalLength() const noexcept
+{
+    return totalBytes.load(std::memory_order_acquire);
+}
+
+const StreamingDownload::Options& StreamingDownload::getOptions() const noexcept
+{
+    return options;
+}
+
+const URL& StreamingDownload::getURL() const noexcept
+{
+    return url;
+}
+
+StreamingDownload::Stats StreamingDownload::getStats() const
+{
+    Stats stats;
+    stats.totalBytes = totalBytes.load();
+    stats.bytesDownloaded = bytesDownloaded.load();
+    stats.numRequests = numRequests.load();
+    stats.numUnderruns = numUnderruns.load();
+    stats.rangesSupported = rangesSupported.load();
+    stats.complete = complete.load();
+    stats.failed = failed.load();
+    return stats;
+}
+
+//==============================================================================
+void StreamingDownload::run()
+{
+    int64 next = 0;
+    int retries = 0;
+    while (!threadShouldExit())
+    {
+        // a reader waiting somewhere else comes first
+        const int64 wanted = requested.exchange(-1);
+        const int64 start = totalBytes < 0 ? 0 : findMissingChunk(wanted >= 0 ? wanted : next);
+        if (start < 0)
+        {
+            complete = true;
+            break;
+        }
+
+        const int64 before = bytesDownloaded.load();
+        if (fetchFrom(start))
+        {
+            retries = 0;
+        }
+        else if (bytesDownloaded.load() == before && ++retries > maxRetries)
+        {
+            failed = true;
+            break;
+        }
+
+        // carry on from the first gap after what that connection brought
+        next = totalBytes < 0 ? 0 : start;
+    }
+    arrived.signal();
+}
+
+bool StreamingDownload::fetchFrom(int64 start)
+{
+    WebInputStream stream(url, false);
+    stream.withConnectionTimeout(options.timeoutMs)
+          .withExtraHeaders("Range: bytes=" + String(start) + "-");
+    ++numRequests;
+    if (!stream.connect(nullptr))
+        return false;
+
+    const int status = stream.getStatusCode();
+    int64 position = start;
+    if (status == 206)
+    {
+        // "Content-Range: bytes 0-999/1000"
+        const String range = stream.getResponseHeaders().getValue("Content-Range", {});
+        rangesSupported = true;
+        if (!setLength(range.fromLastOccurrenceOf("/", false, false).trim().getLargeIntValue()))
+            return false;
+    }
+    else if (status == 200)
+    {
+        // the range was ignored: here comes the whole file again
+        position = 0;
+        if (!setLength(stream.getTotalLength()))
+            return false;
+    }
+    else
+    {
+        return false;
+    }
+
+    const int64 length = totalBytes.load();
+    const int64 chunkBytes = options.chunkBytes;
+    char discard[readBytes];
+    while (position < length && !threadShouldExit())
+    {
+        const int64 chunk = position / chunkBytes;
+        if (position % chunkBytes == 0)
+        {
+            // got to something that's here already: with ranges, ask for the next gap instead
+            if (isChunkComplete(chunk) && rangesSupported)
+                return true;
+
+            int64 wanted = requested.load(std::memory_order_relaxed);
+            if (wanted >= 0 && rangesSupported)
+            {
+                const int64 wantedChunk = wanted / chunkBytes;
+                if (isChunkComplete(wantedChunk) || (wantedChunk >= chunk && wantedChunk < chunk + aheadChunksToWaitFor))
+                    requested.compare_exchange_strong(wanted, -1);
+                else
+                    return true;    // run() reconnects there
+            }
+        }
+
+        // without ranges a retry starts from the top again: don't write over what readers may be reading
+        const bool alreadyHere = isChunkComplete(chunk);
+        char* destination = alreadyHere ? discard : data.get() + position;
+        const int64 chunkEnd = jmin(length, (chunk + 1) * chunkBytes);
+        const int numRead = stream.read(destination, (int)jmin((int64)readBytes, chunkEnd - position));
+        if (numRead <= 0)
+            return false;
+
+        position += numRead;
+        if (!alreadyHere)
+            bytesDownloaded += numRead;
+        if (position == chunkEnd && !alreadyHere)
+        {
+            chunkComplete[(size_t)chunk].store(true, std::memory_order_release);
+            arrived.signal();
+        }
+    }
+    return position >= length;
+}
+
+bool StreamingDownload::setLength(int64 length)
+{
+    const int64 known = totalBytes.load();
+    if (known >= 0)
+        return length == known;
+    if (length <= 0 || length > options.maxBytes)
+        return false;
+
+    data.allocate((size_t)length, false);
+    chunkComplete.reset(new std::atomic<bool>[(size_t)((length + options.chunkBytes - 1) / options.chunkBytes)]());
+    totalBytes.store(length, std::memory_order_release);
+    arrived.signal();
+    return true;
+}
+
+int64 StreamingDownload::findMissingChunk(int64 fromByte) const
+{
+    const int64 length = totalBytes.load();
+    const int64 numChunks = (length + options.chunkBytes - 1) / options.chunkBytes;
+    const int64 from = jlimit((int64)0, numChunks, fromByte / options.chunkBytes);
+
+    for (int64 i = 0; i < numChunks; ++i)
+    {
+        const int64 chunk = (from + i) % numChunks;
+        if (!isChunkComplete(chunk))
+            return chunk * options.chunkBytes;
+    }
+    return -1;
+}
+
+bool StreamingDownload::isChunkComplete(int64 chunk) const noexcept
+{
+    return chunkComplete[(size_t)chunk].load(std::memory_order_acquire);
+}
+
+bool StreamingDownload::waitFor(int64 start, int64 numBytes)
+{
+    const uint32 deadline = Time::getMillisecondCounter() + (uint32)options.timeoutMs;
+    while (totalBytes < 0 || !isAvailable(start, numBytes))
+    {
+        if (failed || complete || Time::getMillisecondCounter() > deadline)
+            return totalBytes >= 0 && isAvailable(start, numBytes);
+
+        prefetch(start);
+        arrived.reset();
+        if (totalBytes < 0 || !isAvailable(start, numBytes))
+            arrived.wait(20);
+    }
+    return true;
+}
@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+
+    StreamingDownload.h
+    Created: 20 Oct 2026 5:31:08am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+#include <memory>
+
+//==============================================================================
+/*
+    Downloads an http(s) track on its own thread into a buffer the size of
+    the file, so a deck can start playing it long before it has all
+    arrived.
+
+    The buffer is split into chunks, and a chunk can be read once all of it
+    is in. The download runs from the start of the file. When a reader
+    jumps to a part that hasn't arrived and isn't coming soon (prefetch), it
+    drops the connection and asks the server for a byte range starting at
+    that chunk. Once it reaches the end it goes back for whatever was
+    skipped. A server that ignores range requests still works, but seeks
+    then have to wait for the download to get there.
+
+    Streams created by createStream() read from the buffer, each with its
+    own position. A blocking stream waits for the bytes it needs, for
+    opening the reader and for background decoding. A non-blocking one is
+    for the audio thread: where bytes are missing it returns a short read,
+    which the readers turn into silence, asks the download for them and
+    counts an underrun. DJAudioPlayer avoids those by holding a streamed
+    deck silent until prerollSeconds past the playhead have arrived.
+
+    The server has to say how long the file is (Content-Length or
+    Content-Range).
+*/
+class StreamingDownload : public ReferenceCountedObject,
+                          private Thread
+{
+public:
+    using Ptr = ReferenceCountedObjectPtr<StreamingDownload>;
+
+    struct Options
+    {
+        int chunkBytes = 64 * 1024;
+        double prerollSeconds = 2.0;    // read by DJAudioPlayer
+        int timeoutMs = 10000;          // connecting, and a blocking stream's wait for bytes
+        int64 maxBytes = (int64)1 << 30;
+    };
+
+    struct Stats
+    {
+        int64 totalBytes = -1;      // -1 until the server has answered
+        int64 bytesDownloaded = 0;
+        int numRequests = 0;
+        int numUnderruns = 0;
+        bool rangesSupported = false;
+        bool complete = false;
+        bool failed = false;
+    };
+
+    /** true for http and https URLs */
+    static bool canStream(const URL& url);
+
+    /** starts downloading straight away */
+    StreamingDownload(const URL& url, const Options& options);
+    ~StreamingDownload() override;
+
+    /** a reader over the download, made with a blocking stream that then
+        turns non-blocking if forAudioThread. Waits for the file's headers;
+        nullptr with error if they don't come or no format can read them. */
+    std::unique_ptr<AudioFormatReader> createReader(AudioFormatManager& formatManager, bool forAudioThread, String& error);
+    std::unique_ptr<InputStream> createStream(bool blocking);
+
+    /** any thread, lock-free: true if every byte in [start, start + numBytes)
+        within the file has arrived */
+    bool isAvailable(int64 start, int64 numBytes) const noexcept;
+    /** any thread, lock-free: the download should get to this byte soon */
+    void prefetch(int64 byte) noexcept;
+
+    /** -1 until the server has answered */
+    int64 getTotalLength() const noexcept;
+    const Options& getOptions() const noexcept;
+    const URL& getURL() const noexcept;
+    Stats getStats() const;
+
+private:
+    class Stream;
+
+    void run() override;
+    /** one connection from start; false if it failed */
+    bool fetchFrom(int64 start);
+    bool setLength(int64 length);
+    int64 findMissingChunk(int64 fromByte) const;
+    bool isChunkComplete(int64 chunk) const noexcept;
+    /** the stream's side: wait for bytes to arrive, false on timeout or failure */
+    bool waitFor(int64 start, int64 numBytes);
+
+    const URL url;
+    const Options options;
+
+    HeapBlock<char> data;
+    std::unique_ptr<std::atomic<bool>[]> chunkComplete;
+    std::atomic<int64> totalBytes{ -1 };
+    std::atomic<int64> requested{ -1 };
+    std::atomic<int64> bytesDownloaded{ 0 };
+    std::atomic<int> numRequests{ 0 };
+    std::atomic<int> numUnderruns{ 0 };
+    std::atomic<bool> rangesSupported{ false };
+    std::atomic<bool> complete{ false };
+    std::atomic<bool> failed{ false };
+    WaitableEvent arrived{ true };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StreamingDownload)
+};
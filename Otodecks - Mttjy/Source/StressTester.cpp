@@ -0,0 +1,346 @@
+/*
+  ==============================================================================
+
+    StressTester.cpp
+    Created: 20 Oct 2026 4:37:20am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "StressTester.h"
+#include <deque>
+
+namespace
+{
+    constexpr double trackSecs = 20.0;
+    // whole cycles in trackSecs, so a looped track is seamless
+    const double trackFrequencies[] = { 1.0, 2.0 };
+}
+
+/** the simulated audio device: one callback per block period, timed */
+class StressTester::DeviceThread : public Thread
+{
+public:
+    DeviceThread(StressTester& _owner, MixEngine& _engine, CaseReport& _report, int _blockSize)
+        : Thread("Stress device"), owner(_owner), engine(_engine), report(_report), blockSize(_blockSize)
+    {
+    }
+
+    void run() override
+    {
+        const Options& options = owner.options;
+        const int64 periodTicks = Time::secondsToHighResolutionTicks(blockSize / options.sampleRate);
+        const int64 totalBlocks = (int64)(options.secondsPerCase * options.sampleRate / blockSize);
+        const int64 spinTicks = Time::secondsToHighResolutionTicks(0.002);
+
+        durations.reserve((size_t)totalBlocks);
+        AudioBuffer<float> buffer(2, blockSize);
+        int lastEpoch = owner.commandEpoch.load();
+        int64 start = Time::getHighResolutionTicks();
+
+        for (int64 block = 0; block < totalBlocks && !threadShouldExit(); ++block)
+        {
+            if (options.realtime)
+            {
+                const int64 due = start + block * periodTicks;
+                for (int64 remaining = due - Time::getHighResolutionTicks(); remaining > 0; remaining = due - Time::getHighResolutionTicks())
+                {
+                    if (remaining > spinTicks)
+                        Thread::sleep(1);
+                    else
+                        Thread::yield();
+                }
+
+                // a real device would have run dry here; start the clock again from now
+                const int64 late = Time::getHighResolutionTicks() - due;
+                if (late > periodTicks)
+                {
+                    ++report.lateStarts;
+                    start += late;
+                }
+            }
+
+            // a command sent since the last block may land on this one's first sample
+            const int epoch = owner.commandEpoch.load();
+            const bool commandLanding = owner.commandsInFlight.load() > 0 || epoch != lastEpoch;
+            lastEpoch = epoch;
+            const bool playingBefore = isAnyDeckPlaying();
+
+            const int64 callbackStart = Time::getHighResolutionTicks();
+            AudioSourceChannelInfo info(&buffer, 0, blockSize);
+            engine.getNextAudioBlock(info);
+            const int64 callbackTicks = Time::getHighResolutionTicks() - callbackStart;
+
+            // the decks' limiters add to it only while they are in the path
+            latency = engine.getLatencySamples();
+
+            durations.push_back(callbackTicks);
+            if (callbackTicks > periodTicks)
+                ++report.deadlineMisses;
+
+            rendered.push_back({ block * blockSize, commandLanding, playingBefore && isAnyDeckPlaying() && !commandLanding });
+            check(buffer, block * blockSize);
+        }
+        report.numCallbacks = (int64)durations.size();
+        report.latencySamples = engine.getLatencySamples();
+        report.deckLimiters = engine.areDeckLimitersInPath();
+    }
+
+    std::vector<int64> durations;
+
+private:
+    bool isAnyDeckPlaying() const
+    {
+        for (int d = 0; d < engine.getNumDecks(); ++d)
+            if (engine.getDeck(d)->isPlaying())
+                return true;
+        return false;
+    }
+
+    void check(const AudioBuffer<float>& buffer, int64 blockStart)
+    {
+        const float* left = buffer.getReadPointer(0);
+        const float* right = buffer.getReadPointer(1);
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            const int64 sample = blockStart + i;
+
+            // the limiters put out what the decks rendered latency samples earlier,
+            // so that is the block whose commands and transport state apply
+            const int64 source = sample - latency;
+            while (rendered.size() > 1 && rendered[1].start <= source)
+                rendered.pop_front();
+            const bool known = !rendered.empty() && rendered.front().start <= source;
+            const bool commandLanding = known && rendered.front().commandLanding && rendered.front().start == source;
+            const bool playing = known && rendered.front().playing;
+            if (!playing)
+                zeroRun = 0;
+
+            if (!std::isfinite(left[i]) || !std::isfinite(right[i]) || std::abs(left[i]) > 1.0f || std::abs(right[i]) > 1.0f)
+            {
+                ++report.numInvalid;
+                addGlitch("invalid", sample, left[i]);
+            }
+
+            const float step = std::abs(left[i] - previous);
+            if (havePrevious && !commandLanding && step > jumpThreshold)
+            {
+                ++report.numJumps;
+                addGlitch("jump", sample, step);
+            }
+            previous = left[i];
+            havePrevious = true;
+
+            if (playing && left[i] == 0.0f)
+            {
+                if (++zeroRun == dropoutLength)
+                {
+                    ++report.numDropouts;
+                    addGlitch("dropout", sample - dropoutLength + 1, 0.0f);
+                }
+            }
+            else
+            {
+                zeroRun = 0;
+            }
+        }
+    }
+
+    void addGlitch(const String& kind, int64 sample, float size)
+    {
+        if ((int)report.firstGlitches.size() < maxGlitchesKept)
+            report.firstGlitches.push_back({ kind, sample, size });
+    }
+
+    StressTester& owner;
+    MixEngine& engine;
+    CaseReport& report;
+    const int blockSize;
+
+    /** what was true of a block when it was rendered */
+    struct RenderedBlock
+    {
+        int64 start;
+        bool commandLanding;
+        bool playing;
+    };
+
+    std::deque<RenderedBlock> rendered;
+    int latency = 0;
+
+    float previous = 0;
+    bool havePrevious = false;
+    int zeroRun = 0;
+};
+
+//==============================================================================
+int StressTester::CaseReport::getNumGlitches() const
+{
+    return numJumps + numDropouts + numInvalid;
+}
+
+String StressTester::CaseReport::toString() const
+{
+    String text;
+    text << "block " << String(blockSize).paddedLeft(' ', 4) << " (" << String(budgetMicros / 1000.0, 2) << " ms): "
+         << numCallbacks << " callbacks, p99 " << String(p99Micros / 1000.0, 3) << " ms, max " << String(maxMicros / 1000.0, 3)
+         << " ms, " << deadlineMisses << " deadline misses, " << lateStarts << " late starts; "
+         << numCommands << " commands (" << numLoads << " loads, " << droppedCommands << " dropped); "
+         << numJumps << " jumps, " << numDropouts << " dropouts, " << numInvalid << " invalid; latency "
+         << latencySamples << " samples (" << (deckLimiters ? "master and deck limiters" : "master limiter only") << ")\n";
+    for (auto& glitch : firstGlitches)
+        text << "    " << glitch.kind << " at sample " << glitch.sample << " (" << String(glitch.size, 4) << ")\n";
+    return text;
+}
+
+//==============================================================================
+StressTester::StressTester(AudioFormatManager& _formatManager)
+    : formatManager(_formatManager)
+{
+}
+
+StressTester::~StressTester()
+{
+}
+
+bool StressTester::prepare(const File& folder, const Options& _options, String& error)
+{
+    options = _options;
+    options.numDecks = jlimit(1, AudioCallbackMonitor::maxDecks, options.numDecks);
+    options.commandIntervalMs = jmax(0, options.commandIntervalMs);
+
+    if (!folder.createDirectory())
+    {
+        error = "cannot create " + folder.getFullPathName();
+        return false;
+    }
+
+    const int length = (int)(trackSecs * options.sampleRate);
+    for (int t = 0; t < 2; ++t)
+    {
+        AudioBuffer<float> sine(2, length);
+        for (int i = 0; i < length; ++i)
+            sine.setSample(0, i, amplitude * (float)std::sin(MathConstants<double>::twoPi * trackFrequencies[t] * i / options.sampleRate));
+        sine.copyFrom(1, 0, sine, 0, 0, length);
+
+        tracks[t] = folder.getChildFile("stress_" + String(t + 1) + ".wav");
+        tracks[t].deleteFile();
+        WavAudioFormat wav;
+        std::unique_ptr<AudioFormatWriter> writer(wav.createWriterFor(tracks[t].createOutputStream().release(),
+                                                                      options.sampleRate, 2, 32, {}, 0));
+        if (writer == nullptr || !writer->writeFromAudioSampleBuffer(sine, 0, length))
+        {
+            error = "cannot write " + tracks[t].getFullPathName();
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<StressTester::CaseReport> StressTester::run()
+{
+    std::vector<CaseReport> reports;
+    for (int blockSize : options.blockSizes)
+        reports.push_back(runCase(jmax(1, blockSize)));
+    return reports;
+}
+
+//==============================================================================
+StressTester::CaseReport StressTester::runCase(int blockSize)
+{
+    CaseReport report;
+    report.blockSize = blockSize;
+    report.budgetMicros = blockSize / options.sampleRate * 1.0e6;
+
+    MixEngine engine;
+    std::vector<std::unique_ptr<DJAudioPlayer>> decks;
+    for (int d = 0; d < options.numDecks; ++d)
+    {
+        decks.push_back(std::make_unique<DJAudioPlayer>(formatManager));
+        engine.addDeck(decks.back().get());
+    }
+    engine.prepareToPlay(blockSize, options.sampleRate);
+
+    // every deck already playing when the device starts
+    Random random(options.seed * 7919 + blockSize);
+    for (int d = 0; d < options.numDecks; ++d)
+    {
+        DJAudioPlayer& deck = *decks[(size_t)d];
+        deck.loadURL(URL{ tracks[d % 2] });
+        deck.setLooping(d % 2 == 0);
+        deck.setPosition(random.nextDouble() * trackSecs);
+        deck.setGain(0.8);
+        deck.start();
+    }
+
+    commandsInFlight = 0;
+    commandEpoch = 0;
+    DeviceThread device(*this, engine, report, blockSize);
+    device.startThread();
+
+    while (device.isThreadRunning())
+    {
+        sendRandomCommand(engine, random, report);
+        Thread::sleep(random.nextInt(2 * options.commandIntervalMs + 1));
+    }
+    device.stopThread(-1);
+    engine.releaseResources();
+
+    for (auto& deck : decks)
+        report.droppedCommands += deck->getNumDroppedCommands();
+
+    std::vector<int64> durations = device.durations;
+    if (!durations.empty())
+    {
+        std::sort(durations.begin(), durations.end());
+        report.p99Micros = Time::highResolutionTicksToSeconds(durations[durations.size() * 99 / 100]) * 1.0e6;
+        report.maxMicros = Time::highResolutionTicksToSeconds(durations.back()) * 1.0e6;
+    }
+    return report;
+}
+
+void StressTester::sendRandomCommand(MixEngine& engine, Random& random, CaseReport& report)
+{
+    DJAudioPlayer& deck = *engine.getDeck(random.nextInt(engine.getNumDecks()));
+    ++commandsInFlight;
+
+    const int action = random.nextInt(100);
+    if (action < 30)
+    {
+        deck.setPosition(random.nextDouble() * trackSecs);
+    }
+    else if (action < 55)
+    {
+        // mostly the ends of the range, where the resampler works hardest
+        const int pick = random.nextInt(3);
+        deck.setSpeed(pick == 0 ? 0.25 : pick == 1 ? 10.0 : 0.25 * (1 + random.nextInt(40)));
+    }
+    else if (action < 65)
+    {
+        deck.loadURL(URL{ tracks[random.nextInt(2)] });
+        deck.setPosition(random.nextDouble() * trackSecs);
+        deck.start();
+        ++report.numLoads;
+    }
+    else if (action < 80)
+    {
+        if (deck.isPlaying())
+            deck.stop();
+        else
+            deck.start();
+    }
+    else if (action < 85)
+    {
+        deck.setLooping(!deck.isLooping());
+    }
+    else
+    {
+        deck.setGain(0.6 + 0.4 * random.nextDouble());
+    }
+
+    ++report.numCommands;
+    ++commandEpoch;
+    --commandsInFlight;
+}
@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+    StressTester.h
+    Created: 20 Oct 2026 4:37:20am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+#include <vector>
+#include "MixEngine.h"
+
+//==============================================================================
+/*
+    Plays the decks and the mixer through a simulated audio device while
+    another thread throws everything at them, to reproduce the combinations
+    that cause dropouts.
+
+    The device is a thread calling the MixEngine the way the device manager
+    calls MainComponent: prepareToPlay, then getNextAudioBlock on a fixed
+    clock of one block period, spinning for the last stretch so even
+    16-sample blocks start on time. Meanwhile the control thread picks a
+    random deck every few milliseconds and, at random:
+
+        seeks it, sets an extreme speed (0.25 to 10), loads the other test
+        track into it while it plays, starts or stops it, toggles its loop,
+        or moves its volume
+
+    Each deck plays a 1 Hz sine, 0.1 peak and a whole number of cycles
+    long, so the mix moves by well under 0.002 per sample and loops
+    seamlessly. Every block is checked as it comes out:
+
+        jump      two neighbouring samples more than 0.02 apart, other than
+                  at the start of a block where a command may have landed
+        dropout   32 or more exact zeros while decks are playing and no
+                  command is in flight
+        invalid   NaN, infinity or above full scale
+
+    The limiters delay the output by the engine's latency, so each sample is
+    judged by what was true when the block it came from was rendered. The
+    latency is read after every block, since the decks' limiters only add to
+    it while one of them is on, and the report says which it was.
+
+    A callback that takes longer than its block lasts is a deadline miss.
+    A callback the device thread itself started a whole block late is
+    counted apart, since that is the scheduler and not the engine.
+*/
+class StressTester
+{
+public:
+    struct Options
+    {
+        int numDecks = AudioCallbackMonitor::maxDecks;
+        double sampleRate = 44100.0;
+        double secondsPerCase = 3.0;
+        Array<int> blockSizes{ 16, 32, 64, 128, 256, 512 };
+        int commandIntervalMs = 2;
+        bool realtime = true;       // false: callbacks back to back, for a quick run
+        int seed = 1;
+    };
+
+    struct Glitch
+    {
+        String kind;
+        int64 sample = 0;
+        float size = 0;
+    };
+
+    struct CaseReport
+    {
+        int blockSize = 0;
+        int64 numCallbacks = 0;
+        double budgetMicros = 0;
+        double p99Micros = 0;
+        double maxMicros = 0;
+        int deadlineMisses = 0;
+        int lateStarts = 0;
+        int numCommands = 0;
+        int numLoads = 0;
+        int droppedCommands = 0;    // sent while a deck's queue was full
+        int numJumps = 0;
+        int numDropouts = 0;
+        int numInvalid = 0;
+        int latencySamples = 0;     // at the end of the case
+        bool deckLimiters = false;  // whether the decks' limiters were in the path then
+        std::vector<Glitch> firstGlitches;     // the first few, to find them again
+
+        int getNumGlitches() const;
+        String toString() const;
+    };
+
+    StressTester(AudioFormatManager& formatManager);
+    ~StressTester();
+
+    /** write the test tracks to folder; false with error if they can't be */
+    bool prepare(const File& folder, const Options& options, String& error);
+
+    /** one block size at a time, as Options say */
+    std::vector<CaseReport> run();
+
+private:
+    class DeviceThread;
+
+    CaseReport runCase(int blockSize);
+    /** the control thread's part: one random command to one random deck */
+    void sendRandomCommand(MixEngine& engine, Random& random, CaseReport& report);
+
+    static constexpr float amplitude = 0.1f;
+    static constexpr float jumpThreshold = 0.02f;
+    static constexpr int dropoutLength = 32;
+    static constexpr int maxGlitchesKept = 5;
+
+    AudioFormatManager& formatManager;
+    Options options;
+    File tracks[2];
+
+    // the device thread reads these at the start of each block to tell a
+    // command's jump from a glitch
+    std::atomic<int> commandsInFlight{ 0 };
+    std::atomic<int> commandEpoch{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StressTester)
+};
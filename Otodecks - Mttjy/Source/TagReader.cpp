@@ -0,0 +1,528 @@
+/*
+  ==============================================================================
+
+    TagReader.cpp
+    Created: 19 Oct 2026 4:40:27pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "TagReader.h"
+#include <atomic>
+#include <thread>
+
+bool TrackTags::isEmpty() const
+{
+    return title.isEmpty() && artist.isEmpty() && album.isEmpty() && genre.isEmpty() && comment.isEmpty();
+}
+
+//==============================================================================
+/*
+    Serves small reads out of a 64 KB window, refilled with one large read
+    whenever a request falls outside it.
+*/
+class TagReader::ChunkedReader
+{
+public:
+    ChunkedReader(const File& file) : stream(file)
+    {
+        totalSize = stream.openedOk() ? stream.getTotalLength() : 0;
+    }
+
+    bool openedOk() const { return stream.openedOk(); }
+    int64 getSize() const { return totalSize; }
+    int64 getBytesRead() const { return bytesRead; }
+    String getExtension() const { return stream.getFile().getFileExtension().toLowerCase(); }
+
+    /** pointer to n bytes at pos, valid until the next call; nullptr past the end */
+    const uint8* get(int64 pos, int n)
+    {
+        if (pos < 0 || n > chunkSize || pos + n > totalSize)
+            return nullptr;
+
+        if (pos < bufferStart || pos + n > bufferStart + bufferLength)
+        {
+            stream.setPosition(pos);
+            bufferLength = jmax(0, stream.read(buffer.getData(), chunkSize));
+            bufferStart = pos;
+            bytesRead += bufferLength;
+            if (bufferLength < n)
+                return nullptr;
+        }
+        return buffer.getData() + (pos - bufferStart);
+    }
+
+    /** copy of n bytes at pos, for blocks that may be bigger than the window */
+    bool read(int64 pos, int n, MemoryBlock& dest)
+    {
+        if (n <= chunkSize)
+        {
+            auto* data = get(pos, n);
+            if (data == nullptr)
+                return false;
+            dest.replaceAll(data, (size_t)n);
+            return true;
+        }
+
+        if (pos < 0 || pos + n > totalSize)
+            return false;
+        dest.setSize((size_t)n);
+        stream.setPosition(pos);
+        const int numRead = stream.read(dest.getData(), n);
+        bytesRead += jmax(0, numRead);
+        return numRead == n;
+    }
+
+private:
+    static constexpr int chunkSize = 64 * 1024;
+
+    FileInputStream stream;
+    HeapBlock<uint8> buffer{ (size_t)chunkSize };
+    int64 totalSize = 0;
+    int64 bufferStart = 0;
+    int bufferLength = 0;
+    int64 bytesRead = 0;
+};
+
+//==============================================================================
+namespace
+{
+    const char* const id3Genres[] =
+    {
+        "Blues", "Classic Rock", "Country", "Dance", "Disco", "Funk", "Grunge", "Hip-Hop", "Jazz", "Metal",
+        "New Age", "Oldies", "Other", "Pop", "R&B", "Rap", "Reggae", "Rock", "Techno", "Industrial",
+        "Alternative", "Ska", "Death Metal", "Pranks", "Soundtrack", "Euro-Techno", "Ambient", "Trip-Hop", "Vocal", "Jazz+Funk",
+        "Fusion", "Trance", "Classical", "Instrumental", "Acid", "House", "Game", "Sound Clip", "Gospel", "Noise",
+        "AlternRock", "Bass", "Soul", "Punk", "Space", "Meditative", "Instrumental Pop", "Instrumental Rock", "Ethnic", "Gothic",
+        "Darkwave", "Techno-Industrial", "Electronic", "Pop-Folk", "Eurodance", "Dream", "Southern Rock", "Comedy", "Cult", "Gangsta",
+        "Top 40", "Christian Rap", "Pop/Funk", "Jungle", "Native American", "Cabaret", "New Wave", "Psychedelic", "Rave", "Showtunes",
+        "Trailer", "Lo-Fi", "Tribal", "Acid Punk", "Acid Jazz", "Polka", "Retro", "Musical", "Rock & Roll", "Hard Rock"
+    };
+
+    /** "(17)", "17" and "(17)Rock" all become "Rock" */
+    String resolveGenre(const String& genre)
+    {
+        String trimmed = genre.trim();
+        String number = trimmed.startsWithChar('(') ? trimmed.fromFirstOccurrenceOf("(", false, false).upToFirstOccurrenceOf(")", false, false)
+                                                    : trimmed;
+        if (number.isNotEmpty() && number.containsOnly("0123456789"))
+        {
+            const int index = number.getIntValue();
+            if (isPositiveAndBelow(index, (int)numElementsInArray(id3Genres)))
+                return id3Genres[index];
+        }
+        return trimmed;
+    }
+
+    uint32 readBigEndian(const uint8* p, int numBytes)
+    {
+        uint32 v = 0;
+        for (int i = 0; i < numBytes; ++i)
+            v = (v << 8) | p[i];
+        return v;
+    }
+
+    uint32 readSynchsafe(const uint8* p)
+    {
+        return ((uint32)(p[0] & 0x7f) << 21) | ((uint32)(p[1] & 0x7f) << 14) | ((uint32)(p[2] & 0x7f) << 7) | (uint32)(p[3] & 0x7f);
+    }
+
+    String latin1ToString(const uint8* data, size_t size)
+    {
+        String s;
+        s.preallocateBytes(size * 2);
+        for (size_t i = 0; i < size && data[i] != 0; ++i)
+            s += (juce_wchar)data[i];
+        return s;
+    }
+
+    void setIfEmpty(String& field, const String& value)
+    {
+        if (field.isEmpty())
+            field = value.trim();
+    }
+}
+
+String TagReader::decodeID3Text(const uint8* data, size_t size, int encoding)
+{
+    switch (encoding)
+    {
+        case 0: // ISO-8859-1
+            return latin1ToString(data, size);
+
+        case 1: // UTF-16 with BOM
+        case 2: // UTF-16 big endian
+        {
+            bool bigEndian = encoding == 2;
+            size_t i = 0;
+            if (size >= 2 && ((data[0] == 0xff && data[1] == 0xfe) || (data[0] == 0xfe && data[1] == 0xff)))
+            {
+                bigEndian = data[0] == 0xfe;
+                i = 2;
+            }
+
+            std::vector<juce_wchar> chars;
+            chars.reserve(size / 2 + 1);
+            for (; i + 1 < size; i += 2)
+            {
+                uint32 unit = bigEndian ? (uint32)((data[i] << 8) | data[i + 1]) : (uint32)((data[i + 1] << 8) | data[i]);
+                if (unit == 0)
+                    break;
+
+                if (unit >= 0xd800 && unit < 0xdc00 && i + 3 < size)
+                {
+                    const uint32 low = bigEndian ? (uint32)((data[i + 2] << 8) | data[i + 3]) : (uint32)((data[i + 3] << 8) | data[i + 2]);
+                    unit = 0x10000 + ((unit - 0xd800) << 10) + (low - 0xdc00);
+                    i += 2;
+                }
+                chars.push_back((juce_wchar)unit);
+            }
+            chars.push_back(0);
+            return String(CharPointer_UTF32(chars.data()));
+        }
+
+        case 3: // UTF-8
+        default:
+        {
+            size_t length = 0;
+            while (length < size && data[length] != 0)
+                ++length;
+            return String::fromUTF8((const char*)data, (int)length);
+        }
+    }
+}
+
+//==============================================================================
+bool TagReader::readID3v2(ChunkedReader& in, TrackTags& tags)
+{
+    const uint8* header = in.get(0, 10);
+    if (header == nullptr || memcmp(header, "ID3", 3) != 0)
+        return false;
+
+    const int version = header[3];
+    const int flags = header[5];
+    const int64 end = 10 + (int64)readSynchsafe(header + 6);
+    int64 pos = 10;
+
+    if ((flags & 0x40) != 0) // extended header
+    {
+        const uint8* ext = in.get(pos, 4);
+        if (ext == nullptr)
+            return false;
+        pos += version >= 4 ? (int64)readSynchsafe(ext) : 4 + (int64)readBigEndian(ext, 4);
+    }
+
+    const int idLength = version == 2 ? 3 : 4;
+    const int frameHeaderSize = version == 2 ? 6 : 10;
+    bool found = false;
+
+    while (pos + frameHeaderSize <= end)
+    {
+        const uint8* frame = in.get(pos, frameHeaderSize);
+        if (frame == nullptr || frame[0] == 0) // padding
+            break;
+
+        const String id = String::fromUTF8((const char*)frame, idLength);
+        const uint32 size = version == 2 ? readBigEndian(frame + 3, 3)
+                          : version >= 4 ? readSynchsafe(frame + 4)
+                                         : readBigEndian(frame + 4, 4);
+        const int frameFlags = version == 2 ? 0 : (int)readBigEndian(frame + 8, 2);
+        const int64 payloadPos = pos + frameHeaderSize;
+        pos = payloadPos + size;
+
+        if (size == 0 || pos > end)
+            break;
+
+        String* field = nullptr;
+        bool isComment = false;
+        if (id == "TIT2" || id == "TT2")      field = &tags.title;
+        else if (id == "TPE1" || id == "TP1") field = &tags.artist;
+        else if (id == "TALB" || id == "TAL") field = &tags.album;
+        else if (id == "TCON" || id == "TCO") field = &tags.genre;
+        else if (id == "COMM" || id == "COM") { field = &tags.comment; isComment = true; }
+
+        // skip compressed or encrypted frames, and anything we don't show
+        const bool packed = version == 3 ? (frameFlags & 0x00c0) != 0 : version >= 4 ? (frameFlags & 0x000c) != 0 : false;
+        if (field == nullptr || packed || field->isNotEmpty())
+            continue;
+
+        MemoryBlock payload;
+        if (!in.read(payloadPos, (int)jmin(size, (uint32)(1 << 20)), payload) || payload.getSize() < 2)
+            continue;
+
+        auto* data = (const uint8*)payload.getData();
+        const int encoding = data[0];
+        size_t offset = 1;
+
+        if (isComment)
+        {
+            // language, then a terminated description, then the text
+            offset = 4;
+            const bool wide = encoding == 1 || encoding == 2;
+            while (offset < payload.getSize())
+            {
+                if (wide)
+                {
+                    if (offset + 1 < payload.getSize() && data[offset] == 0 && data[offset + 1] == 0) { offset += 2; break; }
+                    offset += 2;
+                }
+                else
+                {
+                    if (data[offset++] == 0)
+                        break;
+                }
+            }
+        }
+
+        if (offset < payload.getSize())
+        {
+            *field = decodeID3Text(data + offset, payload.getSize() - offset, encoding).trim();
+            found = true;
+        }
+    }
+
+    if (tags.genre.isNotEmpty())
+        tags.genre = resolveGenre(tags.genre);
+    return found;
+}
+
+bool TagReader::readID3v1(ChunkedReader& in, TrackTags& tags)
+{
+    const uint8* tag = in.get(in.getSize() - 128, 128);
+    if (tag == nullptr || memcmp(tag, "TAG", 3) != 0)
+        return false;
+
+    setIfEmpty(tags.title, latin1ToString(tag + 3, 30));
+    setIfEmpty(tags.artist, latin1ToString(tag + 33, 30));
+    setIfEmpty(tags.album, latin1ToString(tag + 63, 30));
+    setIfEmpty(tags.comment, latin1ToString(tag + 97, 28));
+    if (tags.genre.isEmpty() && isPositiveAndBelow((int)tag[127], (int)numElementsInArray(id3Genres)))
+        tags.genre = id3Genres[tag[127]];
+    return true;
+}
+
+void TagReader::readVorbisComments(const uint8* data, size_t size, TrackTags& tags)
+{
+    auto readLE32 = [data, size](size_t pos) -> uint32
+    {
+        return pos + 4 <= size ? (uint32)data[pos] | ((uint32)data[pos + 1] << 8) | ((uint32)data[pos + 2] << 16) | ((uint32)data[pos + 3] << 24)
+                               : 0xffffffff;
+    };
+
+    size_t pos = 0;
+    const uint32 vendorLength = readLE32(pos);
+    if (vendorLength == 0xffffffff)
+        return;
+    pos += 4 + vendorLength;
+
+    const uint32 count = readLE32(pos);
+    pos += 4;
+
+    for (uint32 i = 0; i < count && pos + 4 <= size; ++i)
+    {
+        const uint32 length = readLE32(pos);
+        pos += 4;
+        if (length > size - pos)
+            break;
+
+        const String entry = String::fromUTF8((const char*)data + pos, (int)length);
+        pos += length;
+
+        const String key = entry.upToFirstOccurrenceOf("=", false, false).toUpperCase();
+        const String value = entry.fromFirstOccurrenceOf("=", false, false);
+
+        if (key == "TITLE")                                 setIfEmpty(tags.title, value);
+        else if (key == "ARTIST")                           setIfEmpty(tags.artist, value);
+        else if (key == "ALBUM")                            setIfEmpty(tags.album, value);
+        else if (key == "GENRE")                            setIfEmpty(tags.genre, value);
+        else if (key == "COMMENT" || key == "DESCRIPTION")  setIfEmpty(tags.comment, value);
+    }
+}
+
+bool TagReader::readFlac(ChunkedReader& in, TrackTags& tags)
+{
+    const uint8* magic = in.get(0, 4);
+    if (magic == nullptr || memcmp(magic, "fLaC", 4) != 0)
+        return false;
+
+    int64 pos = 4;
+    for (;;)
+    {
+        const uint8* header = in.get(pos, 4);
+        if (header == nullptr)
+            return false;
+
+        const bool last = (header[0] & 0x80) != 0;
+        const int type = header[0] & 0x7f;
+        const int length = (int)readBigEndian(header + 1, 3);
+
+        if (type == 4) // VORBIS_COMMENT
+        {
+            MemoryBlock block;
+            if (!in.read(pos + 4, length, block))
+                return false;
+            readVorbisComments((const uint8*)block.getData(), block.getSize(), tags);
+            return true;
+        }
+
+        // STREAMINFO, SEEKTABLE, PICTURE etc. are skipped without reading them
+        pos += 4 + length;
+        if (last)
+            return false;
+    }
+}
+
+bool TagReader::readOgg(ChunkedReader& in, TrackTags& tags)
+{
+    // the comment header is the second packet; it may span several pages
+    MemoryBlock packet;
+    int packetIndex = 0;
+    int64 pos = 0;
+
+    for (int page = 0; page < 64; ++page)
+    {
+        const uint8* header = in.get(pos, 27);
+        if (header == nullptr || memcmp(header, "OggS", 4) != 0)
+            return false;
+
+        const int numSegments = header[26];
+        const uint8* table = in.get(pos + 27, numSegments);
+        if (table == nullptr)
+            return false;
+
+        const std::vector<uint8> lacing(table, table + numSegments);
+        int64 bodyPos = pos + 27 + numSegments;
+
+        for (auto segment : lacing)
+        {
+            if (packetIndex == 1 && segment > 0)
+            {
+                const uint8* body = in.get(bodyPos, segment);
+                if (body == nullptr)
+                    return false;
+                packet.append(body, segment);
+            }
+            bodyPos += segment;
+
+            if (segment < 255 && ++packetIndex == 2)
+            {
+                auto* data = (const uint8*)packet.getData();
+                if (packet.getSize() > 7 && memcmp(data, "\x03vorbis", 7) == 0)
+                    readVorbisComments(data + 7, packet.getSize() - 7, tags);
+                else if (packet.getSize() > 8 && memcmp(data, "OpusTags", 8) == 0)
+                    readVorbisComments(data + 8, packet.getSize() - 8, tags);
+                return true;
+            }
+        }
+        pos = bodyPos;
+    }
+    return false;
+}
+
+bool TagReader::readWav(ChunkedReader& in, TrackTags& tags)
+{
+    const uint8* header = in.get(0, 12);
+    if (header == nullptr || memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0)
+        return false;
+
+    auto readLE32 = [](const uint8* p) { return (uint32)p[0] | ((uint32)p[1] << 8) | ((uint32)p[2] << 16) | ((uint32)p[3] << 24); };
+
+    int64 pos = 12;
+    bool found = false;
+    while (pos + 8 <= in.getSize())
+    {
+        const uint8* chunk = in.get(pos, 12);
+        if (chunk == nullptr)
+            break;
+
+        const uint32 length = readLE32(chunk + 4);
+        if (memcmp(chunk, "LIST", 4) == 0 && memcmp(chunk + 8, "INFO", 4) == 0 && length >= 4)
+        {
+            MemoryBlock list;
+            if (!in.read(pos + 12, (int)jmin(length - 4, (uint32)(1 << 20)), list))
+                break;
+
+            auto* data = (const uint8*)list.getData();
+            size_t p = 0;
+            while (p + 8 <= list.getSize())
+            {
+                const uint32 itemLength = readLE32(data + p + 4);
+                if (itemLength > list.getSize() - p - 8)
+                    break;
+
+                uint32 textLength = 0;
+                while (textLength < itemLength && data[p + 8 + textLength] != 0)
+                    ++textLength;
+
+                const String value = String::fromUTF8((const char*)data + p + 8, (int)textLength);
+                if (memcmp(data + p, "INAM", 4) == 0)      setIfEmpty(tags.title, value);
+                else if (memcmp(data + p, "IART", 4) == 0) setIfEmpty(tags.artist, value);
+                else if (memcmp(data + p, "IPRD", 4) == 0) setIfEmpty(tags.album, value);
+                else if (memcmp(data + p, "IGNR", 4) == 0) setIfEmpty(tags.genre, value);
+                else if (memcmp(data + p, "ICMT", 4) == 0) setIfEmpty(tags.comment, value);
+                p += 8 + itemLength + (itemLength & 1);
+            }
+            found = true;
+        }
+
+        // the data chunk is skipped by seeking past it
+        pos += 8 + (int64)length + (length & 1);
+    }
+    return found;
+}
+
+//==============================================================================
+bool TagReader::readTags(const File& file, TrackTags& tags, int64* bytesRead)
+{
+    ChunkedReader in(file);
+    if (!in.openedOk())
+        return false;
+
+    bool found = false;
+    const uint8* magic = in.get(0, 4);
+    if (magic != nullptr)
+    {
+        if (memcmp(magic, "ID3", 3) == 0)       found = readID3v2(in, tags);
+        else if (memcmp(magic, "fLaC", 4) == 0) found = readFlac(in, tags);
+        else if (memcmp(magic, "OggS", 4) == 0) found = readOgg(in, tags);
+        else if (memcmp(magic, "RIFF", 4) == 0) found = readWav(in, tags);
+    }
+
+    // old MP3s only carry the 128 byte trailer
+    if ((!found || tags.title.isEmpty()) && in.getExtension() == ".mp3")
+        found = readID3v1(in, tags) || found;
+
+    if (bytesRead != nullptr)
+        *bytesRead = in.getBytesRead();
+    return found && !tags.isEmpty();
+}
+
+std::vector<TrackTags> TagReader::readTagsParallel(const Array<File>& files, int numThreads, int64* totalBytesRead)
+{
+    std::vector<TrackTags> results((size_t)files.size());
+    std::atomic<int> nextFile{ 0 };
+    std::atomic<int64> bytes{ 0 };
+
+    auto worker = [&]
+    {
+        for (int i = nextFile++; i < files.size(); i = nextFile++)
+        {
+            int64 fileBytes = 0;
+            readTags(files.getReference(i), results[(size_t)i], &fileBytes);
+            bytes += fileBytes;
+        }
+    };
+
+    const int threads = jlimit(1, 64, numThreads > 0 ? numThreads : SystemStats::getNumCpus());
+    std::vector<std::thread> workers;
+    for (int t = 1; t < jmin(threads, files.size()); ++t)
+        workers.emplace_back(worker);
+    worker();
+    for (auto& w : workers)
+        w.join();
+
+    if (totalBytesRead != nullptr)
+        *totalBytesRead = bytes.load();
+    return results;
+}
@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    TagReader.h
+    Created: 19 Oct 2026 4:40:27pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+
+struct TrackTags
+{
+    String title;
+    String artist;
+    String album;
+    String genre;
+    String comment;
+
+    bool isEmpty() const;
+};
+
+//==============================================================================
+/*
+    Reads title/artist/album/genre/comment from ID3v2, ID3v1, FLAC and Ogg
+    Vorbis comments and WAV LIST/INFO chunks, without decoding any audio.
+
+    Only the tag blocks are read, in large sequential chunks; frames and
+    blocks we don't need (cover art, seek tables) are skipped by seeking.
+*/
+class TagReader
+{
+public:
+    /** returns false if the file can't be opened or holds no known tags */
+    static bool readTags(const File& file, TrackTags& tags, int64* bytesRead = nullptr);
+
+    /** read the tags of every file using numThreads threads (0 = one per core) */
+    static std::vector<TrackTags> readTagsParallel(const Array<File>& files, int numThreads = 0,
+                                                   int64* totalBytesRead = nullptr);
+
+private:
+    class ChunkedReader;
+
+    static bool readID3v2(ChunkedReader& in, TrackTags& tags);
+    static bool readID3v1(ChunkedReader& in, TrackTags& tags);
+    static bool readFlac(ChunkedReader& in, TrackTags& tags);
+    static bool readOgg(ChunkedReader& in, TrackTags& tags);
+    static bool readWav(ChunkedReader& in, TrackTags& tags);
+    static void readVorbisComments(const uint8* data, size_t size, TrackTags& tags);
+    static String decodeID3Text(const uint8* data, size_t size, int encoding);
+};
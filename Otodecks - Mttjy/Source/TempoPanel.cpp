@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    TempoPanel.cpp
+    Created: 19 Oct 2026 10:31:44pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "TempoPanel.h"
+
+//==============================================================================
+TempoPanel::TempoPanel(MixEngine& _engine, AudioDeviceManager& _deviceManager)
+    : engine(_engine),
+      deviceManager(_deviceManager)
+{
+    addAndMakeVisible(tempoSlider);
+    tempoSlider.setSliderStyle(Slider::IncDecButtons);
+    tempoSlider.setTextBoxStyle(Slider::TextBoxLeft, false, 60, 20);
+    tempoSlider.setRange(60.0, 200.0, 0.1);
+    tempoSlider.setTextValueSuffix(" bpm");
+    tempoSlider.setValue(engine.getTempo(), dontSendNotification);
+    tempoSlider.onValueChange = [this] { engine.setTempo(tempoSlider.getValue()); };
+
+    addAndMakeVisible(quantizeBox);
+    quantizeBox.addItem("Q off", 1 + (int)MixEngine::Quantize::off);
+    quantizeBox.addItem("Q beat", 1 + (int)MixEngine::Quantize::beat);
+    quantizeBox.addItem("Q bar", 1 + (int)MixEngine::Quantize::bar);
+    quantizeBox.setSelectedId(1 + (int)engine.getQuantize(), dontSendNotification);
+    quantizeBox.onChange = [this] { engine.setQuantize((MixEngine::Quantize)(quantizeBox.getSelectedId() - 1)); };
+
+    addAndMakeVisible(downbeatButton);
+    downbeatButton.onClick = [this] { setDownbeat(); };
+}
+
+TempoPanel::~TempoPanel()
+{
+}
+
+void TempoPanel::paint (Graphics& g)
+{
+    g.fillAll(Colour::fromRGB(15, 15, 15));
+}
+
+void TempoPanel::resized()
+{
+    tempoSlider.setBounds(0, 0, 120, getHeight());
+    quantizeBox.setBounds(124, 0, 80, getHeight());
+    downbeatButton.setBounds(208, 0, 28, getHeight());
+}
+
+void TempoPanel::setDownbeat()
+{
+    // the block rendered last is heard one buffer plus the output latency later,
+    // and the engine's limiters hold it back a little more
+    int64 latency = engine.getLatencySamples();
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+        latency += device->getOutputLatencyInSamples() + device->getCurrentBufferSizeSamples();
+    engine.setGridOrigin(engine.getSamplePosition() - latency);
+}
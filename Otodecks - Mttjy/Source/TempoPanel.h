@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    TempoPanel.h
+    Created: 19 Oct 2026 10:31:44pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MixEngine.h"
+
+//==============================================================================
+/*
+    Master tempo and quantize setting for the decks' transport buttons, and
+    a button that puts the grid's downbeat on the sample being heard now.
+*/
+class TempoPanel  : public Component
+{
+public:
+    TempoPanel(MixEngine& engine, AudioDeviceManager& deviceManager);
+    ~TempoPanel() override;
+
+    void paint (Graphics&) override;
+    void resized() override;
+
+private:
+    void setDownbeat();
+
+    MixEngine& engine;
+    AudioDeviceManager& deviceManager;
+
+    Slider tempoSlider;
+    ComboBox quantizeBox;
+    TextButton downbeatButton{ "1" };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TempoPanel)
+};
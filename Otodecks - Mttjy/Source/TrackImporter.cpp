@@ -0,0 +1,385 @@
+/*
+  ==============================================================================
+
+    TrackImporter.cpp
+    Created: 19 Oct 2026 3:22:08pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#ifdef _WIN32
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+#endif
+
+#include "TrackImporter.h"
+
+#if JUCE_LINUX
+ #include <fcntl.h>
+ #include <unistd.h>
+ #include <sys/ioctl.h>
+ #include <linux/fs.h>
+#elif JUCE_MAC
+ #include <unistd.h>
+ #include <sys/clonefile.h>
+#endif
+
+//==============================================================================
+class TrackImporter::ImportJob : public ThreadPoolJob
+{
+public:
+    ImportJob(TrackImporter& _owner, const File& _source)
+        : ThreadPoolJob("Import " + _source.getFileName()), owner(_owner), source(_source)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        owner.runImport(*this, source);
+        return jobHasFinished;
+    }
+
+    using ThreadPoolJob::shouldExit;
+
+private:
+    TrackImporter& owner;
+    File source;
+};
+
+//==============================================================================
+TrackImporter::TrackImporter(const File& _tracksFolder)
+    : tracksFolder(_tracksFolder),
+      indexFile(_tracksFolder.getSiblingFile("import_index.txt")),
+      partialFolder(_tracksFolder.getSiblingFile("tracks.partial"))
+{
+    formatManager.registerBasicFormats();
+}
+
+TrackImporter::~TrackImporter()
+{
+    pool.removeAllJobs(true, 5000);
+}
+
+void TrackImporter::importFile(const File& source)
+{
+    Status status;
+    status.source = source;
+    status.message = "queued";
+    updateStatus(status);
+
+    pool.addJob(new ImportJob(*this, source), true);
+}
+
+TrackImporter::Status TrackImporter::getStatus(const File& source) const
+{
+    const ScopedLock sl(statusLock);
+    for (auto& status : statuses)
+        if (status.source == source)
+            return status;
+    return {};
+}
+
+Array<TrackImporter::Status> TrackImporter::takeImported()
+{
+    const ScopedLock sl(statusLock);
+    Array<Status> finished;
+    finished.swapWith(imported);
+    return finished;
+}
+
+void TrackImporter::updateStatus(const Status& status)
+{
+    {
+        const ScopedLock sl(statusLock);
+        bool found = false;
+        for (auto& existing : statuses)
+        {
+            if (existing.source == status.source)
+            {
+                existing = status;
+                found = true;
+            }
+        }
+        if (!found)
+            statuses.add(status);
+
+        if (status.finished && !status.failed && !status.duplicate)
+            imported.add(status);
+    }
+    sendChangeMessage();
+}
+
+//==============================================================================
+uint64 TrackImporter::hashFile(const File& file, std::function<bool(double)> progressCallback)
+{
+    FileInputStream in(file);
+    if (!in.openedOk())
+        return 0;
+
+    // 64-bit FNV-1a over 8-byte words, seeded with the length
+    const int64 total = in.getTotalLength();
+    uint64 hash = 14695981039346656037ull ^ (uint64)total;
+    HeapBlock<char> chunk(1 << 20, true);
+    int64 done = 0;
+
+    for (;;)
+    {
+        const int numRead = in.read(chunk.getData(), 1 << 20);
+        if (numRead <= 0)
+            break;
+
+        const int numWords = numRead / 8;
+        auto* words = reinterpret_cast<const uint64*>(chunk.getData());
+        for (int i = 0; i < numWords; ++i)
+            hash = (hash ^ words[i]) * 1099511628211ull;
+        for (int i = numWords * 8; i < numRead; ++i)
+            hash = (hash ^ (uint8)chunk[i]) * 1099511628211ull;
+
+        done += numRead;
+        if (progressCallback != nullptr && !progressCallback(total > 0 ? (double)done / (double)total : 1.0))
+            return 0;
+    }
+    return hash;
+}
+
+void TrackImporter::runImport(ImportJob& job, const File& source)
+{
+    Status status = getStatus(source);
+    status.source = source;
+
+    auto fail = [&](const String& message)
+    {
+        status.failed = true;
+        status.finished = true;
+        status.message = message;
+        updateStatus(status);
+    };
+
+    if (!source.existsAsFile())
+        return fail("file not found");
+
+    if (!indexLoaded)
+    {
+        status.message = "indexing library";
+        updateStatus(status);
+        loadIndex();
+    }
+
+    // hashing is the first half of the progress bar, copying the second
+    status.message = "checking";
+    int64 lastUpdate = 0;
+    const uint64 hash = hashFile(source, [&](double p)
+    {
+        const int64 now = Time::currentTimeMillis();
+        if (now - lastUpdate > 100)
+        {
+            status.progress = p * 0.5;
+            updateStatus(status);
+            lastUpdate = now;
+        }
+        return !job.shouldExit();
+    });
+
+    if (job.shouldExit())
+        return fail("cancelled");
+
+    const int64 size = source.getSize();
+    File existing = findDuplicate(hash, size);
+    if (existing != File())
+    {
+        status.duplicate = true;
+        status.finished = true;
+        status.progress = 1.0;
+        status.destination = existing;
+        status.message = "already in library as " + existing.getFileName();
+        updateStatus(status);
+        return;
+    }
+
+    // a different track with the same name gets a numbered name instead of a prompt
+    tracksFolder.createDirectory();
+    File destination = tracksFolder.getChildFile(source.getFileName());
+    if (destination.exists())
+        destination = destination.getNonexistentSibling(true);
+    status.destination = destination;
+
+    if (!cloneOrLink(source, destination))
+    {
+        status.message = "copying";
+        partialFolder.createDirectory();
+        File partial = partialFolder.getChildFile(destination.getFileName());
+        partial.deleteFile();
+
+        {
+            FileInputStream in(source);
+            std::unique_ptr<FileOutputStream> out(partial.createOutputStream());
+            if (!in.openedOk() || out == nullptr)
+                return fail("cannot copy");
+
+            HeapBlock<char> chunk(1 << 20);
+            int64 copied = 0;
+            for (;;)
+            {
+                if (job.shouldExit())
+                    break;
+
+                const int numRead = in.read(chunk.getData(), 1 << 20);
+                if (numRead <= 0)
+                    break;
+                if (!out->write(chunk.getData(), (size_t)numRead))
+                    break;
+
+                copied += numRead;
+                const int64 now = Time::currentTimeMillis();
+                if (now - lastUpdate > 100)
+                {
+                    status.progress = 0.5 + 0.5 * (double)copied / (double)jmax((int64)1, size);
+                    updateStatus(status);
+                    lastUpdate = now;
+                }
+            }
+            out->flush();
+            if (copied != size)
+            {
+                out.reset();
+                partial.deleteFile();
+                return fail(job.shouldExit() ? "cancelled" : "copy failed");
+            }
+        }
+
+        if (!partial.moveFileTo(destination))
+        {
+            partial.deleteFile();
+            return fail("cannot move into " + tracksFolder.getFileName());
+        }
+    }
+
+    IndexEntry entry;
+    entry.hash = hash;
+    entry.size = size;
+    entry.modificationTime = destination.getLastModificationTime().toMilliseconds();
+    index[destination.getFileName()] = entry;
+    saveIndex();
+
+    TagReader::readTags(destination, status.tags);
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(destination));
+    if (reader != nullptr && reader->sampleRate > 0)
+        status.duration = reader->lengthInSamples / reader->sampleRate;
+
+    status.progress = 1.0;
+    status.finished = true;
+    status.message = "imported";
+    updateStatus(status);
+}
+
+//==============================================================================
+void TrackImporter::loadIndex()
+{
+    index.clear();
+
+    StringArray lines;
+    indexFile.readLines(lines);
+    for (auto& line : lines)
+    {
+        StringArray fields = StringArray::fromTokens(line, "|", "");
+        if (fields.size() != 4)
+            continue;
+
+        IndexEntry entry;
+        entry.hash = (uint64)fields[0].getHexValue64();
+        entry.size = fields[1].getLargeIntValue();
+        entry.modificationTime = fields[2].getLargeIntValue();
+        index[fields[3]] = entry;
+    }
+
+    // drop stale entries and hash anything added behind our back
+    std::map<String, IndexEntry> current;
+    for (auto& file : tracksFolder.findChildFiles(File::findFiles | File::ignoreHiddenFiles, false))
+    {
+        const auto found = index.find(file.getFileName());
+        const int64 modified = file.getLastModificationTime().toMilliseconds();
+        if (found != index.end() && found->second.size == file.getSize() && found->second.modificationTime == modified)
+        {
+            current[file.getFileName()] = found->second;
+            continue;
+        }
+
+        IndexEntry entry;
+        entry.hash = hashFile(file);
+        entry.size = file.getSize();
+        entry.modificationTime = modified;
+        current[file.getFileName()] = entry;
+    }
+
+    index.swap(current);
+    indexLoaded = true;
+    saveIndex();
+}
+
+void TrackImporter::saveIndex()
+{
+    String text;
+    for (auto& item : index)
+    {
+        text << String::toHexString((int64)item.second.hash) << "|" << item.second.size << "|"
+             << item.second.modificationTime << "|" << item.first << "\n";
+    }
+
+    TemporaryFile temp(indexFile);
+    if (temp.getFile().replaceWithText(text))
+        temp.overwriteTargetFileWithTemporary();
+}
+
+File TrackImporter::findDuplicate(uint64 hash, int64 size) const
+{
+    for (auto& item : index)
+    {
+        if (item.second.hash == hash && item.second.size == size)
+        {
+            File file = tracksFolder.getChildFile(item.first);
+            if (file.existsAsFile())
+                return file;
+        }
+    }
+    return {};
+}
+
+bool TrackImporter::cloneOrLink(const File& source, const File& destination)
+{
+    // a clone or hard link is instant and costs no space; both need the same volume
+    const String src = source.getFullPathName();
+    const String dst = destination.getFullPathName();
+
+   #if JUCE_LINUX
+    const int in = open(src.toRawUTF8(), O_RDONLY);
+    if (in >= 0)
+    {
+        const int out = open(dst.toRawUTF8(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (out >= 0)
+        {
+            const bool cloned = ioctl(out, FICLONE, in) == 0;
+            close(out);
+            close(in);
+            if (cloned)
+                return true;
+            unlink(dst.toRawUTF8());
+        }
+        else
+        {
+            close(in);
+        }
+    }
+    return link(src.toRawUTF8(), dst.toRawUTF8()) == 0;
+   #elif JUCE_MAC
+    if (clonefile(src.toRawUTF8(), dst.toRawUTF8(), 0) == 0)
+        return true;
+    return link(src.toRawUTF8(), dst.toRawUTF8()) == 0;
+   #elif defined (_WIN32)
+    return CreateHardLinkW(dst.toWideCharPointer(), src.toWideCharPointer(), nullptr) != 0;
+   #else
+    return false;
+   #endif
+}
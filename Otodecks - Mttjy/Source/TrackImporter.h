@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    TrackImporter.h
+    Created: 19 Oct 2026 3:22:08pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <map>
+#include "TagReader.h"
+
+//==============================================================================
+/*
+    Brings dropped files into the tracks folder without blocking the UI.
+
+    Each import runs on a background thread. It hashes the content, skips
+    files the library already holds, then clones or hard-links the file
+    where the filesystem allows and copies it otherwise. Copies go through a
+    temporary file so a half-copied track never shows up in the library.
+    A change message is sent whenever progress is made. The imported track's
+    tags and length are read on the same thread, so adding it to the
+    library opens nothing on the message thread.
+*/
+class TrackImporter : public ChangeBroadcaster
+{
+public:
+    struct Status
+    {
+        File source;
+        File destination;
+        double progress = 0;
+        bool finished = false;
+        bool duplicate = false;
+        bool failed = false;
+        String message;
+
+        // once finished, for the library
+        double duration = 0;
+        TrackTags tags;
+    };
+
+    TrackImporter(const File& tracksFolder);
+    ~TrackImporter() override;
+
+    /** queue source for import; returns immediately */
+    void importFile(const File& source);
+
+    /** the latest status of the import of source, or a default Status if unknown */
+    Status getStatus(const File& source) const;
+
+    /** message thread: tracks that finished importing since the last call, with their tags */
+    Array<Status> takeImported();
+
+    /** content hash used for de-duplication */
+    static uint64 hashFile(const File& file, std::function<bool(double)> progressCallback = nullptr);
+
+private:
+    class ImportJob;
+    friend class ImportJob;
+
+    struct IndexEntry
+    {
+        uint64 hash = 0;
+        int64 size = 0;
+        int64 modificationTime = 0;
+    };
+
+    void runImport(ImportJob& job, const File& source);
+    void updateStatus(const Status& status);
+    void loadIndex();
+    void saveIndex();
+    File findDuplicate(uint64 hash, int64 size) const;
+    static bool cloneOrLink(const File& source, const File& destination);
+
+    File tracksFolder;
+    File indexFile;
+    File partialFolder;
+    AudioFormatManager formatManager;
+
+    ThreadPool pool{ 1 };
+
+    mutable CriticalSection statusLock;
+    Array<Status> statuses;
+    Array<Status> imported;
+
+    // only touched from the pool's single thread
+    std::map<String, IndexEntry> index;
+    bool indexLoaded = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TrackImporter)
+};
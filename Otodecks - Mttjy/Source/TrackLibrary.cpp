@@ -0,0 +1,352 @@
+/*
+  ==============================================================================
+
+    TrackLibrary.cpp
+    Created: 19 Oct 2026 2:41:16pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "TrackLibrary.h"
+#include <algorithm>
+#include <numeric>
+
+TrackLibrary::TrackLibrary()
+{
+    clear();
+}
+
+void TrackLibrary::clear()
+{
+    strings.clear();
+    stringIndex.clear();
+    intern({}); // index 0 is the empty string
+
+    pathColumn.clear();
+    titleColumnText.clear();
+    searchColumn.clear();
+    durationColumnValue.clear();
+    durationColumnText.clear();
+    bpmColumnValue.clear();
+    bpmColumnText.clear();
+    keyColumnText.clear();
+    artistColumnText.clear();
+    albumColumnText.clear();
+    genreColumnText.clear();
+    commentColumnText.clear();
+    aliveColumn.clear();
+    numAlive = 0;
+    trackForPath.clear();
+
+    titleRank.clear();
+    keyRank.clear();
+    artistRank.clear();
+    albumRank.clear();
+    genreRank.clear();
+    commentRank.clear();
+    ranksDirty = true;
+
+    scope.clear();
+    scoped = false;
+    view.clear();
+    rowForId.clear();
+}
+
+uint32 TrackLibrary::intern(const String& s)
+{
+    if (stringIndex.contains(s))
+        return stringIndex[s];
+
+    const uint32 index = (uint32)strings.size();
+    strings.push_back(s);
+    stringIndex.set(s, index);
+    return index;
+}
+
+const String& TrackLibrary::lookup(uint32 index) const
+{
+    return strings[index];
+}
+
+String TrackLibrary::formatDuration(double seconds)
+{
+    if (seconds <= 0)
+        return {};
+
+    const int totalSeconds = (int)seconds;
+    return String::formatted("%02d:%02d", totalSeconds / 60, totalSeconds % 60);
+}
+
+TrackLibrary::TrackId TrackLibrary::addTrack(const File& file, double durationSecs, float bpm, const String& key)
+{
+    const TrackId id = (TrackId)aliveColumn.size();
+    const String title = file.getFileNameWithoutExtension();
+    const uint32 path = intern(file.getFullPathName());
+
+    pathColumn.push_back(path);
+    trackForPath[path] = id;
+    titleColumnText.push_back(intern(title));
+    searchColumn.push_back(intern(title.toLowerCase()));
+    durationColumnValue.push_back(durationSecs);
+    durationColumnText.push_back(intern(formatDuration(durationSecs)));
+    bpmColumnValue.push_back(bpm);
+    bpmColumnText.push_back(intern(bpm > 0 ? String(bpm, 1) : String()));
+    keyColumnText.push_back(intern(key));
+    artistColumnText.push_back(0);
+    albumColumnText.push_back(0);
+    genreColumnText.push_back(0);
+    commentColumnText.push_back(0);
+    aliveColumn.push_back(1);
+    ++numAlive;
+
+    ranksDirty = true;
+    return id;
+}
+
+void TrackLibrary::removeTrack(TrackId id)
+{
+    if (!isValid(id))
+        return;
+
+    aliveColumn[id] = 0;
+    --numAlive;
+    trackForPath.erase(pathColumn[id]);
+}
+
+void TrackLibrary::setDuration(TrackId id, double durationSecs)
+{
+    if (!isValid(id))
+        return;
+
+    durationColumnValue[id] = durationSecs;
+    durationColumnText[id] = intern(formatDuration(durationSecs));
+}
+
+void TrackLibrary::setBpmAndKey(TrackId id, float bpm, const String& key)
+{
+    if (!isValid(id))
+        return;
+
+    bpmColumnValue[id] = bpm;
+    bpmColumnText[id] = intern(bpm > 0 ? String(bpm, 1) : String());
+    keyColumnText[id] = intern(key);
+    ranksDirty = true;
+}
+
+void TrackLibrary::setTags(TrackId id, const TrackTags& tags)
+{
+    if (!isValid(id))
+        return;
+
+    if (tags.title.isNotEmpty())
+        titleColumnText[id] = intern(tags.title);
+    artistColumnText[id] = intern(tags.artist);
+    albumColumnText[id] = intern(tags.album);
+    genreColumnText[id] = intern(tags.genre);
+    commentColumnText[id] = intern(tags.comment);
+    updateSearchText(id);
+    ranksDirty = true;
+}
+
+void TrackLibrary::updateSearchText(TrackId id)
+{
+    String text = lookup(titleColumnText[id]);
+    for (uint32 field : { artistColumnText[id], albumColumnText[id], genreColumnText[id], commentColumnText[id] })
+        if (field != 0)
+            text << " " << lookup(field);
+
+    searchColumn[id] = intern(text.toLowerCase());
+}
+
+bool TrackLibrary::isValid(TrackId id) const
+{
+    return id < aliveColumn.size() && aliveColumn[id] != 0;
+}
+
+int TrackLibrary::getNumTracks() const
+{
+    return numAlive;
+}
+
+File TrackLibrary::getFile(TrackId id) const
+{
+    return isValid(id) ? File(lookup(pathColumn[id])) : File();
+}
+
+String TrackLibrary::getTitle(TrackId id) const
+{
+    return lookup(isValid(id) ? titleColumnText[id] : 0);
+}
+
+double TrackLibrary::getDuration(TrackId id) const
+{
+    return isValid(id) ? durationColumnValue[id] : 0.0;
+}
+
+TrackLibrary::TrackId TrackLibrary::findTrack(const File& file) const
+{
+    const String path = file.getFullPathName();
+    if (!stringIndex.contains(path))
+        return invalidId;
+
+    const auto found = trackForPath.find(stringIndex[path]);
+    return found != trackForPath.end() ? found->second : invalidId;
+}
+
+//==============================================================================
+void TrackLibrary::setFilter(const String& query)
+{
+    filter = query.trim().toLowerCase();
+    updateView();
+}
+
+void TrackLibrary::setSortOrder(int columnId, bool forwards)
+{
+    sortColumn = columnId;
+    sortForwards = forwards;
+    updateView();
+}
+
+void TrackLibrary::setScope(std::vector<TrackId> ids)
+{
+    scope = std::move(ids);
+    scoped = true;
+    updateView();
+}
+
+void TrackLibrary::clearScope()
+{
+    scope.clear();
+    scoped = false;
+    updateView();
+}
+
+bool TrackLibrary::isScoped() const
+{
+    return scoped;
+}
+
+void TrackLibrary::updateRanks()
+{
+    if (!ranksDirty)
+        return;
+
+    // rank every interned string once; after that sorting compares integers
+    std::vector<uint32> order((size_t)strings.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [this](uint32 a, uint32 b)
+    {
+        return strings[a].compareNatural(strings[b]) < 0;
+    });
+
+    std::vector<uint32> stringRank(strings.size());
+    for (uint32 r = 0; r < (uint32)order.size(); ++r)
+        stringRank[order[r]] = r;
+
+    auto rankColumn = [&stringRank](const std::vector<uint32>& column, std::vector<uint32>& rank)
+    {
+        rank.resize(column.size());
+        for (size_t id = 0; id < column.size(); ++id)
+            rank[id] = stringRank[column[id]];
+    };
+
+    rankColumn(titleColumnText, titleRank);
+    rankColumn(keyColumnText, keyRank);
+    rankColumn(artistColumnText, artistRank);
+    rankColumn(albumColumnText, albumRank);
+    rankColumn(genreColumnText, genreRank);
+    rankColumn(commentColumnText, commentRank);
+    ranksDirty = false;
+}
+
+void TrackLibrary::updateView()
+{
+    view.clear();
+    view.reserve(scoped ? scope.size() : (size_t)numAlive);
+
+    auto addIfVisible = [this](TrackId id)
+    {
+        if (!isValid(id))
+            return;
+        if (filter.isNotEmpty() && !lookup(searchColumn[id]).contains(filter))
+            return;
+        view.push_back(id);
+    };
+
+    if (scoped)
+    {
+        for (TrackId id : scope)
+            addIfVisible(id);
+    }
+    else
+    {
+        for (TrackId id = 0; id < (TrackId)aliveColumn.size(); ++id)
+            addIfVisible(id);
+    }
+
+    if (sortColumn != 0)
+    {
+        updateRanks();
+
+        auto sortByKey = [this](const auto& keys)
+        {
+            if (sortForwards)
+                std::stable_sort(view.begin(), view.end(), [&keys](TrackId a, TrackId b) { return keys[a] < keys[b]; });
+            else
+                std::stable_sort(view.begin(), view.end(), [&keys](TrackId a, TrackId b) { return keys[b] < keys[a]; });
+        };
+
+        switch (sortColumn)
+        {
+            case titleColumn:    sortByKey(titleRank); break;
+            case durationColumn: sortByKey(durationColumnValue); break;
+            case bpmColumn:      sortByKey(bpmColumnValue); break;
+            case keyColumn:      sortByKey(keyRank); break;
+            case artistColumn:   sortByKey(artistRank); break;
+            case albumColumn:    sortByKey(albumRank); break;
+            case genreColumn:    sortByKey(genreRank); break;
+            case commentColumn:  sortByKey(commentRank); break;
+            default: break;
+        }
+    }
+
+    rowForId.assign(aliveColumn.size(), -1);
+    for (int row = (int)view.size(); --row >= 0;)
+        rowForId[view[(size_t)row]] = row; // a playlist may repeat a track; keep the first row
+}
+
+int TrackLibrary::getNumRows() const
+{
+    return (int)view.size();
+}
+
+TrackLibrary::TrackId TrackLibrary::getIdForRow(int row) const
+{
+    return isPositiveAndBelow(row, (int)view.size()) ? view[(size_t)row] : invalidId;
+}
+
+int TrackLibrary::getRowForId(TrackId id) const
+{
+    return id < rowForId.size() ? rowForId[id] : -1;
+}
+
+const String& TrackLibrary::getCellText(int row, int columnId) const
+{
+    const TrackId id = getIdForRow(row);
+    if (!isValid(id))
+        return lookup(0);
+
+    switch (columnId)
+    {
+        case titleColumn:    return lookup(titleColumnText[id]);
+        case durationColumn: return lookup(durationColumnText[id]);
+        case bpmColumn:      return lookup(bpmColumnText[id]);
+        case keyColumn:      return lookup(keyColumnText[id]);
+        case artistColumn:   return lookup(artistColumnText[id]);
+        case albumColumn:    return lookup(albumColumnText[id]);
+        case genreColumn:    return lookup(genreColumnText[id]);
+        case commentColumn:  return lookup(commentColumnText[id]);
+        default:             return lookup(0);
+    }
+}
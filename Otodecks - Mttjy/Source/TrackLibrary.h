@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    TrackLibrary.h
+    Created: 19 Oct 2026 2:41:16pm
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+#include <unordered_map>
+#include "TagReader.h"
+
+//==============================================================================
+/*
+    Column store behind the playlist table.
+
+    Every track gets a TrackId that never changes or gets reused while the
+    library is open, and one slot in each column vector. Strings are interned,
+    and the display text for every cell is formatted when the track is added,
+    so painting a row is a lookup. The table shows a "view": the ids that
+    pass the search filter, in the current sort order. Sorting uses
+    precomputed integer ranks instead of comparing strings. The view can be
+    scoped to a playlist, which then gives the order when nothing is sorted.
+*/
+class TrackLibrary
+{
+public:
+    using TrackId = uint32;
+    static constexpr TrackId invalidId = 0xffffffff;
+
+    /** column ids, shared with the TableListBox header */
+    enum Column
+    {
+        titleColumn = 1,
+        durationColumn,
+        bpmColumn,
+        keyColumn,
+        artistColumn,
+        albumColumn,
+        genreColumn,
+        commentColumn
+    };
+
+    TrackLibrary();
+
+    void clear();
+
+    /** durationSecs and bpm may be 0 and key empty if unknown */
+    TrackId addTrack(const File& file, double durationSecs, float bpm = 0.0f, const String& key = {});
+    void removeTrack(TrackId id);
+
+    void setDuration(TrackId id, double durationSecs);
+    void setBpmAndKey(TrackId id, float bpm, const String& key);
+    /** a tag title replaces the file name as the displayed title; all tags are searchable */
+    void setTags(TrackId id, const TrackTags& tags);
+
+    bool isValid(TrackId id) const;
+    int getNumTracks() const;
+    File getFile(TrackId id) const;
+    String getTitle(TrackId id) const;
+    double getDuration(TrackId id) const;
+    TrackId findTrack(const File& file) const;
+
+    //==============================================================================
+    /** case-insensitive substring filter applied to the view */
+    void setFilter(const String& query);
+    void setSortOrder(int columnId, bool forwards);
+    /** show only these tracks, in this order */
+    void setScope(std::vector<TrackId> ids);
+    /** show the whole library again */
+    void clearScope();
+    bool isScoped() const;
+    /** rebuild the view after tracks were added or removed */
+    void updateView();
+
+    int getNumRows() const;
+    TrackId getIdForRow(int row) const;
+    int getRowForId(TrackId id) const;
+    const String& getCellText(int row, int columnId) const;
+
+private:
+    uint32 intern(const String& s);
+    const String& lookup(uint32 index) const;
+    void updateRanks();
+    void updateSearchText(TrackId id);
+    static String formatDuration(double seconds);
+
+    // interned strings
+    std::vector<String> strings;
+    HashMap<String, uint32> stringIndex;
+
+    // one entry per TrackId
+    std::vector<uint32> pathColumn;
+    std::vector<uint32> titleColumnText;
+    std::vector<uint32> searchColumn;
+    std::vector<double> durationColumnValue;
+    std::vector<uint32> durationColumnText;
+    std::vector<float> bpmColumnValue;
+    std::vector<uint32> bpmColumnText;
+    std::vector<uint32> keyColumnText;
+    std::vector<uint32> artistColumnText;
+    std::vector<uint32> albumColumnText;
+    std::vector<uint32> genreColumnText;
+    std::vector<uint32> commentColumnText;
+    std::vector<uint8> aliveColumn;
+    int numAlive = 0;
+    std::unordered_map<uint32, TrackId> trackForPath;
+
+    // precomputed sort keys, rebuilt lazily after strings change
+    std::vector<uint32> titleRank;
+    std::vector<uint32> keyRank;
+    std::vector<uint32> artistRank;
+    std::vector<uint32> albumRank;
+    std::vector<uint32> genreRank;
+    std::vector<uint32> commentRank;
+    bool ranksDirty = true;
+
+    std::vector<TrackId> scope;
+    bool scoped = false;
+
+    std::vector<TrackId> view;
+    std::vector<int> rowForId;
+    String filter;
+    int sortColumn = 0;
+    bool sortForwards = true;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TrackLibrary)
+};
@@ -0,0 +1,381 @@
+/*
+  ==============================================================================
+
+    TrackRecommender.cpp
+    Created: 20 Oct 2026 3:58:36am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#include "TrackRecommender.h"
+
+namespace
+{
+    constexpr int minRowsToBuild = 256;
+    constexpr int numProbes = 8;
+}
+
+TrackRecommender::TrackRecommender(const File& _tracksFolder)
+    : tracksFolder(_tracksFolder),
+      featuresFile(_tracksFolder.getSiblingFile("track_features.otfv"))
+{
+    formatManager.registerBasicFormats();
+
+    // a small library is searched from the message thread's own unbuilt index
+    readFeatures();
+    rebuildWanted = (int)entries.size() >= minRowsToBuild;
+
+    analysisThread.addTimeSliceClient(this);
+    analysisThread.startThread();
+}
+
+TrackRecommender::~TrackRecommender()
+{
+    // stops an analysis part way through rather than waiting for it
+    analysisThread.signalThreadShouldExit();
+    analysisThread.removeTimeSliceClient(this);
+    analysisThread.stopThread(5000);
+
+    if (numUnsaved > 0)
+        writeFeatures();
+}
+
+void TrackRecommender::addTracks(const Array<File>& files)
+{
+    const ScopedLock sl(lock);
+    if (queueNext == queue.size())
+    {
+        queue.clear();
+        queueNext = 0;
+    }
+    queue.insert(queue.end(), files.begin(), files.end());
+}
+
+void TrackRecommender::removeTrack(const File& file)
+{
+    const ScopedLock sl(lock);
+    auto it = rowForPath.find(file.getFullPathName());
+    if (it == rowForPath.end())
+        return;
+
+    entries[(size_t)it->second].removed = true;
+    rowForPath.erase(it);
+    ++numUnsaved;
+}
+
+Array<File> TrackRecommender::takeAnalysedFiles()
+{
+    Array<File> result;
+    const ScopedLock sl(lock);
+    result.swapWith(analysed);
+    return result;
+}
+
+bool TrackRecommender::getTempoAndKey(const File& file, float& bpm, int& key) const
+{
+    const ScopedLock sl(lock);
+    auto it = rowForPath.find(file.getFullPathName());
+    if (it == rowForPath.end() || !entries[(size_t)it->second].valid)
+        return false;
+
+    bpm = entries[(size_t)it->second].bpm;
+    key = entries[(size_t)it->second].key;
+    return true;
+}
+
+bool TrackRecommender::findSimilar(const File& file, int k, std::vector<Suggestion>& suggestions,
+                                   const Array<File>& exclude)
+{
+    const int64 start = Time::getHighResolutionTicks();
+    suggestions.clear();
+    updateIndex();
+
+    const ScopedLock sl(lock);
+    auto it = rowForPath.find(file.getFullPathName());
+    if (it == rowForPath.end() || !entries[(size_t)it->second].valid || index->size() == 0)
+        return false;
+
+    const int row = it->second;
+    std::vector<int> excluded;
+    for (auto& other : exclude)
+    {
+        auto found = rowForPath.find(other.getFullPathName());
+        if (found != rowForPath.end())
+            excluded.push_back(found->second);
+    }
+
+    // a few spare, in case some of the files have gone since they were analysed
+    const std::vector<SimilarityIndex::Match> matches = index->search(vectors.data() + (size_t)row * dimensions, k + 4, numProbes, [&](int id)
+    {
+        return id == row || entries[(size_t)id].removed
+            || std::find(excluded.begin(), excluded.end(), id) != excluded.end();
+    });
+
+    for (auto& match : matches)
+    {
+        const Entry& entry = entries[(size_t)match.id];
+        if ((int)suggestions.size() == k || !entry.file.existsAsFile())
+            continue;
+
+        Suggestion suggestion;
+        suggestion.file = entry.file;
+        suggestion.distance = match.distance;
+        suggestion.bpm = entry.bpm;
+        suggestion.key = entry.key;
+        suggestions.push_back(suggestion);
+    }
+
+    lastQueryMs = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) * 1000.0;
+    return true;
+}
+
+int TrackRecommender::getNumAnalysed() const
+{
+    const ScopedLock sl(lock);
+    return (int)rowForPath.size();
+}
+
+int TrackRecommender::getNumPending() const
+{
+    const ScopedLock sl(lock);
+    return (int)(queue.size() - queueNext);
+}
+
+double TrackRecommender::getLastQueryMs() const
+{
+    return lastQueryMs;
+}
+
+File TrackRecommender::getFeaturesFile() const
+{
+    return featuresFile;
+}
+
+//==============================================================================
+int TrackRecommender::useTimeSlice()
+{
+    File file;
+    Entry previous;
+    bool known = false;
+    {
+        const ScopedLock sl(lock);
+        if (rebuildWanted)
+        {
+            const ScopedUnlock su(lock);
+            rebuildIndex();
+            return 0;
+        }
+
+        if (queueNext == queue.size())
+        {
+            if (numUnsaved > 0)
+            {
+                const ScopedUnlock su(lock);
+                writeFeatures();
+            }
+            return 250;
+        }
+
+        file = queue[queueNext++];
+        auto it = rowForPath.find(file.getFullPathName());
+        known = it != rowForPath.end();
+        if (known)
+            previous = entries[(size_t)it->second];
+    }
+
+    Entry entry;
+    entry.file = file;
+    entry.size = file.getSize();
+    entry.modified = file.getLastModificationTime().toMilliseconds();
+    if (known && previous.size == entry.size && previous.modified == entry.modified)
+        return 0;
+    if (!file.existsAsFile())
+        return 0;
+
+    TrackFeatures features;
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+    entry.valid = reader != nullptr
+        && FeatureExtractor::extract(*reader, features, [this] { return analysisThread.threadShouldExit(); });
+    if (analysisThread.threadShouldExit())
+        return 0;
+
+    // unreadable files are remembered too, so they aren't decoded again every launch
+    entry.bpm = features.bpm;
+    entry.key = features.key;
+
+    bool save = false;
+    {
+        const ScopedLock sl(lock);
+        append(entry, features.values);
+        if (entry.valid)
+            analysed.add(file);
+
+        save = ++numUnsaved >= saveEvery;
+        if ((int)entries.size() >= jmax(minRowsToBuild, 2 * lastBuildRows))
+            rebuildWanted = true;
+    }
+
+    if (save)
+        writeFeatures();
+    sendChangeMessage();
+    return 0;
+}
+
+void TrackRecommender::append(Entry entry, const float* vector)
+{
+    const String path = entry.file.getFullPathName();
+    auto it = rowForPath.find(path);
+    if (it != rowForPath.end())
+        entries[(size_t)it->second].removed = true;
+
+    const int row = (int)entries.size();
+    entries.push_back(std::move(entry));
+    vectors.insert(vectors.end(), vector, vector + dimensions);
+    rowForPath[path] = row;
+}
+
+void TrackRecommender::rebuildIndex()
+{
+    std::vector<float> data;
+    std::vector<int> ids;
+    int rows = 0;
+    {
+        const ScopedLock sl(lock);
+        rows = (int)entries.size();
+        data.reserve(vectors.size());
+        ids.reserve(entries.size());
+        for (int row = 0; row < rows; ++row)
+        {
+            const Entry& entry = entries[(size_t)row];
+            if (!entry.valid || entry.removed)
+                continue;
+            const float* vector = vectors.data() + (size_t)row * dimensions;
+            data.insert(data.end(), vector, vector + dimensions);
+            ids.push_back(row);
+        }
+        rebuildWanted = false;
+        lastBuildRows = rows;
+    }
+
+    auto built = std::make_unique<SimilarityIndex>();
+    if (!built->build(data.data(), ids.data(), (int)ids.size(), 0, [this] { return analysisThread.threadShouldExit(); }))
+        return;
+
+    {
+        const ScopedLock sl(lock);
+        rebuilt = std::move(built);
+        rebuiltRows = rows;
+    }
+    sendChangeMessage();
+}
+
+void TrackRecommender::updateIndex()
+{
+    const ScopedLock sl(lock);
+    if (rebuilt != nullptr)
+    {
+        index = std::move(rebuilt);
+        indexedRows = rebuiltRows;
+    }
+    if (index == nullptr)
+        index = std::make_unique<SimilarityIndex>();
+
+    for (; indexedRows < (int)entries.size(); ++indexedRows)
+    {
+        const Entry& entry = entries[(size_t)indexedRows];
+        if (entry.valid && !entry.removed)
+            index->add(indexedRows, vectors.data() + (size_t)indexedRows * dimensions);
+    }
+}
+
+//==============================================================================
+bool TrackRecommender::readFeatures()
+{
+    MemoryBlock data;
+    if (!featuresFile.loadFileAsData(data) || data.getSize() < 16)
+        return false;
+
+    MemoryInputStream in(data, false);
+    char magic[4];
+    in.read(magic, 4);
+    if (memcmp(magic, "OTFV", 4) != 0 || in.readInt() != version || in.readInt() != dimensions)
+        return false;
+
+    const int count = in.readInt();
+    if (count < 0)
+        return false;
+
+    entries.reserve((size_t)count);
+    vectors.reserve((size_t)count * dimensions);
+    for (int i = 0; i < count; ++i)
+    {
+        Entry entry;
+        entry.file = tracksFolder.getChildFile(in.readString());
+        entry.size = in.readInt64();
+        entry.modified = in.readInt64();
+        entry.bpm = in.readFloat();
+        entry.key = in.readInt();
+        entry.valid = in.readByte() != 0;
+
+        float vector[dimensions];
+        for (float& value : vector)
+            value = in.readFloat();
+
+        if (in.isExhausted() && i < count - 1)
+        {
+            // cut short: the tracks get analysed again
+            entries.clear();
+            vectors.clear();
+            rowForPath.clear();
+            return false;
+        }
+        append(entry, vector);
+    }
+    return true;
+}
+
+bool TrackRecommender::writeFeatures()
+{
+    MemoryBlock data;
+    {
+        const ScopedLock sl(lock);
+        int count = 0;
+        for (auto& entry : entries)
+            if (!entry.removed)
+                ++count;
+
+        MemoryOutputStream out(data, false);
+        out.write("OTFV", 4);
+        out.writeInt(version);
+        out.writeInt(dimensions);
+        out.writeInt(count);
+        for (size_t row = 0; row < entries.size(); ++row)
+        {
+            const Entry& entry = entries[row];
+            if (entry.removed)
+                continue;
+
+            out.writeString(entry.file.getRelativePathFrom(tracksFolder));
+            out.writeInt64(entry.size);
+            out.writeInt64(entry.modified);
+            out.writeFloat(entry.bpm);
+            out.writeInt(entry.key);
+            out.writeByte(entry.valid ? 1 : 0);
+            for (int d = 0; d < dimensions; ++d)
+                out.writeFloat(vectors[row * dimensions + (size_t)d]);
+        }
+        numUnsaved = 0;
+    }
+
+    TemporaryFile temp(featuresFile);
+    {
+        FileOutputStream out(temp.getFile());
+        if (!out.openedOk() || !out.write(data.getData(), data.getSize()))
+            return false;
+        out.flush();
+        if (out.getStatus().failed())
+            return false;
+    }
+    return temp.overwriteTargetFileWithTemporary();
+}
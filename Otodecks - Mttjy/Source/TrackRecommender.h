@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    TrackRecommender.h
+    Created: 20 Oct 2026 3:58:36am
+    Author:  matthew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+#include <unordered_map>
+#include "FeatureExtractor.h"
+#include "SimilarityIndex.h"
+
+//==============================================================================
+/*
+    Suggests what to play next: the library tracks whose TrackFeatures are
+    nearest to a given track's.
+
+    Tracks handed to addTracks() are analysed one at a time on a background
+    thread, the first time they are seen and again whenever their size or
+    modification time changes. The results are kept in track_features.otfv
+    next to the tracks folder, so a track is only decoded once. The vectors
+    sit back to back in one array in the order they were analysed, and a
+    SimilarityIndex over them answers queries. The index is built on the
+    analysis thread whenever the library has doubled since the last build,
+    and tracks analysed in between are added to it as they arrive.
+
+        "OTFV" int32 version, int32 dimensions, int32 count
+        count x { string relative path, int64 size, int64 modified ms,
+                  float bpm, int32 key, uint8 valid, float[dimensions] }
+
+    A change message goes out as tracks are analysed, and once the first
+    index is ready.
+*/
+class TrackRecommender : public ChangeBroadcaster,
+                         private TimeSliceClient
+{
+public:
+    struct Suggestion
+    {
+        File file;
+        float distance = 0;
+        float bpm = 0;
+        int key = -1;
+    };
+
+    TrackRecommender(const File& tracksFolder);
+    ~TrackRecommender() override;
+
+    /** message thread: analyse these unless they already have been, at the same size and date */
+    void addTracks(const Array<File>& files);
+    /** message thread: never suggest this file again */
+    void removeTrack(const File& file);
+
+    /** message thread: files analysed since the last call */
+    Array<File> takeAnalysedFiles();
+    /** false if the file hasn't been analysed, or nothing could be made of it */
+    bool getTempoAndKey(const File& file, float& bpm, int& key) const;
+
+    /** message thread: up to k tracks that sound like file, nearest first, leaving out
+        exclude; false if file hasn't been analysed or there is no index yet */
+    bool findSimilar(const File& file, int k, std::vector<Suggestion>& suggestions,
+                     const Array<File>& exclude = {});
+
+    int getNumAnalysed() const;
+    int getNumPending() const;
+    double getLastQueryMs() const;
+    File getFeaturesFile() const;
+
+private:
+    struct Entry
+    {
+        File file;
+        int64 size = 0;
+        int64 modified = 0;
+        float bpm = 0;
+        int key = -1;
+        bool valid = false;
+        bool removed = false;
+    };
+
+    static constexpr int version = 1;
+    static constexpr int dimensions = TrackFeatures::numDimensions;
+    static constexpr int saveEvery = 200;
+
+    int useTimeSlice() override;
+
+    /** analysis thread, with the lock held */
+    void append(Entry entry, const float* vector);
+    /** analysis thread: index every valid row there is now */
+    void rebuildIndex();
+    /** message thread: swap in a rebuilt index and add the rows it hasn't seen */
+    void updateIndex();
+
+    bool readFeatures();
+    bool writeFeatures();
+
+    File tracksFolder;
+    File featuresFile;
+    AudioFormatManager formatManager;
+    TimeSliceThread analysisThread{ "Track analysis" };
+
+    mutable CriticalSection lock;
+    std::vector<Entry> entries;
+    std::vector<float> vectors;                     // entries.size() x dimensions
+    std::unordered_map<String, int> rowForPath;
+    std::vector<File> queue;
+    size_t queueNext = 0;
+    Array<File> analysed;
+    int numUnsaved = 0;
+    bool rebuildWanted = false;
+    int lastBuildRows = 0;
+    std::unique_ptr<SimilarityIndex> rebuilt;       // handed from the analysis thread to the message thread
+    int rebuiltRows = 0;
+
+    std::unique_ptr<SimilarityIndex> index;         // message thread only
+    int indexedRows = 0;
+    double lastQueryMs = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TrackRecommender)
+};
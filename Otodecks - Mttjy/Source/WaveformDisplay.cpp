@@ -11,10 +11,34 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "WaveformDisplay.h"
 
+namespace
+{
+    /** the thumbnail's source for a streamed track: a blocking stream over the deck's download */
+    class DownloadInputSource : public InputSource
+    {
+    public:
+        DownloadInputSource(StreamingDownload::Ptr _download, int64 _hash)
+            : download(_download), hash(_hash)
+        {
+        }
+
+        InputStream* createInputStream() override { return download->createStream(true).release(); }
+        InputStream* createInputStreamFor(const String&) override { return nullptr; }
+        int64 hashCode() const override { return hash; }
+
+    private:
+        StreamingDownload::Ptr download;
+        int64 hash;
+    };
+}
+
 //==============================================================================
 WaveformDisplay::WaveformDisplay(AudioFormatManager & 	formatManagerToUse,
-                                 AudioThumbnailCache & 	cacheToUse) :
-                                 audioThumb(1000, formatManagerToUse, cacheToUse), 
+                                 AudioThumbnailCache & 	cacheToUse,
+                                 BandAnalyser & analyserToUse) :
+                                 thumbCache(cacheToUse),
+                                 audioThumb(BandWaveform::samplesPerColumn, formatManagerToUse, cacheToUse), 
+                                 analyser(analyserToUse),
                                  fileLoaded(false), 
                                  position(0)
                           
@@ -23,10 +47,13 @@ WaveformDisplay::WaveformDisplay(AudioFormatManager & 	formatManagerToUse,
     // initialise any special settings that your component needs.
 
   audioThumb.addChangeListener(this);
+  analyser.addChangeListener(this);
 }
 
 WaveformDisplay::~WaveformDisplay()
 {
+    analyser.removeThumbnail(&audioThumb);
+    analyser.removeChangeListener(this);
 }
 
 void WaveformDisplay::paint (Graphics& g)
@@ -46,13 +73,22 @@ void WaveformDisplay::paint (Graphics& g)
     g.setColour (Colour::fromRGB(200, 135, 220));
     if(fileLoaded)
     {
-      audioThumb.drawChannel(g, 
-        getLocalBounds(), 
-        0, 
-        audioThumb.getTotalLength(), 
-        0, 
-        1.0f
-      );
+      if (bands != nullptr)
+      {
+        if (bandImage.getWidth() != getWidth() || bandImage.getHeight() != getHeight())
+          bandImage = BandAnalyser::render(*bands, getWidth(), getHeight());
+        g.drawImageAt(bandImage, 0, 0);
+      }
+      else
+      {
+        audioThumb.drawChannel(g, 
+          getLocalBounds(), 
+          0, 
+          audioThumb.getTotalLength(), 
+          0, 
+          1.0f
+        );
+      }
       g.setColour(Colours::red);
       g.drawRect(position * getWidth(), 0, 2, getHeight());
     }
@@ -72,10 +108,35 @@ void WaveformDisplay::resized()
 
 }
 
-void WaveformDisplay::loadURL(URL audioURL)
+void WaveformDisplay::loadURL(URL audioURL, StreamingDownload::Ptr download)
 {
+  analyser.removeThumbnail(&audioThumb);
   audioThumb.clear();
-  fileLoaded  = audioThumb.setSource(new URLInputSource(audioURL));
+  fileLoaded = !audioURL.isEmpty();
+
+  // a streamed track is only ever read from the deck's own download
+  if (download != nullptr && download->getURL() != audioURL)
+    download = nullptr;
+  const bool streamed = StreamingDownload::canStream(audioURL);
+
+  // a track analysed before shows in colour straight away
+  loadedURL = audioURL;
+  bandImage = Image();
+  bands = analyser.getResult(audioURL);
+  if (fileLoaded && bands == nullptr)
+  {
+    // the analysis decodes the track anyway; the thumbnail rides along unless it is cached
+    const bool cached = thumbCache.loadThumb(audioThumb, getThumbnailHash(audioURL));
+    if (!analyser.request(audioURL, cached ? nullptr : &audioThumb, download) && !cached)
+    {
+      bands = analyser.getResult(audioURL);
+      if (bands == nullptr && !streamed)
+        fileLoaded = audioThumb.setSource(new URLInputSource(audioURL));
+      else if (bands == nullptr && download != nullptr)
+        fileLoaded = audioThumb.setSource(new DownloadInputSource(download, getThumbnailHash(audioURL)));
+    }
+  }
+
   if (fileLoaded)
   {
     std::cout << "wfd: loaded! " << std::endl;
@@ -89,25 +150,56 @@ void WaveformDisplay::loadURL(URL audioURL)
 
 void WaveformDisplay::changeListenerCallback (ChangeBroadcaster *source)
 {
-    std::cout << "wfd: change received! " << std::endl;
+    if (source == &analyser)
+    {
+        // some deck's analysis finished; only this track's matters here
+        if (bands != nullptr || !fileLoaded)
+            return;
+        bands = analyser.getResult(loadedURL);
+        if (bands == nullptr)
+            return;
+
+        // built from the analysis's blocks, so keep it for the next session
+        if (audioThumb.isFullyLoaded())
+            thumbCache.storeThumb(audioThumb, getThumbnailHash(loadedURL));
+    }
+    else if (bands != nullptr)
+    {
+        return; // the thumbnail is no longer drawn
+    }
 
     repaint();
-
 }
 
 void WaveformDisplay::setPositionRelative(double pos)
 {
-  if (pos != position)
+  if (pos == position)
+    return;
+
+  // only the strips under the old and new playhead need redrawing, and
+  // only once it has moved to another pixel
+  const int oldX = (int)(position * getWidth());
+  const int newX = (int)(pos * getWidth());
+  position = pos;
+  if (newX != oldX)
   {
-    position = pos;
-    repaint();
+    repaint(oldX - 1, 0, 4, getHeight());
+    repaint(newX - 1, 0, 4, getHeight());
   }
 }
 
 void WaveformDisplay::clear()
 {
+    analyser.removeThumbnail(&audioThumb);
     audioThumb.clear();
+    bands = nullptr;
+    bandImage = Image();
     fileLoaded = false;
     position = 0.0;
     repaint();
-}
\ No newline at end of file
+}
+
+int64 WaveformDisplay::getThumbnailHash(const URL& url)
+{
+    return url.toString(true).hashCode64();
+}
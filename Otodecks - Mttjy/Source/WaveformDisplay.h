@@ -11,16 +11,27 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "BandAnalyser.h"
 
 //==============================================================================
 /*
+    The track's waveform with the playhead over it. Until the band analysis
+    is ready the thumbnail is drawn in one colour; after that the coloured
+    image from BandAnalyser::render(), rebuilt only when the size changes.
+
+    The thumbnail comes from the thumbnail cache when it is there, and is
+    otherwise built from the analysis's decoded blocks as they arrive. Only
+    if that analysis has already started for another deck does the
+    thumbnail read the file itself. A streamed track is read from the
+    deck's download for both, and isn't shown without one.
 */
 class WaveformDisplay    : public Component, 
                            public ChangeListener
 {
 public:
     WaveformDisplay( AudioFormatManager & 	formatManagerToUse,
-                    AudioThumbnailCache & 	cacheToUse );
+                    AudioThumbnailCache & 	cacheToUse,
+                    BandAnalyser & analyserToUse );
     ~WaveformDisplay();
 
     void paint (Graphics&) override;
@@ -28,7 +39,8 @@ public:
 
     void changeListenerCallback (ChangeBroadcaster *source) override;
 
-    void loadURL(URL audioURL);
+    /** download: the deck's, if it is streaming audioURL */
+    void loadURL(URL audioURL, StreamingDownload::Ptr download = nullptr);
 
     /** set the relative position of the playhead*/
     void setPositionRelative(double pos);
@@ -36,7 +48,15 @@ public:
     void clear();
 
 private:
+    /** the key AudioThumbnail's own URLInputSource would use, so cache entries are shared */
+    static int64 getThumbnailHash(const URL& url);
+
+    AudioThumbnailCache& thumbCache;
     AudioThumbnail audioThumb;
+    BandAnalyser& analyser;
+    URL loadedURL;
+    std::shared_ptr<const BandWaveform> bands;
+    Image bandImage;
     bool fileLoaded; 
     double position;
     